@@ -0,0 +1,220 @@
+// Copyright (C) 2010-2013 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+/// @file benchmark-assembly.cpp
+/// @brief Benchmark of Proto element assembly and of the linear system assembly and solve, per element type
+///
+/// A Laplace problem is assembled with UFEM on quadrilaterals, triangles and hexahedra.
+/// Arguments (see Tools::Testing::Benchmark): --size N gives the number of cells per direction.
+/// The 3D mesh uses half that number, to keep the problem sizes of the same order.
+/// proto_assembly_nocache repeats the assembly with the jacobian cache disabled. Only the affine triangles use the
+/// cache, so for them the difference with proto_assembly is what the cache gains.
+
+#define BOOST_PROTO_MAX_ARITY 10
+#ifdef BOOST_MPL_LIMIT_METAFUNCTION_ARITY
+ #undef BOOST_MPL_LIMIT_METAFUNCTION_ARITY
+ #define BOOST_MPL_LIMIT_METAFUNCTION_ARITY 10
+#endif
+
+#include <algorithm>
+
+#include <boost/bind.hpp>
+#include <boost/mpl/vector.hpp>
+
+#include "common/Core.hpp"
+#include "common/Environment.hpp"
+#include "common/OptionList.hpp"
+#include "common/PE/Comm.hpp"
+
+#include "math/LSS/SolveLSS.hpp"
+#include "math/LSS/System.hpp"
+
+#include "mesh/Domain.hpp"
+#include "mesh/Mesh.hpp"
+#include "mesh/MeshGenerator.hpp"
+#include "mesh/MeshTransformer.hpp"
+#include "mesh/LagrangeP1/Hexa3D.hpp"
+#include "mesh/LagrangeP1/Quad2D.hpp"
+#include "mesh/LagrangeP1/Triag2D.hpp"
+
+#include "solver/Model.hpp"
+
+#include "solver/actions/Proto/ProtoAction.hpp"
+#include "solver/actions/Proto/Expression.hpp"
+
+#include "Tools/Testing/Benchmark.hpp"
+
+#include "UFEM/BoundaryConditions.hpp"
+#include "UFEM/LSSAction.hpp"
+#include "UFEM/Solver.hpp"
+#include "UFEM/Tags.hpp"
+
+using namespace cf3;
+using namespace cf3::common;
+using namespace cf3::mesh;
+using namespace cf3::solver;
+using namespace cf3::solver::actions::Proto;
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Assembly of a Laplace problem on one element type
+struct AssemblyBenchmark
+{
+  AssemblyBenchmark(Tools::Testing::Benchmark& benchmark, const std::string& element_name) :
+    bench(benchmark),
+    name(element_name)
+  {
+  }
+
+  /// Set up the model and the LSS on the given mesh, with the assembly for the element types in ElementsT
+  template<typename ElementsT>
+  void setup(const ElementsT& allowed_elements, const Uint dimension, const bool triangulate)
+  {
+    Model& model = *Core::instance().root().create_component<Model>("Assembly" + name);
+    Domain& domain = model.create_domain("Domain");
+    UFEM::Solver& solver = *model.create_component<UFEM::Solver>("Solver");
+    model.create_physics("cf3.physics.DynamicModel");
+
+    m_lss_action = Handle<UFEM::LSSAction>(solver.add_direct_solver("cf3.UFEM.LSSAction"));
+
+    FieldVariable<0, ScalarField> temperature("Temperature", UFEM::Tags::solution());
+
+    boost::shared_ptr<UFEM::BoundaryConditions> bc = allocate_component<UFEM::BoundaryConditions>("BoundaryConditions");
+
+    *m_lss_action
+      << create_proto_action
+      (
+        "Assembly",
+        elements_expression
+        (
+          allowed_elements,
+          group
+          (
+            _A = _0,
+            element_quadrature( _A(temperature) += transpose(nabla(temperature)) * nabla(temperature) ),
+            m_lss_action->system_matrix += _A
+          )
+        )
+      )
+      << bc
+      << allocate_component<math::LSS::SolveLSS>("SolveLSS");
+
+    const Uint nb_cells = dimension == 3 ? std::max(bench.size() / 2, 1u) : bench.size();
+    Handle<MeshGenerator> generator(domain.create_component("generator", "cf3.mesh.SimpleMeshGenerator"));
+    generator->options().set("mesh", domain.uri() / "Mesh");
+    generator->options().set("nb_cells", std::vector<Uint>(dimension, nb_cells));
+    generator->options().set("lengths", std::vector<Real>(dimension, 1.));
+    Mesh& mesh = generator->generate();
+    if(triangulate)
+    {
+      Handle<MeshTransformer> triangulator(domain.create_component("triangulator", "cf3.mesh.MeshTriangulator"));
+      triangulator->transform(mesh);
+    }
+
+    m_lss_action->options().set("regions", std::vector<URI>(1, mesh.topology().uri()));
+
+    bc->add_constant_bc("left", "Temperature", 10.);
+    bc->add_constant_bc("right", "Temperature", 35.);
+
+    m_lss = m_lss_action->options().value< Handle<math::LSS::System> >("lss");
+    m_assembly = Handle<common::Action>(m_lss_action->get_child("Assembly"));
+    m_bc = Handle<common::Action>(m_lss_action->get_child("BoundaryConditions"));
+    m_solve = Handle<common::Action>(m_lss_action->get_child("SolveLSS"));
+
+    // Initialize the solution field and everything else that is created on the first execution
+    m_lss_action->execute();
+  }
+
+  void reset()
+  {
+    m_lss->reset();
+  }
+
+  void assemble()
+  {
+    m_assembly->execute();
+  }
+
+  /// Assembly with the jacobians of affine elements computed at every quadrature point, to compare with assemble()
+  void assemble_without_jacobian_cache()
+  {
+    set_jacobian_cache_enabled(false);
+    m_assembly->execute();
+    set_jacobian_cache_enabled(true);
+  }
+
+  void assemble_and_constrain()
+  {
+    m_lss->reset();
+    m_assembly->execute();
+    m_bc->execute();
+  }
+
+  void solve()
+  {
+    m_solve->execute();
+  }
+
+  void run_all()
+  {
+    m_lss_action->execute();
+  }
+
+  void run()
+  {
+    bench.measure("proto_assembly_" + name, boost::bind(&AssemblyBenchmark::assemble, this), boost::bind(&AssemblyBenchmark::reset, this));
+    bench.measure("proto_assembly_nocache_" + name, boost::bind(&AssemblyBenchmark::assemble_without_jacobian_cache, this), boost::bind(&AssemblyBenchmark::reset, this));
+    bench.measure("lss_solve_" + name, boost::bind(&AssemblyBenchmark::solve, this), boost::bind(&AssemblyBenchmark::assemble_and_constrain, this));
+    bench.measure("lss_assemble_solve_" + name, boost::bind(&AssemblyBenchmark::run_all, this), boost::bind(&AssemblyBenchmark::reset, this));
+  }
+
+  Tools::Testing::Benchmark& bench;
+  const std::string name;
+
+  Handle<UFEM::LSSAction> m_lss_action;
+  Handle<math::LSS::System> m_lss;
+  Handle<common::Action> m_assembly;
+  Handle<common::Action> m_bc;
+  Handle<common::Action> m_solve;
+};
+
+/// Set up and run the benchmark for one element type. Setup failures are reported as a skipped phase.
+template<typename ElementsT>
+void benchmark_element_type(Tools::Testing::Benchmark& bench, const std::string& name, const ElementsT& allowed_elements, const Uint dimension, const bool triangulate)
+{
+  AssemblyBenchmark assembly(bench, name);
+  try
+  {
+    assembly.setup(allowed_elements, dimension, triangulate);
+  }
+  catch(Exception& e)
+  {
+    bench.skip("setup_" + name, e.what());
+    return;
+  }
+  assembly.run();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char** argv)
+{
+  Core::instance().initiate(argc, argv);
+  PE::Comm::instance().init(argc, argv);
+  Core::instance().environment().options().set("log_level", 1u);
+
+  Tools::Testing::Benchmark benchmark("assembly", argc, argv);
+
+  benchmark_element_type(benchmark, "Quad2D", boost::mpl::vector1<LagrangeP1::Quad2D>(), 2, false);
+  benchmark_element_type(benchmark, "Triag2D", boost::mpl::vector1<LagrangeP1::Triag2D>(), 2, true);
+  benchmark_element_type(benchmark, "Hexa3D", boost::mpl::vector1<LagrangeP1::Hexa3D>(), 3, false);
+
+  benchmark.write();
+
+  PE::Comm::instance().finalize();
+  Core::instance().terminate();
+  return 0;
+}
@@ -0,0 +1,265 @@
+// Copyright (C) 2010-2013 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+/// @file benchmark-mesh.cpp
+/// @brief Benchmark of the mesh pipeline: generation, I/O, partitioning, global numbering, face building,
+///        halo synchronization, interpolation and restart files
+///
+/// Arguments (see Tools::Testing::Benchmark): --size N gives the number of cells per direction,
+/// --dim 2 or 3 selects a rectangle of quads or a box of hexahedra.
+
+#include <boost/bind.hpp>
+#include <boost/lexical_cast.hpp>
+
+#include "common/Core.hpp"
+#include "common/Environment.hpp"
+#include "common/Group.hpp"
+#include "common/OptionList.hpp"
+#include "common/PE/Comm.hpp"
+
+#include "mesh/Dictionary.hpp"
+#include "mesh/Field.hpp"
+#include "mesh/Mesh.hpp"
+#include "mesh/MeshGenerator.hpp"
+#include "mesh/MeshReader.hpp"
+#include "mesh/MeshTransformer.hpp"
+#include "mesh/MeshWriter.hpp"
+
+#include "mesh/actions/Interpolate.hpp"
+
+#include "solver/Tags.hpp"
+#include "solver/Time.hpp"
+
+#include "Tools/Testing/Benchmark.hpp"
+
+using namespace cf3;
+using namespace cf3::common;
+using namespace cf3::mesh;
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Phases of the benchmark. Each phase works on meshes created in its setup, so the phases are independent.
+struct MeshBenchmark
+{
+  MeshBenchmark(Tools::Testing::Benchmark& benchmark, const Uint dim) :
+    bench(benchmark),
+    dimension(dim),
+    parent(*Core::instance().root().create_component<Group>("MeshBenchmark"))
+  {
+  }
+
+  /// Generate a new mesh with the given name, replacing any existing one
+  Mesh& generate(const std::string& name)
+  {
+    if(is_not_null(parent.get_child(name)))
+      parent.remove_component(name);
+
+    Handle<MeshGenerator> generator = parent.get_child("generator")->handle<MeshGenerator>();
+    generator->options().set("mesh", parent.uri() / name);
+    return generator->generate();
+  }
+
+  void setup_generator()
+  {
+    if(is_not_null(parent.get_child("generator")))
+      parent.remove_component("generator");
+    Handle<MeshGenerator> generator(parent.create_component("generator", "cf3.mesh.SimpleMeshGenerator"));
+    generator->options().set("nb_cells", std::vector<Uint>(dimension, bench.size()));
+    generator->options().set("lengths", std::vector<Real>(dimension, 1.));
+  }
+
+  void run_generate()
+  {
+    generate("mesh");
+  }
+
+  void run_write()
+  {
+    m_writer->write_from_to(*m_mesh, URI(file_name(), URI::Scheme::FILE));
+  }
+
+  void run_read()
+  {
+    m_reader->read_mesh_into(URI(rank_file_name(), URI::Scheme::FILE), *m_mesh);
+  }
+
+  void setup_read()
+  {
+    if(is_not_null(parent.get_child("read_mesh")))
+      parent.remove_component("read_mesh");
+    m_mesh = parent.create_component<Mesh>("read_mesh");
+  }
+
+  void setup_transform(const std::string& builder_name)
+  {
+    m_mesh = generate("mesh").handle<Mesh>();
+    if(is_not_null(parent.get_child("transformer")))
+      parent.remove_component("transformer");
+    m_transformer = Handle<MeshTransformer>(parent.create_component("transformer", builder_name));
+  }
+
+  void run_transform()
+  {
+    m_transformer->transform(*m_mesh);
+  }
+
+  void setup_fields()
+  {
+    m_mesh = generate("mesh").handle<Mesh>();
+    Dictionary& nodes = m_mesh->geometry_fields();
+    m_field = nodes.create_field("benchmark_field", "u[vector]").handle<Field>();
+    const Uint nb_nodes = nodes.size();
+    const Uint row_size = m_field->row_size();
+    for(Uint i = 0; i != nb_nodes; ++i)
+      for(Uint j = 0; j != row_size; ++j)
+        (*m_field)[i][j] = nodes.coordinates()[i][j % dimension];
+  }
+
+  void run_synchronize()
+  {
+    m_field->synchronize();
+  }
+
+  void setup_interpolate()
+  {
+    setup_fields();
+    Dictionary& cells = m_mesh->create_discontinuous_space("benchmark_cells", "cf3.mesh.LagrangeP0");
+    Field& target = cells.create_field("benchmark_field", "u[vector]");
+
+    if(is_not_null(parent.get_child("interpolator")))
+      parent.remove_component("interpolator");
+    Handle<actions::Interpolate> interpolator = parent.create_component<actions::Interpolate>("interpolator");
+    interpolator->options().set("source", m_field->handle<Field const>());
+    interpolator->options().set("target", target.handle<Field>());
+    m_interpolator = interpolator;
+  }
+
+  void run_interpolate()
+  {
+    m_interpolator->execute();
+  }
+
+  void setup_restart()
+  {
+    setup_fields();
+    if(is_null(parent.get_child("time")))
+      parent.create_component<solver::Time>("time");
+    Handle<solver::Time> time(parent.get_child("time"));
+
+    if(is_not_null(parent.get_child("restart_writer")))
+      parent.remove_component("restart_writer");
+    m_restart_writer = Handle<Action>(parent.create_component("restart_writer", "cf3.solver.actions.WriteRestartFile"));
+    m_restart_writer->options().set("fields", std::vector< Handle<Field> >(1, m_field));
+    m_restart_writer->options().set("file", URI(restart_file_name(), URI::Scheme::FILE));
+    m_restart_writer->options().set(solver::Tags::time(), time);
+
+    if(is_not_null(parent.get_child("restart_reader")))
+      parent.remove_component("restart_reader");
+    m_restart_reader = Handle<Action>(parent.create_component("restart_reader", "cf3.solver.actions.ReadRestartFile"));
+    m_restart_reader->options().set("mesh", m_mesh);
+    m_restart_reader->options().set("file", URI(restart_file_name(), URI::Scheme::FILE));
+    m_restart_reader->options().set(solver::Tags::time(), time);
+  }
+
+  void run_write_restart()
+  {
+    m_restart_writer->execute();
+  }
+
+  void run_read_restart()
+  {
+    m_restart_reader->execute();
+  }
+
+  void run()
+  {
+    bench.measure("generate", boost::bind(&MeshBenchmark::run_generate, this), boost::bind(&MeshBenchmark::setup_generator, this));
+
+    m_mesh = generate("mesh").handle<Mesh>();
+    m_writer = Handle<MeshWriter>(parent.create_component("writer", "cf3.mesh.gmsh.Writer"));
+    bench.measure("write_gmsh", boost::bind(&MeshBenchmark::run_write, this));
+
+    // Each rank reads back its own part, as written by the gmsh writer
+    m_reader = Handle<MeshReader>(parent.create_component("reader", "cf3.mesh.gmsh.Reader"));
+    m_reader->options().set("part", 0u);
+    m_reader->options().set("nb_parts", 1u);
+    bench.measure("read_gmsh", boost::bind(&MeshBenchmark::run_read, this), boost::bind(&MeshBenchmark::setup_read, this));
+
+    bench.measure("global_numbering", boost::bind(&MeshBenchmark::run_transform, this),
+                  boost::bind(&MeshBenchmark::setup_transform, this, "cf3.mesh.actions.GlobalNumbering"));
+    bench.measure("partition", boost::bind(&MeshBenchmark::run_transform, this),
+                  boost::bind(&MeshBenchmark::setup_transform, this, "cf3.mesh.actions.LoadBalance"));
+    bench.measure("build_faces", boost::bind(&MeshBenchmark::run_transform, this),
+                  boost::bind(&MeshBenchmark::setup_transform, this, "cf3.mesh.actions.BuildFaces"));
+
+    setup_fields();
+    bench.measure("halo_synchronize", boost::bind(&MeshBenchmark::run_synchronize, this));
+
+    bench.measure("interpolate", boost::bind(&MeshBenchmark::run_interpolate, this), boost::bind(&MeshBenchmark::setup_interpolate, this));
+
+    setup_restart();
+    bench.measure("write_restart", boost::bind(&MeshBenchmark::run_write_restart, this));
+    bench.measure("read_restart", boost::bind(&MeshBenchmark::run_read_restart, this));
+  }
+
+  std::string file_name() const
+  {
+    return "benchmark-mesh-" + boost::lexical_cast<std::string>(dimension) + "d.msh";
+  }
+
+  /// File written by this rank. In parallel, the gmsh writer adds the rank to the file name.
+  std::string rank_file_name() const
+  {
+    if(!PE::Comm::instance().is_active() || PE::Comm::instance().size() == 1)
+      return file_name();
+    return "benchmark-mesh-" + boost::lexical_cast<std::string>(dimension) + "d_P" + boost::lexical_cast<std::string>(PE::Comm::instance().rank()) + ".msh";
+  }
+
+  std::string restart_file_name() const
+  {
+    return "benchmark-mesh-" + boost::lexical_cast<std::string>(dimension) + "d.cfrestart";
+  }
+
+  Tools::Testing::Benchmark& bench;
+  const Uint dimension;
+  Group& parent;
+
+  Handle<Mesh> m_mesh;
+  Handle<MeshWriter> m_writer;
+  Handle<MeshReader> m_reader;
+  Handle<MeshTransformer> m_transformer;
+  Handle<Field> m_field;
+  Handle<Action> m_interpolator;
+  Handle<Action> m_restart_writer;
+  Handle<Action> m_restart_reader;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char** argv)
+{
+  Core::instance().initiate(argc, argv);
+  PE::Comm::instance().init(argc, argv);
+  Core::instance().environment().options().set("log_level", 1u);
+
+  Uint dimension = 3;
+  for(int i = 1; i < argc-1; ++i)
+  {
+    if(std::string(argv[i]) == "--dim")
+      dimension = boost::lexical_cast<Uint>(argv[i+1]);
+  }
+
+  Tools::Testing::Benchmark benchmark("mesh-" + boost::lexical_cast<std::string>(dimension) + "d", argc, argv);
+  benchmark.add_parameter("dimension", boost::lexical_cast<std::string>(dimension));
+
+  MeshBenchmark(benchmark, dimension).run();
+
+  benchmark.write();
+
+  PE::Comm::instance().finalize();
+  Core::instance().terminate();
+  return 0;
+}
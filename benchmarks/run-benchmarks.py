@@ -0,0 +1,99 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+
+# Runs the benchmark executables for a range of problem sizes and numbers of processes, and merges their
+# JSON output into a single file. With --compare, the timings are checked against the results of an earlier
+# run and the script exits with an error if any phase got slower by more than the threshold.
+
+from __future__ import print_function
+
+import json
+import optparse
+import os
+import subprocess
+import sys
+
+# benchmark executable and extra arguments, the benchmark name in the JSON output is used as key
+benchmarks = [
+  ('benchmark-mesh', ['--dim', '2']),
+  ('benchmark-mesh', ['--dim', '3']),
+  ('benchmark-assembly', [])
+]
+
+def run_benchmarks(options):
+  runs = []
+  for (executable, extra_args) in benchmarks:
+    command = os.path.join(options.bindir, executable)
+    if not os.path.exists(command):
+      print('skipping', executable, '(not built)')
+      continue
+    for nb_procs in [int(n) for n in options.procs.split(',')]:
+      for size in [int(s) for s in options.sizes.split(',')]:
+        output = 'benchmark-result-%s-%s-np%d-s%d.json' % (executable, '-'.join(extra_args), nb_procs, size)
+        cmd = [command, '--size', str(size), '--repeat', str(options.repeat), '--output', output] + extra_args
+        if nb_procs > 1 or options.always_mpi:
+          cmd = [options.mpiexec, '-np', str(nb_procs)] + cmd
+        print('running', ' '.join(cmd))
+        if subprocess.call(cmd) != 0:
+          print('error: benchmark exited with an error', file=sys.stderr)
+          continue
+        with open(output) as f:
+          runs.append(json.load(f))
+  return runs
+
+def timings(runs):
+  result = {}
+  for run in runs:
+    meta = run['metadata']
+    for phase in run['phases']:
+      if phase['completed']:
+        key = '%s np=%d size=%d %s' % (run['benchmark'], meta['nb_procs'], meta['size'], phase['name'])
+        result[key] = phase['time_max']
+  return result
+
+def compare(runs, baseline_runs, threshold):
+  current = timings(runs)
+  baseline = timings(baseline_runs)
+  regressions = []
+  for key in sorted(current.keys()):
+    if key not in baseline or baseline[key] <= 0.:
+      continue
+    ratio = current[key] / baseline[key]
+    status = 'ok'
+    if ratio > 1. + threshold:
+      status = 'REGRESSION'
+      regressions.append(key)
+    elif ratio < 1. - threshold:
+      status = 'improved'
+    print('%-70s %10.4g s %10.4g s %7.2f %s' % (key, baseline[key], current[key], ratio, status))
+  return regressions
+
+parser = optparse.OptionParser(usage='%prog [options]')
+parser.add_option('--bindir', default=os.path.dirname(os.path.abspath(__file__)), help='directory containing the benchmark executables')
+parser.add_option('--mpiexec', default='@MPIEXEC@', help='MPI launcher')
+parser.add_option('--always-mpi', action='store_true', default=False, help='also use the MPI launcher for serial runs')
+parser.add_option('--sizes', default='16,32,64', help='comma-separated list of problem sizes')
+parser.add_option('--procs', default='1,2,4', help='comma-separated list of numbers of processes')
+parser.add_option('--repeat', type='int', default=3, help='number of repetitions of each phase')
+parser.add_option('--output', default='benchmark-results.json', help='merged JSON output')
+parser.add_option('--compare', default=None, help='JSON output of an earlier run to compare with')
+parser.add_option('--threshold', type='float', default=0.1, help='relative slowdown that is reported as a regression')
+parser.add_option('--no-run', action='store_true', default=False, help='only compare the existing output file with the baseline')
+(options, args) = parser.parse_args()
+
+if options.no_run:
+  with open(options.output) as f:
+    runs = json.load(f)['runs']
+else:
+  runs = run_benchmarks(options)
+  with open(options.output, 'w') as f:
+    json.dump({'runs': runs}, f, indent=2)
+  print('results written to', options.output)
+
+if options.compare is not None:
+  with open(options.compare) as f:
+    baseline_runs = json.load(f)['runs']
+  regressions = compare(runs, baseline_runs, options.threshold)
+  if regressions:
+    print('%d phases are slower than the baseline by more than %g%%' % (len(regressions), 100.*options.threshold), file=sys.stderr)
+    sys.exit(1)
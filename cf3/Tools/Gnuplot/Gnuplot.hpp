@@ -173,8 +173,8 @@ public:
     return *this;
   }
 
-  template <class T>
-  Gnuplot &send(const boost::multi_array<T,2>& x, const boost::multi_array<T,2>& y)
+  template <class T, class AllocatorT>
+  Gnuplot &send(const boost::multi_array<T,2,AllocatorT>& x, const boost::multi_array<T,2,AllocatorT>& y)
   {
     if (x.shape()[1] != 1 || y.shape()[1] != 1)
       throw std::runtime_error("multi-arrays have more than 1 column");
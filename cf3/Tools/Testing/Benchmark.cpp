@@ -0,0 +1,378 @@
+// Copyright (C) 2010-2013 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <sstream>
+
+#include <boost/lexical_cast.hpp>
+
+#include "common/CF.hpp"
+
+#ifdef CF3_HAVE_PERF_EVENT_H
+  #include <linux/perf_event.h>
+  #include <sys/ioctl.h>
+  #include <sys/syscall.h>
+  #include <unistd.h>
+#endif
+
+#include "common/BasicExceptions.hpp"
+#include "common/BuildInfo.hpp"
+#include "common/Core.hpp"
+#include "common/Log.hpp"
+#include "common/Timer.hpp"
+#include "common/PE/Comm.hpp"
+
+#include "Tools/Testing/Benchmark.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace Tools {
+namespace Testing {
+
+using namespace common;
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace detail
+{
+
+/// Hardware counters of the calling thread. The counters are opened all or none, so names() is either the
+/// complete list or empty if the counters are not available.
+class HardwareCounters
+{
+public:
+  HardwareCounters()
+  {
+#ifdef CF3_HAVE_PERF_EVENT_H
+    open(PERF_COUNT_HW_CPU_CYCLES, "cycles");
+    open(PERF_COUNT_HW_INSTRUCTIONS, "instructions");
+    open(PERF_COUNT_HW_CACHE_MISSES, "cache_misses");
+    open(PERF_COUNT_HW_BRANCH_MISSES, "branch_misses");
+    if(m_fds.size() != 4)
+      close_all();
+#endif
+  }
+
+  ~HardwareCounters()
+  {
+#ifdef CF3_HAVE_PERF_EVENT_H
+    close_all();
+#endif
+  }
+
+  const std::vector<std::string>& names() const { return m_names; }
+
+  void start()
+  {
+#ifdef CF3_HAVE_PERF_EVENT_H
+    for(Uint i = 0; i != m_fds.size(); ++i)
+    {
+      ioctl(m_fds[i], PERF_EVENT_IOC_RESET, 0);
+      ioctl(m_fds[i], PERF_EVENT_IOC_ENABLE, 0);
+    }
+#endif
+  }
+
+  /// Stop counting and return the counts since start()
+  std::vector<double> stop()
+  {
+    std::vector<double> result(m_names.size(), 0.);
+#ifdef CF3_HAVE_PERF_EVENT_H
+    for(Uint i = 0; i != m_fds.size(); ++i)
+    {
+      ioctl(m_fds[i], PERF_EVENT_IOC_DISABLE, 0);
+      long long count = 0;
+      if(read(m_fds[i], &count, sizeof(count)) == sizeof(count))
+        result[i] = static_cast<double>(count);
+    }
+#endif
+    return result;
+  }
+
+private:
+#ifdef CF3_HAVE_PERF_EVENT_H
+  /// Open a counter. The kernel may refuse, e.g. without PMU access or due to perf_event_paranoid.
+  void open(const unsigned long long config, const std::string& name)
+  {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof(attr);
+    attr.config = config;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    const int fd = static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+    if(fd < 0)
+      return;
+    m_fds.push_back(fd);
+    m_names.push_back(name);
+  }
+
+  void close_all()
+  {
+    for(Uint i = 0; i != m_fds.size(); ++i)
+      close(m_fds[i]);
+    m_fds.clear();
+    m_names.clear();
+  }
+
+  std::vector<int> m_fds;
+#endif
+  std::vector<std::string> m_names;
+};
+
+/// Quote a string for JSON
+std::string json_string(const std::string& str)
+{
+  std::stringstream result;
+  result << "\"";
+  for(std::string::const_iterator c = str.begin(); c != str.end(); ++c)
+  {
+    switch(*c)
+    {
+      case '"': result << "\\\""; break;
+      case '\\': result << "\\\\"; break;
+      case '\n': result << "\\n"; break;
+      case '\t': result << "\\t"; break;
+      default:
+        if(static_cast<unsigned char>(*c) < 0x20)
+          result << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(*c) << std::dec;
+        else
+          result << *c;
+    }
+  }
+  result << "\"";
+  return result.str();
+}
+
+bool comm_active()
+{
+  return PE::Comm::instance().is_active();
+}
+
+} // detail
+
+////////////////////////////////////////////////////////////////////////////////
+
+BenchmarkResult::BenchmarkResult() :
+  completed(false),
+  time_min(0.),
+  time_mean(0.),
+  time_max(0.)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+Benchmark::Benchmark(const std::string& name, int argc, char** argv) :
+  m_name(name),
+  m_size(4),
+  m_repeat(3),
+  m_output(name + ".json")
+{
+  for(int i = 1; i < argc; ++i)
+  {
+    const std::string arg(argv[i]);
+    if(i+1 == argc)
+      break;
+    if(arg == "--size")
+      m_size = boost::lexical_cast<Uint>(argv[++i]);
+    else if(arg == "--repeat")
+      m_repeat = boost::lexical_cast<Uint>(argv[++i]);
+    else if(arg == "--output")
+      m_output = argv[++i];
+  }
+
+  if(m_repeat == 0)
+    throw BadValue(FromHere(), "Benchmark " + m_name + ": the number of repetitions must be at least 1");
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void Benchmark::add_parameter(const std::string& name, const std::string& value)
+{
+  m_parameters.push_back(std::make_pair(name, value));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool Benchmark::measure(const std::string& name, const FunctionT& run, const FunctionT& setup)
+{
+  const bool parallel = detail::comm_active();
+  detail::HardwareCounters counters;
+
+  BenchmarkResult result;
+  result.name = name;
+  result.counter_names = counters.names();
+
+  double best_time = std::numeric_limits<double>::max();
+  std::vector<double> best_counters(counters.names().size(), 0.);
+  int failed = 0;
+
+  for(Uint rep = 0; rep != m_repeat; ++rep)
+  {
+    try
+    {
+      if(!setup.empty())
+        setup();
+
+      if(parallel)
+        PE::Comm::instance().barrier();
+
+      Timer timer;
+      counters.start();
+      run();
+      const std::vector<double> counts = counters.stop();
+      const double elapsed = timer.elapsed();
+
+      if(elapsed < best_time)
+      {
+        best_time = elapsed;
+        best_counters = counts;
+      }
+    }
+    catch(Exception& e)
+    {
+      failed = 1;
+      result.message = e.what();
+    }
+
+    // A phase that fails on one rank is reported as failed on all ranks
+    if(parallel)
+    {
+      int failed_anywhere = 0;
+      PE::Comm::instance().all_reduce(PE::max(), &failed, 1, &failed_anywhere);
+      failed = failed_anywhere;
+    }
+    if(failed)
+      break;
+  }
+
+  result.completed = !failed;
+  if(failed)
+  {
+    if(result.message.empty())
+      result.message = "failed on another rank";
+    CFerror << "Benchmark " << m_name << ": phase " << name << " failed: " << result.message << CFendl;
+    result.counter_names.clear();
+    m_results.push_back(result);
+    return false;
+  }
+
+  result.time_min = best_time;
+  result.time_mean = best_time;
+  result.time_max = best_time;
+  result.counter_values = best_counters;
+  if(parallel)
+  {
+    PE::Comm& comm = PE::Comm::instance();
+    comm.all_reduce(PE::min(), &best_time, 1, &result.time_min);
+    comm.all_reduce(PE::max(), &best_time, 1, &result.time_max);
+    comm.all_reduce(PE::plus(), &best_time, 1, &result.time_mean);
+    result.time_mean /= static_cast<double>(comm.size());
+
+    // Only report counters if they could be opened on all ranks
+    int nb_counters = static_cast<int>(best_counters.size());
+    int min_nb_counters = 0;
+    comm.all_reduce(PE::min(), &nb_counters, 1, &min_nb_counters);
+    result.counter_names.resize(min_nb_counters);
+    best_counters.resize(min_nb_counters);
+    result.counter_values.resize(min_nb_counters);
+    if(min_nb_counters != 0)
+      comm.all_reduce(PE::plus(), &best_counters[0], min_nb_counters, &result.counter_values[0]);
+  }
+
+  CFinfo << "Benchmark " << m_name << ": " << name << " took " << result.time_max << " s" << CFendl;
+
+  m_results.push_back(result);
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void Benchmark::skip(const std::string& name, const std::string& reason)
+{
+  BenchmarkResult result;
+  result.name = name;
+  result.message = reason;
+  m_results.push_back(result);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void Benchmark::write_json(std::ostream& out) const
+{
+  const BuildInfo& build_info = Core::instance().build_info();
+  const Uint nb_procs = detail::comm_active() ? PE::Comm::instance().size() : 1u;
+
+  out << std::setprecision(std::numeric_limits<double>::digits10);
+  out << "{\n";
+  out << "  \"benchmark\": " << detail::json_string(m_name) << ",\n";
+  out << "  \"metadata\": {\n";
+  out << "    \"release\": " << detail::json_string(build_info.release_version()) << ",\n";
+  out << "    \"commit\": " << detail::json_string(build_info.git_commit_sha()) << ",\n";
+  out << "    \"build_type\": " << detail::json_string(build_info.build_type()) << ",\n";
+  out << "    \"processor\": " << detail::json_string(build_info.build_processor()) << ",\n";
+  out << "    \"os\": " << detail::json_string(build_info.os_long_name()) << ",\n";
+  out << "    \"nb_procs\": " << nb_procs << ",\n";
+  out << "    \"size\": " << m_size << ",\n";
+  out << "    \"repeat\": " << m_repeat;
+  for(Uint i = 0; i != m_parameters.size(); ++i)
+    out << ",\n    " << detail::json_string(m_parameters[i].first) << ": " << detail::json_string(m_parameters[i].second);
+  out << "\n  },\n";
+  out << "  \"phases\": [";
+  for(Uint i = 0; i != m_results.size(); ++i)
+  {
+    const BenchmarkResult& result = m_results[i];
+    out << (i == 0 ? "\n" : ",\n");
+    out << "    {\n";
+    out << "      \"name\": " << detail::json_string(result.name) << ",\n";
+    out << "      \"completed\": " << (result.completed ? "true" : "false");
+    if(!result.completed)
+    {
+      out << ",\n      \"message\": " << detail::json_string(result.message) << "\n    }";
+      continue;
+    }
+    out << ",\n";
+    out << "      \"time_min\": " << result.time_min << ",\n";
+    out << "      \"time_mean\": " << result.time_mean << ",\n";
+    out << "      \"time_max\": " << result.time_max << ",\n";
+    out << "      \"counters\": {";
+    for(Uint j = 0; j != result.counter_names.size(); ++j)
+      out << (j == 0 ? " " : ", ") << detail::json_string(result.counter_names[j]) << ": " << result.counter_values[j];
+    out << (result.counter_names.empty() ? "}\n" : " }\n");
+    out << "    }";
+  }
+  out << "\n  ]\n";
+  out << "}\n";
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void Benchmark::write() const
+{
+  if(detail::comm_active() && PE::Comm::instance().rank() != 0)
+    return;
+
+  std::ofstream file(m_output.c_str());
+  if(!file)
+    throw FileSystemError(FromHere(), "Benchmark " + m_name + ": could not open " + m_output + " for writing");
+  write_json(file);
+  CFinfo << "Benchmark " << m_name << ": results written to " << m_output << CFendl;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // Testing
+} // Tools
+} // cf3
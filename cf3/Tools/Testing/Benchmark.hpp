@@ -0,0 +1,113 @@
+// Copyright (C) 2010-2013 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef cf3_Tools_Testing_Benchmark_hpp
+#define cf3_Tools_Testing_Benchmark_hpp
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+#include <boost/function.hpp>
+#include <boost/noncopyable.hpp>
+
+#include "Tools/Testing/LibTesting.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace Tools {
+namespace Testing {
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Timings and hardware counters of one benchmark phase, reduced over all ranks
+struct Testing_API BenchmarkResult
+{
+  BenchmarkResult();
+
+  std::string name;
+  /// False if the phase threw, in which case message holds the reason
+  bool completed;
+  std::string message;
+  /// Wall clock time of the fastest repetition, in seconds. Min, mean and max are taken over the ranks.
+  double time_min;
+  double time_mean;
+  double time_max;
+  /// Hardware counters of the fastest repetition, summed over the ranks. Empty if the counters are not available.
+  std::vector<std::string> counter_names;
+  std::vector<double> counter_values;
+};
+
+/// Harness for the executables in the benchmarks directory.
+/// Each benchmark is a sequence of named phases. A phase runs a number of times after an optional setup
+/// that is not timed, and the fastest repetition is kept. All ranks run all phases, so phases may be collective.
+/// Hardware counters (cycles, instructions, cache and branch misses) are read through perf_event_open when
+/// the system provides it. The results are written as JSON by rank 0.
+///
+/// Command line arguments, all optional:
+///   - --size N: problem size, interpretation is up to the benchmark (typically the number of cells per direction)
+///   - --repeat N: number of repetitions of each phase (default 3)
+///   - --output file: JSON output file (default: the benchmark name followed by .json)
+class Testing_API Benchmark : public boost::noncopyable
+{
+public:
+  typedef boost::function<void()> FunctionT;
+
+  /// Parses the command line. Core and PE::Comm must be initialized by the caller.
+  Benchmark(const std::string& name, int argc, char** argv);
+
+  /// Problem size given on the command line
+  Uint size() const { return m_size; }
+
+  /// Number of repetitions of each phase
+  Uint repeat() const { return m_repeat; }
+
+  /// Set the problem size, used when the benchmark derives it from something else than --size
+  void set_size(const Uint size) { m_size = size; }
+
+  /// Add a free-form parameter, written to the metadata of the output
+  void add_parameter(const std::string& name, const std::string& value);
+
+  /// Run and time a phase. Collective.
+  /// @param name Name of the phase, as it appears in the output
+  /// @param run Function that is timed
+  /// @param setup Function called before each repetition, not timed
+  /// @return true if the phase completed on all ranks
+  bool measure(const std::string& name, const FunctionT& run, const FunctionT& setup = FunctionT());
+
+  /// Record a phase that could not be run in this build, e.g. because a plugin is missing
+  void skip(const std::string& name, const std::string& reason);
+
+  /// Results of the phases that were measured up to now
+  const std::vector<BenchmarkResult>& results() const { return m_results; }
+
+  /// Write the results as JSON
+  void write_json(std::ostream& out) const;
+
+  /// Write the results to the output file given on the command line. Only rank 0 writes.
+  void write() const;
+
+private:
+  const std::string m_name;
+  Uint m_size;
+  Uint m_repeat;
+  std::string m_output;
+  std::vector< std::pair<std::string, std::string> > m_parameters;
+  std::vector<BenchmarkResult> m_results;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // Testing
+} // Tools
+} // cf3
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // cf3_Tools_Testing_Benchmark_hpp
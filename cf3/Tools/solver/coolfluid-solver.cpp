@@ -78,7 +78,10 @@ int main(int argc, char ** argv)
 
   // initiate the CF core and MPI environment
   Core::instance().initiate(argc, argv);
-  Comm::instance().init(argc, argv);
+  // signals from the parent are received in a separate thread, which waits in MPI while
+  // the solver works. That needs MPI_THREAD_MULTIPLE, so it is only requested for workers
+  // spawned by a manager: without a parent, the solver exits right away.
+  Comm::instance().init(argc, argv, Manager::is_spawned_worker(argc, argv) ? MPI_THREAD_MULTIPLE : MPI_THREAD_SINGLE);
 
   parent_comm = Comm::instance().get_parent();
   rank = Comm::instance().rank();
@@ -24,7 +24,7 @@ class ArrayBase {
 
 public: // typedefs
   typedef ValueT value_type;
-  typedef boost::multi_array<ValueT,2> ArrayT;
+  typedef boost::multi_array<ValueT,2,HugePagesAllocator<ValueT> > ArrayT;
   typedef typename boost::subarray_gen<ArrayT,1>::type Row;
   typedef const typename boost::const_subarray_gen<ArrayT,1>::type ConstRow;
   typedef ArrayBufferT<ValueT> Buffer;
@@ -14,6 +14,7 @@
 #include <boost/foreach.hpp>
 
 #include "common/BoostArray.hpp"
+#include "common/HugePages.hpp"
 #include "common/BasicExceptions.hpp"
 #include "common/StringConversion.hpp"
 
@@ -46,7 +47,7 @@ class ArrayBufferT
 
 public: // typedef
 
-  typedef boost::multi_array<T,2> Array_t;
+  typedef boost::multi_array<T,2,HugePagesAllocator<T> > Array_t;
   typedef T value_type;
 
   typedef boost::detail::multi_array::sub_array<T,1> SubArray_t;
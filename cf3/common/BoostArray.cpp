@@ -6,6 +6,7 @@
 
 #include "common/BoostArray.hpp"
 #include "common/StringConversion.hpp"
+#include "common/Table_fwd.hpp"
 
 using namespace boost;
 using namespace boost::detail::multi_array;
@@ -14,7 +15,7 @@ namespace cf3 {
 namespace common {
 
 template <>
-Common_API std::string to_str< multi_array<Uint,2> > (const multi_array<Uint,2> & v)
+Common_API std::string to_str< TableArray<Uint>::type > (const TableArray<Uint>::type & v)
 {
   std::string s = "";
   if (v.num_elements()) {
@@ -29,7 +30,7 @@ Common_API std::string to_str< multi_array<Uint,2> > (const multi_array<Uint,2>
 }
 
 template <>
-Common_API std::string to_str< multi_array<Real,2> > (const multi_array<Real,2> & v)
+Common_API std::string to_str< TableArray<Real>::type > (const TableArray<Real>::type & v)
 {
   std::string s = "";
   if (v.num_elements()) {
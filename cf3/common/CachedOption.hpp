@@ -0,0 +1,121 @@
+// Copyright (C) 2010-2013 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef cf3_common_CachedOption_hpp
+#define cf3_common_CachedOption_hpp
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <boost/bind.hpp>
+#include <boost/function.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/weak_ptr.hpp>
+
+#include "common/OptionList.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace common {
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Typed copy of the value of an option, kept up to date by a trigger on the option.
+/// The option is looked up and its type is checked once, in attach(). Reading the value afterwards
+/// is a plain member access, without the map lookup and boost::any_cast of OptionList::value, so this is
+/// meant for values that are read in execute() or other functions that are called every iteration.
+/// Works for any option type, including handles to components (T = Handle<SomeComponent>) and arrays
+/// (T = std::vector<...>). The value type must match the type stored in the option exactly.
+/// As for variables set through Option::link_to, Option::restore_default does not update the cached value.
+///
+/// Typical use, for an option added in the constructor of a component:
+/// @code
+/// options().add("saverate", 1u);
+/// m_saverate.attach(options(), "saverate");
+/// ...
+/// if(iter % m_saverate.value() == 0)
+/// @endcode
+template<typename T>
+class CachedOption : boost::noncopyable
+{
+public:
+  CachedOption() : m_value(), m_trigger_id(0)
+  {
+  }
+
+  /// Construct and attach to the option with the given name
+  CachedOption(OptionList& options, const std::string& name) : m_value(), m_trigger_id(0)
+  {
+    attach(options, name);
+  }
+
+  ~CachedOption()
+  {
+    detach();
+  }
+
+  /// Attach to the option with the given name, detaching from any previously attached option
+  /// @throw ValueNotFound if the option does not exist
+  /// @throw CastingFailed if the option does not hold a value of type T
+  CachedOption& attach(OptionList& options, const std::string& name)
+  {
+    detach();
+    const boost::shared_ptr<Option>& option = options.option_ptr(name);
+    m_value = option->template value<T>(); // checks the type
+    m_option = option;
+    m_trigger_id = option->attach_trigger_tracked(boost::bind(&CachedOption::update, this));
+    return *this;
+  }
+
+  /// Stop following the option. The last value is kept.
+  void detach()
+  {
+    boost::shared_ptr<Option> option = m_option.lock();
+    if(is_not_null(option))
+      option->detach_trigger(m_trigger_id);
+    m_option.reset();
+  }
+
+  /// True if attached to an option that still exists
+  bool is_attached() const
+  {
+    return !m_option.expired();
+  }
+
+  /// The current value of the option
+  const T& value() const
+  {
+    return m_value;
+  }
+
+  /// Shorthand for value()
+  const T& operator()() const
+  {
+    return m_value;
+  }
+
+private:
+  /// Trigger, called after each change of the option value
+  void update()
+  {
+    boost::shared_ptr<Option> option = m_option.lock();
+    cf3_assert(is_not_null(option));
+    m_value = option->template value<T>();
+  }
+
+  T m_value;
+  boost::weak_ptr<Option> m_option;
+  Option::TriggerID m_trigger_id;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // common
+} // cf3
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // cf3_common_CachedOption_hpp
@@ -32,6 +32,7 @@
 #include "common/PropertyList.hpp"
 #include "common/ComponentIterator.hpp"
 #include "common/TimedComponent.hpp"
+#include "common/TreeChangeLog.hpp"
 #include "common/UUCount.hpp"
 
 
@@ -64,6 +65,10 @@ Component::Component ( const std::string& name ) :
     throw InvalidURI(FromHere(), "Component name ["+name+"] is invalid");
   m_name = name;
 
+  // configuration changes, through signals or directly, are recorded once a remote client follows the changes
+  if(TreeChangeLog::instance().is_enabled())
+    attach_tree_change_recorder();
+
   // signals
 
   regist_signal( "create_component" )
@@ -79,6 +84,13 @@ Component::Component ( const std::string& name ) :
       .description("list the tree of subcomponents")
       .pretty_name("List tree");
 
+  regist_signal( "list_tree_diff" )
+      .connect( boost::bind( &Component::signal_list_tree_diff, this, _1 ) )
+      .hidden(true)
+      .read_only(true)
+      .description("list the changes in the tree of subcomponents since a given revision")
+      .pretty_name("List tree changes");
+
   regist_signal( "list_tree_recursive" )
       .connect( boost::bind( &Component::signal_list_tree_recursive, this, _1 ) )
       .hidden(true)
@@ -221,6 +233,8 @@ void Component::rename ( const std::string& name )
 
   // notification should be done before the real renaming since the path changes
   raise_tree_updated_event();
+  const bool record_change = TreeChangeLog::instance().is_enabled() && in_core_tree();
+  const std::string old_path = record_change ? uri().path() : std::string();
 
   if(is_not_null(m_parent))
   {
@@ -235,6 +249,12 @@ void Component::rename ( const std::string& name )
   }
 
   m_name = name;
+
+  if(record_change)
+  {
+    TreeChangeLog::instance().record(TreeChangeLog::REMOVED, old_path);
+    TreeChangeLog::instance().record(TreeChangeLog::ADDED, uri().path());
+  }
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////
@@ -302,6 +322,11 @@ Component& Component::add_component ( const boost::shared_ptr<Component>& subcom
   subcomp->m_parent = this;
 
   raise_tree_updated_event();
+  // Children added in the constructor of a component that is not attached yet are sent with it as a whole
+  subcomp->record_tree_change(TreeChangeLog::ADDED);
+  // The subtree may have been created before the change log was enabled
+  if(TreeChangeLog::instance().is_enabled())
+    subcomp->attach_tree_change_recorder();
 
   return *subcomp;
 }
@@ -362,6 +387,8 @@ boost::shared_ptr<Component> Component::remove_component ( const std::string& na
 
     m_component_lookup.erase(itr);               // remove it from the lookup
 
+    comp->record_tree_change(TreeChangeLog::REMOVED);
+
     comp->change_parent( Handle<Component>() );                   // set parent to invalid
 
     // Create new storage to eliminate the removed component
@@ -765,6 +792,104 @@ void Component::signal_list_tree( SignalArgs& args ) const
 
 ////////////////////////////////////////////////////////////////////////////////////////////
 
+bool Component::in_core_tree() const
+{
+  const Component* top = this;
+  while(top->m_parent != 0)
+    top = top->m_parent;
+  return top == &Core::instance().root();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void Component::record_tree_change( const Uint change_type ) const
+{
+  TreeChangeLog& change_log = TreeChangeLog::instance();
+  if(change_log.is_enabled() && in_core_tree())
+    change_log.record(static_cast<TreeChangeLog::ChangeType>(change_type), uri().path());
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void Component::attach_tree_change_recorder()
+{
+  if(!m_options->has_trigger_on_all())
+    m_options->attach_trigger_to_all( boost::bind( &Component::record_tree_change, this, static_cast<Uint>(TreeChangeLog::MODIFIED) ) );
+
+  boost_foreach(const boost::shared_ptr<Component>& child, m_components)
+    child->attach_tree_change_recorder();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void Component::signal_list_tree_diff( SignalArgs& args ) const
+{
+  SignalOptions options( args );
+  const Uint revision = options.check("revision") ? options.value<Uint>("revision") : 0u;
+  const std::string log_id = options.check("log_id") ? options.value<std::string>("log_id") : std::string();
+
+  // A client follows the changes from now on. It gets the complete tree the first time, since nothing was recorded before.
+  TreeChangeLog& change_log = TreeChangeLog::instance();
+  change_log.enable();
+  TreeChangeLog::ChangesT changes;
+  const bool incremental = revision != 0 && log_id == change_log.id().string() && change_log.changes_since(revision, changes);
+
+  SignalFrame reply = args.create_reply( uri() );
+  SignalOptions reply_options( reply );
+  XmlNode tree_node = reply.map("tree").main_map.content;
+
+  reply_options.add("revision", change_log.revision());
+  reply_options.add("log_id", change_log.id().string());
+  reply_options.add("full", !incremental);
+
+  if(!incremental)
+  {
+    write_xml_tree(tree_node, false);
+    return;
+  }
+
+  // Only changes to this component and its children are reported
+  const std::string this_path = uri().path();
+  const std::string prefix = this_path == "/" ? this_path : this_path + "/";
+
+  std::vector<std::string> removed;
+  std::vector<std::string> modified;
+  for(TreeChangeLog::ChangesT::const_iterator it = changes.begin(); it != changes.end(); ++it)
+  {
+    const std::string& path = it->first;
+    if(path != this_path && path.compare(0, prefix.size(), prefix) != 0)
+      continue;
+
+    if(it->second == TreeChangeLog::REMOVED)
+    {
+      removed.push_back(path);
+      continue;
+    }
+
+    Handle<Component> comp = access_component(URI(path, URI::Scheme::CPATH));
+    if(is_null(comp))
+    {
+      removed.push_back(path);
+    }
+    else if(it->second == TreeChangeLog::MODIFIED || is_null(comp->m_parent))
+    {
+      modified.push_back(path);
+    }
+    else
+    {
+      // Added components are sent with their complete subtree
+      XmlNode added_node = tree_node.add_node("added");
+      added_node.set_attribute("parent", comp->m_parent->uri().path());
+      comp->write_xml_tree(added_node, false);
+    }
+  }
+
+  reply_options.add("removed", removed);
+  reply_options.add("modified", modified);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
 void Component::signal_list_tree_recursive( SignalArgs& args) const
 {
   CFinfo << uri().path() << " [" << derived_type_name() << "]" << CFendl;
@@ -1071,6 +1196,7 @@ Component& Component::mark_basic()
 {
   add_tag("basic");
   raise_tree_updated_event();
+  record_tree_change(TreeChangeLog::MODIFIED);
   return *this;
 }
 
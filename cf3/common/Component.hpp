@@ -314,6 +314,10 @@ public: // functions
   /// lists the sub components and puts them on the xml_tree
   void signal_list_tree( SignalArgs& args ) const;
 
+  /// lists the changes in the tree since the revision given in the "revision" option, or the complete tree
+  /// if that revision is no longer available
+  void signal_list_tree_diff( SignalArgs& args ) const;
+
   ///  prints tree recursively
   void signal_list_tree_recursive ( SignalArgs& args) const;
 
@@ -416,6 +420,19 @@ private: // helper functions
   /// Triggered when the "ping" event is raised. Useful to find out what components still exist
   void on_ping_event( SignalArgs& args );
 
+  /// True if this component is part of the tree under the root of the Core, i.e. the tree a remote client sees
+  bool in_core_tree() const;
+
+  /// Record a change to this component in the TreeChangeLog, if a client follows the changes and the component is in the Core tree
+  /// @param change_type One of the TreeChangeLog::ChangeType values
+  void record_tree_change( const Uint change_type ) const;
+
+public:
+
+  /// Record the option changes of this component and its children in the TreeChangeLog. Called for the whole Core tree
+  /// when the change log is enabled, and for components created or attached afterwards. Attaching twice has no effect.
+  void attach_tree_change_recorder();
+
 private: // data
 
   /// component name (stored as path to ensure validity)
@@ -0,0 +1,402 @@
+// Copyright (C) 2010-2013 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <map>
+
+#include <boost/algorithm/string/split.hpp>
+#include <boost/algorithm/string/classification.hpp>
+#include <boost/cstdint.hpp>
+
+#include "common/BasicExceptions.hpp"
+#include "common/Component.hpp"
+#include "common/ConfigurationBatch.hpp"
+#include "common/Foreach.hpp"
+#include "common/OptionList.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace common {
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace detail {
+
+/// Magic number at the start of a binary batch
+const char batch_magic[4] = { '\0', 'C', 'F', 'B' };
+
+/// Type of a value in the binary form. Vectors have the array flag set.
+enum BatchValueType { BATCH_BOOL=0, BATCH_INT=1, BATCH_UINT=2, BATCH_REAL=3, BATCH_STRING=4, BATCH_URI=5, BATCH_ARRAY=0x80 };
+
+/// Writes a binary batch. Strings are written once and referenced by index afterwards.
+class BatchWriter
+{
+public:
+  BatchWriter(std::string& buffer) : m_buffer(buffer) {}
+
+  void write_uint(boost::uint64_t value)
+  {
+    while(value >= 0x80)
+    {
+      m_buffer.push_back(static_cast<char>((value & 0x7F) | 0x80));
+      value >>= 7;
+    }
+    m_buffer.push_back(static_cast<char>(value));
+  }
+
+  void write_int(const int value)
+  {
+    // zigzag encoding, so small negative numbers stay small
+    const boost::int64_t v = value;
+    write_uint(static_cast<boost::uint64_t>((v << 1) ^ (v >> 63)));
+  }
+
+  void write_real(const Real value)
+  {
+    char bytes[sizeof(Real)];
+    std::memcpy(bytes, &value, sizeof(Real));
+    m_buffer.append(bytes, sizeof(Real));
+  }
+
+  void write_string(const std::string& str)
+  {
+    std::map<std::string, Uint>::const_iterator it = m_strings.find(str);
+    if(it != m_strings.end())
+    {
+      write_uint(it->second + 1);
+      return;
+    }
+    // 0 announces a new string, numbered in order of appearance
+    write_uint(0);
+    write_uint(str.size());
+    m_buffer.append(str);
+    const Uint idx = m_strings.size();
+    m_strings[str] = idx;
+  }
+
+  template<typename T>
+  bool write_array(const boost::any& value, const BatchValueType type)
+  {
+    const std::vector<T>* values = boost::any_cast< std::vector<T> >(&value);
+    if(is_null(values))
+      return false;
+    m_buffer.push_back(static_cast<char>(type | BATCH_ARRAY));
+    write_uint(values->size());
+    boost_foreach(const T& v, *values)
+      write(v);
+    return true;
+  }
+
+  template<typename T>
+  bool write_single(const boost::any& value, const BatchValueType type)
+  {
+    const T* v = boost::any_cast<T>(&value);
+    if(is_null(v))
+      return false;
+    m_buffer.push_back(static_cast<char>(type));
+    write(*v);
+    return true;
+  }
+
+  void write_value(const boost::any& value)
+  {
+    if(write_single<bool>(value, BATCH_BOOL) || write_single<int>(value, BATCH_INT) || write_single<Uint>(value, BATCH_UINT)
+       || write_single<Real>(value, BATCH_REAL) || write_single<std::string>(value, BATCH_STRING) || write_single<URI>(value, BATCH_URI)
+       || write_array<bool>(value, BATCH_BOOL) || write_array<int>(value, BATCH_INT) || write_array<Uint>(value, BATCH_UINT)
+       || write_array<Real>(value, BATCH_REAL) || write_array<std::string>(value, BATCH_STRING) || write_array<URI>(value, BATCH_URI))
+      return;
+    throw NotSupported(FromHere(), std::string("Values of type ") + value.type().name() + " can not be stored in a binary configuration batch");
+  }
+
+private:
+  void write(const bool v) { m_buffer.push_back(v ? 1 : 0); }
+  void write(const int v) { write_int(v); }
+  void write(const Uint v) { write_uint(v); }
+  void write(const Real v) { write_real(v); }
+  void write(const std::string& v) { write_string(v); }
+  void write(const URI& v) { write_string(v.string()); }
+
+  std::string& m_buffer;
+  std::map<std::string, Uint> m_strings;
+};
+
+/// Reads a binary batch
+class BatchReader
+{
+public:
+  BatchReader(const char* data, const std::size_t length) : m_data(data), m_end(data + length) {}
+
+  char read_byte()
+  {
+    if(m_data == m_end)
+      throw ParsingFailed(FromHere(), "Truncated binary configuration batch");
+    return *m_data++;
+  }
+
+  boost::uint64_t read_uint()
+  {
+    boost::uint64_t result = 0;
+    for(Uint shift = 0; shift < 64; shift += 7)
+    {
+      const unsigned char byte = static_cast<unsigned char>(read_byte());
+      result |= static_cast<boost::uint64_t>(byte & 0x7F) << shift;
+      if(!(byte & 0x80))
+        return result;
+    }
+    throw ParsingFailed(FromHere(), "Bad integer in binary configuration batch");
+  }
+
+  int read_int()
+  {
+    const boost::uint64_t v = read_uint();
+    return static_cast<int>(static_cast<boost::int64_t>(v >> 1) ^ -static_cast<boost::int64_t>(v & 1));
+  }
+
+  Real read_real()
+  {
+    if(m_end - m_data < static_cast<std::ptrdiff_t>(sizeof(Real)))
+      throw ParsingFailed(FromHere(), "Truncated binary configuration batch");
+    Real result;
+    std::memcpy(&result, m_data, sizeof(Real));
+    m_data += sizeof(Real);
+    return result;
+  }
+
+  const std::string& read_string()
+  {
+    const boost::uint64_t ref = read_uint();
+    if(ref != 0)
+    {
+      if(ref > m_strings.size())
+        throw ParsingFailed(FromHere(), "Bad string reference in binary configuration batch");
+      return m_strings[ref-1];
+    }
+    const boost::uint64_t size = read_uint();
+    if(static_cast<boost::uint64_t>(m_end - m_data) < size)
+      throw ParsingFailed(FromHere(), "Truncated binary configuration batch");
+    m_strings.push_back(std::string(m_data, size));
+    m_data += size;
+    return m_strings.back();
+  }
+
+  boost::any read_value()
+  {
+    const unsigned char type = static_cast<unsigned char>(read_byte());
+    if(type & BATCH_ARRAY)
+    {
+      const Uint size = static_cast<Uint>(read_uint());
+      switch(type & ~BATCH_ARRAY)
+      {
+        case BATCH_BOOL:   return read_array<bool>(size);
+        case BATCH_INT:    return read_array<int>(size);
+        case BATCH_UINT:   return read_array<Uint>(size);
+        case BATCH_REAL:   return read_array<Real>(size);
+        case BATCH_STRING: return read_array<std::string>(size);
+        case BATCH_URI:    return read_array<URI>(size);
+      }
+    }
+    else
+    {
+      switch(type)
+      {
+        case BATCH_BOOL:   return read_single<bool>();
+        case BATCH_INT:    return read_single<int>();
+        case BATCH_UINT:   return read_single<Uint>();
+        case BATCH_REAL:   return read_single<Real>();
+        case BATCH_STRING: return read_single<std::string>();
+        case BATCH_URI:    return read_single<URI>();
+      }
+    }
+    throw ParsingFailed(FromHere(), "Bad value type in binary configuration batch");
+  }
+
+private:
+  void read(bool& v) { v = read_byte() != 0; }
+  void read(int& v) { v = read_int(); }
+  void read(Uint& v) { v = static_cast<Uint>(read_uint()); }
+  void read(Real& v) { v = read_real(); }
+  void read(std::string& v) { v = read_string(); }
+  void read(URI& v) { v = URI(read_string()); }
+
+  template<typename T>
+  boost::any read_single()
+  {
+    T result;
+    read(result);
+    return result;
+  }
+
+  template<typename T>
+  boost::any read_array(const Uint size)
+  {
+    std::vector<T> result;
+    result.reserve(std::min(size, static_cast<Uint>(m_end - m_data)));
+    for(Uint i = 0; i != size; ++i)
+    {
+      T v;
+      read(v);
+      result.push_back(v);
+    }
+    return result;
+  }
+
+  const char* m_data;
+  const char* const m_end;
+  /// Strings in order of appearance. A deque, so references stay valid when adding strings.
+  std::deque<std::string> m_strings;
+};
+
+/// Resolves component paths, remembering each component on the way so common parents are only looked up once
+class ComponentResolver
+{
+public:
+  ComponentResolver(Component& base) : m_base(base), m_root(*base.root()) {}
+
+  Component& resolve(const URI& uri)
+  {
+    // Build the absolute list of names
+    std::vector<std::string> names;
+    if(uri.is_relative())
+      split(m_base.uri().path(), names);
+    split(uri.path(), names);
+
+    // Find the deepest parent that is still known
+    std::string path;
+    std::vector<std::string> prefixes;
+    prefixes.reserve(names.size()+1);
+    prefixes.push_back(path);
+    boost_foreach(const std::string& name, names)
+    {
+      path += "/" + name;
+      prefixes.push_back(path);
+    }
+
+    Uint depth = names.size();
+    Handle<Component> component;
+    for(; depth != 0; --depth)
+    {
+      std::map<std::string, Handle<Component> >::const_iterator it = m_cache.find(prefixes[depth]);
+      if(it != m_cache.end() && is_not_null(it->second))
+      {
+        component = it->second;
+        break;
+      }
+    }
+    if(depth == 0)
+      component = m_root.handle();
+
+    // Walk down from there
+    for(; depth != names.size(); ++depth)
+    {
+      Handle<Component> child = component->get_child(names[depth]);
+      if(is_null(child))
+        throw ValueNotFound(FromHere(), "Component " + prefixes[depth+1] + " does not exist");
+      m_cache[prefixes[depth+1]] = child;
+      component = child;
+    }
+
+    return *component;
+  }
+
+private:
+  /// Append the names in the path to the list, interpreting . and ..
+  static void split(const std::string& path, std::vector<std::string>& names)
+  {
+    std::vector<std::string> parts;
+    boost::algorithm::split(parts, path, boost::algorithm::is_any_of("/"));
+    boost_foreach(const std::string& part, parts)
+    {
+      if(part.empty() || part == ".")
+        continue;
+      if(part == "..")
+      {
+        if(!names.empty())
+          names.pop_back();
+        continue;
+      }
+      names.push_back(part);
+    }
+  }
+
+  Component& m_base;
+  Component& m_root;
+  std::map<std::string, Handle<Component> > m_cache;
+};
+
+} // detail
+
+////////////////////////////////////////////////////////////////////////////////
+
+void ConfigurationBatch::add(const URI& component, const std::string& option, const boost::any& value)
+{
+  m_entries.push_back(Entry());
+  Entry& entry = m_entries.back();
+  entry.component = component;
+  entry.option = option;
+  entry.value = value;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void ConfigurationBatch::apply(Component& base, std::vector<std::string>* errors) const
+{
+  detail::ComponentResolver resolver(base);
+
+  boost_foreach(const Entry& entry, m_entries)
+  {
+    try
+    {
+      Component& component = resolver.resolve(entry.component);
+      component.options().set(entry.option, entry.value);
+    }
+    catch(Exception& e)
+    {
+      if(is_null(errors))
+        throw;
+      errors->push_back(e.what());
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void ConfigurationBatch::to_binary(std::string& buffer) const
+{
+  buffer.append(detail::batch_magic, sizeof(detail::batch_magic));
+  detail::BatchWriter writer(buffer);
+  writer.write_uint(m_entries.size());
+  boost_foreach(const Entry& entry, m_entries)
+  {
+    writer.write_string(entry.component.string());
+    writer.write_string(entry.option);
+    writer.write_value(entry.value);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void ConfigurationBatch::from_binary(const char* data, const std::size_t length)
+{
+  if(length < sizeof(detail::batch_magic) || std::memcmp(data, detail::batch_magic, sizeof(detail::batch_magic)) != 0)
+    throw ParsingFailed(FromHere(), "Buffer does not contain a binary configuration batch");
+
+  detail::BatchReader reader(data + sizeof(detail::batch_magic), length - sizeof(detail::batch_magic));
+  const boost::uint64_t nb_entries = reader.read_uint();
+  for(boost::uint64_t i = 0; i != nb_entries; ++i)
+  {
+    const URI component(reader.read_string());
+    const std::string option = reader.read_string();
+    add(component, option, reader.read_value());
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // common
+} // cf3
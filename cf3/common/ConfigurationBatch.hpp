@@ -0,0 +1,82 @@
+// Copyright (C) 2010-2013 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef cf3_common_ConfigurationBatch_hpp
+#define cf3_common_ConfigurationBatch_hpp
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <vector>
+
+#include <boost/any.hpp>
+
+#include "common/CommonAPI.hpp"
+#include "common/URI.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace common {
+
+class Component;
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// List of option values to set on many components at once, without going through signals and XML.
+/// The values are applied in the order they were added, so an option that creates components through its trigger
+/// can be followed by options of the created components. Each component path is resolved only once, starting from the
+/// deepest parent that was already resolved.
+/// The batch can be stored in a compact binary form, for values of type bool, int, Uint, Real, std::string and URI
+/// and vectors of these.
+class Common_API ConfigurationBatch
+{
+public:
+
+  /// Add a value to set
+  /// @param component Path of the component, either absolute or relative to the component the batch is applied to
+  /// @param option Name of the option
+  /// @param value New value, of the type of the option
+  void add(const URI& component, const std::string& option, const boost::any& value);
+
+  /// Number of values in the batch
+  Uint size() const { return m_entries.size(); }
+
+  void clear() { m_entries.clear(); }
+
+  /// Set all values, triggering the option actions
+  /// @param base Component that relative paths start from
+  /// @param errors If not null, errors are appended to it and the remaining values are still applied.
+  ///               Otherwise the first error is thrown.
+  /// @throw ValueNotFound if a component or an option does not exist
+  void apply(Component& base, std::vector<std::string>* errors = 0) const;
+
+  /// Append the binary form of the batch to the buffer
+  /// @throw NotSupported if a value has an unsupported type
+  void to_binary(std::string& buffer) const;
+
+  /// Add the values stored in the binary form produced by to_binary
+  /// @throw ParsingFailed if the buffer is not a valid binary batch
+  void from_binary(const char* data, const std::size_t length);
+
+private:
+  struct Entry
+  {
+    URI component;
+    std::string option;
+    boost::any value;
+  };
+
+  std::vector<Entry> m_entries;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // common
+} // cf3
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // cf3_common_ConfigurationBatch_hpp
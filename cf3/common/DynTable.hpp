@@ -69,6 +69,28 @@ public:
 
   void set_row_size(const Uint i, const Uint s) { m_array[i].resize(s); }
 
+  /// Memory allocated for the rows and their values, including the unused capacity of the rows
+  /// @return the memory usage in bytes
+  Real memory_usage() const
+  {
+    Real bytes = static_cast<Real>(m_array.capacity()) * sizeof(std::vector<T>);
+    for (typename ArrayT::const_iterator row = m_array.begin(); row != m_array.end(); ++row)
+      bytes += static_cast<Real>(row->capacity()) * sizeof(T);
+    return bytes;
+  }
+
+  /// Release the unused capacity of the rows, which remains after the rows were filled through a Buffer
+  void shrink_to_fit()
+  {
+    for (typename ArrayT::iterator row = m_array.begin(); row != m_array.end(); ++row)
+    {
+      if (row->capacity() != row->size())
+        std::vector<T>(*row).swap(*row);
+    }
+    if (m_array.capacity() != m_array.size())
+      ArrayT(m_array).swap(m_array);
+  }
+
   Buffer create_buffer(const size_t buffersize=16384)
   {
     return Buffer(m_array,buffersize);
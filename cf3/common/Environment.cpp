@@ -11,6 +11,7 @@
 #include "common/LogLevel.hpp"
 #include "common/Log.hpp"
 #include "common/Environment.hpp"
+#include "common/HugePages.hpp"
 #include "common/PropertyList.hpp"
 
 namespace cf3 {
@@ -102,6 +103,12 @@ Environment::Environment ( const std::string& name) : Component ( name )
       .mark_basic()
       .attach_trigger(boost::bind(&Environment::trigger_log_level,this));
 
+  options().add("huge_pages", huge_pages_enabled())
+      .pretty_name("Huge Pages")
+      .description("If true, the storage of large tables and fields is backed by transparent huge pages, where supported. "
+                   "Applies to the tables that are allocated after setting this option.")
+      .attach_trigger(boost::bind(&Environment::trigger_huge_pages,this));
+
   trigger_log_level();
 
   // signals
@@ -180,5 +187,12 @@ void Environment::trigger_log_level()
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void Environment::trigger_huge_pages()
+{
+  enable_huge_pages(options().value<bool>("huge_pages"));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 } // common
 } // cf3
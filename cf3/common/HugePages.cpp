@@ -0,0 +1,116 @@
+// Copyright (C) 2010-2013 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#include <new>
+
+#include "common/CF.hpp"
+
+#ifdef CF3_HAVE_SYS_MMAN_H
+  #include <sys/mman.h>
+#endif
+
+#include "common/HugePages.hpp"
+
+#if defined(CF3_HAVE_SYS_MMAN_H) && defined(MAP_ANONYMOUS)
+  #define CF3_HUGE_PAGES_MAPPING
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace common {
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+  bool huge_pages_flag = false;
+
+  /// Size of a transparent huge page on x86_64 and most aarch64 configurations
+  const std::size_t huge_page_size = 2*1024*1024;
+
+  /// Mapped size of an array, rounded up to whole huge pages
+  std::size_t mapped_size(const std::size_t bytes)
+  {
+    return (bytes + huge_page_size - 1) & ~(huge_page_size - 1);
+  }
+
+  /// Arrays that are smaller than this use std::allocator, whether huge pages are enabled or not
+  bool is_mapped(const std::size_t bytes)
+  {
+#ifdef CF3_HUGE_PAGES_MAPPING
+    return bytes >= 2*huge_page_size;
+#else
+    return false;
+#endif
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void enable_huge_pages(const bool enable)
+{
+  huge_pages_flag = enable;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool huge_pages_enabled()
+{
+  return huge_pages_flag;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void* allocate_huge_pages(const std::size_t bytes)
+{
+  if (!is_mapped(bytes))
+    return nullptr;
+
+#ifdef CF3_HUGE_PAGES_MAPPING
+  // Map one extra huge page, and unmap what lies outside of the aligned range
+  const std::size_t length = mapped_size(bytes);
+  void* mapping = mmap(nullptr, length + huge_page_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (mapping == MAP_FAILED)
+    throw std::bad_alloc();
+
+  char* mapping_begin = static_cast<char*>(mapping);
+  char* begin = reinterpret_cast<char*>((reinterpret_cast<std::size_t>(mapping_begin) + huge_page_size - 1) & ~(huge_page_size - 1));
+  if (begin != mapping_begin)
+    munmap(mapping_begin, begin - mapping_begin);
+  const std::size_t tail = mapping_begin + length + huge_page_size - (begin + length);
+  if (tail != 0)
+    munmap(begin + length, tail);
+
+#ifdef MADV_HUGEPAGE
+  // Failures are not errors: the system may not support transparent huge pages, and the memory remains usable
+  if (huge_pages_flag)
+    madvise(begin, length, MADV_HUGEPAGE);
+#endif
+
+  return begin;
+#else
+  return nullptr;
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool deallocate_huge_pages(void* data, const std::size_t bytes)
+{
+  if (!is_mapped(bytes))
+    return false;
+
+#ifdef CF3_HUGE_PAGES_MAPPING
+  munmap(data, mapped_size(bytes));
+#endif
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // common
+} // cf3
@@ -0,0 +1,105 @@
+// Copyright (C) 2010-2013 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef cf3_common_HugePages_hpp
+#define cf3_common_HugePages_hpp
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cstddef>
+#include <memory>
+
+#include "common/CommonAPI.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace common {
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// @name Transparent huge pages for large arrays
+/// Large tables are accessed row by row over their full length in every assembly and synchronization loop,
+/// so backing them with 2 MB pages instead of 4 KB pages removes most TLB misses.
+/// The storage of Table and List is allocated through HugePagesAllocator. Arrays of at least two huge pages get their own
+/// mapping, aligned on a huge page, which is advised before boost::multi_array initializes it. The kernel then backs it
+/// with huge pages from the first touch on, for every table and field, whenever it is created.
+///
+/// Pages are placed on the NUMA node of the thread that first touches them. boost::multi_array initializes its storage
+/// in the thread that resizes it, so the whole array starts on the node of that thread, even when the node loops run on
+/// several threads afterwards. A misplaced huge page costs more than a misplaced small page, so on multi-socket
+/// machines the threads of a process should be bound to a single NUMA node, with one process per node.
+///
+/// This is disabled by default, and is set through the "huge_pages" option of the Environment.
+/// It has no effect on systems without mmap or transparent huge pages.
+//@{
+
+/// Enable or disable the advice for the arrays that are allocated after this call
+Common_API void enable_huge_pages(const bool enable);
+
+/// True if huge pages are advised for large arrays
+Common_API bool huge_pages_enabled();
+
+/// Map fresh storage aligned on a huge page, and advise huge pages for it if they are enabled.
+/// @return the storage, or a null pointer if the size is smaller than two huge pages or the system has no mmap
+Common_API void* allocate_huge_pages(const std::size_t bytes);
+
+/// Unmap storage that was returned by allocate_huge_pages
+/// @return false if storage of this size is not allocated by allocate_huge_pages
+Common_API bool deallocate_huge_pages(void* data, const std::size_t bytes);
+
+/// Allocator for the storage of Table and List. Large arrays are mapped by allocate_huge_pages, others use std::allocator.
+template<typename T>
+class HugePagesAllocator : public std::allocator<T>
+{
+public:
+  typedef T* pointer;
+  typedef std::size_t size_type;
+
+  template<typename U>
+  struct rebind
+  {
+    typedef HugePagesAllocator<U> other;
+  };
+
+  HugePagesAllocator() {}
+
+  HugePagesAllocator(const HugePagesAllocator& other) : std::allocator<T>(other) {}
+
+  template<typename U>
+  HugePagesAllocator(const HugePagesAllocator<U>&) {}
+
+  pointer allocate(const size_type n, const void* = 0)
+  {
+    void* storage = allocate_huge_pages(n*sizeof(T));
+    if (storage)
+      return static_cast<pointer>(storage);
+    return std::allocator<T>::allocate(n);
+  }
+
+  void deallocate(pointer data, const size_type n)
+  {
+    if (!deallocate_huge_pages(data, n*sizeof(T)))
+      std::allocator<T>::deallocate(data, n);
+  }
+};
+
+template<typename T, typename U>
+bool operator==(const HugePagesAllocator<T>&, const HugePagesAllocator<U>&) { return true; }
+
+template<typename T, typename U>
+bool operator!=(const HugePagesAllocator<T>&, const HugePagesAllocator<U>&) { return false; }
+
+//@}
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // common
+} // cf3
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // cf3_common_HugePages_hpp
@@ -10,13 +10,18 @@
 
 #include "common/BoostAnyConversion.hpp"
 #include "common/Builder.hpp"
+#include "common/ConfigurationBatch.hpp"
 #include "common/Signal.hpp"
 #include "common/Core.hpp"
+#include "common/Foreach.hpp"
 #include "common/NetworkInfo.hpp"
 #include "common/Log.hpp"
 #include "common/LibCommon.hpp"
+#include "common/OptionFactory.hpp"
+#include "common/OptionList.hpp"
 #include "common/OptionT.hpp"
 #include "common/XML/Protocol.hpp"
+#include "common/XML/SignalOptions.hpp"
 #include "common/XML/XmlDoc.hpp"
 #include "common/XML/FileOperations.hpp"
 
@@ -130,6 +135,22 @@ void Journal::add_signal ( const SignalArgs & signal_node )
 
 ////////////////////////////////////////////////////////////////////////////////
 
+namespace
+{
+  /// Apply the pending configuration values and empty the batch, logging the values that could not be set
+  void apply_batch(ConfigurationBatch& batch, Component& root)
+  {
+    if(batch.size() == 0)
+      return;
+
+    std::vector<std::string> errors;
+    batch.apply(root, &errors);
+    batch.clear();
+    boost_foreach(const std::string& error, errors)
+      CFerror << error << CFendl;
+  }
+}
+
 void Journal::execute_signals (const URI& filename)
 {
   boost::shared_ptr<XmlDoc> xmldoc = XML::parse_file(filename);
@@ -140,6 +161,7 @@ void Journal::execute_signals (const URI& filename)
 //  rapidxml::xml_attribute<>* key_attr = nullptr;
   Component& root = Core::instance().root();
   const char * frame_tag = Protocol::Tags::node_frame();
+  ConfigurationBatch batch;
 
   XmlNode signal_map = Map(doc_node).find_value( Protocol::Tags::key_signals() );
 
@@ -181,6 +203,44 @@ void Journal::execute_signals (const URI& filename)
       try
       {
         SignalFrame sf(node);
+
+        // consecutive configure signals are applied directly from the parsed values
+        if(target == "configure" && sf.has_map( Protocol::Tags::key_options() ))
+        {
+          XmlNode opt_map = sf.map( Protocol::Tags::key_options() ).main_map.content;
+          const URI receiver_uri(receiver);
+          Handle<Component> receiver_comp = root.access_component(receiver_uri);
+          if(is_null(receiver_comp))
+          {
+            // the receiver may be created by a pending value
+            apply_batch(batch, root);
+            receiver_comp = root.access_component(receiver_uri);
+          }
+
+          for(rapidxml::xml_node<>* opt_node = opt_map.content->first_node(); opt_node != nullptr; opt_node = opt_node->next_sibling())
+          {
+            XmlNode value_node(opt_node);
+
+            // options the factory can not build, such as handles, are parsed by the option of the receiver itself
+            rapidxml::xml_attribute<>* key_attr = opt_node->first_attribute( Protocol::Tags::attr_key() );
+            if(is_not_null(receiver_comp) && is_not_null(key_attr) && receiver_comp->options().check(key_attr->value()))
+            {
+              Option& receiver_option = receiver_comp->options().option(key_attr->value());
+              if(!OptionFactory::instance().has_builder(receiver_option.type()))
+              {
+                apply_batch(batch, root);
+                receiver_option.set(value_node);
+                continue;
+              }
+            }
+
+            boost::shared_ptr<Option> option = SignalOptions::xml_to_option( value_node );
+            batch.add(receiver_uri, option->name(), option->value());
+          }
+          continue;
+        }
+
+        apply_batch(batch, root);
         root.access_component(receiver)->call_signal(target, sf);
       }
       catch(Exception & e)
@@ -191,6 +251,7 @@ void Journal::execute_signals (const URI& filename)
     }
   }
 
+  apply_batch(batch, root);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -45,7 +45,7 @@ public: // typedefs
   typedef ValueT value_type;
 
   /// @brief the type of the internal structure of the list
-  typedef boost::multi_array<ValueT,1> ListT;
+  typedef boost::multi_array<ValueT,1,HugePagesAllocator<ValueT> > ListT;
 
   /// @brief the type of the buffer used to interact with the table
   typedef ListBufferT<ValueT> Buffer;
@@ -110,6 +110,10 @@ public: // functions
   /// @return The number of local rows in the array
   Uint size() const { return m_array.size(); }
 
+  /// Memory allocated for the stored values
+  /// @return the memory usage in bytes
+  Real memory_usage() const { return static_cast<Real>(m_array.num_elements()) * sizeof(ValueT); }
+
 private: // data
 
   /// storage of the array
@@ -13,6 +13,7 @@
 
 #include "common/Foreach.hpp"
 #include "common/BoostArray.hpp"
+#include "common/HugePages.hpp"
 #include "common/BasicExceptions.hpp"
 #include "common/StringConversion.hpp"
 
@@ -46,7 +47,7 @@ public: // typedef
   typedef ListBufferIterator<ListBufferT const> const_iterator;
 
 
-  typedef boost::multi_array<T,1> Array_t;
+  typedef boost::multi_array<T,1,HugePagesAllocator<T> > Array_t;
   typedef T value_type;
 
 private:
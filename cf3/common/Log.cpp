@@ -151,5 +151,32 @@ void Logger::set_log_level(const Uint log_level)
 
 //////////////////////////////////////////////////////////////////////////////
 
+void Logger::synchronize()
+{
+  std::map<LogLevel, LogStream *>::iterator it;
+
+  PE::Comm& comm = PE::Comm::instance();
+  if(comm.is_active())
+  {
+    Uint nb_messages = 0;
+    for(it = m_streams.begin() ; it != m_streams.end() ; it++)
+    {
+      nb_messages += it->second->nb_sync_messages();
+    }
+
+    Uint total_nb_messages = 0;
+    comm.all_reduce(PE::plus(), &nb_messages, 1, &total_nb_messages);
+    if(total_nb_messages == 0)
+      return;
+  }
+
+  for(it = m_streams.begin() ; it != m_streams.end() ; it++)
+  {
+    it->second->synchronize();
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
 } // common
 } // cf3
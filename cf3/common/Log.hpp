@@ -80,6 +80,15 @@ class Common_API Logger : public boost::noncopyable {
 
   void set_log_level(const Uint log_level);
 
+  /// @brief Writes the messages that all processors buffered for the
+  /// @c LogStream::SYNC_SCREEN destination of each stream on rank 0.
+
+  /// This is a collective operation, see LogStream::synchronize(). A single reduction
+  /// skips the gathers if no processor has buffered messages. Called at the end of
+  /// each iteration of solver::actions::Iterate, and by PE::Comm::finalize() so that
+  /// the buffers are empty when MPI shuts down.
+  void synchronize();
+
   private :
 
   /// @brief Managed streams.
@@ -0,0 +1,248 @@
+// Copyright (C) 2010-2013 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+#include <boost/bind.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
+
+#include "common/LogBuffer.hpp"
+#include "common/PE/Comm.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace common {
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace detail
+{
+  /// Wall clock time in seconds since the epoch. The clocks of the nodes are assumed to be synchronized (NTP),
+  /// which is good enough to interleave the messages of different ranks.
+  double log_time()
+  {
+    static const boost::posix_time::ptime epoch(boost::gregorian::date(1970,1,1));
+    return static_cast<double>((boost::posix_time::microsec_clock::universal_time() - epoch).total_microseconds()) * 1e-6;
+  }
+
+  /// Position of a gathered message, sorted by time, then by rank, then by order of appending
+  struct GatheredMessage
+  {
+    GatheredMessage(const double t, const Uint r, const Uint i) : time(t), rank(r), idx(i) {}
+    double time;
+    Uint rank;
+    Uint idx;
+
+    bool operator<(const GatheredMessage& other) const
+    {
+      if(time != other.time)
+        return time < other.time;
+      if(rank != other.rank)
+        return rank < other.rank;
+      return idx < other.idx;
+    }
+  };
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+LogBuffer::LogBuffer(const Uint capacity) :
+  m_capacity(capacity),
+  m_dropped(0),
+  m_rank(0),
+  m_stop(false)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+LogBuffer::~LogBuffer()
+{
+  if(m_drain_thread)
+  {
+    {
+      boost::lock_guard<boost::mutex> lock(m_mutex);
+      m_stop = true;
+    }
+    m_wakeup.notify_one();
+    m_drain_thread->join();
+  }
+
+  MessagesT remaining;
+  take(remaining);
+  for(MessagesT::const_iterator it = remaining.begin(); it != remaining.end(); ++it)
+    std::cout << "[" << m_rank << "] " << it->text;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void LogBuffer::append(const std::string& message)
+{
+  const double time = detail::log_time();
+  const Uint rank = PE::Comm::instance().rank();
+  {
+    boost::lock_guard<boost::mutex> lock(m_mutex);
+    m_rank = rank;
+    if(m_messages.size() == m_capacity)
+    {
+      m_messages.pop_front();
+      ++m_dropped;
+    }
+    m_messages.push_back(Message(time, message));
+  }
+  if(m_drain_thread)
+    m_wakeup.notify_one();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void LogBuffer::drain_to_file(const std::string& filename)
+{
+  if(m_drain_thread)
+    return;
+
+  m_file.open(filename.c_str());
+  m_stop = false;
+  m_drain_thread.reset(new boost::thread(boost::bind(&LogBuffer::drain_loop, this)));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void LogBuffer::gather(std::ostream& out)
+{
+  MessagesT messages;
+  const Uint dropped = take(messages);
+
+  if(!PE::Comm::instance().is_active())
+  {
+    if(dropped)
+      out << "[0] " << dropped << " log messages dropped\n";
+    for(MessagesT::const_iterator it = messages.begin(); it != messages.end(); ++it)
+      out << it->text;
+    out.flush();
+    return;
+  }
+
+  PE::Comm& comm = PE::Comm::instance();
+  const Uint nb_procs = comm.size();
+  const int root = 0;
+
+  // Flatten the local messages. The number of dropped messages is sent as an extra time entry.
+  std::vector<double> times; times.reserve(messages.size()+1);
+  std::vector<int> lengths; lengths.reserve(messages.size()+1);
+  std::vector<char> text;
+  for(MessagesT::const_iterator it = messages.begin(); it != messages.end(); ++it)
+  {
+    times.push_back(it->time);
+    lengths.push_back(static_cast<int>(it->text.size()));
+    text.insert(text.end(), it->text.begin(), it->text.end());
+  }
+  times.push_back(static_cast<double>(dropped));
+  lengths.push_back(0);
+
+  std::vector<double> all_times;
+  std::vector<int> all_lengths;
+  std::vector<char> all_text;
+  std::vector<int> nb_messages(nb_procs, -1);
+  std::vector<int> nb_chars(nb_procs, -1);
+  comm.gather(times, times.size(), all_times, nb_messages, root);
+  std::vector<int> nb_lengths(nb_procs, -1);
+  comm.gather(lengths, lengths.size(), all_lengths, nb_lengths, root);
+  if(text.empty())
+    text.push_back('\0');
+  comm.gather(text, text.size(), all_text, nb_chars, root);
+
+  if(comm.rank() != root)
+    return;
+
+  // Offsets of each message in the gathered text
+  std::vector<Uint> text_offsets(all_lengths.size());
+  std::vector<detail::GatheredMessage> order;
+  order.reserve(all_times.size());
+  Uint msg_offset = 0;
+  Uint char_offset = 0;
+  for(Uint pid = 0; pid != nb_procs; ++pid)
+  {
+    const Uint nb_local = static_cast<Uint>(nb_messages[pid]) - 1;
+    Uint rank_chars = 0;
+    for(Uint i = 0; i != nb_local; ++i)
+    {
+      text_offsets[msg_offset+i] = char_offset + rank_chars;
+      rank_chars += all_lengths[msg_offset+i];
+      order.push_back(detail::GatheredMessage(all_times[msg_offset+i], pid, msg_offset+i));
+    }
+    const Uint rank_dropped = static_cast<Uint>(all_times[msg_offset+nb_local]);
+    if(rank_dropped)
+      out << "[" << pid << "] " << rank_dropped << " log messages dropped\n";
+    msg_offset += nb_local + 1;
+    char_offset += nb_chars[pid];
+  }
+
+  std::sort(order.begin(), order.end());
+  for(std::vector<detail::GatheredMessage>::const_iterator it = order.begin(); it != order.end(); ++it)
+    out.write(&all_text[text_offsets[it->idx]], all_lengths[it->idx]);
+  out.flush();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+Uint LogBuffer::size() const
+{
+  boost::lock_guard<boost::mutex> lock(m_mutex);
+  return m_messages.size();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+Uint LogBuffer::take(MessagesT& messages)
+{
+  boost::lock_guard<boost::mutex> lock(m_mutex);
+  messages.clear();
+  messages.swap(m_messages);
+  const Uint dropped = m_dropped;
+  m_dropped = 0;
+  return dropped;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void LogBuffer::drain_loop()
+{
+  MessagesT messages;
+  while(true)
+  {
+    bool stop = false;
+    Uint dropped = 0;
+    {
+      boost::unique_lock<boost::mutex> lock(m_mutex);
+      while(m_messages.empty() && !m_stop)
+        m_wakeup.wait(lock);
+      stop = m_stop;
+      messages.swap(m_messages);
+      dropped = m_dropped;
+      m_dropped = 0;
+    }
+
+    // The file is written outside the lock, so appending only waits for the swap above
+    if(dropped)
+      m_file << dropped << " log messages dropped\n";
+    for(MessagesT::const_iterator it = messages.begin(); it != messages.end(); ++it)
+      m_file << it->text;
+    m_file.flush();
+    messages.clear();
+
+    if(stop)
+      break;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // common
+} // cf3
@@ -0,0 +1,109 @@
+// Copyright (C) 2010-2013 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef cf3_common_LogBuffer_hpp
+#define cf3_common_LogBuffer_hpp
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <deque>
+#include <fstream>
+#include <iosfwd>
+#include <string>
+
+#include <boost/noncopyable.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+
+#include "common/CommonAPI.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace common {
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// @brief Per-rank in-memory store of complete log messages
+
+/// Appending a message never waits for other ranks: the message is stored with a time stamp
+/// in a bounded ring of messages. The ring is emptied either by a background thread that writes
+/// it to a per-rank file (see @c #drain_to_file()), or at an explicit, collective flush point where
+/// rank 0 collects the messages of all ranks and writes them ordered by time stamp (see @c #gather()).
+/// If the ring is full, the oldest messages are dropped and their number is reported at the next flush.
+class Common_API LogBuffer : public boost::noncopyable
+{
+public:
+
+  /// @param capacity Maximum number of messages kept in memory
+  LogBuffer(const Uint capacity = 100000);
+
+  /// Messages that were not flushed yet are written to the standard output, prefixed with the rank.
+  /// Doesn't use PE::Comm, since the buffer may be destroyed after it during the static destruction.
+  ~LogBuffer();
+
+  /// Store a complete message. Thread-safe, and does not communicate.
+  void append(const std::string& message);
+
+  /// Start a background thread that writes the messages to the given file as they arrive,
+  /// instead of keeping them for @c #gather(). Does nothing if the thread is already running.
+  void drain_to_file(const std::string& filename);
+
+  /// Collect the stored messages of all ranks on rank 0 and write them to @c out, ordered by time stamp.
+  /// Collective over the ranks of PE::Comm. Without an active communicator, the local messages are written.
+  void gather(std::ostream& out);
+
+  /// Number of messages currently stored
+  Uint size() const;
+
+private:
+
+  struct Message
+  {
+    Message(const double t, const std::string& txt) : time(t), text(txt) {}
+    /// Seconds since the epoch, UTC
+    double time;
+    std::string text;
+  };
+
+  typedef std::deque<Message> MessagesT;
+
+  /// Move the stored messages out of the ring
+  Uint take(MessagesT& messages);
+
+  /// Body of the drain thread
+  void drain_loop();
+
+  const Uint m_capacity;
+
+  mutable boost::mutex m_mutex;
+  boost::condition_variable m_wakeup;
+
+  /// The stored messages, oldest first
+  MessagesT m_messages;
+
+  /// Number of messages dropped since the last flush because the ring was full
+  Uint m_dropped;
+
+  /// Rank of this processor, recorded when a message is appended
+  Uint m_rank;
+
+  /// Drain thread and its output file, if any
+  boost::scoped_ptr<boost::thread> m_drain_thread;
+  std::ofstream m_file;
+  bool m_stop;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // common
+} // cf3
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // cf3_common_LogBuffer_hpp
@@ -9,6 +9,7 @@
 #include "common/PE/Comm.hpp"
 #include "common/Log.hpp"
 #include "common/LogStream.hpp"
+#include "common/LogBuffer.hpp"
 #include "common/LogLevelFilter.hpp"
 #include "common/LogStampFilter.hpp"
 #include "common/LogStringForwarder.hpp"
@@ -21,6 +22,7 @@ using namespace boost;
 
 LogStream::LogStream(const std::string & streamName, LogLevel level)
 : m_buffer(),
+m_sync_buffer(new LogBuffer()),
 m_streamName(streamName),
 m_filter_level(level),
 m_flushed(true)
@@ -49,7 +51,7 @@ m_flushed(true)
   stream = new iostreams::filtering_ostream();
   stream->push(levelFilter);
   stream->push(LogStampFilter(streamName));
-  stream->push(std::cout);
+  stream->push(back_inserter(m_sync_message));
   m_destinations[SYNC_SCREEN] = stream;
 
 
@@ -63,7 +65,7 @@ m_flushed(true)
   m_filterRankZero[SCREEN] = true;
   m_filterRankZero[FILE] = true;
   m_filterRankZero[STRING] = true;
-  m_filterRankZero[SYNC_SCREEN] = true;
+  m_filterRankZero[SYNC_SCREEN] = false;
 
 }
 
@@ -168,12 +170,53 @@ void LogStream::flush()
     m_buffer.clear();
   }
 
+  // complete SYNC_SCREEN messages are only buffered here, so that logging never
+  // waits for the other processors
+  if(!m_sync_message.empty())
+  {
+    if(PE::Comm::instance().is_active())
+      m_sync_buffer->append(m_sync_message);
+    else
+      std::cout << m_sync_message << std::flush;
+    m_sync_message.clear();
+  }
+
   m_flushed = true;
 }
 
 //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 
+void LogStream::synchronize()
+{
+  if(!m_flushed)
+    this->flush();
+
+  m_sync_buffer->gather(std::cout);
+}
+
+//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+Uint LogStream::nb_sync_messages()
+{
+  if(!m_flushed)
+    this->flush();
+
+  return m_sync_buffer->size();
+}
+
+//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+void LogStream::setSyncFile(const std::string & fileName)
+{
+  m_sync_buffer->drain_to_file(fileName);
+}
+
+//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
 void LogStream::set_log_level(const Uint level)
 {
   this->getLevelFilter(SCREEN).set_log_level(level);
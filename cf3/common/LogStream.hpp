@@ -9,6 +9,8 @@
 
 ////////////////////////////////////////////////////////////////////////////////
 
+#include <boost/scoped_ptr.hpp>
+
 #include "common/BoostIostreams.hpp"
 
 #include "common/PE/Comm.hpp"
@@ -17,6 +19,7 @@ namespace cf3 {
 namespace common {
 
 class CodeLocation;
+class LogBuffer;
 class LogToStream;
 class LogLevelFilter;
 class LogStampFilter;
@@ -55,11 +58,14 @@ class Common_API LogStream
     /// @brief A string buffer
     STRING = 4,
 
-		/// @brief Standard output (with MPI synchronization)
-		/// @note If one processor will output more than another, that processor will
-		/// wait FOREVER for synchronization. Use with care!
-		SYNC_SCREEN = 8
-	};
+    /// @brief Standard output of rank 0, collecting the messages of all processors
+
+    /// Complete messages are buffered on each processor, without any synchronization.
+    /// They are written, ordered by time, when @c #synchronize() is called by all
+    /// processors, or to a file per processor if @c #setSyncFile() was called.
+    /// Unlike the other destinations, the rank zero filter is disabled by default.
+    SYNC_SCREEN = 8
+  };
 
 
   /// @brief Constructor
@@ -76,6 +82,23 @@ class Common_API LogStream
   /// @brief Flushes the stream contents.
   void flush();
 
+  /// @brief Writes the messages buffered for @c #SYNC_SCREEN by all processors
+  /// to the standard output of rank 0, ordered by time.
+
+  /// This is a collective operation: all processors must call it.
+  void synchronize();
+
+  /// @brief Number of complete messages buffered for @c #SYNC_SCREEN on this processor.
+
+  /// The current message is flushed first.
+  Uint nb_sync_messages();
+
+  /// @brief Writes the messages for @c #SYNC_SCREEN to a file per processor
+  /// from a background thread, instead of buffering them for @c #synchronize().
+
+  /// @param fileName The name of the file for this processor.
+  void setSyncFile(const std::string & fileName);
+
   /// @brief Overrides operator &lt;&lt; for @c #LogLevel type.
 
   /// Sets @c #level as current level for all destinations.
@@ -117,20 +140,11 @@ class Common_API LogStream
             m_flushed = false;
           }
         }
-        else if (PE::Comm::instance().is_active())
+        else if (PE::Comm::instance().rank() == 0 || !this->getFilterRankZero(SYNC_SCREEN))
         {
-          for( Uint i = 0 ; i < PE::Comm::instance().size(); ++i )
-          {
-            if (!this->getFilterRankZero(it->first))
-            {
-                      PE::Comm::instance().barrier();
-                  }
-            if (i == PE::Comm::instance().rank())
-            {
-              *(it->second) << t;
-              m_flushed = false;
-            }
-          }
+          // Buffered per message, see flush()
+          *(it->second) << t;
+          m_flushed = false;
         }
       }
     }
@@ -302,6 +316,12 @@ class Common_API LogStream
   /// @brief Buffer for @c #STRING destination
   std::string m_buffer;
 
+  /// @brief Buffer for the current message of the @c #SYNC_SCREEN destination
+  std::string m_sync_message;
+
+  /// @brief Complete messages of the @c #SYNC_SCREEN destination
+  boost::scoped_ptr<LogBuffer> m_sync_buffer;
+
   /// @brief Stream name
 
   /// This attribute is used on @c #FILE stream creation.
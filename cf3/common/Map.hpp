@@ -172,6 +172,13 @@ public: // functions
   /// @brief Get the capacity of the map (memory allocated)
   size_t capacity() const;
 
+  /// @brief Memory allocated for the pairs
+  /// @return the memory usage in bytes
+  Real memory_usage() const { return static_cast<Real>(capacity()) * sizeof(value_type); }
+
+  /// @brief Release the memory that was reserved but is not used
+  void shrink_to_fit();
+
   /// @brief Overloading of the operator"[]" for assignment AND insertion
   /// @note WARNING: This procedure will call the costly sort_keys() if the map is not sorted
   /// @param[in] key The key to look for. If the key is not found,
@@ -395,6 +402,15 @@ inline void Map<KEY,DATA>::clear()
 
 //////////////////////////////////////////////////////////////////////////////
 
+template <typename KEY, typename DATA>
+void Map<KEY,DATA>::shrink_to_fit()
+{
+  if (m_vectorMap.capacity() != m_vectorMap.size())
+    std::vector<value_type>(m_vectorMap).swap(m_vectorMap);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
 template <typename KEY, typename DATA>
 size_t Map<KEY,DATA>::capacity() const
 {
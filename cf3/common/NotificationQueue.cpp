@@ -40,6 +40,11 @@ void NotificationQueue::add_notification ( SignalArgs & args )
 
   cf3_assert( !name.empty() );
 
+  // the same event from the same sender is only notified once per flush: the first occurrence is kept as is, so the
+  // notifications are flushed in the order in which they were first raised
+  if( !m_pending.insert( std::make_pair(name, args.node.attribute_value("sender")) ).second )
+    return;
+
   m_notifications.push_back( std::pair<std::string, SignalArgs>(name, args) );
 }
 
@@ -84,6 +89,7 @@ void NotificationQueue::flush()
     }
 
     m_notifications.clear();
+    m_pending.clear();
   }
 }
 
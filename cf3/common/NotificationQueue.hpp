@@ -9,6 +9,9 @@
 
 /////////////////////////////////////////////////////////////////////////////////
 
+#include <map>
+#include <set>
+
 #include <boost/signals2/signal.hpp>
 
 #include "common/CF.hpp"
@@ -110,6 +113,13 @@ namespace common {
     /// the signal arguments.
     std::vector< std::pair<std::string, SignalArgs> > m_notifications;
 
+    /// @brief Event name and sender path of the buffered notifications.
+
+    /// Used to debounce the notifications: repeated events from the same
+    /// sender are only buffered once between two flushes. The first
+    /// occurrence is kept, with its arguments and its place in the buffer.
+    std::set< std::pair<std::string, std::string> > m_pending;
+
     /// @brief Signal used to raise events when #flush() method is called.
     boost::shared_ptr< SignalTypeFlush_t > m_sig_begin_flush;
 
@@ -34,6 +34,12 @@ boost::shared_ptr< Option > OptionFactory::create_option ( const std::string& na
   return builder->create_option(name, default_value);
 }
 
+bool OptionFactory::has_builder ( const std::string& type ) const
+{
+  std::map< std::string, boost::shared_ptr<OptionBuilder> >::const_iterator it = m_builders.find(type);
+  return it != m_builders.end() && is_not_null(it->second);
+}
+
 void OptionFactory::register_builder ( const std::string& type, const boost::shared_ptr< OptionBuilder >& builder )
 {
   if ( ! m_builders.count(type) )
@@ -45,6 +45,9 @@ public:
   /// Create an option with the given type and default value, passed as a string or vector of strings
   boost::shared_ptr<Option> create_option(const std::string& name, const std::string& type, const boost::any& default_value);
 
+  /// True if options of the given type can be created by the factory
+  bool has_builder(const std::string& type) const;
+
 private:
   OptionFactory();
   std::map< std::string, boost::shared_ptr<OptionBuilder> > m_builders;
@@ -152,6 +152,16 @@ void OptionList::set(const std::string& pname, const boost::any& val)
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void OptionList::attach_trigger_to_all(const Option::TriggerT& trigger)
+{
+  cf3_assert(m_list_trigger.empty());
+  m_list_trigger = trigger;
+  for(OptionStorage_t::iterator it = store.begin(); it != store.end(); ++it)
+    it->second->attach_trigger(m_list_trigger);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 std::string OptionList::list_options() const
 {
   std::string opt_list="";
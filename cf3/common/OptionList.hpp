@@ -50,6 +50,8 @@ public:
     typedef typename SelectOptionType<T>::type OptionType;
     boost::shared_ptr<OptionType> opt ( new OptionType(name, default_value) );
     store.insert( std::make_pair(name, opt ) );
+    if(!m_list_trigger.empty())
+      opt->attach_trigger(m_list_trigger);
     return *opt;
   }
 
@@ -63,6 +65,8 @@ public:
                       this->store.find(option->name()) == store.end() );
 
     store.insert( std::make_pair(option->name(), option ) );
+    if(!m_list_trigger.empty())
+      option->attach_trigger(m_list_trigger);
     return *option;
   }
 
@@ -113,6 +117,13 @@ public:
     return store.find(opt_name) != store.end();
   }
 
+  /// Attach a trigger to all options in the list, including the ones added later
+  /// @pre Only one such trigger can be attached to the list
+  void attach_trigger_to_all(const Option::TriggerT& trigger);
+
+  /// True if a trigger was attached with attach_trigger_to_all
+  bool has_trigger_on_all() const { return !m_list_trigger.empty(); }
+
   /// erases an option from the list
   /// @param name the option name to erase
   void erase (const std::string & name);
@@ -152,6 +163,11 @@ public:
   /// storage of options
   OptionStorage_t store;
 
+private:
+
+  /// Trigger attached to every option of the list
+  Option::TriggerT m_list_trigger;
+
 }; // class OptionList
 
 /////////////////////////////////////////////////////////////////////////////////////
@@ -77,14 +77,22 @@ std::string Comm::version() const
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void Comm::init(int argc, char** args)
+void Comm::init(int argc, char** args, const int required_thread_support)
 {
   if ( is_finalized() )
     throw SetupError( FromHere(), "Should not call Comm::initialize() after Comm::finalize()" );
 
   if( !is_initialized() ) // then initialize
   {
-    MPI_CHECK_RESULT(MPI_Init,(&argc,&args));
+    if( required_thread_support == MPI_THREAD_SINGLE )
+    {
+      MPI_CHECK_RESULT(MPI_Init,(&argc,&args));
+    }
+    else
+    {
+      int provided;
+      MPI_CHECK_RESULT(MPI_Init_thread,(&argc,&args,required_thread_support,&provided));
+    }
     //  CFinfo << "MPI (version " <<  version() << ") -- initiated" << CFendl;
   }
 
@@ -93,8 +101,24 @@ void Comm::init(int argc, char** args)
 
 ////////////////////////////////////////////////////////////////////////////////
 
+int Comm::thread_support() const
+{
+  if( !is_initialized() || is_finalized() )
+    return MPI_THREAD_SINGLE;
+
+  int provided;
+  MPI_CHECK_RESULT(MPI_Query_thread,(&provided));
+  return provided;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 void Comm::finalize()
 {
+  // The buffered SYNC_SCREEN messages are written while the processors can still communicate
+  if( is_active() )
+    Logger::instance().synchronize();
+
   if( is_initialized() && !is_finalized() ) // then finalized
   {
     MPI_CHECK_RESULT(MPI_Finalize,());
@@ -68,8 +68,13 @@ public:
   std::string version() const;
 
   /// Initialise the PE
+  /// @param required_thread_support Level of thread support to request from MPI, one of the MPI_THREAD_* constants.
+  /// Processes that receive signals in a separate thread (see PE::Manager) should request MPI_THREAD_MULTIPLE.
   /// @post will have a valid state
-  void init(int argc=0, char** args=0);
+  void init(int argc=0, char** args=0, const int required_thread_support=MPI_THREAD_SINGLE);
+
+  /// Level of thread support provided by MPI, one of the MPI_THREAD_* constants
+  int thread_support() const;
   /// Free the PE, careful because some mpi-s fail upon re-init after a proper finalize
   /// @post will have not a valid state
   void finalize();
@@ -6,6 +6,8 @@
 
 ////////////////////////////////////////////////////////////////////////////////
 
+#include <numeric>
+
 #include "boost/lexical_cast.hpp"
 
 #include "common/BoostAssertions.hpp"
@@ -124,7 +126,45 @@ void CommPattern::setup(const Handle<CommWrapper>& gid, std::vector<Uint>& rank)
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void CommPattern::setup(const Handle<CommWrapper>& gid, boost::multi_array<Uint,1>& rank)
+void CommPattern::setup(const Handle<CommWrapper>& gid, const boost::multi_array<Uint,1,HugePagesAllocator<Uint> >& rank,
+                        const std::vector<int>& send_count, const std::vector<int>& send_map,
+                        const std::vector<int>& recv_count, const std::vector<int>& recv_map)
+{
+  const CPint irank=(CPint)PE::Comm::instance().rank();
+  const CPint nproc=(CPint)PE::Comm::instance().size();
+
+  // basic check
+  BOOST_ASSERT( (Uint)gid->size() == rank.size() );
+  if (gid->stride()!=1) throw cf3::common::BadValue(FromHere(),"Data to be registered as gid is not of stride=1.");
+  if (gid->is_data_type_Uint()!=true) throw cf3::common::CastingFailed(FromHere(),"Data to be registered as gid is not of type Uint.");
+  if ((CPint)send_count.size()!=nproc || (CPint)recv_count.size()!=nproc)
+    throw cf3::common::BadValue(FromHere(),"Send and receive counts need one entry per rank for commpattern: " + name());
+  if (std::accumulate(send_count.begin(),send_count.end(),0)!=(int)send_map.size() || std::accumulate(recv_count.begin(),recv_count.end(),0)!=(int)recv_map.size())
+    throw cf3::common::BadValue(FromHere(),"Send or receive counts do not match the map sizes for commpattern: " + name());
+
+  m_ranks.assign(rank.begin(), rank.end());
+  m_gid=gid;
+  m_gid->add_tag("gid_of_"+this->name());
+
+  m_isUpdatable.resize(rank.size());
+  for (int i=0; i<(const int)rank.size(); i++)
+    m_isUpdatable[i]=((CPint)rank[i]==irank);
+
+  m_sendCount.assign(send_count.begin(),send_count.end());
+  m_sendMap.assign(send_map.begin(),send_map.end());
+  m_recvCount.assign(recv_count.begin(),recv_count.end());
+  m_recvMap.assign(recv_map.begin(),recv_map.end());
+
+  m_isUpToDate=true;
+  m_add_buffer.clear();
+  m_rem_buffer.clear();
+  m_mov_buffer.clear();
+  m_free_lids.assign(1,m_isUpdatable.size());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void CommPattern::setup(const Handle<CommWrapper>& gid, boost::multi_array<Uint,1,HugePagesAllocator<Uint> >& rank)
 {
 //PECheckPoint(100,"-- Setup input via multiarray: (gid|rank) -- " + uri().path());
 //PEProcessSortedExecute(-1,
@@ -159,7 +199,7 @@ void CommPattern::setup(const Handle<CommWrapper>& gid, boost::multi_array<Uint,
     std::vector<int> map(gid->size());
     for(int i=0; i<(int)map.size(); i++) map[i]=i;
     PE::CommWrapperView<Uint> cwv_gid(m_gid);
-    boost::multi_array<Uint,1>::iterator irank=rank.begin();
+    boost::multi_array<Uint,1,HugePagesAllocator<Uint> >::iterator irank=rank.begin();
     for (Uint* iigid=cwv_gid();irank!=rank.end();irank++,iigid++)
       add_global(*iigid,*irank);
 
@@ -611,6 +651,108 @@ void CommPattern::synchronize_this( const CommWrapper& pobj, std::vector<unsigne
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void CommPattern::start_synchronize( const std::vector< Handle<CommWrapper> >& pobjs )
+{
+  if (is_synchronizing()) throw common::ShouldNotBeHere(FromHere(),"A synchronization is already in progress for commpattern '" + name() + "'.");
+
+  BOOST_FOREACH( const Handle<CommWrapper>& pobj, pobjs )
+  {
+    if (is_not_null(pobj) && pobj->needs_update()) m_sync_objects.push_back(pobj);
+  }
+  if (m_sync_objects.empty()) return;
+
+  const Uint nproc = PE::Comm::instance().size();
+
+  // number of bytes sent for each item, summed over the objects
+  Uint item_bytes = 0;
+  BOOST_FOREACH( const Handle<CommWrapper>& pobj, m_sync_objects ) item_bytes += pobj->size_of()*pobj->stride();
+
+  // pack each object, and place its values in the message of each rank after those of the previous objects
+  m_sync_sndbuf.resize(m_sendMap.size()*item_bytes);
+  m_sync_rcvbuf.resize(m_recvMap.size()*item_bytes);
+  std::vector<unsigned char> packed;
+  Uint obj_offset = 0;
+  BOOST_FOREACH( const Handle<CommWrapper>& pobj, m_sync_objects )
+  {
+    pobj->pack(packed,m_sendMap);
+    const Uint obj_bytes = pobj->size_of()*pobj->stride();
+    Uint src = 0;
+    Uint rank_start = 0;
+    for (Uint i=0; i<nproc; ++i)
+    {
+      const Uint nb_bytes = m_sendCount[i]*obj_bytes;
+      if (nb_bytes != 0) std::copy(packed.begin()+src, packed.begin()+src+nb_bytes, m_sync_sndbuf.begin()+rank_start*item_bytes+m_sendCount[i]*obj_offset);
+      src += nb_bytes;
+      rank_start += m_sendCount[i];
+    }
+    obj_offset += obj_bytes;
+  }
+
+  // post the receives first, so the sends can complete as soon as possible
+  MPI_Comm comm = PE::Comm::instance().communicator();
+  const int tag = 9301;
+  m_sync_requests.clear();
+  Uint rank_start = 0;
+  for (Uint i=0; i<nproc; ++i)
+  {
+    if (m_recvCount[i] != 0)
+    {
+      m_sync_requests.push_back(MPI_Request());
+      MPI_CHECK_RESULT(MPI_Irecv,(&m_sync_rcvbuf[rank_start*item_bytes], m_recvCount[i]*item_bytes, MPI_BYTE, i, tag, comm, &m_sync_requests.back()));
+    }
+    rank_start += m_recvCount[i];
+  }
+  rank_start = 0;
+  for (Uint i=0; i<nproc; ++i)
+  {
+    if (m_sendCount[i] != 0)
+    {
+      m_sync_requests.push_back(MPI_Request());
+      MPI_CHECK_RESULT(MPI_Isend,(&m_sync_sndbuf[rank_start*item_bytes], m_sendCount[i]*item_bytes, MPI_BYTE, i, tag, comm, &m_sync_requests.back()));
+    }
+    rank_start += m_sendCount[i];
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void CommPattern::finish_synchronize()
+{
+  if (!is_synchronizing()) return;
+
+  if (!m_sync_requests.empty())
+    MPI_CHECK_RESULT(MPI_Waitall,(m_sync_requests.size(), &m_sync_requests[0], MPI_STATUSES_IGNORE));
+
+  const Uint nproc = PE::Comm::instance().size();
+  Uint item_bytes = 0;
+  BOOST_FOREACH( const Handle<CommWrapper>& pobj, m_sync_objects ) item_bytes += pobj->size_of()*pobj->stride();
+
+  // extract the values of each object from the messages, and unpack them
+  std::vector<unsigned char> packed;
+  Uint obj_offset = 0;
+  BOOST_FOREACH( const Handle<CommWrapper>& pobj, m_sync_objects )
+  {
+    const Uint obj_bytes = pobj->size_of()*pobj->stride();
+    packed.resize(m_recvMap.size()*obj_bytes);
+    Uint dst = 0;
+    Uint rank_start = 0;
+    for (Uint i=0; i<nproc; ++i)
+    {
+      const Uint nb_bytes = m_recvCount[i]*obj_bytes;
+      if (nb_bytes != 0) std::copy(m_sync_rcvbuf.begin()+rank_start*item_bytes+m_recvCount[i]*obj_offset, m_sync_rcvbuf.begin()+rank_start*item_bytes+m_recvCount[i]*obj_offset+nb_bytes, packed.begin()+dst);
+      dst += nb_bytes;
+      rank_start += m_recvCount[i];
+    }
+    if (!packed.empty()) pobj->unpack(packed,m_recvMap);
+    obj_offset += obj_bytes;
+  }
+
+  m_sync_objects.clear();
+  m_sync_requests.clear();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 void CommPattern::add_global(Uint gid, Uint rank)
 {
   // later a mechanism could be implemented when commpattern can give gids by calling a "reserve(int num)" beforehand, to optimize performance
@@ -168,7 +168,7 @@ public:
   /// @param data Multiarray holding the data (not copied)
   /// @param stride number of array element grouping
   template<typename ValueT, std::size_t NDims>
-  void insert(const std::string& name, boost::multi_array<ValueT, NDims>& data, const bool needs_update=true)
+  void insert(const std::string& name, boost::multi_array<ValueT, NDims, HugePagesAllocator<ValueT> >& data, const bool needs_update=true)
   {
     typedef CommWrapperMArray<ValueT, NDims> CommWrapperT;
     Handle<CommWrapperT> ow = create_component<CommWrapperT>(name);
@@ -211,7 +211,19 @@ public:
   /// this overload of setup is designed for making no callback functions, so all the registered data should match the size of current size + number of additions
   /// @param gid CommWrapper to a Uint tpye of data array
   /// @param rank vector of ranks where given global ids are updatable to add
-  void setup(const Handle<CommWrapper>& gid, boost::multi_array<Uint,1>& rank);
+  void setup(const Handle<CommWrapper>& gid, boost::multi_array<Uint,1,HugePagesAllocator<Uint> >& rank);
+
+  /// set up the communication pattern from send and receive maps that are already known on each rank,
+  /// e.g. computed from the structured indices of a generated mesh. No communication is done, so the maps must be consistent over all ranks.
+  /// @param gid CommWrapper to a Uint type of data array, containing the global ids of all local items. It is not modified.
+  /// @param rank rank where each local item is updatable
+  /// @param send_count number of items sent to each rank
+  /// @param send_map local ids of the items to send, grouped by destination rank, in the order the destination receives them
+  /// @param recv_count number of items received from each rank
+  /// @param recv_map local ids of the ghost items to receive, grouped by source rank
+  void setup(const Handle<CommWrapper>& gid, const boost::multi_array<Uint,1,HugePagesAllocator<Uint> >& rank,
+             const std::vector<int>& send_count, const std::vector<int>& send_map,
+             const std::vector<int>& recv_count, const std::vector<int>& recv_map);
 
   /// build and/or modify communication pattern - only incorporate actual buffers
   /// this function sets actually up the communication pattern
@@ -229,6 +241,20 @@ public:
   /// @param name the name of the parallel object
   void synchronize( const CommWrapper& pobj );
 
+  /// start synchronizing the given parallel objects, without waiting for the data to arrive
+  /// the values of all objects are sent in a single message per rank, using non-blocking point to point communication
+  /// the ghost values are only updated by finish_synchronize(), which must be called before the next start_synchronize()
+  /// all ranks must start the synchronizations of their comm patterns in the same order
+  /// @param pobjs the parallel objects to synchronize
+  void start_synchronize( const std::vector< Handle<CommWrapper> >& pobjs );
+
+  /// wait for the synchronization started by start_synchronize() and unpack the received ghost values
+  /// does nothing if no synchronization was started
+  void finish_synchronize();
+
+  /// true between start_synchronize() and finish_synchronize()
+  bool is_synchronizing() const { return !m_sync_objects.empty(); }
+
   /// add element to the commpattern
   /// when all changes done, all needs to be committed by calling setup
   /// if global id is not on current rank, then a ghost is automatically created on current rank
@@ -349,6 +375,21 @@ private:
   /// Rank for all the gids in local index space
   std::vector<int> m_ranks;
 
+  /// @name STATE OF A SYNCHRONIZATION STARTED WITH start_synchronize
+  //@{
+
+  /// the objects being synchronized
+  std::vector< Handle<CommWrapper> > m_sync_objects;
+
+  /// send and receive buffers, with for each rank the values of all objects one after the other
+  std::vector<unsigned char> m_sync_sndbuf;
+  std::vector<unsigned char> m_sync_rcvbuf;
+
+  /// the pending non-blocking sends and receives
+  std::vector<MPI_Request> m_sync_requests;
+
+  //@} END STATE OF A SYNCHRONIZATION
+
 }; // CommPattern
 
 ////////////////////////////////////////////////////////////////////////////////////////////
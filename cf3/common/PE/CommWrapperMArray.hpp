@@ -14,6 +14,7 @@
 
 #include "common/PE/CommWrapper.hpp"
 #include "common/BoostArray.hpp"
+#include "common/HugePages.hpp"
 #include "common/Foreach.hpp"
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -60,7 +61,7 @@ class CommWrapperMArray<T,1>: public CommWrapper{
     /// setup of passing by reference
     /// @param std::vector of data
     /// @param stride number of array element grouping
-    void setup(boost::multi_array<T,1>& data, const bool needs_update)
+    void setup(boost::multi_array<T,1,HugePagesAllocator<T> >& data, const bool needs_update)
     {
       if (boost::is_pod<T>::value==false) throw cf3::common::BadValue(FromHere(),name()+": Data is not POD (plain old datatype).");
       m_data=&data;
@@ -167,7 +168,7 @@ class CommWrapperMArray<T,1>: public CommWrapper{
   private:
 
     /// pointer to std::vector
-    boost::multi_array<T,1>* m_data;
+    boost::multi_array<T,1,HugePagesAllocator<T> >* m_data;
 };
 
 //////////////////////////////////////////////////////////////////////////////
@@ -194,7 +195,7 @@ class CommWrapperMArray<T,2>: public CommWrapper{
     /// setup of passing by reference
     /// @param std::vector of data
     /// @param stride number of array element grouping
-    void setup(boost::multi_array<T,2>& data, const bool needs_update)
+    void setup(boost::multi_array<T,2,HugePagesAllocator<T> >& data, const bool needs_update)
     {
       if (boost::is_pod<T>::value==false) throw cf3::common::BadValue(FromHere(),name()+": Data is not POD (plain old datatype).");
       m_data=&data;
@@ -309,7 +310,7 @@ class CommWrapperMArray<T,2>: public CommWrapper{
   private:
 
     /// pointer to std::vector
-    boost::multi_array<T,2>* m_data;
+    boost::multi_array<T,2,HugePagesAllocator<T> >* m_data;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
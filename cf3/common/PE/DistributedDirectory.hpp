@@ -0,0 +1,189 @@
+// Copyright (C) 2010-2013 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+/// @file DistributedDirectory.hpp
+/// @brief Distributed key to (value, rank) lookup, with memory bounded by the local number of keys
+
+#ifndef CF3_COMMON_PE_DistributedDirectory_hpp
+#define CF3_COMMON_PE_DistributedDirectory_hpp
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <limits>
+#include <map>
+#include <vector>
+
+#include "common/Assertions.hpp"
+#include "common/PE/Comm.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace common {
+namespace PE {
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// @brief Directory of keys, distributed over the ranks by key range
+///
+/// Each key in [0, max_key] is assigned to the directory rank that owns its range (e.g. a range
+/// of the Hilbert curve). Ranks send the keys they own to the directory ranks, and ask the
+/// directory ranks about the keys they need. Each exchange only carries the local keys, so the
+/// memory use is bounded by the local size instead of the global size that broadcasting
+/// or gathering all keys on every rank needs.
+/// If a key is inserted by more than one rank, the lowest rank and its value are kept.
+template <typename KeyT>
+class DistributedDirectory
+{
+public:
+
+  /// Construct an empty directory for keys in [0, max_key]
+  DistributedDirectory(const KeyT max_key) :
+    m_nb_procs(Comm::instance().is_active() ? Comm::instance().size() : 1u),
+    m_range(m_nb_procs == 1 ? max_key : max_key / m_nb_procs + 1)
+  {
+  }
+
+  /// Insert keys with an associated value. Collective.
+  void insert(const std::vector<KeyT>& keys, const std::vector<Uint>& values)
+  {
+    cf3_assert(keys.size() == values.size());
+
+    std::vector< std::vector<KeyT> > send_keys(m_nb_procs);
+    std::vector< std::vector<Uint> > send_values(m_nb_procs);
+    for (Uint i=0; i<keys.size(); ++i)
+    {
+      const Uint dir = directory_rank(keys[i]);
+      send_keys[dir].push_back(keys[i]);
+      send_values[dir].push_back(values[i]);
+    }
+
+    std::vector< std::vector<KeyT> > recv_keys(m_nb_procs);
+    std::vector< std::vector<Uint> > recv_values(m_nb_procs);
+    exchange(send_keys, recv_keys);
+    exchange(send_values, recv_values);
+
+    for (Uint pid=0; pid<m_nb_procs; ++pid)
+    {
+      cf3_assert(recv_keys[pid].size() == recv_values[pid].size());
+      for (Uint i=0; i<recv_keys[pid].size(); ++i)
+      {
+        typename EntriesT::iterator entry = m_entries.find(recv_keys[pid][i]);
+        if (entry == m_entries.end())
+          m_entries.insert(std::make_pair(recv_keys[pid][i], Entry(recv_values[pid][i], pid)));
+        else if (pid < entry->second.rank)
+          entry->second = Entry(recv_values[pid][i], pid);
+      }
+    }
+  }
+
+  /// Look up keys. Collective.
+  /// @param [out] values the value inserted for each key, or unknown() if the key is unknown
+  /// @param [out] ranks the (lowest) rank that inserted each key, or unknown() if the key is unknown
+  void find(const std::vector<KeyT>& keys, std::vector<Uint>& values, std::vector<Uint>& ranks) const
+  {
+    // Requests, with the position of each request in the keys
+    std::vector< std::vector<KeyT> > send_keys(m_nb_procs);
+    std::vector< std::vector<Uint> > request_positions(m_nb_procs);
+    for (Uint i=0; i<keys.size(); ++i)
+    {
+      const Uint dir = directory_rank(keys[i]);
+      send_keys[dir].push_back(keys[i]);
+      request_positions[dir].push_back(i);
+    }
+
+    std::vector< std::vector<KeyT> > recv_keys(m_nb_procs);
+    exchange(send_keys, recv_keys);
+
+    // Answer the requests received from each rank
+    std::vector< std::vector<Uint> > send_values(m_nb_procs);
+    std::vector< std::vector<Uint> > send_ranks(m_nb_procs);
+    for (Uint pid=0; pid<m_nb_procs; ++pid)
+    {
+      send_values[pid].resize(recv_keys[pid].size(), unknown());
+      send_ranks[pid].resize(recv_keys[pid].size(), unknown());
+      for (Uint i=0; i<recv_keys[pid].size(); ++i)
+      {
+        typename EntriesT::const_iterator entry = m_entries.find(recv_keys[pid][i]);
+        if (entry != m_entries.end())
+        {
+          send_values[pid][i] = entry->second.value;
+          send_ranks[pid][i] = entry->second.rank;
+        }
+      }
+    }
+
+    std::vector< std::vector<Uint> > recv_values(m_nb_procs);
+    std::vector< std::vector<Uint> > recv_ranks(m_nb_procs);
+    exchange(send_values, recv_values);
+    exchange(send_ranks, recv_ranks);
+
+    values.assign(keys.size(), unknown());
+    ranks.assign(keys.size(), unknown());
+    for (Uint pid=0; pid<m_nb_procs; ++pid)
+    {
+      cf3_assert(recv_values[pid].size() == request_positions[pid].size());
+      for (Uint i=0; i<request_positions[pid].size(); ++i)
+      {
+        values[request_positions[pid][i]] = recv_values[pid][i];
+        ranks[request_positions[pid][i]] = recv_ranks[pid][i];
+      }
+    }
+  }
+
+  /// Value and rank returned for keys that were not inserted
+  static Uint unknown() { return std::numeric_limits<Uint>::max(); }
+
+  /// Number of keys stored on this rank
+  Uint local_size() const { return m_entries.size(); }
+
+private:
+
+  struct Entry
+  {
+    Entry(const Uint v, const Uint r) : value(v), rank(r) {}
+    Uint value;
+    Uint rank;
+  };
+
+  typedef std::map<KeyT, Entry> EntriesT;
+
+  /// Rank that stores the given key
+  Uint directory_rank(const KeyT key) const
+  {
+    if (m_nb_procs == 1)
+      return 0;
+    const Uint dir = static_cast<Uint>(key / m_range);
+    return dir < m_nb_procs ? dir : m_nb_procs-1;
+  }
+
+  template <typename T>
+  static void exchange(const std::vector< std::vector<T> >& send, std::vector< std::vector<T> >& recv)
+  {
+    if (Comm::instance().is_active())
+      Comm::instance().all_to_all(send, recv);
+    else
+      recv = send;
+  }
+
+  const Uint m_nb_procs;
+
+  /// Size of the key range stored on each rank
+  const KeyT m_range;
+
+  /// Keys stored on this rank
+  EntriesT m_entries;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // PE
+} // common
+} // cf3
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // CF3_COMMON_PE_DistributedDirectory_hpp
@@ -6,6 +6,7 @@
 
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
 
 #include "common/PE/ListeningInfo.hpp"
 
@@ -18,7 +19,8 @@ namespace PE {
 ////////////////////////////////////////////////////////////////////////////
 
 ListeningInfo::ListeningInfo()
-  : ready(true)
+  : ready(true),
+    removed(false)
 {
   data = (char *) std::malloc( buffer_size() );
 }
@@ -32,6 +34,31 @@ ListeningInfo::~ListeningInfo()
 
 ////////////////////////////////////////////////////////////////////////////
 
+namespace
+{
+  /// Starts the large signal header. Text signals start with '<' and binary ones with a zero byte.
+  const char large_signal_magic[4] = { 'C', 'F', 'L', 'S' };
+}
+
+void ListeningInfo::make_large_signal_header(const Uint size, char * header)
+{
+  std::memcpy(header, large_signal_magic, 4);
+  std::memcpy(header + 4, &size, sizeof(Uint));
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+bool ListeningInfo::is_large_signal_header(const char * data, const Uint length, Uint & size)
+{
+  if( length != large_signal_header_size() || std::memcmp(data, large_signal_magic, 4) != 0 )
+    return false;
+
+  std::memcpy(&size, data + 4, sizeof(Uint));
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
 } // PE
 } // common
 } // cf3
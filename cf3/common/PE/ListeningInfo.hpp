@@ -30,6 +30,23 @@ namespace PE {
     /// @returns buffer size (256 KB)
     static Uint buffer_size() { return 262144; }
 
+    /// @returns tag of the messages that carry a signal, or that announce a signal larger than the buffer
+    static int signal_tag() { return 0; }
+
+    /// @returns tag of the messages that carry a signal larger than the buffer
+    static int large_signal_tag() { return 1; }
+
+    /// @returns size of the message that announces a large signal
+    static Uint large_signal_header_size() { return 4 + sizeof(Uint); }
+
+    /// Writes the message that announces a signal of the given size in @c header,
+    /// which must hold @c large_signal_header_size() bytes
+    static void make_large_signal_header(const Uint size, char * header);
+
+    /// Checks if a received message announces a large signal
+    /// @param size if it does, set to the size of the signal
+    static bool is_large_signal_header(const char * data, const Uint length, Uint & size);
+
     /// @brief Received MPI frame
     char * data;
 
@@ -45,6 +62,11 @@ namespace PE {
     /// If @c true, the communicator is ready; if @c false, it is not.
     bool ready;
 
+    /// @brief Indicates that the communicator must not be listened to anymore.
+
+    /// The pending receive is cancelled by the listening thread.
+    bool removed;
+
     /// @brief Constructor
     ListeningInfo();
 
@@ -15,6 +15,7 @@
 
 #include "common/XML/FileOperations.hpp"
 
+#include "common/PE/Comm.hpp"
 #include "common/PE/ListeningInfo.hpp"
 
 #include "common/PE/ListeningThread.hpp"
@@ -32,7 +33,11 @@ namespace PE {
 
 ListeningThread::ListeningThread(unsigned int waitingTime)
   : m_sleep_duration(waitingTime),
-    m_listening(false)
+    m_listening(false),
+    m_blocking(false),
+    m_wakeup_comm(MPI_COMM_NULL),
+    m_wakeup_request(MPI_REQUEST_NULL),
+    m_wakeup_ready(true)
 {
 
 }
@@ -49,6 +54,8 @@ void ListeningThread::add_communicator( Communicator comm )
   m_comms[comm] = new ListeningInfo();
 
   m_mutex.unlock();
+
+  wake_up(); // to post a receive on the new communicator
 }
 
 ////////////////////////////////////////////////////////////////////////////
@@ -63,9 +70,15 @@ void ListeningThread::remove_comunicator( Communicator comm )
 
   cf3_assert( it != m_comms.end() );
 
-  m_comms.erase(it);
+  // the running thread may be using the pending request, so it has to cancel it itself
+  if( m_listening )
+    it->second->removed = true;
+  else
+    release(it);
 
   m_mutex.unlock();
+
+  wake_up();
 }
 
 ////////////////////////////////////////////////////////////////////////////
@@ -76,6 +89,8 @@ void ListeningThread::stop_listening()
 
   m_listening = false;
 
+  wake_up();
+
 //  m_thread.join();
 
 //  m_mutex.unlock();
@@ -87,6 +102,11 @@ void ListeningThread::start_listening()
 {
   if( !m_listening && !m_comms.empty() )
   {
+    m_blocking = Comm::instance().thread_support() == MPI_THREAD_MULTIPLE;
+
+    if( m_blocking && m_wakeup_comm == MPI_COMM_NULL )
+      MPI_Comm_dup( MPI_COMM_SELF, &m_wakeup_comm );
+
     m_listening = true;
 
     m_thread = boost::thread(&ListeningThread::run, this);
@@ -118,26 +138,36 @@ boost::thread & ListeningThread::thread()
 
 void ListeningThread::init()
 {
-  static int count = 0;
   m_mutex.lock();
 
+  if( m_blocking && m_wakeup_ready )
+  {
+    MPI_Irecv(nullptr, 0, MPI_CHAR, 0, 0, m_wakeup_comm, &m_wakeup_request);
+    m_wakeup_ready = false;
+  }
+
   std::map<Communicator, ListeningInfo*>::iterator it = m_comms.begin();
 
   // non-blocking receive on all communicators
-  for( ; it != m_comms.end() && m_listening ; ++it )
+  while( it != m_comms.end() && m_listening )
   {
     ListeningInfo * info = it->second;
 
-    if( info->ready )
+    if( info->removed )
     {
-      MPI_Request request;
-      info->request = request;
+      release(it++);
+      continue;
+    }
 
+    if( info->ready )
+    {
       MPI_Irecv(info->data, ListeningInfo::buffer_size(), MPI_CHAR,
-                    MPI_ANY_SOURCE, 0, it->first, &info->request);
+                    MPI_ANY_SOURCE, ListeningInfo::signal_tag(), it->first, &info->request);
 
       info->ready = false;
     }
+
+    ++it;
   }
 
   m_mutex.unlock();
@@ -150,18 +180,75 @@ void ListeningThread::run()
   while( m_listening )
   {
     this->init(); // initialize the listening process for comms that need it
-    this_thread::sleep( posix_time::milliseconds(m_sleep_duration) );
-    this->check_for_data(); // check if data arrived
+
+    if( m_blocking )
+    {
+      this->wait_for_data(); // returns when data arrived or the thread was woken up
+    }
+    else
+    {
+      this_thread::sleep( posix_time::milliseconds(m_sleep_duration) );
+      this->check_for_data(); // check if data arrived
+    }
   }
 }
 
 ////////////////////////////////////////////////////////////////////////////
 
-void ListeningThread::check_for_data()
+void ListeningThread::wait_for_data()
 {
+  std::vector<MPI_Request> requests;
+  std::vector<ListeningInfo*> infos;
+  std::vector<Communicator> comms;
+
   m_mutex.lock();
 
-  ExceptionManager::instance().ExceptionDumps = false;
+  requests.push_back( m_wakeup_request );
+  infos.push_back( nullptr );
+  comms.push_back( MPI_COMM_NULL );
+
+  std::map<Communicator, ListeningInfo*>::iterator it = m_comms.begin();
+
+  for( ; it != m_comms.end() ; ++it )
+  {
+    if( !it->second->ready && !it->second->removed )
+    {
+      requests.push_back( it->second->request );
+      infos.push_back( it->second );
+      comms.push_back( it->first );
+    }
+  }
+
+  m_mutex.unlock();
+
+  int index;
+  MPI_Status status;
+
+  // only this thread removes communicators, so the infos stay valid while waiting
+  MPI_Waitany( requests.size(), &requests[0], &index, &status );
+
+  if( index == 0 )
+  {
+    m_wakeup_ready = true;
+    return;
+  }
+
+  infos[index]->request = MPI_REQUEST_NULL;
+
+  if( m_listening && !infos[index]->removed )
+    process_message( comms[index], *infos[index], status );
+  else
+    infos[index]->ready = true;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+void ListeningThread::check_for_data()
+{
+  std::vector< std::pair<Communicator, ListeningInfo*> > arrived;
+  std::vector<MPI_Status> statuses;
+
+  m_mutex.lock();
 
   std::map<Communicator, ListeningInfo*>::iterator it = m_comms.begin();
 
@@ -170,33 +257,92 @@ void ListeningThread::check_for_data()
     ListeningInfo * info = it->second;
 
     // if the communicator is waiting for data
-    if( !info->ready )
+    if( !info->ready && !info->removed )
     {
       int flag;
+      MPI_Status status;
 
-      MPI_Test(&info->request, &flag, MPI_STATUS_IGNORE);
+      MPI_Test(&info->request, &flag, &status);
 
       // if data arrived, flag is not zero
       if( flag != 0 )
       {
-        try
-        {
-          boost::shared_ptr<XmlDoc> doc = XML::parse_cstring( info->data );
-
-          new_signal( it->first, doc );
-
-          info->ready = true; // ready to do another non-blocking receive
-        }
-        catch(XmlError & e)
-        {
-          CFerror << e.what() << CFendl;
-          m_listening = false;
-        }
+        arrived.push_back( std::make_pair(it->first, info) );
+        statuses.push_back( status );
       }
     }
   }
 
   m_mutex.unlock();
+
+  for( Uint i = 0 ; i != arrived.size() && m_listening ; ++i )
+    process_message( arrived[i].first, *arrived[i].second, statuses[i] );
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+void ListeningThread::process_message( Communicator comm, ListeningInfo & info, MPI_Status & status )
+{
+  ExceptionManager::instance().ExceptionDumps = false;
+
+  int count;
+  MPI_Get_count( &status, MPI_CHAR, &count );
+
+  const char * data = info.data;
+  Uint length = count;
+  Uint large_size;
+
+  if( ListeningInfo::is_large_signal_header(info.data, length, large_size) )
+  {
+    m_large_buffer.resize( large_size );
+    MPI_Recv( &m_large_buffer[0], large_size, MPI_CHAR, status.MPI_SOURCE,
+              ListeningInfo::large_signal_tag(), comm, MPI_STATUS_IGNORE );
+    data = &m_large_buffer[0];
+    length = large_size;
+  }
+
+  try
+  {
+    boost::shared_ptr<XmlDoc> doc = is_binary( data, length ) ? parse_binary( data, length ) : parse_cstring( data );
+
+    info.ready = true; // ready to do another non-blocking receive
+
+    new_signal( comm, doc );
+  }
+  catch(XmlError & e)
+  {
+    CFerror << e.what() << CFendl;
+    m_listening = false;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+void ListeningThread::release( std::map<Communicator, ListeningInfo*>::iterator it )
+{
+  ListeningInfo * info = it->second;
+
+  if( !info->ready )
+  {
+    MPI_Cancel( &info->request );
+    MPI_Wait( &info->request, MPI_STATUS_IGNORE );
+  }
+
+  delete info;
+  m_comms.erase(it);
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+void ListeningThread::wake_up()
+{
+  if( !m_blocking || m_wakeup_comm == MPI_COMM_NULL )
+    return;
+
+  // never waits, the thread may already have stopped
+  MPI_Request request;
+  MPI_Isend( nullptr, 0, MPI_CHAR, 0, 0, m_wakeup_comm, &request );
+  MPI_Request_free( &request );
 }
 
 ////////////////////////////////////////////////////////////////////////////
@@ -9,6 +9,9 @@
 
 ////////////////////////////////////////////////////////////////////////////////
 
+#include <map>
+#include <vector>
+
 // boost headers
 //#include <boost/asio/deadline_timer.hpp>
 #include <boost/signals2/signal.hpp>
@@ -17,6 +20,7 @@
 
 // CF headers
 #include "common/XML/XmlDoc.hpp"
+#include "common/PE/types.hpp"
 
 ////////////////////////////////////////////////////////////////////////////
 
@@ -40,23 +44,28 @@ namespace PE {
   /// be undefined. @n
 
   /// Internally, the thread makes a non-blocking MPI receive on all
-  /// communicators and then sleeps during some time (defined by the user).
-  /// When it wakes up, it checks all the communicators and, for each of them
-  /// that has new data, calls the @c new_signal signal; and then makes a new
-  /// non-blocking receive. @n
-
-  /// The fact that the thread sleeps is for performance reasons: it is to
-  /// avoid the code to run useless instruction and use not needed CPU time
-  /// while waiting. It is to the user to determine the best "sleeping time".
-  /// The default is 10 milliseconds. @n
-
-  /// However, be careful when defining this sleeping time. The biggest it is,
-  /// the longuest is the response time for requests. If the sleeping time is too
-  /// small, the CPU usage might be too high if no data arrives during a long time. @n
+  /// communicators and then waits until one of them receives data, with
+  /// @c MPI_Waitany. The thread thus wakes up as soon as a message arrives,
+  /// and does not use any CPU time while waiting. For each communicator
+  /// that has new data, the @c new_signal signal is called; and then a new
+  /// non-blocking receive is made. Adding or removing communicators and
+  /// stopping the listening wake the thread up through a message it sends
+  /// to itself. @n
+
+  /// Waiting in one thread while the other threads keep using MPI requires
+  /// MPI to be initialized with @c MPI_THREAD_MULTIPLE (see @c Comm::init()).
+  /// With a lower level of thread support, the thread falls back to polling:
+  /// it checks all communicators and then sleeps during some time
+  /// (defined by the user, 10 milliseconds by default). @n
+
+  /// Signals may be sent as text XML or in the binary form of
+  /// @c XML::to_binary(). Signals that do not fit in the receive buffer are
+  /// announced by a short header (see @c ListeningInfo) and follow in a second
+  /// message. @n
 
   /// New intercommunicators can be added on the run as well as the sleeping
   /// time can be modified. Thoes changes will be taken into account
-  /// at the next iteration (after the next check).
+  /// at the next iteration.
 
   /// @author Quentin Gasper
 
@@ -86,12 +95,12 @@ namespace PE {
 
     /// @brief Starts the listening process
 
-    /// If there is at least one communicator to listen to, the process has three
+    /// If there is at least one communicator to listen to, the process has two
     /// main steps:
     /// @li call Irecv (non-blocking receive) on ready communicators (new ones
     /// and those that just received data)
-    /// @li wait @c #m_waitingTime ms
-    /// @li call check all communicators for new data
+    /// @li wait until data arrives on one of the communicators (or, when polling,
+    /// wait @c #m_sleep_duration ms and check all communicators for new data)
     /// When new data arrived, @c #newFrame signal is emitted. @n
     /// This process is repeated as long as @c #stop_listening() is not called.
     /// If a new communicator is added, it will be taken in account on the next
@@ -108,10 +117,23 @@ namespace PE {
 
     void run();
 
+    /// Blocks until data arrives on a communicator or the thread is woken up
+    void wait_for_data();
+
+    /// Checks all communicators for new data, used when polling
     void check_for_data();
 
     void init();
 
+    /// Parses the received message and emits @c new_signal
+    void process_message( Communicator comm, ListeningInfo & info, MPI_Status & status );
+
+    /// Cancels the pending receive of the communicator and forgets it
+    void release( std::map<Communicator, ListeningInfo*>::iterator it );
+
+    /// Makes the thread return from @c wait_for_data()
+    void wake_up();
+
   private: // data
 
     /// @brief Communicators
@@ -127,6 +149,21 @@ namespace PE {
 
     Uint m_sleep_duration;
 
+    /// If @c true, the thread waits for data in @c MPI_Waitany, otherwise it polls
+    bool m_blocking;
+
+    /// Communicator on which the thread sends itself a message to wake up
+    Communicator m_wakeup_comm;
+
+    /// Receive of the wake-up message
+    MPI_Request m_wakeup_request;
+
+    /// Indicates whether the wake-up receive needs to be posted
+    bool m_wakeup_ready;
+
+    /// Buffer for signals larger than the receive buffer
+    std::vector<char> m_large_buffer;
+
     Communicator m_receivingAcksComm;
 
     boost::mutex m_mutex;
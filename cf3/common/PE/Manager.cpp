@@ -4,6 +4,8 @@
 // GNU Lesser General Public License version 3 (LGPLv3).
 // See doc/lgpl.txt and doc/gpl.txt for the license text.
 
+#include <cstring>
+
 #include <boost/thread/thread.hpp>
 #include <boost/assign/std/vector.hpp> // for 'operator+=()'
 
@@ -16,6 +18,7 @@
 #include "common/Builder.hpp"
 #include "common/LibCommon.hpp"
 #include "common/NotificationQueue.hpp"
+#include "common/OptionList.hpp"
 #include "common/OptionT.hpp"
 #include "common/OptionURI.hpp"
 #include "common/Signal.hpp"
@@ -24,6 +27,7 @@
 #include "common/XML/SignalOptions.hpp"
 
 #include "common/PE/Comm.hpp"
+#include "common/PE/ListeningInfo.hpp"
 #include "common/PE/ListeningThread.hpp"
 
 #include "common/PE/Manager.hpp"
@@ -46,12 +50,27 @@ common::ComponentBuilder < Manager, Component, LibCommon > Manager_Builder;
 
 ////////////////////////////////////////////////////////////////////////////
 
+namespace detail
+{
+  /// Prefix of the argument that spawn_group() gives to each worker
+  std::string forward_argument() { return "--forward="; }
+}
+
+////////////////////////////////////////////////////////////////////////////
+
 Manager::Manager ( const std::string & name )
-  : Component(name)
+  : Component(name),
+    m_binary_signals(true)
 {
   m_listener = new ListeningThread();
   m_queue = new NotificationQueue();
 
+  options().add("binary_signals", m_binary_signals)
+      .pretty_name("Binary Signals")
+      .description("Send signals to the other groups in binary form instead of as XML text. "
+                   "Both forms are always accepted on reception.")
+      .link_to(&m_binary_signals);
+
   if( Comm::instance().get_parent() != MPI_COMM_NULL )
   {
     m_groups["MPI_Parent"] = Comm::instance().get_parent();
@@ -209,6 +228,19 @@ void Manager::new_event ( SignalArgs & args )
 
 ////////////////////////////////////////////////////////////////////////////
 
+bool Manager::is_spawned_worker( int argc, char ** argv )
+{
+  const std::string forw = detail::forward_argument();
+  for( int i = 1 ; i < argc ; ++i )
+  {
+    if( std::strncmp( argv[i], forw.c_str(), forw.size() ) == 0 )
+      return true;
+  }
+  return false;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
 void Manager::spawn_group ( const std::string & name,
                                Uint nb_workers,
                                const char * command,
@@ -219,7 +251,7 @@ void Manager::spawn_group ( const std::string & name,
     throw ValueExists(FromHere(), "A group of name " + name + " already exists.");
 
   boost::filesystem::path path;
-  std::string forw = "--forward=" + forward;
+  std::string forw = detail::forward_argument() + forward;
 
   path = boost::filesystem::system_complete( command );
 
@@ -325,24 +357,45 @@ void Manager::broadcast ( const SignalArgs & args )
 void Manager::send_to ( Communicator comm, const SignalArgs &args )
 {
   std::string str;
-  char * buffer;
+  Uint size;
   int remote_size;
 
   cf3_assert( is_not_null(args.xml_doc) );
 
-  to_string( *args.xml_doc, str);
+  if( m_binary_signals )
+  {
+    to_binary( *args.xml_doc, str );
+    size = str.length();
+  }
+  else
+  {
+    to_string( *args.xml_doc, str );
+    size = str.length() + 1; // text is sent with its terminating null character
+  }
 
-  buffer = new char[ str.length() + 1 ];
-  std::strcpy( buffer, str.c_str() );
+  char * buffer = const_cast<char*>( str.c_str() );
 
   MPI_Comm_remote_size(comm, &remote_size);
 
 //  std::cout << "Worker[" << Comm::instance().rank() << "]" << " -> Sending " << buffer << std::endl;
 
-  for(int i = 0 ; i < remote_size ; ++i)
-    MPI_Send( buffer, str.length() + 1, MPI_CHAR, i, 0, comm );
+  if( size <= ListeningInfo::buffer_size() )
+  {
+    for(int i = 0 ; i < remote_size ; ++i)
+      MPI_Send( buffer, size, MPI_CHAR, i, ListeningInfo::signal_tag(), comm );
+  }
+  else
+  {
+    // announce the size, so the receiver can allocate a buffer for it
+    std::vector<char> header( ListeningInfo::large_signal_header_size() );
+    ListeningInfo::make_large_signal_header( size, &header[0] );
 
-  delete [] buffer;
+    for(int i = 0 ; i < remote_size ; ++i)
+    {
+      MPI_Send( &header[0], header.size(), MPI_CHAR, i, ListeningInfo::signal_tag(), comm );
+      MPI_Send( buffer, size, MPI_CHAR, i, ListeningInfo::large_signal_tag(), comm );
+    }
+  }
 }
 
 ////////////////////////////////////////////////////////////////////////////
@@ -42,6 +42,11 @@ public: // functions
                    const char * command, const std::string & forward = std::string(),
                    const char * hosts = nullptr);
 
+  /// Checks the command line of a process for the arguments given by @c spawn_group().
+  /// Can be called before MPI is initialized, to request the level of thread support
+  /// needed by the thread that listens to the parent.
+  static bool is_spawned_worker( int argc, char ** argv );
+
   void kill_group( const std::string & name );
 
   void kill_all();
@@ -102,6 +107,9 @@ private:
 
   common::NotificationQueue * m_queue;
 
+  /// Send signals in the binary form of XML::to_binary() rather than as text
+  bool m_binary_signals;
+
 }; // Manager
 
 /////////////////////////////////////////////////////////////////////////////////////////////
@@ -12,6 +12,7 @@
 #undef BOOST_MULTI_ARRAY_NO_GENERATORS
 
 #include "common/CF.hpp"
+#include "common/HugePages.hpp"
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -26,7 +27,7 @@ class Table;
 template <typename T>
 struct TableArray
 {
-  typedef boost::multi_array<T,2> type;
+  typedef boost::multi_array<T,2,HugePagesAllocator<T> > type;
 };
 
 
@@ -45,16 +46,16 @@ struct TableConstRow
 ////////////////////////////////////////////////////////////////////////////////
 
 template<typename T, typename list_type>
-boost::multi_array<T,2> table_array(const Uint rows, const Uint cols, const list_type& vec)
+typename TableArray<T>::type table_array(const Uint rows, const Uint cols, const list_type& vec)
 {
   cf3_assert(vec.size() == rows*cols);
-  boost::multi_array<T,2> array(boost::extents[rows][cols]);
+  typename TableArray<T>::type array(boost::extents[rows][cols]);
   array.assign(vec.begin(),vec.end());
   return array;
 }
 
 template<typename T, Uint ROWS, Uint COLS, typename list_type>
-boost::multi_array<T,2> table_array(const list_type& vec)
+typename TableArray<T>::type table_array(const list_type& vec)
 {
   return table_array<T>(ROWS,COLS,vec);
 }
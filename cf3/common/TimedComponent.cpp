@@ -98,6 +98,23 @@ void print_timing_tree(cf3::common::Component& root, const bool print_untimed, c
     }
   }
 
+  // Components that keep a workspace between calls count how often it had to be (re)allocated
+  if(root.properties().check("workspace_allocations"))
+  {
+    const Uint local_allocations = root.properties().value<Uint>("workspace_allocations");
+    if(PE::Comm::instance().is_active() && PE::Comm::instance().size() > 1)
+    {
+      Uint max_allocations;
+      PE::Comm::instance().all_reduce(PE::max(), &local_allocations, 1, &max_allocations);
+      if(PE::Comm::instance().rank() == 0)
+        std::cout << prefix << root.name() << ": workspace allocations: " << max_allocations << " (max over CPUs)\n";
+    }
+    else
+    {
+      std::cout << prefix << root.name() << ": workspace allocations: " << local_allocations << "\n";
+    }
+  }
+
   BOOST_FOREACH(Component& component, root)
   {
     print_timing_tree(component, print_untimed, prefix + "  ");
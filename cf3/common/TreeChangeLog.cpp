@@ -0,0 +1,124 @@
+// Copyright (C) 2010-2013 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#include <boost/thread/locks.hpp>
+
+#include "common/Component.hpp"
+#include "common/Core.hpp"
+#include "common/TreeChangeLog.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace common {
+
+////////////////////////////////////////////////////////////////////////////////
+
+TreeChangeLog& TreeChangeLog::instance()
+{
+  static TreeChangeLog change_log;
+  return change_log;
+}
+
+TreeChangeLog::TreeChangeLog() :
+  m_enabled(false),
+  m_revision(0),
+  m_capacity(10000)
+{
+}
+
+Uint TreeChangeLog::revision() const
+{
+  boost::lock_guard<boost::mutex> lock(m_mutex);
+  return m_revision;
+}
+
+bool TreeChangeLog::is_enabled() const
+{
+  boost::lock_guard<boost::mutex> lock(m_mutex);
+  return m_enabled;
+}
+
+void TreeChangeLog::enable()
+{
+  {
+    boost::lock_guard<boost::mutex> lock(m_mutex);
+    if(m_enabled)
+      return;
+    m_enabled = true;
+  }
+
+  // Option changes are only tracked while a client follows the changes, so processes without a client don't pay for it
+  Core::instance().root().attach_tree_change_recorder();
+}
+
+void TreeChangeLog::record(const ChangeType type, const std::string& path)
+{
+  boost::lock_guard<boost::mutex> lock(m_mutex);
+  if(!m_enabled)
+    return;
+
+  m_entries.push_back(Entry(type, path));
+  ++m_revision;
+  while(m_entries.size() > m_capacity)
+    m_entries.pop_front();
+}
+
+bool TreeChangeLog::changes_since(const Uint revision, ChangesT& changes) const
+{
+  changes.clear();
+
+  boost::lock_guard<boost::mutex> lock(m_mutex);
+  if(revision > m_revision)
+    return false;
+
+  const Uint nb_changes = m_revision - revision;
+  if(nb_changes > m_entries.size())
+    return false;
+
+  // Collapse the changes per path. A modification does not hide an addition, since an added component is sent completely.
+  for(std::deque<Entry>::const_iterator entry = m_entries.end() - nb_changes; entry != m_entries.end(); ++entry)
+  {
+    ChangesT::iterator it = changes.find(entry->path);
+    if(it == changes.end())
+      changes.insert(std::make_pair(entry->path, entry->type));
+    else if(!(entry->type == MODIFIED && it->second == ADDED))
+      it->second = entry->type;
+  }
+
+  // Drop everything that is below a path that is added or removed as a whole
+  for(ChangesT::iterator it = changes.begin(); it != changes.end();)
+  {
+    bool covered = false;
+    std::string::size_type sep = it->first.rfind('/');
+    while(sep != std::string::npos && sep != 0 && !covered)
+    {
+      ChangesT::const_iterator parent = changes.find(it->first.substr(0, sep));
+      covered = parent != changes.end() && parent->second != MODIFIED;
+      sep = it->first.rfind('/', sep-1);
+    }
+
+    if(covered)
+      changes.erase(it++);
+    else
+      ++it;
+  }
+
+  return true;
+}
+
+void TreeChangeLog::set_capacity(const Uint capacity)
+{
+  boost::lock_guard<boost::mutex> lock(m_mutex);
+  m_capacity = capacity;
+  while(m_entries.size() > m_capacity)
+    m_entries.pop_front();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // common
+} // cf3
@@ -0,0 +1,96 @@
+// Copyright (C) 2010-2013 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef cf3_common_TreeChangeLog_hpp
+#define cf3_common_TreeChangeLog_hpp
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <deque>
+#include <map>
+
+#include <boost/noncopyable.hpp>
+#include <boost/thread/mutex.hpp>
+
+#include "common/CommonAPI.hpp"
+#include "common/UUCount.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace common {
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Versioned log of the structural changes in the component tree.
+/// Each recorded change increments the revision, so a remote client that knows the revision
+/// it last synchronized with can ask for the changes since then instead of the complete tree.
+/// Only the most recent changes are kept. If a client is too far behind, it has to reload the complete tree.
+/// Nothing is recorded until a client asks for the changes for the first time, so processes without a remote client
+/// don't pay for it. Recording is thread-safe.
+class Common_API TreeChangeLog : public boost::noncopyable
+{
+public:
+
+  /// Kind of change
+  enum ChangeType { ADDED=0, REMOVED=1, MODIFIED=2 };
+
+  /// Changes, indexed by the path of the component
+  typedef std::map<std::string, ChangeType> ChangesT;
+
+  static TreeChangeLog& instance();
+
+  /// Current revision, 0 if nothing was recorded yet
+  Uint revision() const;
+
+  /// Identifies this log, so a client can detect that it is talking to a different process
+  const UUCount& id() const { return m_id; }
+
+  /// True once a client follows the changes. Callers should check this before building the path to record.
+  bool is_enabled() const;
+
+  /// Start recording changes. The first call attaches the recording of option changes to the components of the Core tree.
+  /// The client that enables the log needs to get the complete tree first.
+  void enable();
+
+  /// Record a change to the component at the given path. Does nothing if the log is not enabled.
+  void record(const ChangeType type, const std::string& path);
+
+  /// Collect the changes after the given revision, keeping only the last relevant change for each path and
+  /// dropping changes below a path that was added or removed as a whole.
+  /// @return false if the log does not go back to the requested revision
+  bool changes_since(const Uint revision, ChangesT& changes) const;
+
+  /// Maximum number of changes kept in the log
+  void set_capacity(const Uint capacity);
+
+private:
+  TreeChangeLog();
+
+  struct Entry
+  {
+    Entry(const ChangeType t, const std::string& p) : type(t), path(p) {}
+    ChangeType type;
+    std::string path;
+  };
+
+  UUCount m_id;
+  bool m_enabled;
+  Uint m_revision;
+  Uint m_capacity;
+  /// Recorded changes, the last one having revision m_revision
+  std::deque<Entry> m_entries;
+  mutable boost::mutex m_mutex;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // common
+} // cf3
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // cf3_common_TreeChangeLog_hpp
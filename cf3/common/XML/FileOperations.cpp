@@ -5,7 +5,10 @@
 // See doc/lgpl.txt and doc/gpl.txt for the license text.
 
 #include <cstdio>
+#include <cstring>
 #include <fstream>
+#include <map>
+#include <vector>
 
 #include "rapidxml/rapidxml_print.hpp" // includes rapidxml/rapidxml.hpp
 
@@ -119,6 +122,201 @@ void to_string ( const XmlNode& node, std::string& str )
 
 /////////////////////////////////////////////////////////////////////////////
 
+/////////////////////////////////////////////////////////////////////////////
+
+namespace detail
+{
+
+/// Magic number at the start of binary XML buffers. Text XML can not start with a zero byte.
+const char binary_magic[4] = { '\0', 'C', 'F', '1' };
+
+/// Writes binary XML. Strings are written once and referenced by index afterwards.
+struct BinaryWriter
+{
+  BinaryWriter(std::string& buffer) : out(buffer)
+  {
+  }
+
+  void write_uint(std::size_t value)
+  {
+    while(value >= 0x80)
+    {
+      out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+      value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+  }
+
+  void write_string(const char* str, const std::size_t size)
+  {
+    const std::string key(str, size);
+    std::map<std::string, std::size_t>::const_iterator it = string_indices.find(key);
+    if(it != string_indices.end())
+    {
+      write_uint(it->second + 1);
+      return;
+    }
+    const std::size_t index = string_indices.size();
+    string_indices[key] = index;
+    write_uint(0);
+    write_uint(size);
+    out.append(str, size);
+  }
+
+  void write_node(const rapidxml::xml_node<>& node)
+  {
+    out.push_back(static_cast<char>(node.type()));
+    write_string(node.name(), node.name_size());
+    write_string(node.value(), node.value_size());
+
+    std::size_t nb_attributes = 0;
+    for(rapidxml::xml_attribute<>* attr = node.first_attribute(); attr != nullptr; attr = attr->next_attribute())
+      ++nb_attributes;
+    write_uint(nb_attributes);
+    for(rapidxml::xml_attribute<>* attr = node.first_attribute(); attr != nullptr; attr = attr->next_attribute())
+    {
+      write_string(attr->name(), attr->name_size());
+      write_string(attr->value(), attr->value_size());
+    }
+
+    std::size_t nb_children = 0;
+    for(rapidxml::xml_node<>* child = node.first_node(); child != nullptr; child = child->next_sibling())
+      ++nb_children;
+    write_uint(nb_children);
+    for(rapidxml::xml_node<>* child = node.first_node(); child != nullptr; child = child->next_sibling())
+      write_node(*child);
+  }
+
+  std::string& out;
+  std::map<std::string, std::size_t> string_indices;
+};
+
+/// Reads binary XML into a rapidxml document. Strings are allocated once in the document and shared.
+struct BinaryReader
+{
+  BinaryReader(const char* data, const std::size_t length, rapidxml::xml_document<>& document) :
+    current(data),
+    end(data + length),
+    doc(document)
+  {
+  }
+
+  void check(const std::size_t size)
+  {
+    if(static_cast<std::size_t>(end - current) < size)
+      throw XmlError(FromHere(), "Truncated binary XML buffer");
+  }
+
+  std::size_t read_uint()
+  {
+    std::size_t value = 0;
+    for(Uint shift = 0; ; shift += 7)
+    {
+      // shifting by the width of the type or more is undefined
+      if(shift >= 8*sizeof(std::size_t))
+        throw XmlError(FromHere(), "Bad integer in binary XML buffer");
+      check(1);
+      const unsigned char byte = static_cast<unsigned char>(*current++);
+      value |= static_cast<std::size_t>(byte & 0x7F) << shift;
+      if(!(byte & 0x80))
+        return value;
+    }
+  }
+
+  /// Returns the string, its size is stored in size
+  char* read_string(std::size_t& size)
+  {
+    const std::size_t code = read_uint();
+    if(code != 0)
+    {
+      if(code > strings.size())
+        throw XmlError(FromHere(), "Bad string reference in binary XML buffer");
+      size = sizes[code-1];
+      return strings[code-1];
+    }
+
+    size = read_uint();
+    check(size);
+    char* str = doc.allocate_string(0, size + 1);
+    std::memcpy(str, current, size);
+    str[size] = '\0';
+    current += size;
+    strings.push_back(str);
+    sizes.push_back(size);
+    return str;
+  }
+
+  rapidxml::xml_node<>* read_node()
+  {
+    check(1);
+    const rapidxml::node_type type = static_cast<rapidxml::node_type>(*current++);
+    std::size_t name_size, value_size;
+    char* name = read_string(name_size);
+    char* value = read_string(value_size);
+    rapidxml::xml_node<>* node = type == rapidxml::node_document ? &doc : doc.allocate_node(type, name, value, name_size, value_size);
+
+    const std::size_t nb_attributes = read_uint();
+    for(std::size_t i = 0; i != nb_attributes; ++i)
+    {
+      char* attr_name = read_string(name_size);
+      char* attr_value = read_string(value_size);
+      node->append_attribute(doc.allocate_attribute(attr_name, attr_value, name_size, value_size));
+    }
+
+    const std::size_t nb_children = read_uint();
+    for(std::size_t i = 0; i != nb_children; ++i)
+      node->append_node(read_node());
+
+    return node;
+  }
+
+  const char* current;
+  const char* const end;
+  rapidxml::xml_document<>& doc;
+  std::vector<char*> strings;
+  std::vector<std::size_t> sizes;
+};
+
+} // detail
+
+/////////////////////////////////////////////////////////////////////////////
+
+void to_binary ( const XmlNode& node, std::string& buffer )
+{
+  cf3_assert( node.is_valid() );
+
+  buffer.assign(detail::binary_magic, sizeof(detail::binary_magic));
+  detail::BinaryWriter writer(buffer);
+  writer.write_node(*node.content);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+bool is_binary ( const char * data, std::size_t length )
+{
+  cf3_assert( is_not_null(data) );
+
+  return length >= sizeof(detail::binary_magic) && std::memcmp(data, detail::binary_magic, sizeof(detail::binary_magic)) == 0;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+boost::shared_ptr<XmlDoc> parse_binary ( const char * data, std::size_t length )
+{
+  if( !is_binary(data, length) )
+    throw XmlError(FromHere(), "Buffer does not contain binary XML");
+
+  std::auto_ptr< rapidxml::xml_document<> > xmldoc(new rapidxml::xml_document<>());
+  detail::BinaryReader reader(data + sizeof(detail::binary_magic), length - sizeof(detail::binary_magic), *xmldoc);
+
+  rapidxml::xml_node<>* root = reader.read_node();
+  if( root != xmldoc.get() )
+    xmldoc->append_node(root);
+
+  return boost::shared_ptr<XmlDoc>( new XmlDoc(xmldoc.release()) );
+}
+
+
 } // XML
 } // common
 } // cf3
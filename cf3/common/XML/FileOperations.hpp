@@ -46,6 +46,26 @@ void to_file ( const XmlNode& node, const URI& fpath);
 /// @param node The node to write.
 void to_string ( const XmlNode& node, std::string& str );
 
+/// Writes the provided XML node in a compact binary form, which is much cheaper to produce
+/// and to read back than the text form. Element and attribute names that occur more than once
+/// are only stored the first time. This is meant for transport between processes only, the text
+/// form remains the persistent one.
+/// @param node The node to write. If it is a document, all its child nodes are written.
+/// @param buffer The buffer to which the node is written. Existing contents are replaced.
+void to_binary ( const XmlNode& node, std::string& buffer );
+
+/// Checks if a buffer holds the output of to_binary().
+/// @param data The buffer, cannot be null.
+/// @param length The length of the buffer
+bool is_binary ( const char * data, std::size_t length );
+
+/// Rebuilds an XML document from the output of to_binary().
+/// @param data The buffer, cannot be null.
+/// @param length The length of the buffer
+/// @return Returns a shared pointer with the built XML document.
+/// @throw XmlError If the buffer is not a valid binary XML document.
+boost::shared_ptr<XmlDoc> parse_binary ( const char * data, std::size_t length );
+
 } // XML
 } // common
 } // cf3
@@ -31,7 +31,7 @@ namespace XML {
 ////////////////////////////////////////////////////////////////////////////
 
 XmlNode add_multi_array_in( Map & map, const std::string & name,
-                            const boost::multi_array<Real, 2> & array,
+                            const TableArray<Real>::type & array,
                             const std::string & delimiter,
                             const std::vector<std::string> & labels )
 {
@@ -84,7 +84,7 @@ XmlNode add_multi_array_in( Map & map, const std::string & name,
 ////////////////////////////////////////////////////////////////////////////
 
 void get_multi_array( const Map & map, const std::string & name,
-                          boost::multi_array<Real, 2> & array,
+                          TableArray<Real>::type & array,
                           std::vector<std::string> & labels )
 {
   cf3_assert( map.content.is_valid() );
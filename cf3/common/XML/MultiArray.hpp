@@ -10,6 +10,7 @@
 ////////////////////////////////////////////////////////////////////////////
 
 #include "common/BoostArray.hpp"
+#include "common/Table_fwd.hpp"
 
 #include "common/XML/Map.hpp"
 
@@ -23,12 +24,12 @@ namespace XML {
 
 /// Adds a multi array in the provided @c Map
 XmlNode add_multi_array_in(Map & map, const std::string & name,
-                           const boost::multi_array<Real, 2> & array,
+                           const TableArray<Real>::type & array,
                            const std::string & delimiter = ";",
                            const std::vector<std::string> & labels = std::vector<std::string>());
 
 void get_multi_array(const Map & map, const std::string & name,
-                         boost::multi_array<Real, 2> & array,
+                         TableArray<Real>::type & array,
                          std::vector<std::string> & labels);
 
 ////////////////////////////////////////////////////////////////////////////
@@ -133,7 +133,7 @@ public:
   void reset(Real reset_to=0.) { cf3_assert(m_is_created); }
 
   /// Copies the contents out of the LSS::Vector to table.
-  void get( boost::multi_array<Real, 2>& data)
+  void get( common::TableArray<Real>::type& data)
   {
     cf3_assert(m_is_created);
     cf3_assert(data.shape()[0]==m_blockrow_size);
@@ -144,7 +144,7 @@ public:
   }
 
   /// Copies the contents of the table into the LSS::Vector.
-  void set( boost::multi_array<Real, 2>& data)
+  void set( common::TableArray<Real>::type& data)
   {
     cf3_assert(m_is_created);
     cf3_assert(data.shape()[0]==m_blockrow_size);
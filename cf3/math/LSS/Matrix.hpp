@@ -12,6 +12,7 @@
 #include <boost/utility.hpp>
 
 #include "math/LSS/LibLSS.hpp"
+#include "common/Assertions.hpp"
 #include "common/PE/CommPattern.hpp"
 #include "common/Log.hpp"
 #include "math/LSS/BlockAccumulator.hpp"
@@ -110,6 +111,30 @@ public:
   /// Add one line to another and tie to it via dirichlet-style (applying periodicity)
   virtual void tie_blockrow_pairs (const Uint iblockrow_to, const Uint iblockrow_from) = 0;
 
+  /// Set a list of rows, numbered as iblockrow*neq+ieq, diagonal and off-diagonals values separately (dirichlet-type boundaries)
+  /// The default implementation calls set_row for each row.
+  virtual void set_rows(const std::vector<Uint>& rows, const Real diagval, const Real offdiagval)
+  {
+    const Uint nb_eq = neq();
+    const Uint nb_rows = rows.size();
+    for(Uint i = 0; i != nb_rows; ++i)
+      set_row(rows[i] / nb_eq, rows[i] % nb_eq, diagval, offdiagval);
+  }
+
+  /// Apply dirichlet boundary conditions to a list of distinct rows, numbered as iblockrow*neq+ieq, preserving symmetry.
+  /// Implementations may cache the position of the eliminated entries for a given list of rows, since the same
+  /// list is usually applied after every assembly. The default implementation calls symmetric_dirichlet for each row.
+  /// @pre The matrix must be structurally symmetric
+  /// @pre Once the conditions are applied, the matrix values may only be changed again after a reset()
+  virtual void symmetric_dirichlet_rows(const std::vector<Uint>& rows, const std::vector<Real>& values, LSS::Vector& rhs)
+  {
+    cf3_assert(rows.size() == values.size());
+    const Uint nb_eq = neq();
+    const Uint nb_rows = rows.size();
+    for(Uint i = 0; i != nb_rows; ++i)
+      symmetric_dirichlet(rows[i] / nb_eq, rows[i] % nb_eq, values[i], rhs);
+  }
+
   /// Set the diagonal
   virtual void set_diagonal(const std::vector<Real>& diag) = 0;
 
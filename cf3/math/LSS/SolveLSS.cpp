@@ -4,10 +4,13 @@
 // GNU Lesser General Public License version 3 (LGPLv3).
 // See doc/lgpl.txt and doc/gpl.txt for the license text.
 
+#include <boost/bind.hpp>
+
 #include "common/OptionList.hpp"
 #include "common/PropertyList.hpp"
 #include "common/Builder.hpp"
 
+#include "math/LSS/SolutionStrategy.hpp"
 #include "math/LSS/System.hpp"
 
 #include "SolveLSS.hpp"
@@ -23,7 +26,8 @@ common::ComponentBuilder < SolveLSS, common::Action, LibLSS > SolveLSS_Builder;
 ////////////////////////////////////////////////////////////////////////////////
 
 SolveLSS::SolveLSS( const std::string& name  ) :
-  Action ( name )
+  Action ( name ),
+  m_mixed_precision(false)
 {
   mark_basic();
 
@@ -37,6 +41,15 @@ SolveLSS::SolveLSS( const std::string& name  ) :
       .pretty_name("LSS")
       .mark_basic()
       .link_to(&m_lss);
+
+  options().add("mixed_precision", m_mixed_precision)
+      .description("Solve using single precision inner iterations with double precision iterative refinement (cf3.math.LSS.MixedPrecisionStrategy), "
+                   "instead of the solution strategy of the LSS. Setting this to true creates the strategy as child MixedPrecisionStrategy, where its options can be set, "
+                   "and setting it to false removes it again. Note that the inner GMRES is preconditioned with its own block-Jacobi ILU(0), "
+                   "not with the preconditioner configured for the LSS, so timings against the LSS strategy don't compare like with like.")
+      .pretty_name("Mixed Precision")
+      .link_to(&m_mixed_precision)
+      .attach_trigger(boost::bind(&SolveLSS::trigger_mixed_precision, this));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -51,7 +64,33 @@ void SolveLSS::execute ()
   if(!lss.is_created())
     throw SetupError(FromHere(), "LSS at " + lss.uri().string() + " is not created!");
 
-  lss.solve();
+  if(!m_mixed_precision)
+  {
+    lss.solve();
+    return;
+  }
+
+  // The LSS may have been recreated since the last solve
+  m_mixed_precision_strategy->set_matrix(lss.matrix());
+  m_mixed_precision_strategy->set_rhs(lss.rhs());
+  m_mixed_precision_strategy->set_solution(lss.solution());
+  m_mixed_precision_strategy->solve();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void SolveLSS::trigger_mixed_precision()
+{
+  if(m_mixed_precision && is_null(m_mixed_precision_strategy))
+  {
+    m_mixed_precision_strategy = create_component<SolutionStrategy>("MixedPrecisionStrategy", "cf3.math.LSS.MixedPrecisionStrategy");
+    m_mixed_precision_strategy->mark_basic();
+  }
+  else if(!m_mixed_precision && is_not_null(m_mixed_precision_strategy))
+  {
+    remove_component(*m_mixed_precision_strategy);
+    m_mixed_precision_strategy = Handle<SolutionStrategy>();
+  }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
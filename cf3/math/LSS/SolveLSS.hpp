@@ -18,6 +18,7 @@ namespace math {
 namespace LSS {
 
 class System;
+class SolutionStrategy;
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -38,7 +39,15 @@ public: // functions
   void execute();
 
 private:
+  /// Create or remove the mixed precision strategy
+  void trigger_mixed_precision();
+
   Handle<math::LSS::System> m_lss;
+
+  /// Use the mixed precision strategy instead of the strategy of the LSS
+  bool m_mixed_precision;
+  /// Mixed precision strategy, present while m_mixed_precision is true
+  Handle<SolutionStrategy> m_mixed_precision_strategy;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
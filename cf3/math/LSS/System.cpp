@@ -5,6 +5,7 @@
 // See doc/lgpl.txt and doc/gpl.txt for the license text.
 
 #include <fstream>
+#include <map>
 
 #include <boost/utility.hpp>
 
@@ -48,7 +49,8 @@ using namespace cf3::math;
 common::ComponentBuilder < LSS::System, LSS::System, LSS::LibLSS > System_Builder;
 
 LSS::System::System(const std::string& name) :
-  Component(name)
+  Component(name),
+  m_constraint_batch_depth(0)
 {
   options().add( "matrix_builder" , "cf3.math.LSS.TrilinosFEVbrMatrix")
     .pretty_name("Matrix Builder")
@@ -241,6 +243,22 @@ void LSS::System::dirichlet(const Uint iblockrow, const Uint ieq, const Real val
 {
   cf3_assert(is_created());
 
+  if(m_constraint_batch_depth != 0)
+  {
+    const Uint row = iblockrow*m_mat->neq()+ieq;
+    if(preserve_symmetry)
+    {
+      m_batch_symmetric_dirichlet_rows.push_back(row);
+      m_batch_symmetric_dirichlet_values.push_back(value);
+    }
+    else
+    {
+      m_batch_dirichlet_rows.push_back(row);
+      m_batch_dirichlet_values.push_back(value);
+    }
+    return;
+  }
+
   if (preserve_symmetry)
   {
     m_mat->symmetric_dirichlet(iblockrow, ieq, value, *m_rhs);
@@ -259,6 +277,14 @@ void LSS::System::dirichlet(const Uint iblockrow, const Uint ieq, const Real val
 void LSS::System::periodicity (const Uint iblockrow_to, const Uint iblockrow_from)
 {
   cf3_assert(is_created());
+
+  if(m_constraint_batch_depth != 0)
+  {
+    m_batch_periodic_to.push_back(iblockrow_to);
+    m_batch_periodic_from.push_back(iblockrow_from);
+    return;
+  }
+
   LSS::BlockAccumulator ba;
   const int neq=m_mat->neq();
   ba.resize(2,neq);
@@ -283,6 +309,122 @@ void LSS::System::periodicity (const Uint iblockrow_to, const Uint iblockrow_fro
 
 ////////////////////////////////////////////////////////////////////////////////////////////
 
+void LSS::System::dirichlet(const std::vector<Uint>& rows, const std::vector<Real>& values, const bool preserve_symmetry)
+{
+  cf3_assert(is_created());
+  cf3_assert(rows.size() == values.size());
+
+  if(m_constraint_batch_depth != 0)
+  {
+    std::vector<Uint>& batch_rows = preserve_symmetry ? m_batch_symmetric_dirichlet_rows : m_batch_dirichlet_rows;
+    std::vector<Real>& batch_values = preserve_symmetry ? m_batch_symmetric_dirichlet_values : m_batch_dirichlet_values;
+    batch_rows.insert(batch_rows.end(), rows.begin(), rows.end());
+    batch_values.insert(batch_values.end(), values.begin(), values.end());
+    return;
+  }
+
+  // Rows shared by several boundary regions are only constrained once, with the last value.
+  // The map also sorts the rows, so the same boundary gives the same row list on every call.
+  std::map<Uint, Real> row_values;
+  const Uint nb_constraints = rows.size();
+  for(Uint i = 0; i != nb_constraints; ++i)
+    row_values[rows[i]] = values[i];
+
+  std::vector<Uint> unique_rows; unique_rows.reserve(row_values.size());
+  std::vector<Real> unique_values; unique_values.reserve(row_values.size());
+  for(std::map<Uint, Real>::const_iterator it = row_values.begin(); it != row_values.end(); ++it)
+  {
+    unique_rows.push_back(it->first);
+    unique_values.push_back(it->second);
+  }
+
+  if(preserve_symmetry)
+  {
+    m_mat->symmetric_dirichlet_rows(unique_rows, unique_values, *m_rhs);
+  }
+  else
+  {
+    m_mat->set_rows(unique_rows, 1., 0.);
+    for(Uint i = 0; i != unique_rows.size(); ++i)
+      m_rhs->set_value(unique_rows[i], unique_values[i]);
+  }
+
+  for(Uint i = 0; i != unique_rows.size(); ++i)
+    m_sol->set_value(unique_rows[i], unique_values[i]);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void LSS::System::periodicity(const std::vector<Uint>& iblockrows_to, const std::vector<Uint>& iblockrows_from)
+{
+  cf3_assert(is_created());
+  cf3_assert(iblockrows_to.size() == iblockrows_from.size());
+
+  if(m_constraint_batch_depth != 0)
+  {
+    m_batch_periodic_to.insert(m_batch_periodic_to.end(), iblockrows_to.begin(), iblockrows_to.end());
+    m_batch_periodic_from.insert(m_batch_periodic_from.end(), iblockrows_from.begin(), iblockrows_from.end());
+    return;
+  }
+
+  // Same as the single pair version, reusing one accumulator
+  LSS::BlockAccumulator ba;
+  const int neq=m_mat->neq();
+  ba.resize(2,neq);
+  const Uint nb_pairs = iblockrows_to.size();
+  for(Uint p = 0; p != nb_pairs; ++p)
+  {
+    ba.indices[0]=iblockrows_to[p];
+    ba.indices[1]=iblockrows_from[p];
+    m_mat->tie_blockrow_pairs(iblockrows_to[p],iblockrows_from[p]);
+    m_rhs->get_rhs_values(ba);
+    m_sol->get_sol_values(ba);
+    for (int i=0; i<neq; i++)
+    {
+      ba.rhs[i]+=ba.rhs[neq+i];
+      ba.rhs[neq+i]=0.;
+      ba.sol[neq+i]=0.5*(ba.sol[i]+ba.sol[neq+i]);
+      ba.sol[i]=ba.sol[neq+i];
+    }
+    m_rhs->set_rhs_values(ba);
+    m_sol->set_sol_values(ba);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void LSS::System::begin_constraint_batch()
+{
+  ++m_constraint_batch_depth;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void LSS::System::end_constraint_batch()
+{
+  cf3_assert(m_constraint_batch_depth != 0);
+  if(--m_constraint_batch_depth != 0)
+    return;
+
+  std::vector<Uint> periodic_to, periodic_from, dirichlet_rows, symmetric_dirichlet_rows;
+  std::vector<Real> dirichlet_values, symmetric_dirichlet_values;
+  periodic_to.swap(m_batch_periodic_to);
+  periodic_from.swap(m_batch_periodic_from);
+  dirichlet_rows.swap(m_batch_dirichlet_rows);
+  dirichlet_values.swap(m_batch_dirichlet_values);
+  symmetric_dirichlet_rows.swap(m_batch_symmetric_dirichlet_rows);
+  symmetric_dirichlet_values.swap(m_batch_symmetric_dirichlet_values);
+
+  if(!periodic_to.empty())
+    periodicity(periodic_to, periodic_from);
+  if(!dirichlet_rows.empty())
+    dirichlet(dirichlet_rows, dirichlet_values, false);
+  if(!symmetric_dirichlet_rows.empty())
+    dirichlet(symmetric_dirichlet_rows, symmetric_dirichlet_values, true);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
 void LSS::System::set_diagonal(const std::vector<Real>& diag)
 {
   cf3_assert(is_created());
@@ -115,6 +115,20 @@ public:
   /// Note that only structural symmetry can be preserved (again, if sparsity input was symmetric).
   void periodicity (const Uint iblockrow_to, const Uint iblockrow_from);
 
+  /// Apply dirichlet-type boundary conditions to a list of rows at once. Rows are numbered as iblockrow*neq+ieq.
+  /// If a row appears more than once, the last value is used.
+  void dirichlet(const std::vector<Uint>& rows, const std::vector<Real>& values, const bool preserve_symmetry=false);
+
+  /// Apply periodicity to a list of block row pairs
+  void periodicity(const std::vector<Uint>& iblockrows_to, const std::vector<Uint>& iblockrows_from);
+
+  /// Collect the dirichlet and periodicity calls that follow instead of applying them immediately, so end_constraint_batch
+  /// can apply them in a single pass. Batches can be nested, only the outermost end_constraint_batch applies the constraints.
+  void begin_constraint_batch();
+
+  /// Apply the constraints collected since begin_constraint_batch: periodicity first, then the dirichlet conditions.
+  void end_constraint_batch();
+
   /// Set the diagonal
   void set_diagonal(const std::vector<Real>& diag);
 
@@ -185,6 +199,17 @@ private:
   /// Strategy for the solution
   Handle<LSS::SolutionStrategy> m_solution_strategy;
 
+  /// Nesting depth of begin_constraint_batch calls
+  Uint m_constraint_batch_depth;
+
+  /// Constraints collected in the current batch
+  std::vector<Uint> m_batch_dirichlet_rows;
+  std::vector<Real> m_batch_dirichlet_values;
+  std::vector<Uint> m_batch_symmetric_dirichlet_rows;
+  std::vector<Real> m_batch_symmetric_dirichlet_values;
+  std::vector<Uint> m_batch_periodic_to;
+  std::vector<Uint> m_batch_periodic_from;
+
 }; // end of class System
 
 ////////////////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,621 @@
+// Copyright (C) 2010-2013 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "Epetra_Comm.h"
+#include "Epetra_Import.h"
+#include "Epetra_Map.h"
+#include "Epetra_RowMatrix.h"
+#include "Epetra_Vector.h"
+
+#include "Teuchos_RCP.hpp"
+
+#include "Thyra_EpetraThyraWrappers.hpp"
+#include "Thyra_LinearOpBase.hpp"
+
+#include "common/Builder.hpp"
+#include "common/Log.hpp"
+#include "common/OptionList.hpp"
+#include "common/PropertyList.hpp"
+
+#include "MixedPrecisionStrategy.hpp"
+#include "ThyraOperator.hpp"
+#include "TrilinosVector.hpp"
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace math {
+namespace LSS {
+
+common::ComponentBuilder<MixedPrecisionStrategy, SolutionStrategy, LibLSS> MixedPrecisionStrategy_builder;
+
+struct MixedPrecisionStrategy::Implementation
+{
+  typedef std::vector<float> FloatVectorT;
+
+  Implementation(common::Component& self) :
+    m_self(self),
+    m_operator(0),
+    m_tolerance(1e-8),
+    m_max_refinements(20),
+    m_inner_tolerance(1e-3),
+    m_max_inner_iterations(500),
+    m_restart(30),
+    m_residual(-1.),
+    m_pattern_valid(false),
+    m_pattern_restart(0)
+  {
+    m_self.options().add("tolerance", m_tolerance)
+      .pretty_name("Tolerance")
+      .description("Relative residual norm at which the iterative refinement stops")
+      .link_to(&m_tolerance)
+      .mark_basic();
+
+    m_self.options().add("max_refinements", m_max_refinements)
+      .pretty_name("Max Refinements")
+      .description("Maximum number of double precision refinement steps")
+      .link_to(&m_max_refinements)
+      .mark_basic();
+
+    m_self.options().add("inner_tolerance", m_inner_tolerance)
+      .pretty_name("Inner Tolerance")
+      .description("Relative residual reduction requested from each single precision GMRES solve. Values much below 1e-6 can not be reached in single precision.")
+      .link_to(&m_inner_tolerance)
+      .mark_basic();
+
+    m_self.options().add("max_inner_iterations", m_max_inner_iterations)
+      .pretty_name("Max Inner Iterations")
+      .description("Maximum number of GMRES iterations for each refinement step")
+      .link_to(&m_max_inner_iterations);
+
+    m_self.options().add("restart", m_restart)
+      .pretty_name("Restart")
+      .description("Krylov subspace size after which GMRES restarts")
+      .link_to(&m_restart);
+
+    m_self.properties().add("iteration_count", 0u);
+    m_self.properties().add("refinements", 0u);
+    m_self.properties().add("residual", -1.);
+    m_self.properties().add("workspace_allocations", 0u);
+  }
+
+  /// Check the system and update the single precision copy of the matrix and its factorization.
+  /// The pattern and the work vectors are only rebuilt when the matrix, its sparsity pattern or the restart length changed.
+  void setup()
+  {
+    if(is_null(m_matrix) || m_operator == 0)
+      throw common::SetupError(FromHere(), "Null or non-Trilinos matrix for " + m_self.uri().path());
+
+    if(is_null(m_rhs))
+      throw common::SetupError(FromHere(), "Null RHS for " + m_self.uri().path());
+
+    if(is_null(m_solution))
+      throw common::SetupError(FromHere(), "Null solution vector for " + m_self.uri().path());
+
+    Teuchos::RCP<Epetra_RowMatrix> row_matrix = Teuchos::rcp_dynamic_cast<Epetra_RowMatrix>(Thyra::get_Epetra_Operator(*m_operator->thyra_operator()));
+    if(row_matrix.is_null())
+      throw common::SetupError(FromHere(), "Matrix " + m_matrix->uri().path() + " does not provide row access, as needed by " + m_self.uri().path());
+
+    if(row_matrix.get() != m_row_matrix.get())
+      m_pattern_valid = false;
+    m_row_matrix = row_matrix;
+
+    if(!m_pattern_valid || m_pattern_restart != std::max(m_restart, 1u))
+      setup_pattern();
+
+    if(!setup_values())
+    {
+      setup_pattern();
+      setup_values();
+    }
+  }
+
+  /// Build the sparsity pattern of the single precision copy and of the ILU(0) factors, and allocate all work vectors
+  void setup_pattern()
+  {
+    const Epetra_RowMatrix& A = *m_row_matrix;
+    if(!A.OperatorDomainMap().SameAs(A.RowMatrixRowMap()))
+      throw common::NotImplemented(FromHere(), "Mixed precision solve requires the same row and domain distribution for matrix " + m_matrix->uri().path());
+
+    const int nb_rows = A.NumMyRows();
+    const int nb_cols = A.NumMyCols();
+
+    // Pattern of the local rows
+    const int max_entries = A.MaxNumEntries();
+    m_row_values.resize(std::max(max_entries, 1));
+    m_row_indices.resize(std::max(max_entries, 1));
+    m_row_ptr.resize(nb_rows+1);
+    m_columns.clear();
+    m_columns.reserve(A.NumMyNonzeros());
+    m_row_ptr[0] = 0;
+    for(int i = 0; i != nb_rows; ++i)
+    {
+      int nb_entries = 0;
+      A.ExtractMyRowCopy(i, max_entries, nb_entries, &m_row_values[0], &m_row_indices[0]);
+      m_columns.insert(m_columns.end(), m_row_indices.begin(), m_row_indices.begin() + nb_entries);
+      m_row_ptr[i+1] = m_columns.size();
+    }
+    m_values.resize(m_columns.size());
+
+    // Local row index of each column, -1 for ghost columns
+    std::vector<int> column_row(nb_cols);
+    for(int c = 0; c != nb_cols; ++c)
+      column_row[c] = A.RowMatrixRowMap().LID(A.RowMatrixColMap().GID(c));
+
+    // Pattern of the block-Jacobi part, with sorted columns, and the position of each entry in m_values
+    std::vector< std::pair<int, int> > row_entries;
+    m_ilu_ptr.resize(nb_rows+1);
+    m_ilu_diagonal.resize(nb_rows);
+    m_ilu_columns.clear();
+    m_ilu_source.clear();
+    m_ilu_ptr[0] = 0;
+    for(int i = 0; i != nb_rows; ++i)
+    {
+      row_entries.clear();
+      bool has_diagonal = false;
+      for(int p = m_row_ptr[i]; p != m_row_ptr[i+1]; ++p)
+      {
+        const int row = column_row[m_columns[p]];
+        if(row < 0)
+          continue;
+        row_entries.push_back(std::make_pair(row, p));
+        has_diagonal = has_diagonal || row == i;
+      }
+      if(!has_diagonal)
+        row_entries.push_back(std::make_pair(i, -1));
+      std::sort(row_entries.begin(), row_entries.end());
+      for(Uint j = 0; j != row_entries.size(); ++j)
+      {
+        if(row_entries[j].first == i)
+          m_ilu_diagonal[i] = m_ilu_columns.size();
+        m_ilu_columns.push_back(row_entries[j].first);
+        m_ilu_source.push_back(row_entries[j].second);
+      }
+      m_ilu_ptr[i+1] = m_ilu_columns.size();
+    }
+    m_ilu_values.resize(m_ilu_columns.size());
+    m_ilu_position.assign(nb_rows, -1);
+
+    // Work vectors
+    m_columns_vector.resize(nb_cols);
+    if(A.RowMatrixImporter() != 0)
+    {
+      m_domain_work.reset(new Epetra_Vector(A.OperatorDomainMap()));
+      m_column_work.reset(new Epetra_Vector(A.RowMatrixColMap()));
+    }
+    else
+    {
+      m_domain_work.reset();
+      m_column_work.reset();
+    }
+    m_residual_work.reset(new Epetra_Vector(A.OperatorRangeMap()));
+    const Uint restart = std::max(m_restart, 1u);
+    m_krylov_basis.resize(restart+1);
+    for(Uint i = 0; i != restart+1; ++i)
+      m_krylov_basis[i].resize(nb_rows);
+    m_hessenberg.resize((restart+1)*restart);
+    m_cs.resize(restart);
+    m_sn.resize(restart);
+    m_g.resize(restart+1);
+    m_y.resize(restart);
+    m_rhs_float.resize(nb_rows);
+    m_correction.resize(nb_rows);
+    m_work.resize(nb_rows);
+    m_preconditioned.resize(nb_rows);
+
+    m_pattern_restart = restart;
+    m_pattern_valid = true;
+    m_self.properties()["workspace_allocations"] = m_self.properties().value<Uint>("workspace_allocations") + 1u;
+  }
+
+  /// Copy the values of the matrix to single precision and compute the ILU(0) factorization of the part that couples local rows.
+  /// @return false if the pattern of the matrix no longer matches the stored pattern
+  bool setup_values()
+  {
+    const Epetra_RowMatrix& A = *m_row_matrix;
+    const int nb_rows = m_row_ptr.size() - 1;
+    const int max_entries = m_row_values.size();
+    if(A.NumMyRows() != nb_rows || A.NumMyNonzeros() != static_cast<int>(m_columns.size()) || A.MaxNumEntries() > max_entries)
+      return false;
+
+    for(int i = 0; i != nb_rows; ++i)
+    {
+      int nb_entries = 0;
+      A.ExtractMyRowCopy(i, max_entries, nb_entries, &m_row_values[0], &m_row_indices[0]);
+      if(nb_entries != m_row_ptr[i+1] - m_row_ptr[i])
+        return false;
+      for(int j = 0; j != nb_entries; ++j)
+      {
+        const int p = m_row_ptr[i] + j;
+        if(m_row_indices[j] != m_columns[p])
+          return false;
+        m_values[p] = static_cast<float>(m_row_values[j]);
+      }
+    }
+
+    const Uint nb_ilu_entries = m_ilu_values.size();
+    for(Uint p = 0; p != nb_ilu_entries; ++p)
+      m_ilu_values[p] = m_ilu_source[p] < 0 ? 0.f : m_values[m_ilu_source[p]];
+
+    // ILU(0) factorization, in place. Zero pivots are replaced by one, which keeps the preconditioner defined for singular local blocks
+    std::vector<int>& position = m_ilu_position;
+    for(int i = 0; i != nb_rows; ++i)
+    {
+      for(int p = m_ilu_ptr[i]; p != m_ilu_ptr[i+1]; ++p)
+        position[m_ilu_columns[p]] = p;
+
+      for(int p = m_ilu_ptr[i]; p != m_ilu_diagonal[i]; ++p)
+      {
+        const int k = m_ilu_columns[p];
+        m_ilu_values[p] /= m_ilu_values[m_ilu_diagonal[k]];
+        const float l_ik = m_ilu_values[p];
+        for(int q = m_ilu_diagonal[k]+1; q != m_ilu_ptr[k+1]; ++q)
+        {
+          const int pos = position[m_ilu_columns[q]];
+          if(pos >= 0)
+            m_ilu_values[pos] -= l_ik * m_ilu_values[q];
+        }
+      }
+
+      if(m_ilu_values[m_ilu_diagonal[i]] == 0.f)
+        m_ilu_values[m_ilu_diagonal[i]] = 1.f;
+
+      for(int p = m_ilu_ptr[i]; p != m_ilu_ptr[i+1]; ++p)
+        position[m_ilu_columns[p]] = -1;
+    }
+
+    return true;
+  }
+
+  /// y = A x, in single precision. Ghost values are exchanged through the double precision import of the matrix.
+  void apply_matrix(const FloatVectorT& x, FloatVectorT& y)
+  {
+    const int nb_rows = m_row_ptr.size() - 1;
+    const float* x_columns = x.empty() ? 0 : &x[0];
+    if(is_not_null(m_domain_work.get()))
+    {
+      for(int i = 0; i != nb_rows; ++i)
+        (*m_domain_work)[i] = x[i];
+      m_column_work->Import(*m_domain_work, *m_row_matrix->RowMatrixImporter(), Insert);
+      const int nb_cols = m_columns_vector.size();
+      for(int c = 0; c != nb_cols; ++c)
+        m_columns_vector[c] = static_cast<float>((*m_column_work)[c]);
+      x_columns = m_columns_vector.empty() ? 0 : &m_columns_vector[0];
+    }
+
+    for(int i = 0; i != nb_rows; ++i)
+    {
+      float sum = 0.f;
+      for(int p = m_row_ptr[i]; p != m_row_ptr[i+1]; ++p)
+        sum += m_values[p] * x_columns[m_columns[p]];
+      y[i] = sum;
+    }
+  }
+
+  /// z = (LU)^-1 r
+  void apply_preconditioner(const FloatVectorT& r, FloatVectorT& z)
+  {
+    const int nb_rows = m_ilu_diagonal.size();
+    for(int i = 0; i != nb_rows; ++i)
+    {
+      float sum = r[i];
+      for(int p = m_ilu_ptr[i]; p != m_ilu_diagonal[i]; ++p)
+        sum -= m_ilu_values[p] * z[m_ilu_columns[p]];
+      z[i] = sum;
+    }
+    for(int i = nb_rows-1; i >= 0; --i)
+    {
+      float sum = z[i];
+      for(int p = m_ilu_diagonal[i]+1; p != m_ilu_ptr[i+1]; ++p)
+        sum -= m_ilu_values[p] * z[m_ilu_columns[p]];
+      z[i] = sum / m_ilu_values[m_ilu_diagonal[i]];
+    }
+  }
+
+  /// Global dot product, accumulated in double precision
+  Real dot(const FloatVectorT& a, const FloatVectorT& b)
+  {
+    Real local = 0.;
+    const Uint n = a.size();
+    for(Uint i = 0; i != n; ++i)
+      local += static_cast<Real>(a[i]) * static_cast<Real>(b[i]);
+    Real result = 0.;
+    m_row_matrix->Comm().SumAll(&local, &result, 1);
+    return result;
+  }
+
+  /// Right-preconditioned restarted GMRES in single precision for A z = m_rhs_float, starting from z = 0.
+  /// @return the number of iterations
+  Uint inner_solve(FloatVectorT& z)
+  {
+    const Uint n = z.size();
+    const Uint restart = m_krylov_basis.size() - 1;
+    std::fill(z.begin(), z.end(), 0.f);
+
+    const Real rhs_norm = std::sqrt(dot(m_rhs_float, m_rhs_float));
+    if(rhs_norm == 0.)
+      return 0;
+    const Real target = m_inner_tolerance * rhs_norm;
+
+    std::vector<Real>& hessenberg = m_hessenberg;
+    std::vector<Real>& cs = m_cs;
+    std::vector<Real>& sn = m_sn;
+    std::vector<Real>& g = m_g;
+    std::vector<Real>& y = m_y;
+
+    Uint iterations = 0;
+    bool first_cycle = true;
+    while(iterations < m_max_inner_iterations)
+    {
+      FloatVectorT& v0 = m_krylov_basis[0];
+      if(first_cycle)
+      {
+        std::copy(m_rhs_float.begin(), m_rhs_float.end(), v0.begin());
+      }
+      else
+      {
+        apply_preconditioner(z, m_preconditioned);
+        apply_matrix(m_preconditioned, v0);
+        for(Uint i = 0; i != n; ++i)
+          v0[i] = m_rhs_float[i] - v0[i];
+      }
+      first_cycle = false;
+
+      const Real beta = std::sqrt(dot(v0, v0));
+      if(beta <= target)
+        break;
+      for(Uint i = 0; i != n; ++i)
+        v0[i] = static_cast<float>(v0[i] / beta);
+      std::fill(g.begin(), g.end(), 0.);
+      g[0] = beta;
+
+      Uint k = 0;
+      bool converged = false;
+      while(k != restart && iterations < m_max_inner_iterations)
+      {
+        FloatVectorT& w = m_krylov_basis[k+1];
+        apply_preconditioner(m_krylov_basis[k], m_work);
+        apply_matrix(m_work, w);
+
+        // Modified Gram-Schmidt
+        for(Uint i = 0; i <= k; ++i)
+        {
+          const Real h = dot(w, m_krylov_basis[i]);
+          hessenberg[i*restart + k] = h;
+          const FloatVectorT& v = m_krylov_basis[i];
+          for(Uint j = 0; j != n; ++j)
+            w[j] -= static_cast<float>(h) * v[j];
+        }
+        const Real h_next = std::sqrt(dot(w, w));
+        if(h_next != 0.)
+        {
+          for(Uint j = 0; j != n; ++j)
+            w[j] = static_cast<float>(w[j] / h_next);
+        }
+
+        // Apply the previous Givens rotations to the new column, and compute the rotation that eliminates h_next
+        for(Uint i = 0; i != k; ++i)
+        {
+          const Real h_i = hessenberg[i*restart + k];
+          const Real h_ip1 = hessenberg[(i+1)*restart + k];
+          hessenberg[i*restart + k] = cs[i]*h_i + sn[i]*h_ip1;
+          hessenberg[(i+1)*restart + k] = -sn[i]*h_i + cs[i]*h_ip1;
+        }
+        const Real h_k = hessenberg[k*restart + k];
+        const Real denominator = std::sqrt(h_k*h_k + h_next*h_next);
+        cs[k] = denominator == 0. ? 1. : h_k / denominator;
+        sn[k] = denominator == 0. ? 0. : h_next / denominator;
+        hessenberg[k*restart + k] = denominator;
+        g[k+1] = -sn[k]*g[k];
+        g[k] = cs[k]*g[k];
+
+        ++k;
+        ++iterations;
+        if(std::abs(g[k]) <= target || h_next == 0.)
+        {
+          converged = true;
+          break;
+        }
+      }
+
+      // Solve the upper triangular system and update z with the (unpreconditioned) combination of the basis vectors
+      for(int i = static_cast<int>(k)-1; i >= 0; --i)
+      {
+        Real sum = g[i];
+        for(Uint j = i+1; j != k; ++j)
+          sum -= hessenberg[i*restart + j] * y[j];
+        y[i] = hessenberg[i*restart + i] == 0. ? 0. : sum / hessenberg[i*restart + i];
+      }
+      std::fill(m_work.begin(), m_work.end(), 0.f);
+      for(Uint i = 0; i != k; ++i)
+      {
+        const float y_i = static_cast<float>(y[i]);
+        const FloatVectorT& v = m_krylov_basis[i];
+        for(Uint j = 0; j != n; ++j)
+          m_work[j] += y_i * v[j];
+      }
+      // z holds the unpreconditioned iterate, the preconditioner is applied once at the end
+      for(Uint j = 0; j != n; ++j)
+        z[j] += m_work[j];
+
+      if(converged)
+        break;
+    }
+
+    apply_preconditioner(z, m_preconditioned);
+    std::copy(m_preconditioned.begin(), m_preconditioned.end(), z.begin());
+    return iterations;
+  }
+
+  void solve()
+  {
+    setup();
+
+    Epetra_Vector& x = *m_solution->epetra_vector();
+    const Epetra_Vector& b = *m_rhs->epetra_vector();
+    Epetra_Vector& r = *m_residual_work;
+    const int nb_rows = m_row_ptr.size() - 1;
+
+    double b_norm = 0.;
+    b.Norm2(&b_norm);
+    Uint total_iterations = 0;
+    Uint refinement = 0;
+    if(b_norm == 0.)
+    {
+      x.PutScalar(0.);
+      m_residual = 0.;
+    }
+    else
+    {
+      Real previous_residual = -1.;
+      while(true)
+      {
+        // Residual in double precision
+        m_row_matrix->Apply(x, r);
+        r.Update(1., b, -1.);
+        double r_norm = 0.;
+        r.Norm2(&r_norm);
+        m_residual = r_norm / b_norm;
+
+        if(m_residual <= m_tolerance || refinement == m_max_refinements)
+          break;
+        if(previous_residual >= 0. && m_residual >= previous_residual)
+        {
+          CFwarn << "Mixed precision refinement for " << m_self.uri().path() << " stagnated at relative residual " << m_residual << CFendl;
+          break;
+        }
+        previous_residual = m_residual;
+
+        // Scale the residual to unit norm, so its float copy does not under- or overflow
+        for(int i = 0; i != nb_rows; ++i)
+          m_rhs_float[i] = static_cast<float>(r[i] / r_norm);
+
+        total_iterations += inner_solve(m_correction);
+
+        for(int i = 0; i != nb_rows; ++i)
+          x[i] += r_norm * static_cast<Real>(m_correction[i]);
+        ++refinement;
+      }
+
+      if(m_residual > m_tolerance)
+        CFwarn << "Mixed precision solve for " << m_self.uri().path() << " reached relative residual " << m_residual << ", tolerance was " << m_tolerance << CFendl;
+    }
+
+    m_self.properties()["iteration_count"] = total_iterations;
+    m_self.properties()["refinements"] = refinement;
+    m_self.properties()["residual"] = m_residual;
+  }
+
+  common::Component& m_self;
+
+  Handle<LSS::Matrix> m_matrix;
+  ThyraOperator* m_operator;
+  Handle<TrilinosVector> m_rhs;
+  Handle<TrilinosVector> m_solution;
+
+  Real m_tolerance;
+  Uint m_max_refinements;
+  Real m_inner_tolerance;
+  Uint m_max_inner_iterations;
+  Uint m_restart;
+  Real m_residual;
+
+  Teuchos::RCP<Epetra_RowMatrix> m_row_matrix;
+
+  /// True if the pattern and the work vectors below match m_row_matrix
+  bool m_pattern_valid;
+  /// Restart length the Krylov workspace was allocated for
+  Uint m_pattern_restart;
+
+  /// Single precision copy of the local rows, with local column indices
+  std::vector<int> m_row_ptr;
+  std::vector<int> m_columns;
+  FloatVectorT m_values;
+
+  /// Buffers to extract a row of the matrix
+  std::vector<double> m_row_values;
+  std::vector<int> m_row_indices;
+
+  /// ILU(0) factors of the coupling between local rows, with local row indices as columns
+  std::vector<int> m_ilu_ptr;
+  std::vector<int> m_ilu_columns;
+  std::vector<int> m_ilu_diagonal;
+  FloatVectorT m_ilu_values;
+  /// Position in m_values of each ILU entry, or -1 for a diagonal entry that is not stored in the matrix
+  std::vector<int> m_ilu_source;
+  /// Position of each column in the row that is being factorized, -1 if not in the row
+  std::vector<int> m_ilu_position;
+
+  /// Work vectors for the ghost exchange, only allocated when the matrix has ghost columns
+  boost::scoped_ptr<Epetra_Vector> m_domain_work;
+  boost::scoped_ptr<Epetra_Vector> m_column_work;
+  FloatVectorT m_columns_vector;
+
+  /// Double precision residual
+  boost::scoped_ptr<Epetra_Vector> m_residual_work;
+
+  /// GMRES workspace: the Krylov basis, the Hessenberg matrix and the Givens rotations
+  std::vector<FloatVectorT> m_krylov_basis;
+  std::vector<Real> m_hessenberg;
+  std::vector<Real> m_cs;
+  std::vector<Real> m_sn;
+  std::vector<Real> m_g;
+  std::vector<Real> m_y;
+  FloatVectorT m_rhs_float;
+  FloatVectorT m_correction;
+  FloatVectorT m_work;
+  FloatVectorT m_preconditioned;
+};
+
+MixedPrecisionStrategy::MixedPrecisionStrategy(const std::string& name) :
+  SolutionStrategy(name),
+  m_implementation(new Implementation(*this))
+{
+}
+
+MixedPrecisionStrategy::~MixedPrecisionStrategy()
+{
+}
+
+Real MixedPrecisionStrategy::compute_residual()
+{
+  return m_implementation->m_residual;
+}
+
+void MixedPrecisionStrategy::set_matrix(const Handle< Matrix >& matrix)
+{
+  if(matrix.get() != m_implementation->m_matrix.get())
+    m_implementation->m_pattern_valid = false;
+  m_implementation->m_matrix = matrix;
+  m_implementation->m_operator = dynamic_cast<ThyraOperator*>(matrix.get());
+}
+
+void MixedPrecisionStrategy::set_rhs(const Handle< Vector >& rhs)
+{
+  m_implementation->m_rhs = Handle<TrilinosVector>(rhs);
+}
+
+void MixedPrecisionStrategy::set_solution(const Handle< Vector >& solution)
+{
+  m_implementation->m_solution = Handle<TrilinosVector>(solution);
+}
+
+void MixedPrecisionStrategy::solve()
+{
+  m_implementation->solve();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+} // namespace LSS
+} // namespace math
+} // namespace cf3
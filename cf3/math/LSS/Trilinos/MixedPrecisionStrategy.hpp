@@ -0,0 +1,61 @@
+// Copyright (C) 2010-2013 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef cf3_Math_LSS_MixedPrecisionStrategy_hpp
+#define cf3_Math_LSS_MixedPrecisionStrategy_hpp
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <boost/scoped_ptr.hpp>
+
+#include "math/LSS/SolutionStrategy.hpp"
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+  @file MixedPrecisionStrategy.hpp Mixed-precision iterative refinement
+**/
+////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace math {
+namespace LSS {
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+/// Solves the system using iterative refinement: the residual and the correction of the solution are computed in double precision,
+/// while each correction is obtained from a restarted GMRES solve that runs entirely in single precision, preconditioned
+/// with a block-Jacobi ILU(0) factorization of the single-precision copy of the local rows of the matrix.
+/// The inner solves only need a modest accuracy, so most of the memory traffic is on float data.
+/// Communication of ghost values goes through the double-precision Epetra import of the matrix.
+class LSS_API MixedPrecisionStrategy : public SolutionStrategy
+{
+public:
+  MixedPrecisionStrategy(const std::string& name);
+  ~MixedPrecisionStrategy();
+
+  /// name of the type
+  static std::string type_name () { return "MixedPrecisionStrategy"; }
+
+  void set_matrix(const Handle<LSS::Matrix>& matrix);
+  void set_rhs(const Handle<LSS::Vector>& rhs);
+  void set_solution(const Handle<LSS::Vector>& solution);
+  void solve();
+  Real compute_residual();
+
+private:
+  /// Hide the implementation to avoid pulling in lots of Trilinos headers
+  struct Implementation;
+  boost::scoped_ptr<Implementation> m_implementation;
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+} // namespace LSS
+} // namespace math
+} // namespace cf3
+
+#endif // cf3_Math_LSS_MixedPrecisionStrategy_hpp
@@ -6,9 +6,11 @@
 
 ////////////////////////////////////////////////////////////////////////////////////////////
 
+#include <algorithm>
 #include <iostream>
 #include <set>
 
+#include <boost/functional/hash.hpp>
 #include <boost/pointer_cast.hpp>
 
 #include "Teuchos_ConfigDefs.hpp"
@@ -136,6 +138,7 @@ void TrilinosCrsMatrix::create_blocked(common::PE::CommPattern& cp, const Variab
 
   // create matrix
   m_mat=Teuchos::rcp(new Epetra_CrsMatrix(Copy, graph));
+  m_thyra_operator.reset();
   TRILINOS_THROW(m_mat->FillComplete());
   TRILINOS_THROW(m_mat->OptimizeStorage());
 
@@ -153,11 +156,13 @@ void TrilinosCrsMatrix::destroy()
   {
     m_mat.reset();
   }
+  m_thyra_operator.reset();
   m_p2m.resize(0);
   m_p2m.reserve(0);
   m_neq=0;
   m_num_my_elements=0;
   m_is_created=false;
+  m_symmetric_dirichlet_patterns.clear();
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////
@@ -402,6 +407,159 @@ void TrilinosCrsMatrix::symmetric_dirichlet(const Uint blockrow, const Uint ieq,
 
 ////////////////////////////////////////////////////////////////////////////////////////////
 
+void TrilinosCrsMatrix::symmetric_dirichlet_rows(const std::vector<Uint>& rows, const std::vector<Real>& values, Vector& rhs)
+{
+  cf3_assert(m_is_created);
+  cf3_assert(rows.size() == values.size());
+
+  // We assume that we have an epetra RHS with the same storage structure as the matrix!
+  Epetra_Vector& epetra_rhs = *dynamic_cast<TrilinosVector&>(rhs).epetra_vector();
+
+  // Look up the pattern for this list of rows, building it if needed. Only a few patterns are kept, since usually
+  // the same boundary conditions are applied after every assembly.
+  const std::size_t rows_hash = boost::hash_range(rows.begin(), rows.end());
+  SymmetricDirichletPattern* pattern = 0;
+  for(Uint i = 0; i != m_symmetric_dirichlet_patterns.size(); ++i)
+  {
+    if(m_symmetric_dirichlet_patterns[i].rows_hash == rows_hash && m_symmetric_dirichlet_patterns[i].rows == rows)
+    {
+      pattern = &m_symmetric_dirichlet_patterns[i];
+      break;
+    }
+  }
+  if(pattern == 0)
+  {
+    const Uint max_nb_patterns = 4;
+    if(m_symmetric_dirichlet_patterns.size() == max_nb_patterns)
+      m_symmetric_dirichlet_patterns.erase(m_symmetric_dirichlet_patterns.begin());
+    m_symmetric_dirichlet_patterns.push_back(SymmetricDirichletPattern());
+    pattern = &m_symmetric_dirichlet_patterns.back();
+    build_symmetric_dirichlet_pattern(rows, *pattern);
+    pattern->rows_hash = rows_hash;
+  }
+
+  int num_entries;
+  Real* extracted_values;
+  int* extracted_indices;
+
+  const int nb_other_rows = pattern->other_rows.size();
+  if(!pattern->values_cached)
+  {
+    pattern->eliminated_values.resize(pattern->entry_positions.size());
+    for(int r = 0; r != nb_other_rows; ++r)
+    {
+      const int row = pattern->other_rows[r];
+      TRILINOS_THROW(m_mat->ExtractMyRowView(row, num_entries, extracted_values, extracted_indices));
+      const int entries_end = pattern->entries_begin[r+1];
+      for(int e = pattern->entries_begin[r]; e != entries_end; ++e)
+      {
+        Real& entry = extracted_values[pattern->entry_positions[e]];
+        pattern->eliminated_values[e] = entry;
+        epetra_rhs[row] -= entry * values[pattern->entry_constraints[e]];
+        entry = 0.;
+      }
+    }
+
+    // The constrained rows become identity rows
+    for(Uint k = 0; k != rows.size(); ++k)
+    {
+      const int bc_row = pattern->bc_rows[k];
+      if(bc_row < 0)
+        continue;
+      TRILINOS_THROW(m_mat->ExtractMyRowView(bc_row, num_entries, extracted_values, extracted_indices));
+      for(int i = 0; i != num_entries; ++i)
+        extracted_values[i] = extracted_indices[i] == bc_row ? 1. : 0.;
+    }
+
+    pattern->values_cached = true;
+  }
+  else // Reuse the eliminated values, if the matrix wasn't reset since the previous BC application
+  {
+    for(int r = 0; r != nb_other_rows; ++r)
+    {
+      const int row = pattern->other_rows[r];
+      const int entries_end = pattern->entries_begin[r+1];
+      for(int e = pattern->entries_begin[r]; e != entries_end; ++e)
+        epetra_rhs[row] -= pattern->eliminated_values[e] * values[pattern->entry_constraints[e]];
+    }
+  }
+
+  for(Uint k = 0; k != rows.size(); ++k)
+  {
+    m_dirichlet_nodes.push_back(std::make_pair(rows[k] / m_neq, rows[k] % m_neq));
+    rhs.set_value(rows[k], values[k]);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void TrilinosCrsMatrix::build_symmetric_dirichlet_pattern(const std::vector<Uint>& rows, SymmetricDirichletPattern& pattern)
+{
+  const Uint nb_bc = rows.size();
+  pattern.rows = rows;
+  pattern.bc_rows.resize(nb_bc);
+  pattern.values_cached = false;
+
+  // Constraint index for each local column, -1 if the column is not constrained
+  std::vector<int> column_constraint(m_mat->NumMyCols(), -1);
+  for(Uint k = 0; k != nb_bc; ++k)
+  {
+    const int bc_col = m_p2m[rows[k]];
+    column_constraint[bc_col] = k;
+    pattern.bc_rows[k] = bc_col < m_num_my_elements ? bc_col : -1;
+  }
+
+  // Unconstrained rows that are connected to a constrained row. By structural symmetry, these are the only rows with entries in the constrained columns.
+  std::vector<int> other_rows;
+  for(Uint k = 0; k != nb_bc; ++k)
+  {
+    const Uint blockrow = rows[k] / m_neq;
+    const Uint conn_end = m_starting_indices[blockrow+1];
+    for(Uint i = m_starting_indices[blockrow]; i != conn_end; ++i)
+    {
+      for(Uint j = 0; j != m_neq; ++j)
+      {
+        const int other_row = m_p2m[m_node_connectivity[i]*m_neq+j];
+        if(other_row < m_num_my_elements && column_constraint[other_row] == -1)
+          other_rows.push_back(other_row);
+      }
+    }
+  }
+  std::sort(other_rows.begin(), other_rows.end());
+  other_rows.erase(std::unique(other_rows.begin(), other_rows.end()), other_rows.end());
+
+  // Scan each row once for its entries in constrained columns
+  pattern.other_rows.clear();
+  pattern.entries_begin.clear();
+  pattern.entry_positions.clear();
+  pattern.entry_constraints.clear();
+  pattern.entries_begin.push_back(0);
+
+  int num_entries;
+  Real* extracted_values;
+  int* extracted_indices;
+  BOOST_FOREACH(const int other_row, other_rows)
+  {
+    TRILINOS_THROW(m_mat->ExtractMyRowView(other_row, num_entries, extracted_values, extracted_indices));
+    for(int i = 0; i != num_entries; ++i)
+    {
+      const int constraint = column_constraint[extracted_indices[i]];
+      if(constraint != -1)
+      {
+        pattern.entry_positions.push_back(i);
+        pattern.entry_constraints.push_back(constraint);
+      }
+    }
+    if(static_cast<int>(pattern.entry_positions.size()) != pattern.entries_begin.back())
+    {
+      pattern.other_rows.push_back(other_row);
+      pattern.entries_begin.push_back(pattern.entry_positions.size());
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
 const std::vector<std::pair<Uint, Uint> >& TrilinosCrsMatrix::get_dirichlet_nodes() const
 {
   return m_dirichlet_nodes;
@@ -510,6 +668,8 @@ void TrilinosCrsMatrix::reset(Real reset_to)
 
   m_symmetric_dirichlet_values.clear();
   m_dirichlet_nodes.clear();
+  for(Uint i = 0; i != m_symmetric_dirichlet_patterns.size(); ++i)
+    m_symmetric_dirichlet_patterns[i].values_cached = false;
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////
@@ -524,6 +684,7 @@ void TrilinosCrsMatrix::clone_to(Matrix &other)
     throw common::SetupError(FromHere(), "clone_to method of TrilinosCrsMatrix needs another TrilinosCrsMatrix, but a " + other.derived_type_name() + " was supplied instead.");
 
   other_ptr->m_mat = Teuchos::rcp(new Epetra_CrsMatrix(*m_mat));
+  other_ptr->m_thyra_operator.reset();
   other_ptr->m_is_created = m_is_created;
   other_ptr->m_neq = m_neq;
   other_ptr->m_num_my_elements = m_num_my_elements;
@@ -532,6 +693,7 @@ void TrilinosCrsMatrix::clone_to(Matrix &other)
   other_ptr->m_node_connectivity = m_node_connectivity;
   other_ptr->m_starting_indices = m_starting_indices;
   other_ptr->m_symmetric_dirichlet_values = m_symmetric_dirichlet_values;
+  other_ptr->m_symmetric_dirichlet_patterns = m_symmetric_dirichlet_patterns;
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////
@@ -704,14 +866,19 @@ void TrilinosCrsMatrix::debug_data(std::vector<Uint>& row_indices, std::vector<U
 
 Teuchos::RCP< const Thyra::LinearOpBase< Real > > TrilinosCrsMatrix::thyra_operator() const
 {
-  return Thyra::epetraLinearOp(m_mat);
+  // The view refers to m_mat, so it stays valid until the matrix is created again
+  if(m_thyra_operator.is_null())
+    m_thyra_operator = Thyra::nonconstEpetraLinearOp(m_mat);
+  return m_thyra_operator;
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////
 
 Teuchos::RCP< Thyra::LinearOpBase< Real > > TrilinosCrsMatrix::thyra_operator()
 {
-  return Thyra::nonconstEpetraLinearOp(m_mat);
+  if(m_thyra_operator.is_null())
+    m_thyra_operator = Thyra::nonconstEpetraLinearOp(m_mat);
+  return m_thyra_operator;
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////
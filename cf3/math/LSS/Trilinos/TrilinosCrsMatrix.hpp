@@ -101,6 +101,13 @@ public:
 
   virtual void symmetric_dirichlet(const Uint blockrow, const Uint ieq, const Real value, Vector& rhs);
 
+  /// Symmetric dirichlet for a list of rows. The positions of the eliminated entries are looked up once for each list of rows,
+  /// and the eliminated values are kept until the next reset, so the conditions can be applied again to a new RHS.
+  /// @pre Between two calls with the same rows, the matrix values may only be changed through reset(). The values
+  /// cached at the first call are not invalidated by set_value, add_value, set_row and the other element-wise
+  /// modifiers, so assembling into the matrix without resetting it first gives a wrong RHS on the next call.
+  virtual void symmetric_dirichlet_rows(const std::vector<Uint>& rows, const std::vector<Real>& values, Vector& rhs);
+
   /// Get the nodes and equations for all dirichlet boundary conditions that have been applied so far
   const std::vector< std::pair< Uint, Uint > >& get_dirichlet_nodes( ) const;
 
@@ -163,6 +170,7 @@ public:
   void replace_epetra_matrix(const Teuchos::RCP<Epetra_CrsMatrix>& mat)
   {
     m_mat = mat;
+    m_symmetric_dirichlet_patterns.clear();
   }
   
   /// Store the local matrix GIDs belonging to each variable in the given vector
@@ -205,6 +213,9 @@ private:
   /// teuchos style smart pointer wrapping the matrix
   Teuchos::RCP<Epetra_CrsMatrix> m_mat;
 
+  /// Thyra view of m_mat, built on first use and reused by all solves
+  mutable Teuchos::RCP< Thyra::LinearOpBase<Real> > m_thyra_operator;
+
   /// epetra mpi environment
   Epetra_MpiComm m_comm;
 
@@ -232,6 +243,31 @@ private:
   DirichletMapT m_symmetric_dirichlet_values;
 
   std::vector< std::pair<Uint,Uint> > m_dirichlet_nodes;
+
+  /// Precomputed positions for symmetric_dirichlet_rows, valid for one list of rows and the sparsity pattern of m_mat
+  struct SymmetricDirichletPattern
+  {
+    /// The rows (iblockrow*neq+ieq) this pattern was built for, and their hash to quickly skip the other patterns
+    std::vector<Uint> rows;
+    std::size_t rows_hash;
+    /// Local matrix row of each constrained row, or -1 for rows that are not owned
+    std::vector<int> bc_rows;
+    /// Unconstrained local rows that have an entry in a constrained column
+    std::vector<int> other_rows;
+    /// Entries of each row in other_rows, in CSR format: position in the row view and index of the constrained row
+    std::vector<int> entries_begin;
+    std::vector<int> entry_positions;
+    std::vector<int> entry_constraints;
+    /// Matrix values that were eliminated, valid if values_cached is true. Only reset() clears values_cached.
+    std::vector<Real> eliminated_values;
+    bool values_cached;
+  };
+
+  /// Build the pattern for the given rows
+  void build_symmetric_dirichlet_pattern(const std::vector<Uint>& rows, SymmetricDirichletPattern& pattern);
+
+  /// Patterns for the recently used lists of rows
+  std::vector<SymmetricDirichletPattern> m_symmetric_dirichlet_patterns;
 }; // end of class Matrix
 
 ////////////////////////////////////////////////////////////////////////////////////////////
@@ -106,6 +106,7 @@ void TrilinosFEVbrMatrix::create(cf3::common::PE::CommPattern& cp, const Uint ne
 
   // create matrix
   m_mat=Teuchos::rcp(new Epetra_FEVbrMatrix(Copy,rowmap,colmap,&rowelements[0]));
+  m_thyra_operator.reset();
   
   // prepare the entries
   int row_start = 0;
@@ -144,6 +145,7 @@ void TrilinosFEVbrMatrix::create_blocked(common::PE::CommPattern& cp, const Vari
 void TrilinosFEVbrMatrix::destroy()
 {
   if (m_is_created) m_mat.reset();
+  m_thyra_operator.reset();
   m_p2m.resize(0);
   m_p2m.reserve(0);
   m_neq=0;
@@ -783,14 +785,19 @@ void TrilinosFEVbrMatrix::debug_data(std::vector<Uint>& row_indices, std::vector
 
 Teuchos::RCP< const Thyra::LinearOpBase< Real > > TrilinosFEVbrMatrix::thyra_operator() const
 {
-  return Thyra::epetraLinearOp(m_mat);
+  // The view refers to m_mat, so it stays valid until the matrix is created again
+  if(m_thyra_operator.is_null())
+    m_thyra_operator = Thyra::nonconstEpetraLinearOp(m_mat);
+  return m_thyra_operator;
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////
 
 Teuchos::RCP< Thyra::LinearOpBase< Real > > TrilinosFEVbrMatrix::thyra_operator()
 {
-  return Thyra::nonconstEpetraLinearOp(m_mat);
+  if(m_thyra_operator.is_null())
+    m_thyra_operator = Thyra::nonconstEpetraLinearOp(m_mat);
+  return m_thyra_operator;
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////
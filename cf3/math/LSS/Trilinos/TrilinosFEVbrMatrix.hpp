@@ -174,6 +174,9 @@ private:
   /// teuchos style smart pointer wrapping an epetra fevbrmatrix
   Teuchos::RCP<Epetra_FEVbrMatrix> m_mat;
 
+  /// Thyra view of m_mat, built on first use and reused by all solves
+  mutable Teuchos::RCP< Thyra::LinearOpBase<Real> > m_thyra_operator;
+
   /// epetra mpi environment
   Epetra_MpiComm m_comm;
 
@@ -6,6 +6,9 @@
 
 ////////////////////////////////////////////////////////////////////////////////////////////
 
+#include <deque>
+
+#include <boost/algorithm/string/predicate.hpp>
 #include <boost/mpl/vector.hpp>
 #include <boost/mpl/for_each.hpp>
 #include <boost/bind.hpp>
@@ -27,6 +30,8 @@
 #include "common/Builder.hpp"
 #include "common/EventHandler.hpp"
 #include "common/OptionList.hpp"
+#include "common/PropertyList.hpp"
+#include "common/Timer.hpp"
 
 #include "ParameterList.hpp"
 #include "ThyraVector.hpp"
@@ -55,7 +60,16 @@ struct TrilinosStratimikosStrategy::Implementation
     m_self(self),
     m_parameter_list(Teuchos::createParameterList()),
     m_preconditioner_reset(1),
-    m_iteration_count(0)
+    m_iteration_count(0),
+    m_adaptive_preconditioner(false),
+    m_max_iteration_growth(2.),
+    m_extrapolation_order(0),
+    m_setup_time(0.),
+    m_time_since_setup(0.),
+    m_solves_since_setup(0),
+    m_reference_iterations(0),
+    m_rebuild_preconditioner(true),
+    m_initialized_operator(0)
   {
     Teko::addTekoToStratimikosBuilder(m_linear_solver_builder);
     m_linear_solver_builder.setParameterList(m_parameter_list);
@@ -82,6 +96,34 @@ struct TrilinosStratimikosStrategy::Implementation
       .mark_basic()
       .link_to(&m_preconditioner_reset);
 
+    m_self.options().add("adaptive_preconditioner", m_adaptive_preconditioner)
+      .pretty_name("Adaptive Preconditioner")
+      .description("Rebuild the preconditioner only when reusing it stops paying off, instead of every preconditioner_reset solves. "
+                   "This happens when a solve takes longer than the average cost per solve (including the setup) since the last rebuild, "
+                   "or when the number of iterations grows beyond max_iteration_growth times the count right after the rebuild")
+      .mark_basic()
+      .link_to(&m_adaptive_preconditioner);
+
+    m_self.options().add("max_iteration_growth", m_max_iteration_growth)
+      .pretty_name("Max Iteration Growth")
+      .description("For the adaptive preconditioner: rebuild when the iteration count exceeds the count after the last rebuild by this factor")
+      .link_to(&m_max_iteration_growth);
+
+    m_self.options().add("extrapolation_order", m_extrapolation_order)
+      .pretty_name("Extrapolation Order")
+      .description("Initial guess for the solution, extrapolated from the previous solutions: "
+                   "0 keeps the current contents of the solution vector, 1 extrapolates linearly from the last two solutions "
+                   "and 2 quadratically from the last three")
+      .attach_trigger(boost::bind(&Implementation::trigger_extrapolation_order, this))
+      .mark_basic()
+      .link_to(&m_extrapolation_order);
+
+    m_self.properties().add("preconditioner_rebuilds", 0u);
+    m_self.properties().add("iteration_count", 0u);
+    m_self.properties().add("setup_time", 0.);
+    m_self.properties().add("solve_time", 0.);
+    m_self.properties().add("workspace_allocations", 0u);
+
     m_self.options().add("settings_file", common::URI("", cf3::common::URI::Scheme::FILE))
       .supported_protocol(cf3::common::URI::Scheme::FILE)
       .pretty_name("Settings File")
@@ -100,6 +142,13 @@ struct TrilinosStratimikosStrategy::Implementation
     }
   }
 
+  void trigger_extrapolation_order()
+  {
+    if(m_extrapolation_order > 2)
+      throw common::BadValue(FromHere(), "extrapolation_order must be 0, 1 or 2 for " + m_self.uri().path());
+    m_previous_solutions.clear();
+  }
+
   void trigger_settings_file()
   {
     const std::string settings_path = m_self.options().option("settings_file").value<common::URI>().path();
@@ -125,10 +174,12 @@ struct TrilinosStratimikosStrategy::Implementation
     m_lows_factory->setVerbLevel(static_cast<Teuchos::EVerbosityLevel>(verb));
     m_lows.reset();
     m_residual_vec.reset();
+    m_initialized_operator = 0;
 
     // Update the component tree that represents the parameters. This automatically exposes available options
     update_parameters();
     m_iteration_count = 0;
+    m_rebuild_preconditioner = true;
   }
 
   void solve()
@@ -148,30 +199,56 @@ struct TrilinosStratimikosStrategy::Implementation
         m_parameter_list->print();
 
       m_lows = m_lows_factory->createOp();
+      m_rebuild_preconditioner = true;
+      count_allocation();
     }
 
-    
-    if(m_iteration_count % m_preconditioner_reset == 0)
+    // The operator view is kept by the matrix, a different one means the matrix was created again
+    Teuchos::RCP<const Thyra::LinearOpBase<Real> > op = m_matrix->thyra_operator();
+    common::Timer timer;
+    const bool rebuild = op.get() != m_initialized_operator || (m_adaptive_preconditioner ? m_rebuild_preconditioner : m_iteration_count % m_preconditioner_reset == 0);
+    if(rebuild)
     {
-      Thyra::initializeOp(*m_lows_factory, m_matrix->thyra_operator(), m_lows.ptr());
+      Thyra::initializeOp(*m_lows_factory, op, m_lows.ptr());
+      m_initialized_operator = op.get();
+      m_setup_time = timer.elapsed();
+      m_time_since_setup = m_setup_time;
+      m_solves_since_setup = 0;
+      m_reference_iterations = 0;
+      m_rebuild_preconditioner = false;
+      m_self.properties()["preconditioner_rebuilds"] = m_self.properties().value<Uint>("preconditioner_rebuilds") + 1u;
+      m_self.properties()["setup_time"] = m_setup_time;
     }
     else
     {
-      Thyra::initializeAndReuseOp(*m_lows_factory, m_matrix->thyra_operator(), m_lows.ptr());
+      Thyra::initializeAndReuseOp(*m_lows_factory, op, m_lows.ptr());
     }
 
     Teuchos::RCP< Thyra::VectorBase<Real> const > b = m_rhs->thyra_vector();
     Teuchos::RCP< Thyra::VectorBase<Real> > x = m_solution->thyra_vector();
-    
+
+    extrapolate_initial_guess(*x);
+
+    timer.restart();
+    Uint nb_iterations = 0;
     try
     {
       Thyra::SolveStatus<double> status = Thyra::solve<double>(*m_lows, Thyra::NOTRANS, *b, x.ptr());
       CFinfo << "Thyra::solve finished with status " << status.message << CFendl;
+      nb_iterations = iteration_count(status);
     }
     catch(std::exception& e)
     {
       std::cout << e.what() << std::endl;
     }
+    const Real solve_time = timer.elapsed();
+    m_self.properties()["solve_time"] = solve_time;
+    m_self.properties()["iteration_count"] = nb_iterations;
+
+    store_solution(*x);
+
+    if(m_adaptive_preconditioner)
+      update_preconditioner_policy(solve_time, nb_iterations);
     
     if(m_self.options().option("compute_residual").value<bool>())
       CFinfo << "Solver residual: " << compute_residual() << CFendl;
@@ -179,6 +256,86 @@ struct TrilinosStratimikosStrategy::Implementation
     ++m_iteration_count;
   }
 
+  /// Decide if the preconditioner must be rebuilt before the next solve. The cost per solve since the last rebuild,
+  /// including the setup, decreases as long as the solves are faster than this average. A slower solve means
+  /// that a new preconditioner is likely to be cheaper overall.
+  void update_preconditioner_policy(const Real solve_time, const Uint nb_iterations)
+  {
+    const Real average_cost = m_solves_since_setup == 0 ? 0. : m_time_since_setup / static_cast<Real>(m_solves_since_setup);
+    ++m_solves_since_setup;
+    m_time_since_setup += solve_time;
+
+    if(m_solves_since_setup == 1)
+    {
+      m_reference_iterations = nb_iterations;
+      return;
+    }
+
+    if(solve_time > average_cost)
+      m_rebuild_preconditioner = true;
+
+    // Iteration counts are only known for solvers that report them
+    if(m_reference_iterations != 0 && static_cast<Real>(nb_iterations) > m_max_iteration_growth * static_cast<Real>(m_reference_iterations))
+      m_rebuild_preconditioner = true;
+  }
+
+  /// Number of iterations reported by the solver, or 0 if it doesn't report them
+  Uint iteration_count(const Thyra::SolveStatus<double>& status)
+  {
+    if(status.extraParameters.is_null())
+      return 0;
+
+    for(Teuchos::ParameterList::ConstIterator it = status.extraParameters->begin(); it != status.extraParameters->end(); ++it)
+    {
+      const std::string& name = status.extraParameters->name(it);
+      if(boost::ends_with(name, "Iteration Count") && status.extraParameters->entry(it).isType<int>())
+        return static_cast<Uint>(Teuchos::getValue<int>(status.extraParameters->entry(it)));
+    }
+
+    return 0;
+  }
+
+  /// Overwrite x with the extrapolation of the previous solutions, if there are enough of them
+  void extrapolate_initial_guess(Thyra::VectorBase<Real>& x)
+  {
+    if(m_previous_solutions.size() < 2)
+      return;
+
+    const Uint order = std::min(m_extrapolation_order, static_cast<Uint>(m_previous_solutions.size()) - 1u);
+
+    // m_previous_solutions[0] is the most recent
+    if(order == 1)
+    {
+      Thyra::V_StVpStV(Teuchos::ptrFromRef(x), 2., *m_previous_solutions[0], -1., *m_previous_solutions[1]);
+    }
+    else
+    {
+      Thyra::V_StVpStV(Teuchos::ptrFromRef(x), 3., *m_previous_solutions[0], -3., *m_previous_solutions[1]);
+      Thyra::Vp_StV(Teuchos::ptrFromRef(x), 1., *m_previous_solutions[2]);
+    }
+  }
+
+  /// Keep the last extrapolation_order+1 solutions, reusing the storage of the oldest one
+  void store_solution(const Thyra::VectorBase<Real>& x)
+  {
+    if(m_extrapolation_order == 0)
+      return;
+
+    Teuchos::RCP< Thyra::VectorBase<Real> > stored;
+    if(m_previous_solutions.size() == m_extrapolation_order + 1)
+    {
+      stored = m_previous_solutions.back();
+      m_previous_solutions.pop_back();
+      Thyra::assign(stored.ptr(), x);
+    }
+    else
+    {
+      stored = x.clone_v();
+      count_allocation();
+    }
+    m_previous_solutions.push_front(stored);
+  }
+
   Real compute_residual()
   {
     if(is_null(m_matrix))
@@ -196,6 +353,7 @@ struct TrilinosStratimikosStrategy::Implementation
     if(m_residual_vec.is_null())
     {
       m_residual_vec = m_rhs->thyra_vector()->clone_v();
+      count_allocation();
     }
 
     Thyra::assign(m_rhs->thyra_vector().ptr(), *m_residual_vec);
@@ -205,6 +363,12 @@ struct TrilinosStratimikosStrategy::Implementation
     return *std::max_element(residuals.begin(), residuals.end());
   }
 
+  /// Count the creation of a solver or a work vector, which should only happen in the first solves for a given matrix
+  void count_allocation()
+  {
+    m_self.properties()["workspace_allocations"] = m_self.properties().value<Uint>("workspace_allocations") + 1u;
+  }
+
   void update_parameters()
   {
     if(is_not_null(m_parameters))
@@ -230,6 +394,23 @@ struct TrilinosStratimikosStrategy::Implementation
   
   Uint m_preconditioner_reset;
   Uint m_iteration_count;
+
+  bool m_adaptive_preconditioner;
+  Real m_max_iteration_growth;
+  Uint m_extrapolation_order;
+
+  /// Statistics since the last preconditioner rebuild
+  Real m_setup_time;
+  Real m_time_since_setup;
+  Uint m_solves_since_setup;
+  Uint m_reference_iterations;
+  bool m_rebuild_preconditioner;
+
+  /// Operator that m_lows was last initialized with, only used for comparison
+  const Thyra::LinearOpBase<Real>* m_initialized_operator;
+
+  /// Previous solutions, most recent first
+  std::deque< Teuchos::RCP< Thyra::VectorBase<Real> > > m_previous_solutions;
 };
 
 ////////////////////////////////////////////////////////////////////////////////////////////
@@ -251,7 +432,12 @@ TrilinosStratimikosStrategy::~TrilinosStratimikosStrategy()
 
 void TrilinosStratimikosStrategy::set_matrix(const Handle< Matrix >& matrix)
 {
-  m_implementation->m_matrix = Handle<ThyraOperator>(matrix);
+  // Setting the same matrix again keeps the solver and the preconditioner
+  const Handle<ThyraOperator const> new_matrix(matrix);
+  if(new_matrix == m_implementation->m_matrix && !m_implementation->m_lows_factory.is_null())
+    return;
+
+  m_implementation->m_matrix = new_matrix;
   m_implementation->setup_solver();
 }
 
@@ -263,6 +449,7 @@ void TrilinosStratimikosStrategy::set_rhs(const Handle< Vector >& rhs)
 void TrilinosStratimikosStrategy::set_solution(const Handle< Vector >& solution)
 {
   m_implementation->m_solution = Handle<ThyraVector>(solution);
+  m_implementation->m_previous_solutions.clear();
 }
 
 void TrilinosStratimikosStrategy::solve()
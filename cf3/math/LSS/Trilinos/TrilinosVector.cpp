@@ -94,6 +94,7 @@ void TrilinosVector::create_blocked(common::PE::CommPattern& cp, const Variables
   m_map = Teuchos::rcp(new Epetra_Map(-1,nmyglobalelements,&myglobalelements[0],0,m_comm));
   // create vector
   m_vec=Teuchos::rcp(new Epetra_Vector(View, *m_map, &m_data[0]));
+  m_thyra_vec.reset();
 
   m_neq=vars.size();
   m_blockrow_size=cp.isUpdatable().size();
@@ -106,6 +107,7 @@ void TrilinosVector::create_blocked(common::PE::CommPattern& cp, const Variables
 void TrilinosVector::destroy()
 {
   if (m_is_created) m_vec.reset();
+  m_thyra_vec.reset();
   m_p2m.resize(0);
   m_p2m.reserve(0);
   m_neq=0;
@@ -287,7 +289,7 @@ void TrilinosVector::reset(Real reset_to)
 
 ////////////////////////////////////////////////////////////////////////////////////////////
 
-void TrilinosVector::get( boost::multi_array<Real, 2>& data)
+void TrilinosVector::get( common::TableArray<Real>::type& data)
 {
   cf3_assert(m_is_created);
   cf3_assert(data.shape()[0]==m_blockrow_size);
@@ -299,7 +301,7 @@ void TrilinosVector::get( boost::multi_array<Real, 2>& data)
 
 ////////////////////////////////////////////////////////////////////////////////////////////
 
-void TrilinosVector::set( boost::multi_array<Real, 2>& data)
+void TrilinosVector::set( common::TableArray<Real>::type& data)
 {
   cf3_assert(m_is_created);
   cf3_assert(data.shape()[0]==m_blockrow_size);
@@ -389,8 +391,13 @@ void TrilinosVector::signal_print_native(common::SignalArgs& args)
 
 Teuchos::RCP< const Thyra::VectorBase< Real > > TrilinosVector::thyra_vector () const
 {
-  Teuchos::RCP< const Thyra::VectorSpaceBase< Real > > space = Thyra::create_VectorSpace(m_map);
-  return Thyra::create_Vector(m_vec, space);
+  // The view refers to m_data, so it stays valid until the vector is created again
+  if(m_thyra_vec.is_null())
+  {
+    Teuchos::RCP< const Thyra::VectorSpaceBase< Real > > space = Thyra::create_VectorSpace(m_map);
+    m_thyra_vec = Thyra::create_Vector(m_vec, space);
+  }
+  return m_thyra_vec;
 }
 
 
@@ -398,8 +405,12 @@ Teuchos::RCP< const Thyra::VectorBase< Real > > TrilinosVector::thyra_vector ()
 
 Teuchos::RCP< Thyra::VectorBase< Real > > TrilinosVector::thyra_vector ()
 {
-  Teuchos::RCP< const Thyra::VectorSpaceBase< Real > > space = Thyra::create_VectorSpace(m_map);
-  return Thyra::create_Vector(m_vec, space);
+  if(m_thyra_vec.is_null())
+  {
+    Teuchos::RCP< const Thyra::VectorSpaceBase< Real > > space = Thyra::create_VectorSpace(m_map);
+    m_thyra_vec = Thyra::create_Vector(m_vec, space);
+  }
+  return m_thyra_vec;
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////
@@ -415,6 +426,7 @@ void TrilinosVector::clone_to(Vector &other)
 
   other_ptr->m_data = m_data;
   other_ptr->m_vec = Teuchos::rcp(new Epetra_Vector(View, *m_map, &other_ptr->m_data[0]));
+  other_ptr->m_thyra_vec.reset();
   other_ptr->m_map = m_map;
   other_ptr->m_neq = m_neq;
   other_ptr->m_blockrow_size = m_blockrow_size;
@@ -120,10 +120,10 @@ public:
   void reset(Real reset_to=0.);
 
   /// Copies the contents out of the LSS::Vector to table.
-  void get( boost::multi_array<Real, 2>& data);
+  void get( common::TableArray<Real>::type& data);
 
   /// Copies the contents of the table into the LSS::Vector.
-  void set( boost::multi_array<Real, 2>& data);
+  void set( common::TableArray<Real>::type& data);
 
   //@} END EFFICCIENT ACCESS
 
@@ -191,6 +191,9 @@ private:
 
   Teuchos::RCP<Epetra_Map> m_map;
 
+  /// Thyra view of m_vec, built on first use and reused by all solves
+  mutable Teuchos::RCP< Thyra::VectorBase<Real> > m_thyra_vec;
+
   /// epetra mpi environment
   Epetra_MpiComm m_comm;
 
@@ -13,6 +13,7 @@
 
 #include "math/LSS/LibLSS.hpp"
 #include "common/PE/CommPattern.hpp"
+#include "common/Table_fwd.hpp"
 #include "common/Log.hpp"
 #include "math/LSS/BlockAccumulator.hpp"
 
@@ -108,10 +109,10 @@ public:
   virtual void reset(Real reset_to=0.) = 0;
 
   /// Copies the contents out of the LSS::Vector to table.
-  virtual void get( boost::multi_array<Real, 2>& data) = 0;
+  virtual void get( common::TableArray<Real>::type& data) = 0;
 
   /// Copies the contents of the table into the LSS::Vector.
-  virtual void set( boost::multi_array<Real, 2>& data) = 0;
+  virtual void set( common::TableArray<Real>::type& data) = 0;
 
   //@} END EFFICCIENT ACCESS
 
@@ -4,6 +4,9 @@
 // GNU Lesser General Public License version 3 (LGPLv3).
 // See doc/lgpl.txt and doc/gpl.txt for the license text.
 
+#include <map>
+#include <set>
+
 #include <boost/algorithm/string/replace.hpp>
 #include <boost/foreach.hpp>
 #include <boost/progress.hpp>
@@ -17,6 +20,8 @@
 #include "common/FindComponents.hpp"
 #include "common/BasicExceptions.hpp"
 #include "common/StringConversion.hpp"
+#include "common/PE/Comm.hpp"
+#include "common/PE/operations.hpp"
 
 #include "math/VariablesDescriptor.hpp"
 
@@ -46,7 +51,8 @@ common::ComponentBuilder< Reader, MeshReader, LibCGNS > aCGNSReader_Builder;
 //////////////////////////////////////////////////////////////////////////////
 
 Reader::Reader(const std::string& name)
-: MeshReader(name), Shared()
+: MeshReader(name), Shared(),
+  m_nb_slice_nodes(0)
 {
   options().add( "SectionsAreBCs", false )
       .description("Treat Sections of lower dimensionality as BC. "
@@ -54,6 +60,10 @@ Reader::Reader(const std::string& name)
   options().add( "zone_handling", false )
       .description("If zero, and there is only 1 zone, the zone is skipped"
                    " as nested region, and the zone's sections are added immediately.");
+  options().add( "parallel_io", true )
+      .description("In parallel, let every rank read only a slice of the sections and nodes"
+                   " through the parallel CGNS API, if available. Otherwise every rank reads the whole file.")
+      .pretty_name("Parallel IO");
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -73,7 +83,8 @@ void Reader::do_read_mesh_into(const URI& file, Mesh& mesh)
   m_mesh = Handle<Mesh>(mesh.handle());
 
   // open file in read mode
-  CALL_CGNS(cg_open(file.path().c_str(),CG_MODE_READ,&m_file.idx));
+  m_parallel = options().value<bool>("parallel_io") && parallel_io_available();
+  open_file(file.path(),CG_MODE_READ);
 
   // check how many bases we have
   CALL_CGNS(cg_nbases(m_file.idx,&m_file.nbBases));
@@ -86,7 +97,7 @@ void Reader::do_read_mesh_into(const URI& file, Mesh& mesh)
     read_base(*m_mesh);
 
   // close the CGNS file
-  CALL_CGNS(cg_close(m_file.idx));
+  close_file();
 
   // Fix global numbering
   /// @todo remove this and read glb_index ourself
@@ -189,14 +200,26 @@ void Reader::read_zone(Mesh& mesh)
     this_region->add_tag("grid_zone");
     m_zone_map[m_zone.idx] = this_region.get();
 
-    // read coordinates in this zone
-    for (int i=1; i<=m_zone.nbGrids; ++i)
-      read_coordinates_unstructured(*this_region);
-
-    // read sections (or subregions) in this zone
-    m_global_to_region.reserve(m_zone.total_nbElements);
-    for (m_section.idx=1; m_section.idx<=m_zone.nbSections; ++m_section.idx)
-      read_section(*this_region);
+    if (m_parallel)
+    {
+      // read the own slice of every section, and then the nodes needed by these elements
+      m_zone.nodes = &mesh.geometry_fields();
+      m_zone.nodes_start_idx = 0;
+      for (m_section.idx=1; m_section.idx<=m_zone.nbSections; ++m_section.idx)
+        read_section_parallel(*this_region);
+      read_nodes_parallel(*this_region);
+    }
+    else
+    {
+      // read coordinates in this zone
+      for (int i=1; i<=m_zone.nbGrids; ++i)
+        read_coordinates_unstructured(*this_region);
+
+      // read sections (or subregions) in this zone
+      m_global_to_region.reserve(m_zone.total_nbElements);
+      for (m_section.idx=1; m_section.idx<=m_zone.nbSections; ++m_section.idx)
+        read_section(*this_region);
+    }
 
 //    // Only read boco's if sections are not defined as BC's
 //    if (!option("SectionsAreBCs")->value<bool>())
@@ -217,6 +240,8 @@ void Reader::read_zone(Mesh& mesh)
     // truely deallocate the global_to_region vector
     m_global_to_region.resize(0);
     std::vector<Region_TableIndex_pair>().swap (m_global_to_region);
+    m_owned_global_to_region.clear();
+    m_section_ranges.clear();
 
 
 
@@ -224,6 +249,9 @@ void Reader::read_zone(Mesh& mesh)
   }
   else if(m_zone.type == CGNS_ENUMV( Structured ))
   {
+    if (m_parallel)
+      throw NotSupported(FromHere(),"CGNS: structured zones can not be read in parallel slices. Set the option parallel_io to false.");
+
     cgsize_t isize[3][3];
     char zone_name_char[CGNS_CHAR_MAX];
     CALL_CGNS(cg_zone_read(m_file.idx,m_base.idx,m_zone.idx,zone_name_char,isize[0]));
@@ -677,19 +705,32 @@ void Reader::read_boco_unstructured(Region& parent_region)
         throw NotSupported(FromHere(),"CGNS: Boundary with pointset_type \"CGNS_ENUMV( ElementRange )\" is only supported for CGNS_ENUMV( Unstructured ) grids");
 
       // First do some simple checks to see if an entire region can be taken as a BC.
-      Handle< Elements > first_elements = m_global_to_region[boco_elems[0]-1].first;
-      Handle< Elements > last_elements = m_global_to_region[boco_elems[1]-1].first;
-      if (first_elements->parent() == last_elements->parent())
+      if (m_parallel)
       {
-        Handle< Region > group_region = Handle<Region>(first_elements->parent());
-        Uint prev_elm_count = group_region->properties().check("previous_elem_count") ? group_region->properties().value<Uint>("previous_elem_count") : 0;
-        if (group_region->recursive_elements_count(true) == prev_elm_count + Uint(boco_elems[1]-boco_elems[0]+1))
+        // The elements are spread over the ranks, so compare with the section ranges to take the same decision everywhere
+        if (Handle<Region> group_region = section_region_of_range(boco_elems[0]-1, boco_elems[1]))
         {
           group_region->properties()["cgns_section_name"] = group_region->name();
           group_region->rename(m_boco.name);
           break;
         }
       }
+      else
+      {
+        Handle< Elements > first_elements = m_global_to_region[boco_elems[0]-1].first;
+        Handle< Elements > last_elements = m_global_to_region[boco_elems[1]-1].first;
+        if (first_elements->parent() == last_elements->parent())
+        {
+          Handle< Region > group_region = Handle<Region>(first_elements->parent());
+          Uint prev_elm_count = group_region->properties().check("previous_elem_count") ? group_region->properties().value<Uint>("previous_elem_count") : 0;
+          if (group_region->recursive_elements_count(true) == prev_elm_count + Uint(boco_elems[1]-boco_elems[0]+1))
+          {
+            group_region->properties()["cgns_section_name"] = group_region->name();
+            group_region->rename(m_boco.name);
+            break;
+          }
+        }
+      }
 
 
       // Create a region inside mesh/regions/bc-regions with the name of the cgns boco.
@@ -709,10 +750,13 @@ void Reader::read_boco_unstructured(Region& parent_region)
       for (int global_element=boco_elems[0]-1;global_element<boco_elems[1];++global_element)
       {
         // Check which region this global_element belongs to
-        Handle< Elements > element_region = m_global_to_region[global_element].first;
+        const Region_TableIndex_pair* found = find_global_element(global_element);
+        if (is_null(found))
+          continue; // read by another rank
+        Handle< Elements > element_region = found->first;
 
         // Check the local element number in this region
-        Uint local_element = m_global_to_region[global_element].second;
+        Uint local_element = found->second;
 
         // Add the local element to the correct Elements component through its buffer
         std::cout << "element_region->element_type().derived_type_name() = " << element_region->element_type().derived_type_name() << std::endl;
@@ -725,7 +769,10 @@ void Reader::read_boco_unstructured(Region& parent_region)
         it->second->flush();
       buffer.clear();
 
-      remove_empty_element_regions(this_region);
+      if (m_parallel)
+        remove_globally_empty_element_regions(this_region);
+      else
+        remove_empty_element_regions(this_region);
       break;
     }
     case CGNS_ENUMV( PointList ):
@@ -735,21 +782,33 @@ void Reader::read_boco_unstructured(Region& parent_region)
         throw NotSupported(FromHere(),"CGNS: Boundary with pointset_type \"ElementList\" is only supported for CGNS_ENUMV( Unstructured ) grids");
 
       // First do some simple checks to see if an entire region can be taken as a BC.
-      std::cout << "boco_elems[0]-1 = " << boco_elems[0]-1 << std::endl;
-      std::cout << m_global_to_region[boco_elems[0]-1].second << std::endl;
-      cf3_assert(m_global_to_region[boco_elems[0]-1].first);
-      Handle< Elements > first_elements = m_global_to_region[boco_elems[0]-1].first;
-      cf3_assert(m_global_to_region[boco_elems[m_boco.nBC_elem-1]-1].first);
-      Handle< Elements > last_elements = m_global_to_region[boco_elems[m_boco.nBC_elem-1]-1].first;
-      if (first_elements->parent() == last_elements->parent())
+      if (m_parallel)
       {
-        Handle< Region > group_region = Handle<Region>(first_elements->parent());
-        if (group_region->name() != m_boco.name)
+        Handle<Region> group_region = section_region_of_range(boco_elems[0]-1, boco_elems[m_boco.nBC_elem-1]);
+        if (is_not_null(group_region) && group_region->name() != m_boco.name)
         {
-          if (group_region->recursive_elements_count(true) == Uint(boco_elems[m_boco.nBC_elem-1]-boco_elems[0]+1))
+          group_region->rename(m_boco.name);
+          break;  // EXIT switch
+        }
+      }
+      else
+      {
+        std::cout << "boco_elems[0]-1 = " << boco_elems[0]-1 << std::endl;
+        std::cout << m_global_to_region[boco_elems[0]-1].second << std::endl;
+        cf3_assert(m_global_to_region[boco_elems[0]-1].first);
+        Handle< Elements > first_elements = m_global_to_region[boco_elems[0]-1].first;
+        cf3_assert(m_global_to_region[boco_elems[m_boco.nBC_elem-1]-1].first);
+        Handle< Elements > last_elements = m_global_to_region[boco_elems[m_boco.nBC_elem-1]-1].first;
+        if (first_elements->parent() == last_elements->parent())
+        {
+          Handle< Region > group_region = Handle<Region>(first_elements->parent());
+          if (group_region->name() != m_boco.name)
           {
-            group_region->rename(m_boco.name);
-            break;  // EXIT switch
+            if (group_region->recursive_elements_count(true) == Uint(boco_elems[m_boco.nBC_elem-1]-boco_elems[0]+1))
+            {
+              group_region->rename(m_boco.name);
+              break;  // EXIT switch
+            }
           }
         }
       }
@@ -774,10 +833,13 @@ void Reader::read_boco_unstructured(Region& parent_region)
         Uint global_element = boco_elems[i]-1;
 
         // Check which region this global_element belongs to
-        Handle< Elements > element_region = m_global_to_region[global_element].first;
+        const Region_TableIndex_pair* found = find_global_element(global_element);
+        if (is_null(found))
+          continue; // read by another rank
+        Handle< Elements > element_region = found->first;
 
         // Check the local element number in this region
-        Uint local_element = m_global_to_region[global_element].second;
+        Uint local_element = found->second;
 
         // Add the local element to the correct Elements component through its buffer
         std::cout << "element_region->element_type().derived_type_name() = " << element_region->element_type().derived_type_name() << std::endl;
@@ -790,7 +852,10 @@ void Reader::read_boco_unstructured(Region& parent_region)
         it->second->flush();
       buffer.clear();
 
-      remove_empty_element_regions(this_region);
+      if (m_parallel)
+        remove_globally_empty_element_regions(this_region);
+      else
+        remove_empty_element_regions(this_region);
 
       break;
     }
@@ -993,7 +1058,7 @@ void Reader::read_flowsolution()
     switch (m_flowsol.grid_loc)
     {
       case CGNS_ENUMV( Vertex ):
-        datasize = m_zone.total_nbVertices;
+        datasize = m_parallel ? m_zone_glb_nodes.size() : m_zone.total_nbVertices;
         dict = m_mesh->geometry_fields().handle<Dictionary>();
         break;
       case CGNS_ENUMV( CellCenter ):
@@ -1008,7 +1073,7 @@ void Reader::read_flowsolution()
         throw NotSupported(FromHere(), "Flow solution Grid location ["+to_str((int)m_flowsol.grid_loc)+"] is not supported");
     }
 
-    cf3_assert(datasize == m_zone.total_nbVertices);
+    cf3_assert(m_parallel || datasize == m_zone.total_nbVertices);
     cf3_assert(datasize == m_mesh->geometry_fields().size());
 
     boost::shared_ptr<math::VariablesDescriptor> variables = allocate_component<math::VariablesDescriptor>("variables");
@@ -1037,10 +1102,17 @@ void Reader::read_flowsolution()
       m_field.name=field_name_char;
 
       std::vector<double> field_data(datasize);
-      cgsize_t imin = 1;
-      cgsize_t imax = datasize;
-      CALL_CGNS(cg_field_read( m_file.idx,m_base.idx,m_zone.idx,m_flowsol.idx,
-                               field_name_char,CGNS_ENUMV( RealDouble ),&imin,&imax,(void*)(&field_data[0]) ));
+      if (m_parallel)
+      {
+        read_vertex_field_parallel(field_data);
+      }
+      else
+      {
+          cgsize_t imin = 1;
+          cgsize_t imax = datasize;
+          CALL_CGNS(cg_field_read( m_file.idx,m_base.idx,m_zone.idx,m_flowsol.idx,
+                                   field_name_char,CGNS_ENUMV( RealDouble ),&imin,&imax,(void*)(&field_data[0]) ));
+      }
 
       cf3_assert(field_data.size() == flowsol_field.size());
       cf3_assert(flowsol_field.nb_vars() == m_flowsol.nbFields);
@@ -1083,6 +1155,280 @@ Uint Reader::get_total_nbElements()
 
 //////////////////////////////////////////////////////////////////////////////
 
+const Reader::Region_TableIndex_pair* Reader::find_global_element(const Uint global_element) const
+{
+  if (m_parallel)
+  {
+    std::map<Uint,Region_TableIndex_pair>::const_iterator found = m_owned_global_to_region.find(global_element);
+    return found == m_owned_global_to_region.end() ? nullptr : &found->second;
+  }
+  cf3_assert(global_element < m_global_to_region.size());
+  return &m_global_to_region[global_element];
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void Reader::read_section_parallel(Region& parent_region)
+{
+  char section_name_char[CGNS_CHAR_MAX];
+
+  // read section information
+  CALL_CGNS(cg_section_read(m_file.idx, m_base.idx, m_zone.idx, m_section.idx, section_name_char, &m_section.type,
+                            &m_section.eBegin, &m_section.eEnd, &m_section.nbBdry, &m_section.parentFlag));
+  m_section.name=section_name_char;
+
+  // replace whitespace by underscore
+  boost::algorithm::replace_all(m_section.name," ","_");
+  boost::algorithm::replace_all(m_section.name,".","_");
+  boost::algorithm::replace_all(m_section.name,":","_");
+  boost::algorithm::replace_all(m_section.name,"/","_");
+
+  if (m_section.type == CGNS_ENUMV( MIXED ))
+    throw NotSupported(FromHere(),"CGNS: section "+m_section.name+" has mixed element types, which can not be read in parallel slices. Set the option parallel_io to false.");
+
+  // Create a new region for this section, with one Elements component, also if this rank reads no elements
+  Region& this_region = parent_region.create_region(m_section.name);
+  CALL_CGNS(cg_npe(m_section.type,&m_section.elemNodeCount));
+  const std::string etype_CF = m_elemtype_CGNS_to_CF[m_section.type]+to_str<int>(m_base.phys_dim)+"D";
+  Elements& elements = this_region.create_elements(etype_CF,*m_zone.nodes);
+
+  // Read the slice of this rank
+  const Uint my_rank = PE::Comm::instance().rank();
+  Uint slice_begin, slice_end;
+  rank_slice(m_section.eEnd-m_section.eBegin+1, my_rank, slice_begin, slice_end);
+  const Uint nb_elems = slice_end-slice_begin;
+
+  std::vector<cgsize_t> elem_nodes(nb_elems*m_section.elemNodeCount);
+#ifdef CF3_HAVE_PCGNS
+  cgsize_t start, end;
+  slice_range(m_section.eBegin, slice_begin, nb_elems, start, end);
+  CALL_CGNS(cgp_elements_read_data(m_file.idx,m_base.idx,m_zone.idx,m_section.idx,start,end,
+                                   nb_elems ? &elem_nodes[0] : nullptr));
+#endif
+
+  // Store the global (0-based) node numbers for now. They are renumbered in read_nodes_parallel()
+  elements.resize(nb_elems);
+  Connectivity& node_connectivity = elements.geometry_space().connectivity();
+  for (Uint elem=0; elem<nb_elems; ++elem)
+  {
+    for (int node=0; node<m_section.elemNodeCount; ++node)
+      node_connectivity[elem][node] = elem_nodes[node+elem*m_section.elemNodeCount]-1;  // -1 because cgns has index-base 1 instead of 0
+    elements.rank()[elem] = my_rank;
+
+    // Store the global element number to a pair of (region , local element number)
+    m_owned_global_to_region[m_section.eBegin-1+slice_begin+elem] = Region_TableIndex_pair(elements.handle<Elements>(),elem);
+  }
+
+  m_section_ranges.push_back(std::make_pair(std::make_pair(Uint(m_section.eBegin-1),Uint(m_section.eEnd)),this_region.handle<Region>()));
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void Reader::read_nodes_parallel(Region& zone_region)
+{
+  CFinfo << "creating coordinates in " << zone_region.uri().string() << CFendl;
+
+  const Uint my_rank = PE::Comm::instance().rank();
+  Uint slice_begin, slice_end;
+  rank_slice(m_zone.total_nbVertices, my_rank, slice_begin, slice_end);
+  m_nb_slice_nodes = slice_end-slice_begin;
+
+  // The local nodes are the owned slice, followed by the other nodes used by the elements read on this rank
+  std::set<Uint> ghost_nodes;
+  boost_foreach(const Elements& elements, find_components_recursively<Elements>(zone_region))
+  {
+    const Connectivity& node_connectivity = elements.geometry_space().connectivity();
+    for (Uint elem=0; elem<node_connectivity.size(); ++elem)
+    {
+      for (Uint node=0; node<node_connectivity.row_size(); ++node)
+      {
+        const Uint glb_node = node_connectivity[elem][node];
+        if (glb_node < slice_begin || glb_node >= slice_end)
+          ghost_nodes.insert(glb_node);
+      }
+    }
+  }
+
+  m_zone_glb_nodes.clear();
+  m_zone_glb_nodes.reserve(m_nb_slice_nodes+ghost_nodes.size());
+  for (Uint glb_node=slice_begin; glb_node<slice_end; ++glb_node)
+    m_zone_glb_nodes.push_back(glb_node);
+  m_zone_glb_nodes.insert(m_zone_glb_nodes.end(),ghost_nodes.begin(),ghost_nodes.end());
+
+  // Read the coordinates of the owned slice, and get the other ones from their owners
+  const Uint dim = m_zone.coord_dim;
+  const char* coord_names[3] = {"CoordinateX","CoordinateY","CoordinateZ"};
+  std::vector<Real> coord_data(m_zone_glb_nodes.size()*dim);
+  std::vector<Real> component(m_nb_slice_nodes);
+  for (Uint d=0; d<dim; ++d)
+  {
+    cgsize_t rmin, rmax;
+    slice_range(1, slice_begin, m_nb_slice_nodes, rmin, rmax);
+    const int coord_idx = coordinate_index(coord_names[d]);
+#ifdef CF3_HAVE_PCGNS
+    CALL_CGNS(cgp_coord_read_data(m_file.idx,m_base.idx,m_zone.idx,coord_idx,&rmin,&rmax,
+                                  m_nb_slice_nodes ? &component[0] : nullptr));
+#endif
+    for (Uint n=0; n<m_nb_slice_nodes; ++n)
+      coord_data[n*dim+d] = component[n];
+  }
+  exchange_ghost_node_data(coord_data,dim);
+
+  m_mesh->initialize_nodes(m_zone_glb_nodes.size(), dim);
+  Dictionary& nodes = *m_zone.nodes;
+  common::Table<Real>& coords = nodes.coordinates();
+  std::map<Uint,Uint> ghost_glb_to_loc;
+  for (Uint n=0; n<m_zone_glb_nodes.size(); ++n)
+  {
+    for (Uint d=0; d<dim; ++d)
+      coords[n][d] = coord_data[n*dim+d];
+    nodes.glb_idx()[n] = m_zone_glb_nodes[n];
+    if (n < m_nb_slice_nodes)
+    {
+      nodes.rank()[n] = my_rank;
+    }
+    else
+    {
+      nodes.rank()[n] = rank_of_slice(m_zone.total_nbVertices, m_zone_glb_nodes[n]);
+      ghost_glb_to_loc[m_zone_glb_nodes[n]] = n;
+    }
+  }
+
+  // Renumber the connectivity from global CGNS node numbers to local node indices
+  boost_foreach(Elements& elements, find_components_recursively<Elements>(zone_region))
+  {
+    Connectivity& node_connectivity = elements.geometry_space().connectivity();
+    for (Uint elem=0; elem<node_connectivity.size(); ++elem)
+    {
+      for (Uint node=0; node<node_connectivity.row_size(); ++node)
+      {
+        const Uint glb_node = node_connectivity[elem][node];
+        if (glb_node >= slice_begin && glb_node < slice_end)
+          node_connectivity[elem][node] = glb_node-slice_begin;
+        else
+          node_connectivity[elem][node] = ghost_glb_to_loc[glb_node];
+      }
+    }
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void Reader::read_vertex_field_parallel(std::vector<Real>& field_data)
+{
+  cf3_assert(field_data.size() == m_zone_glb_nodes.size());
+  if (m_field.datatype != CGNS_ENUMV( RealDouble ))
+    throw NotSupported(FromHere(),"CGNS: only double precision fields can be read in parallel slices");
+
+  Uint slice_begin, slice_end;
+  rank_slice(m_zone.total_nbVertices, PE::Comm::instance().rank(), slice_begin, slice_end);
+  cgsize_t rmin, rmax;
+  slice_range(1, slice_begin, slice_end-slice_begin, rmin, rmax);
+#ifdef CF3_HAVE_PCGNS
+  CALL_CGNS(cgp_field_read_data(m_file.idx,m_base.idx,m_zone.idx,m_flowsol.idx,m_field.idx,&rmin,&rmax,
+                                m_nb_slice_nodes ? &field_data[0] : nullptr));
+#endif
+  exchange_ghost_node_data(field_data,1);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void Reader::exchange_ghost_node_data(std::vector<Real>& data, const Uint stride) const
+{
+  const Uint nb_procs = PE::Comm::instance().size();
+  Uint slice_begin, slice_end;
+  rank_slice(m_zone.total_nbVertices, PE::Comm::instance().rank(), slice_begin, slice_end);
+
+  // Ask the owner of every ghost node for its data
+  std::vector< std::vector<Uint> > requests(nb_procs);
+  std::vector< std::vector<Uint> > request_positions(nb_procs);
+  for (Uint n=m_nb_slice_nodes; n<m_zone_glb_nodes.size(); ++n)
+  {
+    const Uint owner = rank_of_slice(m_zone.total_nbVertices, m_zone_glb_nodes[n]);
+    requests[owner].push_back(m_zone_glb_nodes[n]);
+    request_positions[owner].push_back(n);
+  }
+  std::vector< std::vector<Uint> > received_requests(nb_procs);
+  PE::Comm::instance().all_to_all(requests, received_requests);
+
+  // Answer with the data of the owned slice
+  std::vector< std::vector<Real> > answers(nb_procs);
+  for (Uint pid=0; pid<nb_procs; ++pid)
+  {
+    answers[pid].reserve(received_requests[pid].size()*stride);
+    boost_foreach(const Uint glb_node, received_requests[pid])
+    {
+      cf3_assert(glb_node >= slice_begin && glb_node < slice_end);
+      const Uint loc_node = glb_node-slice_begin;
+      for (Uint j=0; j<stride; ++j)
+        answers[pid].push_back(data[loc_node*stride+j]);
+    }
+  }
+  std::vector< std::vector<Real> > received_answers(nb_procs);
+  PE::Comm::instance().all_to_all(answers, received_answers);
+
+  for (Uint pid=0; pid<nb_procs; ++pid)
+  {
+    cf3_assert(received_answers[pid].size() == request_positions[pid].size()*stride);
+    for (Uint i=0; i<request_positions[pid].size(); ++i)
+      for (Uint j=0; j<stride; ++j)
+        data[request_positions[pid][i]*stride+j] = received_answers[pid][i*stride+j];
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void Reader::remove_globally_empty_element_regions(Region& region)
+{
+  // All ranks create the same Elements components in the same order
+  std::vector< Handle<Elements> > empty_elements;
+  boost_foreach(Elements& elements, find_components_recursively<Elements>(region))
+  {
+    const Uint local_size = elements.size();
+    Uint global_size(0);
+    PE::Comm::instance().all_reduce(PE::plus(), &local_size, 1, &global_size);
+    if (global_size == 0)
+      empty_elements.push_back(elements.handle<Elements>());
+  }
+  boost_foreach(const Handle<Elements>& elements, empty_elements)
+    elements->parent()->remove_component(elements->name());
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+Handle<Region> Reader::section_region_of_range(const Uint begin, const Uint end) const
+{
+  for (Uint i=0; i<m_section_ranges.size(); ++i)
+  {
+    if (m_section_ranges[i].first.first == begin && m_section_ranges[i].first.second == end)
+      return m_section_ranges[i].second;
+  }
+  return Handle<Region>();
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+int Reader::coordinate_index(const std::string& name)
+{
+  int nb_coords;
+  CALL_CGNS(cg_ncoords(m_file.idx,m_base.idx,m_zone.idx,&nb_coords));
+  for (int c=1; c<=nb_coords; ++c)
+  {
+    CGNS_ENUMT( DataType_t ) datatype;
+    char coord_name_char[CGNS_CHAR_MAX];
+    CALL_CGNS(cg_coord_info(m_file.idx,m_base.idx,m_zone.idx,c,&datatype,coord_name_char));
+    if (name == coord_name_char)
+    {
+      if (datatype != CGNS_ENUMV( RealDouble ))
+        throw NotSupported(FromHere(),"CGNS: only double precision coordinates can be read in parallel slices");
+      return c;
+    }
+  }
+  throw ValueNotFound(FromHere(),"CGNS: coordinate "+name+" not found in zone "+m_zone.name);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
 } // CGNS
 } // mesh
 } // cf3
@@ -59,6 +59,24 @@ private: // functions
   void read_flowsolution();
   Uint get_total_nbElements();
 
+  /// @name Parallel reading
+  /// Every rank reads a contiguous slice of each section and of the node arrays, plus the nodes that its elements need.
+  //@{
+  void read_section_parallel(Region& parent_region);
+  void read_nodes_parallel(Region& zone_region);
+  void read_vertex_field_parallel(std::vector<Real>& field_data);
+  /// Fill the data of the nodes outside the owned slice (stride values per node) with the data of their owners
+  void exchange_ghost_node_data(std::vector<Real>& data, const Uint stride) const;
+  /// Remove Elements that are empty on all ranks, so the component tree stays the same everywhere
+  void remove_globally_empty_element_regions(Region& region);
+  /// Region of the section that has exactly the global element range [begin,end), or null
+  Handle<Region> section_region_of_range(const Uint begin, const Uint end) const;
+  int coordinate_index(const std::string& name);
+  //@}
+
+  /// Region and index of the element with the given global (0-based) CGNS number, or null if the element is not read on this rank
+  const Region_TableIndex_pair* find_global_element(const Uint global_element) const;
+
   Uint structured_node_idx(Uint i, Uint j, Uint k)
   {
     return i + j*m_zone.nbVertices[XX] + k*m_zone.nbVertices[XX]*m_zone.nbVertices[YY];
@@ -71,6 +89,17 @@ private: // functions
 private: // data
 
   std::vector<Region_TableIndex_pair> m_global_to_region;
+
+  /// Parallel reading: region and index of the elements read on this rank, by global (0-based) CGNS number
+  std::map<Uint,Region_TableIndex_pair> m_owned_global_to_region;
+
+  /// Parallel reading: global element range [begin,end) of the regions created for the sections
+  std::vector< std::pair< std::pair<Uint,Uint>, Handle<Region> > > m_section_ranges;
+
+  /// Parallel reading: global (0-based) CGNS number of each local node of the current zone.
+  /// The first m_nb_slice_nodes are the slice owned by this rank, in order.
+  std::vector<Uint> m_zone_glb_nodes;
+  Uint m_nb_slice_nodes;
   Handle<Mesh> m_mesh;
   Uint m_coord_start_idx;
 
@@ -4,6 +4,10 @@
 // GNU Lesser General Public License version 3 (LGPLv3).
 // See doc/lgpl.txt and doc/gpl.txt for the license text.
 
+#include <algorithm>
+
+#include "common/PE/Comm.hpp"
+
 #include "mesh/CGNS/Shared.hpp"
 
 //////////////////////////////////////////////////////////////////////////////
@@ -14,7 +18,8 @@ namespace CGNS {
 
 //////////////////////////////////////////////////////////////////////////////
 
-Shared::Shared()
+Shared::Shared() :
+  m_parallel(false)
 {
   m_supported_element_types.reserve(9);
   m_supported_element_types.push_back("cf3.mesh.LagrangeP1.Line1D");
@@ -46,6 +51,81 @@ Shared::Shared()
 
 //////////////////////////////////////////////////////////////////////////////
 
+bool Shared::parallel_io_available()
+{
+#ifdef CF3_HAVE_PCGNS
+  return common::PE::Comm::instance().is_active() && common::PE::Comm::instance().size() > 1;
+#else
+  return false;
+#endif
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void Shared::open_file(const std::string& path, const int mode)
+{
+#ifdef CF3_HAVE_PCGNS
+  if (m_parallel)
+  {
+    CALL_CGNS(cgp_mpi_comm(common::PE::Comm::instance().communicator()));
+    CALL_CGNS(cgp_open(path.c_str(),mode,&m_file.idx));
+    return;
+  }
+#endif
+  CALL_CGNS(cg_open(path.c_str(),mode,&m_file.idx));
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void Shared::close_file()
+{
+#ifdef CF3_HAVE_PCGNS
+  if (m_parallel)
+  {
+    CALL_CGNS(cgp_close(m_file.idx));
+    return;
+  }
+#endif
+  CALL_CGNS(cg_close(m_file.idx));
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void Shared::rank_slice(const Uint nb_objects, const Uint rank, Uint& begin, Uint& end)
+{
+  const Uint nb_procs = common::PE::Comm::instance().is_active() ? common::PE::Comm::instance().size() : 1u;
+  const Uint slice_size = nb_objects / nb_procs;
+  begin = slice_size*rank;
+  end = (rank == nb_procs-1) ? nb_objects : begin + slice_size;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+Uint Shared::rank_of_slice(const Uint nb_objects, const Uint object)
+{
+  const Uint nb_procs = common::PE::Comm::instance().is_active() ? common::PE::Comm::instance().size() : 1u;
+  const Uint slice_size = nb_objects / nb_procs;
+  if (slice_size == 0)
+    return nb_procs-1;
+  return std::min(nb_procs-1, object / slice_size);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void Shared::slice_range(const Uint first, const Uint offset, const Uint nb_objects, cgsize_t& rmin, cgsize_t& rmax)
+{
+  if (nb_objects == 0)
+  {
+    rmin = first;
+    rmax = first;
+    return;
+  }
+  rmin = first+offset;
+  rmax = first+offset+nb_objects-1;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
 } // CGNS
 } // mesh
 } // cf3
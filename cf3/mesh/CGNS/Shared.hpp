@@ -9,7 +9,12 @@
 
 ////////////////////////////////////////////////////////////////////////////////
 
+#include "coolfluid-packages.hpp"
+
 #include <cgnslib.h>
+#ifdef CF3_HAVE_PCGNS
+  #include <pcgnslib.h>
+#endif
 
 #include "mesh/CGNS/LibCGNS.hpp"
 #include "mesh/CGNS/CGNSExceptions.hpp"
@@ -55,8 +60,32 @@ public:
 
   std::vector<std::string>& get_supported_element_types() { return m_supported_element_types; }
 
+  /// True if this build can access one CGNS file from all ranks at once
+  static bool parallel_io_available();
+
 protected:
 
+  /// Open the file, collectively through the parallel CGNS API if m_parallel is true
+  void open_file(const std::string& path, const int mode);
+
+  /// Close the file opened with open_file()
+  void close_file();
+
+  /// Contiguous slice [begin,end) of nb_objects objects that is read or written by the given rank.
+  /// The last rank takes the remainder.
+  static void rank_slice(const Uint nb_objects, const Uint rank, Uint& begin, Uint& end);
+
+  /// Rank whose slice contains the given object
+  static Uint rank_of_slice(const Uint nb_objects, const Uint object);
+
+  /// Inclusive range [rmin,rmax] of the nb_objects objects after offset, in a file array whose first index is first.
+  /// An empty slice gets the valid range [first,first]: the rank must then pass NULL data, so that it still takes part
+  /// in the collective call but reads or writes nothing.
+  static void slice_range(const Uint first, const Uint offset, const Uint nb_objects, cgsize_t& rmin, cgsize_t& rmax);
+
+  /// True if every rank reads or writes only its own slice of the arrays in one shared file
+  bool m_parallel;
+
   std::map<CGNS_ENUMT( ElementType_t ),std::string> m_elemtype_CGNS_to_CF;
   std::map<std::string,CGNS_ENUMT( ElementType_t )> m_elemtype_CF3_to_CGNS;
 
@@ -9,7 +9,13 @@
 #include "common/Log.hpp"
 #include "common/Builder.hpp"
 #include "common/FindComponents.hpp"
+#include "common/List.hpp"
 #include "common/Table.hpp"
+#include "common/OptionList.hpp"
+#include "common/StringConversion.hpp"
+#include "common/PE/Comm.hpp"
+#include "common/PE/DistributedDirectory.hpp"
+#include "common/PE/operations.hpp"
 
 #include "mesh/CGNS/Writer.hpp"
 #include "mesh/Mesh.hpp"
@@ -36,9 +42,13 @@ common::ComponentBuilder < CGNS::Writer, MeshWriter, LibCGNS > aCGNSWriter_Build
 
 Writer::Writer( const std::string& name )
 : MeshWriter(name),
-  Shared()
+  Shared(),
+  m_nodes_offset(0)
 {
-
+  options().add( "parallel_io", true )
+      .description("In parallel, write one file collectively through the parallel CGNS API, if available."
+                   " Otherwise every rank writes its own file.")
+      .pretty_name("Parallel IO");
 }
 
 /////////////////////////////////////////////////////////////////////////////
@@ -56,14 +66,19 @@ void Writer::write()
 {
   m_fileBasename = m_file_path.base_name(); // filename without extension
 
+  m_parallel = options().value<bool>("parallel_io") && parallel_io_available();
+
+  boost::filesystem::path path (m_file_path.path());
+  if (!m_parallel && PE::Comm::instance().is_active() && PE::Comm::instance().size() > 1)
+    path = path.parent_path() / boost::filesystem::path (boost::filesystem::basename(path) + "_P" + to_str(PE::Comm::instance().rank()) + boost::filesystem::extension(path));
 
-  CFdebug << "Opening file " << m_file_path.path() << CFendl;
-  CALL_CGNS(cg_open(m_file_path.path().c_str(),CG_MODE_WRITE,&m_file.idx));
+  CFdebug << "Opening file " << path.string() << CFendl;
+  open_file(path.string(),CG_MODE_WRITE);
 
   write_base(*m_mesh);
 
-  CFdebug << "Closing file " << m_file_path.path() << CFendl;
-  CALL_CGNS(cg_close(m_file.idx));
+  CFdebug << "Closing file " << path.string() << CFendl;
+  close_file();
 
 }
 
@@ -80,9 +95,14 @@ void Writer::write_base(const Mesh& mesh)
 
   //BOOST_FOREACH(const Region& zone_region, find_components<Region>(base_region))
   //{
-  write_zone(mesh.topology(), mesh);
+  if (m_parallel)
+    write_zone_parallel(mesh.topology(), mesh);
+  else
+    write_zone(mesh.topology(), mesh);
   //}
 
+  write_flowsolutions(mesh);
+
 }
 
 /////////////////////////////////////////////////////////////////////////////
@@ -123,6 +143,11 @@ void Writer::write_zone(const Region& region, const Mesh& mesh)
       xCoord = new Real[m_zone.total_nbVertices];
   }
 
+  m_written_nodes.resize(mesh.geometry_fields().size());
+  for (Uint n=0; n<m_written_nodes.size(); ++n)
+    m_written_nodes[n] = n;
+  m_nodes_offset = 0;
+
   Uint idx=0;
   BOOST_FOREACH(const common::Table<Real>& coordinates, find_components_recursively_with_tag<common::Table<Real> >(mesh.geometry_fields(),mesh::Tags::coordinates()))
   {
@@ -201,7 +226,7 @@ void Writer::write_zone(const Region& region, const Mesh& mesh)
 
 /////////////////////////////////////////////////////////////////////////////
 
-void Writer::write_section(const GroupedElements& grouped_elements)
+std::map<std::string,std::string> Writer::element_type_builder_names() const
 {
   Factory& sf_factory = *Core::instance().factories().get_factory<ElementType>();
   std::map<std::string,std::string> builder_name;
@@ -210,6 +235,14 @@ void Writer::write_section(const GroupedElements& grouped_elements)
     boost::shared_ptr< ElementType > sf = boost::dynamic_pointer_cast<ElementType>(sf_builder.build("sf"));
     builder_name[sf->derived_type_name()] = sf_builder.name();
   }
+  return builder_name;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void Writer::write_section(const GroupedElements& grouped_elements)
+{
+  std::map<std::string,std::string> builder_name = element_type_builder_names();
 
 
 
@@ -319,6 +352,227 @@ void Writer::write_section(const GroupedElements& grouped_elements)
 
 }
 
+/////////////////////////////////////////////////////////////////////////////
+
+void Writer::write_zone_parallel(const Region& region, const Mesh& mesh)
+{
+  const Dictionary& nodes = mesh.geometry_fields();
+  const Uint my_rank = PE::Comm::instance().rank();
+  const Uint nb_procs = PE::Comm::instance().size();
+
+  m_zone.name = region.name();
+  m_zone.coord_dim = mesh.dimension();
+
+  // The owned nodes of each rank form a contiguous slice in the file, in the order of the ranks
+  m_written_nodes.clear();
+  for (Uint n=0; n<nodes.size(); ++n)
+  {
+    if (!nodes.is_ghost(n))
+      m_written_nodes.push_back(n);
+  }
+  std::vector<Uint> nb_nodes_per_rank(nb_procs);
+  PE::Comm::instance().all_gather(Uint(m_written_nodes.size()), nb_nodes_per_rank);
+  m_nodes_offset = 0;
+  for (Uint pid=0; pid<my_rank; ++pid)
+    m_nodes_offset += nb_nodes_per_rank[pid];
+  m_zone.total_nbVertices = 0;
+  for (Uint pid=0; pid<nb_procs; ++pid)
+    m_zone.total_nbVertices += nb_nodes_per_rank[pid];
+
+  // File index of every node. Ghost nodes ask their owner, through a directory of the global node indices.
+  m_file_node_idx.assign(nodes.size(), 0);
+  std::vector<boost::uint64_t> owned_glb_idx(m_written_nodes.size());
+  std::vector<Uint> owned_file_idx(m_written_nodes.size());
+  boost::uint64_t max_glb_idx(0);
+  for (Uint i=0; i<m_written_nodes.size(); ++i)
+  {
+    m_file_node_idx[m_written_nodes[i]] = m_nodes_offset+i+1;
+    owned_glb_idx[i] = nodes.glb_idx()[m_written_nodes[i]];
+    owned_file_idx[i] = m_nodes_offset+i+1;
+  }
+  std::vector<boost::uint64_t> ghost_glb_idx;
+  std::vector<Uint> ghost_nodes;
+  for (Uint n=0; n<nodes.size(); ++n)
+  {
+    max_glb_idx = std::max(max_glb_idx, boost::uint64_t(nodes.glb_idx()[n]));
+    if (nodes.is_ghost(n))
+    {
+      ghost_glb_idx.push_back(nodes.glb_idx()[n]);
+      ghost_nodes.push_back(n);
+    }
+  }
+  boost::uint64_t local_max_glb_idx = max_glb_idx;
+  PE::Comm::instance().all_reduce(PE::max(), &local_max_glb_idx, 1, &max_glb_idx);
+
+  PE::DistributedDirectory<boost::uint64_t> node_directory(max_glb_idx);
+  node_directory.insert(owned_glb_idx, owned_file_idx);
+  std::vector<Uint> ghost_file_idx;
+  std::vector<Uint> ghost_owners;
+  node_directory.find(ghost_glb_idx, ghost_file_idx, ghost_owners);
+  for (Uint g=0; g<ghost_nodes.size(); ++g)
+  {
+    if (ghost_file_idx[g] == node_directory.unknown())
+      throw ValueNotFound(FromHere(), "CGNS: owner of ghost node with glb_idx "+to_str(ghost_glb_idx[g])+" not found");
+    m_file_node_idx[ghost_nodes[g]] = ghost_file_idx[g];
+  }
+
+  // Count the owned volume elements
+  const Uint nb_owned_cells = region.recursive_filtered_elements_count(IsElementsVolume(),false);
+  Uint nb_cells(0);
+  PE::Comm::instance().all_reduce(PE::plus(), &nb_owned_cells, 1, &nb_cells);
+  m_zone.nbElements = nb_cells;
+  m_zone.nbBdryVertices = 0;
+
+  cgsize_t size[3][1];
+  size[0][0] = m_zone.total_nbVertices;
+  size[1][0] = m_zone.nbElements;
+  size[2][0] = m_zone.nbBdryVertices;
+
+  CFdebug << "Writing zone " << m_zone.name << CFendl;
+  CALL_CGNS(cg_zone_write(m_file.idx,m_base.idx,m_zone.name.c_str(),size[0],CGNS_ENUMV( Unstructured ),&m_zone.idx));
+
+  // Coordinates
+  const char* coord_names[3] = {"CoordinateX","CoordinateY","CoordinateZ"};
+  const common::Table<Real>& coordinates = nodes.coordinates();
+  std::vector<Real> component(m_written_nodes.size());
+  for (int d=0; d<m_zone.coord_dim; ++d)
+  {
+    for (Uint i=0; i<m_written_nodes.size(); ++i)
+      component[i] = coordinates[m_written_nodes[i]][d];
+
+    CFdebug << "Writing " << coord_names[d] << CFendl;
+    int cgns_coord_idx;
+    cgsize_t rmin, rmax;
+    slice_range(1, m_nodes_offset, m_written_nodes.size(), rmin, rmax);
+#ifdef CF3_HAVE_PCGNS
+    CALL_CGNS(cgp_coord_write(m_file.idx,m_base.idx,m_zone.idx,CGNS_ENUMV( RealDouble ),coord_names[d],&cgns_coord_idx));
+    CALL_CGNS(cgp_coord_write_data(m_file.idx,m_base.idx,m_zone.idx,cgns_coord_idx,&rmin,&rmax,
+                                   component.empty() ? nullptr : &component[0]));
+#endif
+  }
+
+  // One section per Elements component, each rank writing its owned elements as a slice of the section.
+  // All ranks have the same Elements components, so they create the same sections.
+  std::map<std::string,std::string> builder_name = element_type_builder_names();
+  Uint section_end(0);
+  boost_foreach(const Elements& elements, find_components_recursively<Elements>(region))
+  {
+    std::vector<Uint> owned_elems;
+    for (Uint e=0; e<elements.size(); ++e)
+    {
+      if (!elements.is_ghost(e))
+        owned_elems.push_back(e);
+    }
+    std::vector<Uint> nb_elems_per_rank(nb_procs);
+    PE::Comm::instance().all_gather(Uint(owned_elems.size()), nb_elems_per_rank);
+    Uint elems_offset(0);
+    Uint nb_section_elems(0);
+    for (Uint pid=0; pid<nb_procs; ++pid)
+    {
+      if (pid < my_rank)
+        elems_offset += nb_elems_per_rank[pid];
+      nb_section_elems += nb_elems_per_rank[pid];
+    }
+    if (nb_section_elems == 0)
+      continue;
+
+    const Region& section_region = *Handle<Region const>(elements.parent());
+    m_section.name = section_region.name();
+    if (count(find_components<Elements>(section_region)) > 1)
+      m_section.name += "_" + elements.element_type().shape_name();
+    m_section.type = m_elemtype_CF3_to_CGNS[builder_name[elements.element_type().derived_type_name()]];
+    m_section.elemNodeCount = elements.element_type().nb_nodes();
+    m_section.elemStartIdx = section_end + 1;
+    m_section.elemEndIdx = section_end + nb_section_elems;
+    m_section.nbBdry = 0; // unsorted boundary
+    section_end = m_section.elemEndIdx;
+
+    // If this region is a surface, it must be a boundary condition.
+    // Thus create the boundary condition as an element range (no extra storage)
+    if (IsElementsSurface()(elements))
+    {
+      m_boco.name = m_section.name;
+      m_section.name = m_section.name + "_bc";
+      cgsize_t range[2];
+      range[0] = m_section.elemStartIdx;
+      range[1] = m_section.elemEndIdx;
+      CFdebug << "Writing boco " << m_boco.name << CFendl;
+      CALL_CGNS(cg_boco_write(m_file.idx,m_base.idx,m_zone.idx,m_boco.name.c_str(),CGNS_ENUMV( BCTypeNull ),CGNS_ENUMV( ElementRange ),2,range,&m_boco.idx));
+    }
+
+    const Connectivity& connectivity_table = elements.geometry_space().connectivity();
+    std::vector<cgsize_t> elemNodes(owned_elems.size()*m_section.elemNodeCount);
+    for (Uint i=0; i<owned_elems.size(); ++i)
+    {
+      for (int iNode=0; iNode<m_section.elemNodeCount; ++iNode)
+        elemNodes[iNode+i*m_section.elemNodeCount] = m_file_node_idx[connectivity_table[owned_elems[i]][iNode]];
+    }
+
+    CFdebug << "Writing section " << m_section.name << " of type " << m_elemtype_CGNS_to_CF[m_section.type] << CFendl;
+#ifdef CF3_HAVE_PCGNS
+    CALL_CGNS(cgp_section_write(m_file.idx,m_base.idx,m_zone.idx,m_section.name.c_str(),m_section.type,
+                                m_section.elemStartIdx,m_section.elemEndIdx,m_section.nbBdry,&m_section.idx));
+    cgsize_t start, end;
+    slice_range(m_section.elemStartIdx, elems_offset, owned_elems.size(), start, end);
+    CALL_CGNS(cgp_elements_write_data(m_file.idx,m_base.idx,m_zone.idx,m_section.idx,start,end,
+                                      elemNodes.empty() ? nullptr : &elemNodes[0]));
+#endif
+  }
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void Writer::write_flowsolutions(const Mesh& mesh)
+{
+  const char* xyz[3] = {"X","Y","Z"};
+  std::vector<Real> values(m_written_nodes.size());
+  boost_foreach(const Handle<Field const>& field_ptr, m_fields)
+  {
+    const Field& field = *field_ptr;
+    if (&field.dict() != &mesh.geometry_fields())
+    {
+      CFwarn << "CGNS: field " << field.uri() << " is not stored in the geometry nodes and is not written" << CFendl;
+      continue;
+    }
+
+    m_flowsol.name = field.name();
+    CFdebug << "Writing flow solution " << m_flowsol.name << CFendl;
+    CALL_CGNS(cg_sol_write(m_file.idx,m_base.idx,m_zone.idx,m_flowsol.name.c_str(),CGNS_ENUMV( Vertex ),&m_flowsol.idx));
+
+    for (Uint var=0; var<field.nb_vars(); ++var)
+    {
+      const Uint var_begin = field.var_offset(var);
+      const Uint var_length = static_cast<Uint>(field.var_length(var));
+      for (Uint i=0; i<var_length; ++i)
+      {
+        // CGNS names vector components as VelocityX, VelocityY, ...
+        m_field.name = field.var_name(var);
+        if (var_length > 1)
+          m_field.name += var_length <= 3 ? std::string(xyz[i]) : "_"+to_str(i);
+
+        for (Uint n=0; n<m_written_nodes.size(); ++n)
+          values[n] = field[m_written_nodes[n]][var_begin+i];
+
+        if (m_parallel)
+        {
+          cgsize_t rmin, rmax;
+          slice_range(1, m_nodes_offset, m_written_nodes.size(), rmin, rmax);
+#ifdef CF3_HAVE_PCGNS
+          CALL_CGNS(cgp_field_write(m_file.idx,m_base.idx,m_zone.idx,m_flowsol.idx,CGNS_ENUMV( RealDouble ),m_field.name.c_str(),&m_field.idx));
+          CALL_CGNS(cgp_field_write_data(m_file.idx,m_base.idx,m_zone.idx,m_flowsol.idx,m_field.idx,&rmin,&rmax,
+                                         values.empty() ? nullptr : &values[0]));
+#endif
+        }
+        else
+        {
+          CALL_CGNS(cg_field_write(m_file.idx,m_base.idx,m_zone.idx,m_flowsol.idx,CGNS_ENUMV( RealDouble ),m_field.name.c_str(),
+                                   values.empty() ? nullptr : &values[0],&m_field.idx));
+        }
+      }
+    }
+  }
+}
+
 //////////////////////////////////////////////////////////////////////////////
 
 
@@ -58,6 +58,15 @@ private: // functions
 
   void write_section(const GroupedElements& grouped_elements);
 
+  /// Write the zone collectively: every rank writes its owned nodes and elements as a contiguous slice of the arrays
+  void write_zone_parallel(const Region& region, const Mesh& mesh);
+
+  /// Write the configured fields that are stored in the geometry nodes as vertex flow solutions
+  void write_flowsolutions(const Mesh& mesh);
+
+  /// Map from the derived type name of each element type to its builder name
+  std::map<std::string,std::string> element_type_builder_names() const;
+
 //  void write_boco(const GroupedElements& grouped_elements);
 
 private: // data
@@ -66,6 +75,15 @@ private: // data
 
   std::map<const common::Table<Real>*, Uint> m_global_start_idx;
 
+  /// Local indices of the nodes written by this rank, in the order of the file
+  std::vector<Uint> m_written_nodes;
+
+  /// Number of nodes written by the lower ranks
+  Uint m_nodes_offset;
+
+  /// Parallel writing: index of every local node in the file (1-based), also for ghost nodes
+  std::vector<Uint> m_file_node_idx;
+
 }; // end Writer
 
 
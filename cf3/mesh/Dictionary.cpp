@@ -131,6 +131,10 @@ void Dictionary::resize(const Uint size)
 
 CommPattern& Dictionary::comm_pattern()
 {
+  // A mesh generator that knows the pattern beforehand may already have created it
+  if(is_null(m_comm_pattern))
+    m_comm_pattern = Handle<common::PE::CommPattern>(get_child("CommPattern"));
+
   if(is_null(m_comm_pattern))
   {
     PE::CommPattern& comm_pattern = *create_component<PE::CommPattern>("CommPattern");
@@ -98,7 +98,8 @@ public: // functions
   /// Node to space-element connectivity
   const common::DynTable<SpaceElem>& connectivity() const { return *m_connectivity; }
 
-  /// Return the comm pattern valid for this field group. Created based on the glb_idx and rank if it didn't exist already
+  /// Return the comm pattern valid for this field group. Created based on the glb_idx and rank if it didn't exist already,
+  /// either from a previous call or as a child named "CommPattern" built directly by a mesh generator
   common::PE::CommPattern& comm_pattern();
 
   /// Check if a field row is owned by this rank
@@ -0,0 +1,122 @@
+// Copyright (C) 2010-2013 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+/// @file
+/// @brief Static dispatch of loops over elements to the concrete element type
+///
+/// The virtual ElementType interface converts between dynamic and fixed-size matrices on every call.
+/// Actions that loop over many elements can instead resolve the concrete element type once per Entities
+/// and call the static functions of the element type (e.g. LagrangeP1::Triag2D::volume) on fixed-size matrices,
+/// in the same way as the Proto ElementLooper. Entities of a type that is not in the given list are
+/// reported as not dispatched, so the action can fall back to the virtual interface.
+///
+/// Usage:
+/// @code
+/// struct ComputeVolumes
+/// {
+///   template<typename ETYPE>
+///   void operator()(const ETYPE&, const Entities& entities)
+///   {
+///     for_each_element<ETYPE>(entities, *this);
+///   }
+///
+///   template<typename ETYPE>
+///   void operator()(const ETYPE&, const Uint elem_idx, const typename ETYPE::NodesT& nodes) { ... ETYPE::volume(nodes) ... }
+/// };
+///
+/// ComputeVolumes volumes;
+/// if(!dispatch_element_type<LagrangeP1::CellTypes>(cells, volumes))
+///   ... // use cells.element_type()
+/// @endcode
+
+#ifndef cf3_mesh_ElementTypeLoop_hpp
+#define cf3_mesh_ElementTypeLoop_hpp
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <boost/mpl/for_each.hpp>
+
+#include "mesh/Connectivity.hpp"
+#include "mesh/Dictionary.hpp"
+#include "mesh/ElementData.hpp"
+#include "mesh/ElementType.hpp"
+#include "mesh/Entities.hpp"
+#include "mesh/Field.hpp"
+#include "mesh/Space.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace mesh {
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace detail
+{
+  /// Calls the functor for the element type of the entities, if it is the type that is visited
+  template<typename FunctorT>
+  struct ElementTypeDispatcher
+  {
+    ElementTypeDispatcher(const Entities& entities, FunctorT& functor, bool& found) :
+      m_entities(entities),
+      m_functor(functor),
+      m_found(found)
+    {
+    }
+
+    template<typename ETYPE>
+    void operator()(const ETYPE& etype) const
+    {
+      if(m_found || !IsElementType<ETYPE>()(m_entities.element_type()))
+        return;
+
+      m_found = true;
+      m_functor(etype, m_entities);
+    }
+
+    const Entities& m_entities;
+    FunctorT& m_functor;
+    bool& m_found;
+  };
+}
+
+/// Call functor(ETYPE(), entities) with the type from ElementTypesT that matches the element type of the entities
+/// @return false if none of the types in ElementTypesT matches, in which case the functor was not called
+template<typename ElementTypesT, typename FunctorT>
+bool dispatch_element_type(const Entities& entities, FunctorT& functor)
+{
+  bool found = false;
+  boost::mpl::for_each<ElementTypesT>(detail::ElementTypeDispatcher<FunctorT>(entities, functor, found));
+  return found;
+}
+
+/// Call kernel(ETYPE(), elem_idx, nodes) for each element of the entities, with the coordinates of the element nodes
+/// in the fixed-size matrix ETYPE::NodesT. The entities must be of type ETYPE.
+template<typename ETYPE, typename KernelT>
+void for_each_element(const Entities& entities, KernelT& kernel)
+{
+  cf3_assert(IsElementType<ETYPE>()(entities.element_type()));
+
+  const Connectivity& connectivity = entities.geometry_space().connectivity();
+  const Field& coordinates = entities.geometry_fields().coordinates();
+  const ETYPE etype = ETYPE();
+  typename ETYPE::NodesT nodes;
+  const Uint nb_elems = entities.size();
+  for(Uint elem_idx = 0; elem_idx != nb_elems; ++elem_idx)
+  {
+    fill(nodes, coordinates, connectivity[elem_idx]);
+    kernel(etype, elem_idx, nodes);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // mesh
+} // cf3
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // cf3_mesh_ElementTypeLoop_hpp
@@ -4,6 +4,11 @@
 // GNU Lesser General Public License version 3 (LGPLv3).
 // See doc/lgpl.txt and doc/gpl.txt for the license text.
 
+#include <algorithm>
+
+#include <boost/ptr_container/ptr_vector.hpp>
+#include <boost/thread/thread.hpp>
+
 #include "common/Log.hpp"
 #include "common/OptionList.hpp"
 #include "common/OptionT.hpp"
@@ -17,6 +22,7 @@
 #include "math/Consts.hpp"
 
 #include "mesh/FaceCellConnectivity.hpp"
+#include "mesh/FaceHashTable.hpp"
 #include "mesh/NodeElementConnectivity.hpp"
 #include "mesh/Dictionary.hpp"
 #include "mesh/Mesh.hpp"
@@ -42,13 +48,25 @@ common::ComponentBuilder < FaceCellConnectivity , Component, LibMesh > FaceCellC
 FaceCellConnectivity::FaceCellConnectivity ( const std::string& name ) :
   Component(name),
   m_nb_faces(0),
-  m_face_building_algorithm(false)
+  m_face_building_algorithm(false),
+  m_hashed(false),
+  m_nb_threads(1)
 {
 
   options().add("face_building_algorithm", m_face_building_algorithm)
       .link_to(&m_face_building_algorithm)
       .description("Improves efficiency for face building algorithm");
 
+  options().add("hashed", m_hashed)
+      .link_to(&m_hashed)
+      .pretty_name("Hashed")
+      .description("Match faces through a hash table of their sorted nodes instead of node to face lists");
+
+  options().add("nb_threads", m_nb_threads)
+      .link_to(&m_nb_threads)
+      .pretty_name("Number of Threads")
+      .description("Number of threads used to match the faces, if hashed is true");
+
   m_used_components = create_static_component<Group>("used_components");
   m_connectivity = create_static_component<common::Table<Entity> >(mesh::Tags::connectivity_table());
   m_face_nb_in_elem = create_static_component<common::Table<Uint> >("face_number");
@@ -117,6 +135,34 @@ void FaceCellConnectivity::build_connectivity()
     return;
   }
 
+  if (m_face_building_algorithm)
+  {
+    // allocate storage if doesn't exist that says if the element is at the boundary of a region
+    // ( = not the same as the mesh boundary)
+    boost_foreach (Handle< Component > elements_comp, used())
+    {
+      Elements& elements = dynamic_cast<Elements&>(*elements_comp);
+      Handle< Component > comp = elements.get_child("is_bdry");
+      if ( is_null( comp ) || is_null(Handle< common::List<bool> >(comp)) )
+      {
+        common::List<bool>& is_bdry_elem = * elements.create_component< common::List<bool> >("is_bdry");
+
+        const Uint nb_elem = elements.size();
+        is_bdry_elem.resize(nb_elem);
+
+        for (Uint e=0; e<nb_elem; ++e)
+          is_bdry_elem[e] = true;
+      }
+      cf3_assert( Handle< common::List<bool> >(elements.get_child("is_bdry")) );
+    }
+  }
+
+  if (m_hashed)
+  {
+    build_connectivity_hashed();
+    return;
+  }
+
   // declartions
   m_connectivity->resize(0);
   common::Table<Entity>::Buffer f2c = m_connectivity->create_buffer();
@@ -143,28 +189,6 @@ void FaceCellConnectivity::build_connectivity()
     max_nb_faces += nb_faces * elements->size() ;
   }
 
-  if (m_face_building_algorithm)
-  {
-    // allocate storage if doesn't exist that says if the element is at the boundary of a region
-    // ( = not the same as the mesh boundary)
-    boost_foreach (Handle< Component > elements_comp, used())
-    {
-      Elements& elements = dynamic_cast<Elements&>(*elements_comp);
-      Handle< Component > comp = elements.get_child("is_bdry");
-      if ( is_null( comp ) || is_null(Handle< common::List<bool> >(comp)) )
-      {
-        common::List<bool>& is_bdry_elem = * elements.create_component< common::List<bool> >("is_bdry");
-
-        const Uint nb_elem = elements.size();
-        is_bdry_elem.resize(nb_elem);
-
-        for (Uint e=0; e<nb_elem; ++e)
-          is_bdry_elem[e] = true;
-      }
-      cf3_assert( Handle< common::List<bool> >(elements.get_child("is_bdry")) );
-    }
-  }
-
   // Declarations to save frequent allocations in the loop algorithm
   Uint nb_inner_faces = 0;
   Uint nb_matched_nodes = 1;
@@ -339,6 +363,13 @@ void FaceCellConnectivity::build_connectivity()
 
   cf3_assert(m_nb_faces == m_connectivity->size());
 
+  update_bdry_elements();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void FaceCellConnectivity::update_bdry_elements()
+{
   if (m_face_building_algorithm)
   {
     for (Uint f=0; f<m_connectivity->size(); ++f)
@@ -349,11 +380,265 @@ void FaceCellConnectivity::build_connectivity()
         if ( is_not_null(elem.comp) )
         {
           common::List<bool>& is_bdry_elem = *Handle< common::List<bool> >(elem.comp->get_child("is_bdry"));
-          is_bdry_elem[elem.idx] = is_bdry_elem[elem.idx] || is_bdry_face.get_row(f) ;
+          is_bdry_elem[elem.idx] = is_bdry_elem[elem.idx] || (*m_is_bdry_face)[f] ;
+        }
+      }
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace detail
+{
+  /// The cells of all used Elements, numbered contiguously in the order of used()
+  struct CellNumbering
+  {
+    CellNumbering() : max_nb_face_nodes(1)
+    {
+      offsets.push_back(0);
+    }
+
+    void add(Elements& elements, const common::List<bool>* is_bdry_elem)
+    {
+      entities.push_back(&elements);
+      is_bdry.push_back(is_bdry_elem);
+      offsets.push_back(offsets.back() + elements.size());
+      const ElementType& etype = elements.element_type();
+      for (Uint face_idx = 0; face_idx != etype.nb_faces(); ++face_idx)
+        max_nb_face_nodes = std::max(max_nb_face_nodes, static_cast<Uint>(etype.faces().nodes_range(face_idx).size()));
+    }
+
+    Uint nb_cells() const { return offsets.back(); }
+
+    /// Index in entities of the Elements that contain the given cell
+    Uint elements_of(const Uint cell) const
+    {
+      return static_cast<Uint>(std::upper_bound(offsets.begin(), offsets.end(), cell) - offsets.begin()) - 1;
+    }
+
+    /// Nodes of a face of a cell, in the order of the cell
+    Uint face_nodes(const Uint cell, const Uint face_idx, Uint* nodes) const
+    {
+      const Uint e = elements_of(cell);
+      return face_nodes(e, cell - offsets[e], face_idx, nodes);
+    }
+
+    Uint face_nodes(const Uint e, const Uint local_idx, const Uint face_idx, Uint* nodes) const
+    {
+      Connectivity::ConstRow elem_nodes = entities[e]->geometry_space().connectivity()[local_idx];
+      Uint nb_nodes = 0;
+      boost_foreach(const Uint face_node_idx, entities[e]->element_type().faces().nodes_range(face_idx))
+        nodes[nb_nodes++] = elem_nodes[face_node_idx];
+      return nb_nodes;
+    }
+
+    Entity entity(const Uint cell) const
+    {
+      const Uint e = elements_of(cell);
+      return Entity(*entities[e], cell - offsets[e]);
+    }
+
+    std::vector<Elements*> entities;
+    /// Cells that are not flagged in these lists are skipped, if the list is not null
+    std::vector<const common::List<bool>*> is_bdry;
+    std::vector<Uint> offsets;
+    Uint max_nb_face_nodes;
+  };
+
+  /// Faces found in a contiguous range of cells, in the order they were first found
+  struct FaceBlock
+  {
+    FaceBlock(const Uint max_nb_face_nodes, const Uint expected_nb_faces) :
+      faces(max_nb_face_nodes, expected_nb_faces)
+    {
+    }
+
+    /// Add a face, matching it with an existing face of the block if any
+    void add(const Uint cell, const Uint face_idx, const Uint* nodes, const Uint nb_nodes)
+    {
+      bool inserted = false;
+      const Uint face = faces.insert(nodes, nb_nodes, inserted);
+      if (inserted)
+      {
+        left_cell.push_back(cell);
+        left_face.push_back(face_idx);
+        left_first_node.push_back(nodes[0]);
+        right_cell.push_back(FaceHashTable::npos());
+        right_face.push_back(0);
+        right_rotation.push_back(0);
+      }
+      else
+      {
+        match(face, cell, face_idx, nodes, nb_nodes);
+      }
+    }
+
+    /// Set the second cell of a face. The rotation is the position of the first node of the face in the
+    /// first cell, among the nodes of the face in the second cell.
+    void match(const Uint face, const Uint cell, const Uint face_idx, const Uint* nodes, const Uint nb_nodes)
+    {
+      right_cell[face] = cell;
+      right_face[face] = face_idx;
+      Uint rotation;
+      for (rotation=0; rotation!=nb_nodes; ++rotation)
+      {
+        if (nodes[rotation] == left_first_node[face])
+          break;
+      }
+      // Following assertion fails, it means the correct orientation was not found! This should never happen!
+      cf3_always_assert(rotation != nb_nodes);
+      right_rotation[face] = rotation;
+    }
+
+    Uint size() const { return left_cell.size(); }
+
+    FaceHashTable faces;
+    std::vector<Uint> left_cell;
+    std::vector<Uint> left_face;
+    std::vector<Uint> left_first_node;
+    std::vector<Uint> right_cell;
+    std::vector<Uint> right_face;
+    std::vector<Uint> right_rotation;
+  };
+
+  /// Collects the faces of a range of cells, executed by one thread
+  struct BuildFaceBlock
+  {
+    BuildFaceBlock(const CellNumbering& numbering, FaceBlock& face_block, const Uint begin_cell, const Uint end_cell) :
+      cells(numbering),
+      block(face_block),
+      begin(begin_cell),
+      end(end_cell)
+    {
+    }
+
+    void operator()()
+    {
+      std::vector<Uint> nodes(cells.max_nb_face_nodes);
+      Uint e = cells.elements_of(begin);
+      for (Uint cell = begin; cell != end; ++cell)
+      {
+        while (cell == cells.offsets[e+1])
+          ++e;
+        const Uint local_idx = cell - cells.offsets[e];
+        if (is_not_null(cells.is_bdry[e]) && (*cells.is_bdry[e])[local_idx] == false)
+          continue;
+
+        const Uint nb_faces = cells.entities[e]->element_type().nb_faces();
+        for (Uint face_idx = 0; face_idx != nb_faces; ++face_idx)
+        {
+          const Uint nb_nodes = cells.face_nodes(e, local_idx, face_idx, &nodes[0]);
+          block.add(cell, face_idx, &nodes[0], nb_nodes);
         }
       }
     }
+
+    const CellNumbering& cells;
+    FaceBlock& block;
+    const Uint begin;
+    const Uint end;
+  };
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void FaceCellConnectivity::build_connectivity_hashed()
+{
+  detail::CellNumbering cells;
+  boost_foreach (Handle< Component > elements_comp, used() )
+  {
+    Elements& elements = dynamic_cast<Elements&>(*elements_comp);
+    const common::List<bool>* is_bdry_elem = 0;
+    if (m_face_building_algorithm)
+      is_bdry_elem = Handle< common::List<bool> >(elements.get_child("is_bdry")).get();
+    cells.add(elements, is_bdry_elem);
   }
+
+  const Uint nb_cells = cells.nb_cells();
+  const Uint nb_blocks = std::max(1u, std::min(m_nb_threads, nb_cells));
+
+  // Each block of cells is processed by its own thread, matching the faces within the block
+  boost::ptr_vector<detail::FaceBlock> blocks;
+  for (Uint b = 0; b != nb_blocks; ++b)
+    blocks.push_back(new detail::FaceBlock(cells.max_nb_face_nodes, 4*nb_cells/nb_blocks));
+
+  if (nb_blocks == 1)
+  {
+    detail::BuildFaceBlock(cells, blocks[0], 0, nb_cells)();
+  }
+  else
+  {
+    boost::thread_group threads;
+    for (Uint b = 0; b != nb_blocks; ++b)
+      threads.create_thread(detail::BuildFaceBlock(cells, blocks[b], b*nb_cells/nb_blocks, (b+1)*nb_cells/nb_blocks));
+    threads.join_all();
+  }
+
+  // Merge the blocks in order. Faces that are unmatched in their block are matched with the unmatched faces
+  // of earlier blocks, which hold the lower cell numbers. This gives the same face numbering as the sequential algorithm:
+  // in the order of the first cell of each face.
+  detail::FaceBlock result(cells.max_nb_face_nodes, nb_blocks == 1 ? 0 : 4*nb_cells);
+  std::vector<Uint> nodes(cells.max_nb_face_nodes);
+  std::vector<Uint> open_faces; // result index of each face in result.faces
+  for (Uint b = 0; b != nb_blocks; ++b)
+  {
+    detail::FaceBlock& block = blocks[b];
+    for (Uint f = 0; f != block.size(); ++f)
+    {
+      bool append = true;
+      if (nb_blocks != 1 && block.right_cell[f] == FaceHashTable::npos())
+      {
+        bool inserted = false;
+        const Uint open_face = result.faces.insert(block.faces.nodes(f), block.faces.nb_nodes(f), inserted);
+        if (inserted)
+        {
+          open_faces.push_back(result.size());
+        }
+        else
+        {
+          const Uint nb_nodes = cells.face_nodes(block.left_cell[f], block.left_face[f], &nodes[0]);
+          result.match(open_faces[open_face], block.left_cell[f], block.left_face[f], &nodes[0], nb_nodes);
+          append = false;
+        }
+      }
+      if (append)
+      {
+        result.left_cell.push_back(block.left_cell[f]);
+        result.left_face.push_back(block.left_face[f]);
+        result.left_first_node.push_back(block.left_first_node[f]);
+        result.right_cell.push_back(block.right_cell[f]);
+        result.right_face.push_back(block.right_face[f]);
+        result.right_rotation.push_back(block.right_rotation[f]);
+      }
+    }
+    // Release the memory of the block as soon as it is merged
+    blocks.replace(b, new detail::FaceBlock(1, 0));
+  }
+
+  // Copy the flat arrays into the tables
+  m_nb_faces = result.size();
+  m_connectivity->resize(m_nb_faces);
+  m_face_nb_in_elem->resize(m_nb_faces);
+  m_is_bdry_face->resize(m_nb_faces);
+  m_cell_rotation->resize(m_nb_faces);
+  m_cell_orientation->resize(m_nb_faces);
+  for (Uint f = 0; f != m_nb_faces; ++f)
+  {
+    const bool is_bdry = result.right_cell[f] == FaceHashTable::npos();
+    ElementConnectivity::Row cells_row = (*m_connectivity)[f];
+    cells_row[0] = cells.entity(result.left_cell[f]);
+    cells_row[1] = is_bdry ? Entity() : cells.entity(result.right_cell[f]);
+    (*m_face_nb_in_elem)[f][0] = result.left_face[f];
+    (*m_face_nb_in_elem)[f][1] = result.right_face[f];
+    (*m_is_bdry_face)[f] = is_bdry;
+    (*m_cell_rotation)[f][0] = 0;
+    (*m_cell_rotation)[f][1] = result.right_rotation[f];
+    (*m_cell_orientation)[f][0] = MATCHED;
+    (*m_cell_orientation)[f][1] = INVERTED;
+  }
+
+  update_bdry_elements();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
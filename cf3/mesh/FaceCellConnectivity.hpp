@@ -62,6 +62,9 @@ public:
   /// Build the connectivity table
   /// Build the connectivity table as a DynTable<Uint>
   /// @pre set_nodes() and set_elements() must have been called
+  /// If the option "hashed" is set, faces are matched through a FaceHashTable of their sorted nodes,
+  /// and the cells are split in "nb_threads" contiguous blocks that are processed concurrently.
+  /// Both algorithms number the faces in the same order.
 
   void build_connectivity();
 
@@ -95,6 +98,15 @@ public:
 
   void add_used (Component& used_comp);
 
+private: // functions
+
+  /// Hashed, multi-threaded variant of build_connectivity. The faces are collected in flat arrays
+  /// and copied to the tables at the end.
+  void build_connectivity_hashed();
+
+  /// Mark the cells adjacent to a boundary face in the "is_bdry" list of their Elements
+  void update_bdry_elements();
+
 private: // data
 
   /// nb_faces
@@ -116,6 +128,12 @@ private: // data
 
   bool m_face_building_algorithm;
 
+  /// Use build_connectivity_hashed
+  bool m_hashed;
+
+  /// Number of threads used by build_connectivity_hashed
+  Uint m_nb_threads;
+
 }; // FaceCellConnectivity
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,127 @@
+// Copyright (C) 2010-2013 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#include <algorithm>
+
+#include "common/Assertions.hpp"
+
+#include "mesh/FaceHashTable.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace mesh {
+
+////////////////////////////////////////////////////////////////////////////////
+
+FaceHashTable::FaceHashTable(const Uint max_nb_nodes, const Uint expected_nb_faces) :
+  m_max_nb_nodes(max_nb_nodes),
+  m_nb_faces(0),
+  m_sorted(max_nb_nodes)
+{
+  cf3_assert(max_nb_nodes != 0);
+
+  // Keep the load factor at most 1/2
+  Uint nb_slots = 16;
+  while(nb_slots < 2*expected_nb_faces)
+    nb_slots *= 2;
+  m_slots.assign(nb_slots, npos());
+
+  m_keys.reserve(expected_nb_faces*max_nb_nodes);
+  m_nb_nodes.reserve(expected_nb_faces);
+  m_hashes.reserve(expected_nb_faces);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+Uint FaceHashTable::insert(const Uint* nodes, const Uint nb_nodes, bool& inserted)
+{
+  cf3_assert(nb_nodes <= m_max_nb_nodes);
+
+  if(2*(m_nb_faces+1) > m_slots.size())
+    grow();
+
+  const std::size_t hash = sort_and_hash(nodes, nb_nodes);
+  const Uint slot = lookup(hash, nb_nodes);
+  if(m_slots[slot] != npos())
+  {
+    inserted = false;
+    return m_slots[slot];
+  }
+
+  inserted = true;
+  const Uint face = m_nb_faces++;
+  m_slots[slot] = face;
+  m_keys.insert(m_keys.end(), m_sorted.begin(), m_sorted.end());
+  m_nb_nodes.push_back(nb_nodes);
+  m_hashes.push_back(hash);
+  return face;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+Uint FaceHashTable::find(const Uint* nodes, const Uint nb_nodes) const
+{
+  if(nb_nodes > m_max_nb_nodes)
+    return npos();
+  return m_slots[lookup(sort_and_hash(nodes, nb_nodes), nb_nodes)];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+std::size_t FaceHashTable::sort_and_hash(const Uint* nodes, const Uint nb_nodes) const
+{
+  std::copy(nodes, nodes+nb_nodes, m_sorted.begin());
+  std::fill(m_sorted.begin()+nb_nodes, m_sorted.end(), npos());
+  std::sort(m_sorted.begin(), m_sorted.begin()+nb_nodes);
+
+  // FNV-1a over the node indices
+  std::size_t hash = 2166136261u;
+  for(Uint i = 0; i != nb_nodes; ++i)
+  {
+    hash ^= static_cast<std::size_t>(m_sorted[i]);
+    hash *= 16777619u;
+  }
+  return hash ^ (hash >> 16);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+Uint FaceHashTable::lookup(const std::size_t hash, const Uint nb_nodes) const
+{
+  const Uint mask = m_slots.size() - 1;
+  Uint slot = static_cast<Uint>(hash) & mask;
+  while(true)
+  {
+    const Uint face = m_slots[slot];
+    if(face == npos())
+      return slot;
+    if(m_hashes[face] == hash && m_nb_nodes[face] == nb_nodes && std::equal(m_sorted.begin(), m_sorted.begin()+nb_nodes, m_keys.begin()+face*m_max_nb_nodes))
+      return slot;
+    slot = (slot + 1) & mask;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void FaceHashTable::grow()
+{
+  std::vector<Uint> slots(2*m_slots.size(), npos());
+  const Uint mask = slots.size() - 1;
+  for(Uint face = 0; face != m_nb_faces; ++face)
+  {
+    Uint slot = static_cast<Uint>(m_hashes[face]) & mask;
+    while(slots[slot] != npos())
+      slot = (slot + 1) & mask;
+    slots[slot] = face;
+  }
+  m_slots.swap(slots);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // mesh
+} // cf3
@@ -0,0 +1,92 @@
+// Copyright (C) 2010-2013 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef cf3_mesh_FaceHashTable_hpp
+#define cf3_mesh_FaceHashTable_hpp
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <vector>
+
+#include "mesh/LibMesh.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace mesh {
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Set of faces, identified by their nodes regardless of the order of the nodes.
+/// The sorted node tuples are stored contiguously, and looked up through an open-addressing table
+/// with linear probing, so inserting or finding a face costs a hash and a few comparisons,
+/// without any per-face allocation. Faces are numbered in the order they were inserted.
+/// The node indices may be local or global indices; the table does not interpret them.
+/// Lookups use a work array of the table, so concurrent threads must each use their own table.
+class Mesh_API FaceHashTable
+{
+public:
+  /// @param max_nb_nodes Largest number of nodes of a face
+  /// @param expected_nb_faces Number of faces to reserve space for
+  FaceHashTable(const Uint max_nb_nodes, const Uint expected_nb_faces = 0);
+
+  /// Find the face with the given nodes, or insert it if it is not present
+  /// @param nodes Nodes of the face, in any order
+  /// @param nb_nodes Number of nodes of the face
+  /// @param [out] inserted true if the face was not present
+  /// @return Index of the face
+  Uint insert(const Uint* nodes, const Uint nb_nodes, bool& inserted);
+
+  /// Find the face with the given nodes
+  /// @return Index of the face, or npos() if the face is not present
+  Uint find(const Uint* nodes, const Uint nb_nodes) const;
+
+  /// Number of faces in the table
+  Uint size() const { return m_nb_faces; }
+
+  /// Sorted nodes of the given face
+  const Uint* nodes(const Uint face) const { return &m_keys[face*m_max_nb_nodes]; }
+
+  /// Number of nodes of the given face
+  Uint nb_nodes(const Uint face) const { return m_nb_nodes[face]; }
+
+  /// Value returned by find() for a face that is not present
+  static Uint npos() { return static_cast<Uint>(-1); }
+
+private:
+  /// Sort the nodes into m_sorted and return their hash
+  std::size_t sort_and_hash(const Uint* nodes, const Uint nb_nodes) const;
+
+  /// Slot of the face with the nodes in m_sorted, or of the empty slot where it would be inserted
+  Uint lookup(const std::size_t hash, const Uint nb_nodes) const;
+
+  /// Double the number of slots and re-insert all faces
+  void grow();
+
+  const Uint m_max_nb_nodes;
+  Uint m_nb_faces;
+
+  /// Sorted nodes of each face, m_max_nb_nodes per face
+  std::vector<Uint> m_keys;
+  std::vector<Uint> m_nb_nodes;
+  /// Hash of each face, to avoid recomputing it when growing
+  std::vector<std::size_t> m_hashes;
+
+  /// Face index stored in each slot, npos() for empty slots. The size is a power of two.
+  std::vector<Uint> m_slots;
+
+  /// Work array for sorting the nodes of the face that is looked up
+  mutable std::vector<Uint> m_sorted;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // mesh
+} // cf3
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // cf3_mesh_FaceHashTable_hpp
@@ -124,6 +124,9 @@ public: // functions
 
   void synchronize();
 
+  /// The comm pattern used by synchronize(), null if the field was not parallelized
+  const Handle<common::PE::CommPattern>& comm_pattern() const { return m_comm_pattern; }
+
   math::VariablesDescriptor& descriptor() const { return *m_descriptor; }
 
   void set_descriptor(math::VariablesDescriptor& descriptor);
@@ -15,6 +15,7 @@
 #include "common/PropertyList.hpp"
 
 #include "common/PE/debug.hpp"
+#include "common/PE/DistributedDirectory.hpp"
 
 #include "math/Consts.hpp"
 #include "math/VariablesDescriptor.hpp"
@@ -1051,47 +1052,33 @@ void MeshAdaptor::fix_node_ranks()
   rebuild_node_glb_to_loc_map();
   boost_foreach (const Handle<Dictionary>& dict, m_mesh->dictionaries())
   {
-    // nodes to send to other cpu's
+    // The owner of a node is the lowest rank that has it. Every cpu registers its nodes
+    // in a directory distributed over the glb_idx range, and asks the directory for the owners.
     std::vector<boost::uint64_t> glb_nodes(dict->size());
+    boost::uint64_t max_glb_node(0);
     for (Uint n=0; n<glb_nodes.size(); ++n)
     {
-      // fill the nodes to send to other cpu's
       glb_nodes[n] = dict->glb_idx()[n];
-
-      // assign the rank to be ourself to start with. The rank can only become lower.
-      cf3_assert(n<dict->rank().size());
-      dict->rank()[n] = PE::Comm::instance().rank();
+      max_glb_node = std::max(max_glb_node, glb_nodes[n]);
     }
-
-    // Every cpu broadcasts to cpu's with higher rank
-    for (Uint root=0; root<PE::Comm::instance().size(); ++root)
+    if (PE::Comm::instance().is_active())
     {
-      //    CFinfo << "broadcasting from root " << root << CFendl;
-      PE::Comm::instance().barrier();
+      boost::uint64_t local_max_glb_node = max_glb_node;
+      PE::Comm::instance().all_reduce(PE::max(), &local_max_glb_node, 1, &max_glb_node);
+    }
 
-      std::vector<boost::uint64_t> glb_nodes_from_root(0);
-      PE::Comm::instance().broadcast(glb_nodes,glb_nodes_from_root,root);
+    PE::DistributedDirectory<boost::uint64_t> node_directory(max_glb_node);
+    node_directory.insert(glb_nodes, std::vector<Uint>(glb_nodes.size(), 0u));
 
-      // cpu's with higher rank will adapt the ranks of the nodes
-      if (PE::Comm::instance().rank() > root)
-      {
+    std::vector<Uint> unused_values;
+    std::vector<Uint> owners;
+    node_directory.find(glb_nodes, unused_values, owners);
 
-        boost_foreach(const boost::uint64_t& glb_node, glb_nodes_from_root)
-        {
-          if (dict->glb_to_loc().exists(glb_node))
-          {
-            Uint loc_node = dict->glb_to_loc()[glb_node];
-            cf3_assert(dict->glb_idx()[loc_node]==glb_node);
-            cf3_assert(loc_node<dict->rank().size());
-            // if the rank is yourself, it means that the glb_node has not been found
-            // before. Change then the rank to the broacasting cpu.
-            if (dict->rank()[loc_node] == PE::Comm::instance().rank())
-            {
-              dict->rank()[loc_node] = std::min(root,dict->rank()[loc_node]);
-            }
-          }
-        }
-      }
+    cf3_assert(dict->rank().size() == owners.size());
+    for (Uint n=0; n<owners.size(); ++n)
+    {
+      cf3_assert(owners[n] <= PE::Comm::instance().rank());
+      dict->rank()[n] = owners[n];
     }
   }
 
@@ -1669,29 +1656,6 @@ void MeshAdaptor::remove_duplicate_elements_and_nodes()
 
 ////////////////////////////////////////////////////////////////////////////////
 
-template <typename T>
-void MeshAdaptor_send_receive(const Uint send_to_pid, std::vector<T>& send, const Uint receive_from_pid, std::vector<T>& receive)
-{
-  if (send_to_pid == PE::Comm::instance().rank() &&
-      receive_from_pid == PE::Comm::instance().rank())
-  {
-    receive = send;
-      return;
-  }
-  cf3_assert(send.empty()==false);
-  size_t recv_size;
-  size_t send_size = send.size();
-  MPI_Sendrecv(&send_size, 1, PE::get_mpi_datatype<size_t>(), (int)send_to_pid, 0,
-               &recv_size, 1, PE::get_mpi_datatype<size_t>(), (int)receive_from_pid, 0,
-               PE::Comm::instance().communicator(), MPI_STATUS_IGNORE);
-  receive.resize(recv_size);
-  MPI_Sendrecv(&send[0], (int)send.size(), PE::get_mpi_datatype<T>(), (int)send_to_pid, 0,
-               &receive[0], (int)receive.size(), PE::get_mpi_datatype<T>(), (int)receive_from_pid, 0,
-               PE::Comm::instance().communicator(), MPI_STATUS_IGNORE);
-}
-
-////////////////////////////////////////////////////////////////////////////////
-
 void MeshAdaptor::assign_partition_agnostic_global_indices_to_dict( Dictionary& dict )
 {
   /// Nodes found on pid 0 will be numbered from 0 to nb_nodes(pid0)
@@ -1740,53 +1704,24 @@ void MeshAdaptor::assign_partition_agnostic_global_indices_to_dict( Dictionary&
       start_glb_idx += nb_nodes_per_pid[pid];
 
 
-    std::vector< std::vector<boost::uint64_t> > received_global_indices(PE::Comm::instance().size());
-
-    for (Uint pid=0; pid<PE::Comm::instance().size(); pid++)
-    {
-      // Trade my requests with processor procup and procdown
-      const Uint pid_send_hilbert = (PE::Comm::instance().rank() + pid) %
-                                    PE::Comm::instance().size();
-      const Uint pid_recv_hilbert = (PE::Comm::instance().size() + PE::Comm::instance().rank() - pid) %
-                                    PE::Comm::instance().size();
-
-      std::vector<boost::uint64_t>& send_hilbert_indices = hilbert_indices;
-      std::vector<boost::uint64_t> received_hilbert_indices;
-      MeshAdaptor_send_receive(pid_send_hilbert,   send_hilbert_indices,
-                               pid_recv_hilbert, received_hilbert_indices);
-
-      // Find global indices for each received hilbert index
-      std::vector<boost::uint64_t> send_global_indices;
-      send_global_indices.reserve(received_hilbert_indices.size());
-
-      boost_foreach(const boost::uint64_t& hilbert_index, received_hilbert_indices)
-      {
-        if (hilbert_to_loc.exists(hilbert_index))
-          send_global_indices.push_back( start_glb_idx + hilbert_to_loc[hilbert_index]);
-        else
-          send_global_indices.push_back( std::numeric_limits<boost::uint64_t>::max());
-      }
+    // Register the candidate global index of every node in a directory distributed over the
+    // hilbert key range. The candidate from the lowest pid wins.
+    std::vector<Uint> candidate_glb_indices(dict.size());
+    for (Uint node_idx=0; node_idx<dict.size(); ++node_idx)
+      candidate_glb_indices[node_idx] = start_glb_idx + hilbert_to_loc[hilbert_indices[node_idx]];
 
-      const Uint pid_send_glb_indices = pid_recv_hilbert;
-      const Uint pid_recv_glb_indices = pid_send_hilbert;
+    PE::DistributedDirectory<boost::uint64_t> hilbert_directory(compute_hilbert_idx.max_key());
+    hilbert_directory.insert(hilbert_indices, candidate_glb_indices);
 
-      MeshAdaptor_send_receive (pid_send_glb_indices, send_global_indices,
-                                pid_recv_glb_indices, received_global_indices[pid_recv_glb_indices]);
-      cf3_assert( received_global_indices[pid_recv_glb_indices].size() == dict.size() );
-    }
+    std::vector<Uint> glb_indices;
+    std::vector<Uint> glb_indices_rank;
+    hilbert_directory.find(hilbert_indices, glb_indices, glb_indices_rank);
 
     // Assign global indices in the dictionary
     for (Uint node_idx=0; node_idx<dict.size(); ++node_idx)
     {
-      boost::uint64_t glb_idx = std::numeric_limits<boost::uint64_t>::max();
-      for (Uint pid=0; pid<PE::Comm::instance().size(); pid++)
-      {
-        if (received_global_indices[pid][node_idx] < glb_idx)
-        {
-          dict.glb_idx()[node_idx] = received_global_indices[pid][node_idx];
-          break;
-        }
-      }
+      cf3_assert(glb_indices[node_idx] != hilbert_directory.unknown());
+      dict.glb_idx()[node_idx] = glb_indices[node_idx];
     }
 
   }
@@ -12,6 +12,7 @@
 #include "common/OptionList.hpp"
 #include "common/OptionT.hpp"
 #include "common/OptionURI.hpp"
+#include "common/PropertyList.hpp"
 #include "common/PE/Comm.hpp"
 #include "common/PE/datatype.hpp"
 #include "common/PE/Buffer.hpp"
@@ -43,7 +44,8 @@ namespace mesh {
 MeshPartitioner::MeshPartitioner ( const std::string& name ) :
     MeshTransformer(name),
     m_base(0),
-    m_nb_parts(PE::Comm::instance().size())
+    m_nb_parts(PE::Comm::instance().size()),
+    m_has_object_weights(false)
 {
   options().add("nb_parts", m_nb_parts)
       .description("Total number of partitions (e.g. number of processors)")
@@ -187,6 +189,23 @@ void MeshPartitioner::initialize(Mesh& mesh)
   m_nodes_to_export.resize(m_nb_parts);
   m_elements_to_export.resize(m_nb_parts,std::vector< std::vector<Uint> >(mesh.elements().size()));
 
+  // Load weights, in the order of the components of m_lookup: the nodes followed by mesh.elements()
+  Uint local_has_weights = 0;
+  m_object_weights.assign(1, 1.);
+  boost_foreach ( const Handle<Entities>& elements, mesh.elements() )
+  {
+    const Real weight = elements->properties().check("load_weight") ? elements->properties().value<Real>("load_weight") : 1.;
+    if(weight <= 0.)
+      throw BadValue(FromHere(), "load_weight of " + elements->uri().string() + " must be positive, got " + to_str(weight));
+    if(weight != 1.)
+      local_has_weights = 1;
+    m_object_weights.push_back(weight);
+  }
+  Uint has_weights = local_has_weights;
+  if(PE::Comm::instance().is_active())
+    PE::Comm::instance().all_reduce(PE::max(), &local_has_weights, 1, &has_weights);
+  m_has_object_weights = has_weights != 0;
+
   build_global_to_local_index(mesh);
   build_graph();
 
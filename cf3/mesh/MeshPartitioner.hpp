@@ -95,6 +95,14 @@ public: // functions
   template <typename VectorT>
   Uint nb_connected_objects_in_part(const Uint part, VectorT& nb_connections_per_obj) const;
 
+  /// True if any element on any process has a load weight different from 1
+  bool has_object_weights() const { return m_has_object_weights; }
+
+  /// Load weight of each object in the order of list_of_objects_owned_by_part.
+  /// Nodes have weight 1, elements the "load_weight" property of their Entities (1 if not set)
+  template <typename VectorT>
+  void list_of_object_weights_in_part(const Uint part, VectorT& weights) const;
+
   template <typename VectorT, typename WeightsT>
   void list_of_connected_objects_in_part(const Uint part, VectorT& connections_per_obj, WeightsT& edge_weights) const;
 
@@ -167,6 +175,10 @@ private: // data
 
   Handle< UnifiedData > m_lookup;
 
+  /// Load weight per component of m_lookup
+  std::vector<Real> m_object_weights;
+  bool m_has_object_weights;
+
   std::vector< std::pair<bool, Uint > > m_periodic_links;
   std::vector< std::vector<Uint> > m_inverse_periodic_links;
 };
@@ -196,6 +208,23 @@ void MeshPartitioner::list_of_objects_owned_by_part(const Uint part, VectorT& ob
 
 //////////////////////////////////////////////////////////////////////////////
 
+template <typename VectorT>
+void MeshPartitioner::list_of_object_weights_in_part(const Uint part, VectorT& weights) const
+{
+  Uint idx=0;
+  foreach_container((const Uint glb_obj)(const Uint loc_obj),*m_global_to_local)
+  {
+    if (part_of_obj(glb_obj) == part)
+    {
+      const boost::tuple<Uint,Uint> loc = m_lookup->location_idx(loc_obj);
+      if(!(glb_obj < m_end_node_per_part[part] && m_periodic_links[loc.get<1>()].first))
+        weights[idx++] = m_object_weights[loc.get<0>()];
+    }
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
 template <typename VectorT>
 Uint MeshPartitioner::nb_connected_objects_in_part(const Uint part, VectorT& nb_connections_per_obj) const
 {
@@ -4,6 +4,9 @@
 // GNU Lesser General Public License version 3 (LGPLv3).
 // See doc/lgpl.txt and doc/gpl.txt for the license text.
 
+#include <algorithm>
+#include <set>
+
 #include "common/Builder.hpp"
 #include "common/OptionArray.hpp"
 #include "common/OptionURI.hpp"
@@ -12,6 +15,7 @@
 #include "common/FindComponents.hpp"
 #include "common/Foreach.hpp"
 #include "common/PE/Comm.hpp"
+#include "common/PE/CommPattern.hpp"
 #include "common/PE/debug.hpp"
 #include "common/Log.hpp"
 #include "common/Core.hpp"
@@ -42,6 +46,240 @@ ComponentBuilder < SimpleMeshGenerator, MeshGenerator, LibMesh > SimpleMeshGener
 
 ////////////////////////////////////////////////////////////////////////////////
 
+namespace detail
+{
+
+/// Local elements of one partition of a structured mesh: the owned (contiguous) range of linear element indices,
+/// followed by the ghost elements that are within "overlap" layers of an owned element. The ghost layer is
+/// derived from the (i,j,k) indices only, so each partition is generated independently, without communication.
+class StructuredPartition
+{
+public:
+  StructuredPartition(const ParallelDistribution& elems_hash, const Uint part, const Uint overlap, const Uint nx, const Uint ny, const Uint nz) :
+    m_part(part),
+    m_begin(elems_hash.start_idx_in_part(part)),
+    m_end(elems_hash.start_idx_in_part(part) + elems_hash.nb_objects_in_part(part)),
+    m_overlap(overlap),
+    m_nx(nx),
+    m_ny(ny),
+    m_nz(nz)
+  {
+    if(overlap == 0 || m_begin == m_end)
+      return;
+
+    // Elements within the overlap differ at most span from an owned element in their linear index
+    const Uint span = overlap * ((nz > 1 ? nx*ny : 0) + (ny > 1 ? nx : 0) + 1);
+    const Uint candidates_begin = m_begin > span ? m_begin - span : 0;
+    const Uint candidates_end = std::min(m_end + span, nx*ny*nz);
+    for(Uint e = candidates_begin; e != candidates_end; ++e)
+    {
+      if(e >= m_begin && e < m_end)
+        continue;
+      if(touches_owned(e))
+      {
+        m_ghosts.push_back(e);
+        m_ghost_ranks.push_back(elems_hash.proc_of_obj(e));
+      }
+    }
+  }
+
+  /// Number of local elements, owned and ghost
+  Uint size() const
+  {
+    return m_end - m_begin + m_ghosts.size();
+  }
+
+  /// Global index of the given local element
+  Uint glb_idx(const Uint local_idx) const
+  {
+    const Uint nb_owned = m_end - m_begin;
+    return local_idx < nb_owned ? m_begin + local_idx : m_ghosts[local_idx - nb_owned];
+  }
+
+  /// True if the element with the given global index is present in this partition
+  bool is_local(const Uint glb_elem_idx) const
+  {
+    return (glb_elem_idx >= m_begin && glb_elem_idx < m_end) || std::binary_search(m_ghosts.begin(), m_ghosts.end(), glb_elem_idx);
+  }
+
+  /// Rank that owns the local element with the given global index
+  Uint rank(const Uint glb_elem_idx) const
+  {
+    if(glb_elem_idx >= m_begin && glb_elem_idx < m_end)
+      return m_part;
+    return m_ghost_ranks[std::lower_bound(m_ghosts.begin(), m_ghosts.end(), glb_elem_idx) - m_ghosts.begin()];
+  }
+
+  /// Layers (k index) that contain local elements, as the range [begin, end)
+  void layers(Uint& begin, Uint& end) const
+  {
+    if(size() == 0)
+    {
+      begin = end = 0;
+      return;
+    }
+    begin = first() / (m_nx*m_ny);
+    end = (last()-1) / (m_nx*m_ny) + 1;
+  }
+
+  /// Rows (j index) of layer k that contain local elements, as the range [begin, end)
+  void rows(const Uint k, Uint& begin, Uint& end) const
+  {
+    const Uint layer_start = k*m_nx*m_ny;
+    const Uint lo = std::max(first(), layer_start);
+    const Uint hi = std::min(last(), layer_start + m_nx*m_ny);
+    if(lo >= hi)
+    {
+      begin = end = 0;
+      return;
+    }
+    begin = (lo - layer_start) / m_nx;
+    end = (hi - 1 - layer_start) / m_nx + 1;
+  }
+
+  /// Columns (i index) of row j in layer k that contain local elements, as the range [begin, end)
+  void columns(const Uint k, const Uint j, Uint& begin, Uint& end) const
+  {
+    const Uint row_start = (k*m_ny + j)*m_nx;
+    const Uint lo = std::max(first(), row_start);
+    const Uint hi = std::min(last(), row_start + m_nx);
+    if(lo >= hi)
+    {
+      begin = end = 0;
+      return;
+    }
+    begin = lo - row_start;
+    end = hi - row_start;
+  }
+
+private:
+  /// Lowest global index of the local elements
+  Uint first() const
+  {
+    return m_ghosts.empty() ? m_begin : std::min(m_begin, m_ghosts.front());
+  }
+
+  /// One past the highest global index of the local elements
+  Uint last() const
+  {
+    return m_ghosts.empty() ? m_end : std::max(m_end, m_ghosts.back()+1);
+  }
+
+  /// True if an owned element lies within m_overlap layers (counting diagonal neighbours) of the given element
+  bool touches_owned(const Uint glb_elem_idx) const
+  {
+    const Uint k = glb_elem_idx / (m_nx*m_ny);
+    const Uint j = (glb_elem_idx - k*m_nx*m_ny) / m_nx;
+    const Uint i = glb_elem_idx - (k*m_ny + j)*m_nx;
+    const Uint i_begin = i > m_overlap ? i - m_overlap : 0;
+    const Uint i_end = std::min(i + m_overlap, m_nx - 1);
+    for(Uint kk = (k > m_overlap ? k - m_overlap : 0); kk <= std::min(k + m_overlap, m_nz - 1); ++kk)
+    {
+      for(Uint jj = (j > m_overlap ? j - m_overlap : 0); jj <= std::min(j + m_overlap, m_ny - 1); ++jj)
+      {
+        const Uint row_start = (kk*m_ny + jj)*m_nx;
+        if(row_start + i_begin < m_end && row_start + i_end >= m_begin)
+          return true;
+      }
+    }
+    return false;
+  }
+
+  const Uint m_part;
+  const Uint m_begin;
+  const Uint m_end;
+  const Uint m_overlap;
+  const Uint m_nx;
+  const Uint m_ny;
+  const Uint m_nz;
+  std::vector<Uint> m_ghosts;
+  std::vector<Uint> m_ghost_ranks;
+};
+
+/// Build the comm pattern of the nodes directly from the structured indices, without communication.
+/// Ghost nodes are received from their owner in order of increasing global index. The owned nodes that are ghosts on another
+/// rank are found by checking, for each element around an owned node, which ranks have that element: its owner and the
+/// owners of the elements within the overlap layers around it, using the same criterion as StructuredPartition.
+void build_comm_pattern(Dictionary& nodes, const ParallelDistribution& nodes_hash, const ParallelDistribution& elems_hash,
+                        const Uint part, const Uint overlap, const Uint dimension, const Uint nx, const Uint ny, const Uint nz,
+                        const std::map<Uint,Uint>& ghost_nodes_loc)
+{
+  const Uint nb_procs = PE::Comm::instance().size();
+
+  std::vector<int> recv_count(nb_procs, 0);
+  std::vector<int> recv_map;
+  recv_map.reserve(ghost_nodes_loc.size());
+  for(std::map<Uint,Uint>::const_iterator it = ghost_nodes_loc.begin(); it != ghost_nodes_loc.end(); ++it)
+  {
+    ++recv_count[nodes_hash.proc_of_obj(it->first)];
+    recv_map.push_back(it->second);
+  }
+
+  // Number of nodes in each direction
+  const Uint nnx = nx+1;
+  const Uint nny = dimension > 1 ? ny+1 : 1;
+  const Uint node_begin = nodes_hash.start_idx_in_part(part);
+  const Uint node_end = node_begin + nodes_hash.nb_objects_in_part(part);
+  const Uint elem_begin = elems_hash.start_idx_in_part(part);
+  const Uint elem_end = elem_begin + elems_hash.nb_objects_in_part(part);
+
+  // (rank, global node index) of the owned nodes that are ghosts on another rank
+  std::set< std::pair<Uint,Uint> > sends;
+  for(Uint n = node_begin; n != node_end; ++n)
+  {
+    const Uint c = n / (nnx*nny);
+    const Uint b = (n - c*nnx*nny) / nnx;
+    const Uint a = n - (c*nny + b)*nnx;
+    for(Uint k = (c > 0 ? c-1 : 0); k <= std::min(c, nz-1); ++k)
+    {
+      for(Uint j = (b > 0 ? b-1 : 0); j <= std::min(b, ny-1); ++j)
+      {
+        for(Uint i = (a > 0 ? a-1 : 0); i <= std::min(a, nx-1); ++i)
+        {
+          const Uint k_begin = k > overlap ? k - overlap : 0;
+          const Uint k_end = std::min(k + overlap, nz - 1);
+          const Uint j_begin = j > overlap ? j - overlap : 0;
+          const Uint j_end = std::min(j + overlap, ny - 1);
+          const Uint i_begin = i > overlap ? i - overlap : 0;
+          const Uint i_end = std::min(i + overlap, nx - 1);
+          // Skip the common case where all elements within the overlap are owned by this rank
+          if((k_begin*ny + j_begin)*nx + i_begin >= elem_begin && (k_end*ny + j_end)*nx + i_end < elem_end)
+            continue;
+          for(Uint kk = k_begin; kk <= k_end; ++kk)
+          {
+            for(Uint jj = j_begin; jj <= j_end; ++jj)
+            {
+              for(Uint ii = i_begin; ii <= i_end; ++ii)
+              {
+                const Uint rank = elems_hash.proc_of_obj((kk*ny + jj)*nx + ii);
+                if(rank != part)
+                  sends.insert(std::make_pair(rank, n));
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+
+  std::vector<int> send_count(nb_procs, 0);
+  std::vector<int> send_map;
+  send_map.reserve(sends.size());
+  for(std::set< std::pair<Uint,Uint> >::const_iterator it = sends.begin(); it != sends.end(); ++it)
+  {
+    ++send_count[it->first];
+    send_map.push_back(it->second - node_begin);
+  }
+
+  PE::CommPattern& comm_pattern = *nodes.create_component<PE::CommPattern>("CommPattern");
+  comm_pattern.insert("gid", nodes.glb_idx().array(), false);
+  comm_pattern.setup(Handle<PE::CommWrapper>(comm_pattern.get_child("gid")), nodes.rank().array(), send_count, send_map, recv_count, recv_map);
+}
+
+} // detail
+
+////////////////////////////////////////////////////////////////////////////////
+
 SimpleMeshGenerator::SimpleMeshGenerator ( const std::string& name  ) :
   MeshGenerator ( name )
 {
@@ -76,6 +314,10 @@ SimpleMeshGenerator::SimpleMeshGenerator ( const std::string& name  ) :
   options().add("bdry", true)
       .description("Generate Boundary")
       .pretty_name("Boundary");
+
+  options().add("overlap", 0u)
+      .description("Number of layers of ghost elements, computed directly from the structured indices")
+      .pretty_name("Overlap");
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -138,24 +380,25 @@ void SimpleMeshGenerator::create_line()
   hash.options().set("nb_obj",num_obj);
   hash.options().set("nb_parts",nb_parts);
 
+  // local elements: the owned range followed by the ghost elements of the overlap layers
+  const detail::StructuredPartition local_elems(hash.subhash(ELEMS), part, options().value<Uint>("overlap"), x_segments, 1, 1);
+
   // find ghost nodes
   std::map<Uint,Uint> ghost_nodes_loc;
   Uint glb_node_idx;
-  for(Uint i = 0; i < x_segments; ++i)
+  for(Uint e = 0; e != local_elems.size(); ++e)
   {
-    if (hash.subhash(ELEMS).part_owns(part,i))
+    const Uint i = local_elems.glb_idx(e);
+    glb_node_idx = i;
+    if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
     {
-      glb_node_idx = i;
-      if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
-      {
-        ghost_nodes_loc[glb_node_idx]=0; // this value will be set further
-      }
+      ghost_nodes_loc[glb_node_idx]=0; // this value will be set further
+    }
 
-      glb_node_idx = (i+1);
-      if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
-      {
-        ghost_nodes_loc[glb_node_idx]=0; // this value will be set further
-      }
+    glb_node_idx = (i+1);
+    if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
+    {
+      ghost_nodes_loc[glb_node_idx]=0; // this value will be set further
     }
   }
 
@@ -166,20 +409,17 @@ void SimpleMeshGenerator::create_line()
   Uint glb_node_start_idx = hash.subhash(NODES).start_idx_in_part(part);
 
   const Real x_step = x_len / static_cast<Real>(x_segments);
-  for(Uint i = 0; i <= x_segments; ++i)
+  const Uint glb_node_end_idx = glb_node_start_idx + hash.subhash(NODES).nb_objects_in_part(part);
+  for(glb_node_idx = glb_node_start_idx; glb_node_idx != glb_node_end_idx; ++glb_node_idx)
   {
-    glb_node_idx = i;
-
-    if (hash.subhash(NODES).part_owns(part,glb_node_idx))
-    {
-      cf3_assert(glb_node_idx-glb_node_start_idx < nodes.size());
-      common::Table<Real>::Row row = nodes.coordinates()[glb_node_idx-glb_node_start_idx];
-      for (Uint d=0; d<m_coord_dim; ++d)
-        row[d]=0.;
-      row[XX] = static_cast<Real>(i) * x_step + x_offset;
-      nodes.rank()[glb_node_idx-glb_node_start_idx]=part;
-      nodes.glb_idx()[glb_node_idx-glb_node_start_idx]=glb_node_idx;
-    }
+    const Uint i = glb_node_idx;
+    cf3_assert(glb_node_idx-glb_node_start_idx < nodes.size());
+    common::Table<Real>::Row row = nodes.coordinates()[glb_node_idx-glb_node_start_idx];
+    for (Uint d=0; d<m_coord_dim; ++d)
+      row[d]=0.;
+    row[XX] = static_cast<Real>(i) * x_step + x_offset;
+    nodes.rank()[glb_node_idx-glb_node_start_idx]=part;
+    nodes.glb_idx()[glb_node_idx-glb_node_start_idx]=glb_node_idx;
   }
 
   // add ghost nodes
@@ -198,37 +438,36 @@ void SimpleMeshGenerator::create_line()
     nodes.rank()[loc_ghost_node_idx]=hash.subhash(NODES).proc_of_obj(glb_ghost_node_idx);
     nodes.glb_idx()[loc_ghost_node_idx]=glb_ghost_node_idx;
   }
+  // the ghost nodes and their owners are known analytically, so the comm pattern can be built without communication
+  if(PE::Comm::instance().is_active() && nb_parts == PE::Comm::instance().size() && part == PE::Comm::instance().rank())
+    detail::build_comm_pattern(nodes, hash.subhash(NODES), hash.subhash(ELEMS), part, options().value<Uint>("overlap"), DIM_1D, x_segments, 1, 1, ghost_nodes_loc);
   Handle<Cells> cells = region.create_component<Cells>("Line");
   cells->initialize("cf3.mesh.LagrangeP1.Line"+to_str(m_coord_dim)+"D",nodes);
-  cells->resize(hash.subhash(ELEMS).nb_objects_in_part(part));
+  cells->resize(local_elems.size());
   Connectivity& connectivity = cells->geometry_space().connectivity();
   common::List<Uint>& elem_rank = cells->rank();
   common::List<Uint>& elem_glb_idx = cells->glb_idx();
 
-  Uint glb_elem_start_idx = hash.subhash(ELEMS).start_idx_in_part(part);
   Uint glb_elem_idx;
-  for(Uint i = 0; i < x_segments; ++i)
+  for(Uint loc_elem_idx = 0; loc_elem_idx != local_elems.size(); ++loc_elem_idx)
   {
-    glb_elem_idx = i;
+    glb_elem_idx = local_elems.glb_idx(loc_elem_idx);
+    const Uint i = glb_elem_idx;
+    Connectivity::Row nodes = connectivity[loc_elem_idx];
+    elem_rank[loc_elem_idx] = local_elems.rank(glb_elem_idx);
+    elem_glb_idx[loc_elem_idx] = glb_elem_idx;
 
-    if (hash.subhash(ELEMS).part_owns(part,glb_elem_idx))
-    {
-      Connectivity::Row nodes = connectivity[glb_elem_idx-glb_elem_start_idx];
-      elem_rank[glb_elem_idx-glb_elem_start_idx] = part;
-      elem_glb_idx[glb_elem_idx-glb_elem_start_idx] = glb_elem_idx;
-
-      glb_node_idx = i;
-      if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
-        nodes[0] = ghost_nodes_loc[glb_node_idx];
-      else
-        nodes[0] = glb_node_idx-glb_node_start_idx;
-
-      glb_node_idx = (i+1);
-      if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
-        nodes[1] = ghost_nodes_loc[glb_node_idx];
-      else
-        nodes[1] = glb_node_idx-glb_node_start_idx;
-    }
+    glb_node_idx = i;
+    if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
+      nodes[0] = ghost_nodes_loc[glb_node_idx];
+    else
+      nodes[0] = glb_node_idx-glb_node_start_idx;
+
+    glb_node_idx = (i+1);
+    if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
+      nodes[1] = ghost_nodes_loc[glb_node_idx];
+    else
+      nodes[1] = glb_node_idx-glb_node_start_idx;
   }
 
   if (bdry)
@@ -240,7 +479,7 @@ void SimpleMeshGenerator::create_line()
       glb_elem_idx = x_segments;
       Handle<Faces> xneg = mesh.topology().create_region("xneg").create_component<Faces>("Point");
       xneg->initialize("cf3.mesh.LagrangeP0.Point"+to_str(m_coord_dim)+"D", nodes);
-      if (hash.subhash(ELEMS).part_owns(part,0u))
+      if (local_elems.is_local(0u))
       {
         xneg->resize(1);
         glb_node_idx=0u;
@@ -250,7 +489,7 @@ void SimpleMeshGenerator::create_line()
           point_node = glb_node_idx-glb_node_start_idx;
 
         xneg->geometry_space().connectivity()[0][0]=point_node;
-        xneg->rank()[0]=part;
+        xneg->rank()[0]=local_elems.rank(0u);
         xneg->glb_idx()[0]=glb_elem_idx;
       }
     }
@@ -260,7 +499,7 @@ void SimpleMeshGenerator::create_line()
       glb_elem_idx = x_segments+1;
       Handle<Faces> xpos = mesh.topology().create_region("xpos").create_component<Faces>("Point");
       xpos->initialize("cf3.mesh.LagrangeP0.Point"+to_str(m_coord_dim)+"D", nodes);
-      if (hash.subhash(ELEMS).part_owns(part,x_segments-1))
+      if (local_elems.is_local(x_segments-1))
       {
         xpos->resize(1);
 
@@ -271,7 +510,7 @@ void SimpleMeshGenerator::create_line()
           point_node = glb_node_idx-glb_node_start_idx;
 
         xpos->geometry_space().connectivity()[0][0]=point_node;
-        xpos->rank()[0]=part;
+        xpos->rank()[0]=local_elems.rank(x_segments-1);
         xpos->glb_idx()[0]=glb_elem_idx;
       }
     }
@@ -309,39 +548,39 @@ void SimpleMeshGenerator::create_rectangle()
   Dictionary& nodes = mesh.geometry_fields();
 
 
+  // local elements: the owned range followed by the ghost elements of the overlap layers
+  const detail::StructuredPartition local_elems(hash.subhash(ELEMS), part, options().value<Uint>("overlap"), x_segments, y_segments, 1);
+
   // find ghost nodes
   std::map<Uint,Uint> ghost_nodes_loc;
   Uint glb_node_idx;
-  for(Uint j = 0; j < y_segments; ++j)
+  for(Uint e = 0; e != local_elems.size(); ++e)
   {
-    for(Uint i = 0; i < x_segments; ++i)
+    const Uint glb_elem_idx = local_elems.glb_idx(e);
+    const Uint j = glb_elem_idx / x_segments;
+    const Uint i = glb_elem_idx - j*x_segments;
+    glb_node_idx = j * (x_segments+1) + i;
+    if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
     {
-      if (hash.subhash(ELEMS).part_owns(part,i+j*x_segments))
-      {
-        glb_node_idx = j * (x_segments+1) + i;
-        if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
-        {
-          ghost_nodes_loc[glb_node_idx]=0; // this value will be set further
-        }
+      ghost_nodes_loc[glb_node_idx]=0; // this value will be set further
+    }
 
-        glb_node_idx = j * (x_segments+1) + (i+1);
-        if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
-        {
-          ghost_nodes_loc[glb_node_idx]=0; // this value will be set further
-        }
+    glb_node_idx = j * (x_segments+1) + (i+1);
+    if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
+    {
+      ghost_nodes_loc[glb_node_idx]=0; // this value will be set further
+    }
 
-        glb_node_idx = (j+1) * (x_segments+1) + i;
-        if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
-        {
-          ghost_nodes_loc[glb_node_idx]=0; // this value will be set further
-        }
+    glb_node_idx = (j+1) * (x_segments+1) + i;
+    if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
+    {
+      ghost_nodes_loc[glb_node_idx]=0; // this value will be set further
+    }
 
-        glb_node_idx = (j+1) * (x_segments+1) + (i+1);
-        if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
-        {
-          ghost_nodes_loc[glb_node_idx]=0; // this value will be set further
-        }
-      }
+    glb_node_idx = (j+1) * (x_segments+1) + (i+1);
+    if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
+    {
+      ghost_nodes_loc[glb_node_idx]=0; // this value will be set further
     }
   }
 
@@ -351,25 +590,20 @@ void SimpleMeshGenerator::create_rectangle()
   const Real x_step = x_len / static_cast<Real>(x_segments);
   const Real y_step = y_len / static_cast<Real>(y_segments);
   Real y;
-  for(Uint j = 0; j <= y_segments; ++j)
+  const Uint glb_node_end_idx = glb_node_start_idx + hash.subhash(NODES).nb_objects_in_part(part);
+  for(glb_node_idx = glb_node_start_idx; glb_node_idx != glb_node_end_idx; ++glb_node_idx)
   {
+    const Uint j = glb_node_idx / (x_segments+1);
+    const Uint i = glb_node_idx - j*(x_segments+1);
     y = static_cast<Real>(j) * y_step;
-    for(Uint i = 0; i <= x_segments; ++i)
-    {
-      glb_node_idx = j * (x_segments+1) + i;
-
-      if (hash.subhash(NODES).part_owns(part,glb_node_idx))
-      {
-        cf3_assert(glb_node_idx-glb_node_start_idx < nodes.size());
-        common::Table<Real>::Row row = nodes.coordinates()[glb_node_idx-glb_node_start_idx];
-        for (Uint d=0; d<m_coord_dim; ++d)
-          row[d]=0.;
-        row[XX] = static_cast<Real>(i) * x_step + x_offset;
-        row[YY] = y + y_offset;
-        nodes.rank()[glb_node_idx-glb_node_start_idx]=part;
-        nodes.glb_idx()[glb_node_idx-glb_node_start_idx]=glb_node_idx;
-      }
-    }
+    cf3_assert(glb_node_idx-glb_node_start_idx < nodes.size());
+    common::Table<Real>::Row row = nodes.coordinates()[glb_node_idx-glb_node_start_idx];
+    for (Uint d=0; d<m_coord_dim; ++d)
+      row[d]=0.;
+    row[XX] = static_cast<Real>(i) * x_step + x_offset;
+    row[YY] = y + y_offset;
+    nodes.rank()[glb_node_idx-glb_node_start_idx]=part;
+    nodes.glb_idx()[glb_node_idx-glb_node_start_idx]=glb_node_idx;
   }
 
   // add ghost nodes
@@ -390,69 +624,68 @@ void SimpleMeshGenerator::create_rectangle()
     nodes.rank()[loc_ghost_node_idx]=hash.subhash(NODES).proc_of_obj(glb_ghost_node_idx);
     nodes.glb_idx()[loc_ghost_node_idx]=glb_ghost_node_idx;
   }
+  // the ghost nodes and their owners are known analytically, so the comm pattern can be built without communication
+  if(PE::Comm::instance().is_active() && nb_parts == PE::Comm::instance().size() && part == PE::Comm::instance().rank())
+    detail::build_comm_pattern(nodes, hash.subhash(NODES), hash.subhash(ELEMS), part, options().value<Uint>("overlap"), DIM_2D, x_segments, y_segments, 1, ghost_nodes_loc);
   Handle<Cells> cells = region.create_component<Cells>("Quad");
   cells->initialize("cf3.mesh.LagrangeP1.Quad"+to_str(m_coord_dim)+"D",nodes);
 
-  cells->resize(hash.subhash(ELEMS).nb_objects_in_part(part));
+  cells->resize(local_elems.size());
   Connectivity& connectivity = cells->geometry_space().connectivity();
   common::List<Uint>& elem_rank = cells->rank();
   common::List<Uint>& elem_glb_idx = cells->glb_idx();
 
-  Uint glb_elem_start_idx = hash.subhash(ELEMS).start_idx_in_part(part);
   Uint glb_elem_idx;
-  for(Uint j = 0; j < y_segments; ++j)
+  for(Uint loc_elem_idx = 0; loc_elem_idx != local_elems.size(); ++loc_elem_idx)
   {
-    for(Uint i = 0; i < x_segments; ++i)
-    {
-      glb_elem_idx = j * x_segments + i;
-
-      if (hash.subhash(ELEMS).part_owns(part,glb_elem_idx))
-      {
-        Connectivity::Row nodes = connectivity[glb_elem_idx-glb_elem_start_idx];
-        elem_rank[glb_elem_idx-glb_elem_start_idx] = part;
-        elem_glb_idx[glb_elem_idx-glb_elem_start_idx] = glb_elem_idx;
-
-        glb_node_idx = j * (x_segments+1) + i;
-        if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
-          nodes[0] = ghost_nodes_loc[glb_node_idx];
-        else
-          nodes[0] = glb_node_idx-glb_node_start_idx;
-
-        glb_node_idx = j * (x_segments+1) + (i+1);
-        if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
-          nodes[1] = ghost_nodes_loc[glb_node_idx];
-        else
-          nodes[1] = glb_node_idx-glb_node_start_idx;
-
-        glb_node_idx = (j+1) * (x_segments+1) + i;
-        if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
-          nodes[3] = ghost_nodes_loc[glb_node_idx];
-        else
-          nodes[3] = glb_node_idx-glb_node_start_idx;
-
-        glb_node_idx = (j+1) * (x_segments+1) + (i+1);
-        if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
-          nodes[2] = ghost_nodes_loc[glb_node_idx];
-        else
-          nodes[2] = glb_node_idx-glb_node_start_idx;
-      }
-
-    }
+    glb_elem_idx = local_elems.glb_idx(loc_elem_idx);
+    const Uint j = glb_elem_idx / x_segments;
+    const Uint i = glb_elem_idx - j*x_segments;
+    Connectivity::Row nodes = connectivity[loc_elem_idx];
+    elem_rank[loc_elem_idx] = local_elems.rank(glb_elem_idx);
+    elem_glb_idx[loc_elem_idx] = glb_elem_idx;
+
+    glb_node_idx = j * (x_segments+1) + i;
+    if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
+      nodes[0] = ghost_nodes_loc[glb_node_idx];
+    else
+      nodes[0] = glb_node_idx-glb_node_start_idx;
+
+    glb_node_idx = j * (x_segments+1) + (i+1);
+    if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
+      nodes[1] = ghost_nodes_loc[glb_node_idx];
+    else
+      nodes[1] = glb_node_idx-glb_node_start_idx;
+
+    glb_node_idx = (j+1) * (x_segments+1) + i;
+    if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
+      nodes[3] = ghost_nodes_loc[glb_node_idx];
+    else
+      nodes[3] = glb_node_idx-glb_node_start_idx;
+
+    glb_node_idx = (j+1) * (x_segments+1) + (i+1);
+    if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
+      nodes[2] = ghost_nodes_loc[glb_node_idx];
+    else
+      nodes[2] = glb_node_idx-glb_node_start_idx;
   }
 
 
   if (bdry)
   {
-    glb_elem_idx =  (x_segments+1) * (y_segments+1);
+    // boundary elements are numbered after the nodes, per boundary; only the rows and columns with local elements are visited
+    const Uint bdry_start = (x_segments+1) * (y_segments+1);
+    Uint begin, end;
     std::vector<Uint> line_nodes(2);
     Handle<Faces> left = mesh.topology().create_region("left").create_component<Faces>("Line");
     left->initialize("cf3.mesh.LagrangeP1.Line"+to_str(m_coord_dim)+"D", nodes);
     Connectivity::Buffer left_connectivity = left->geometry_space().connectivity().create_buffer();
     common::List<Uint>::Buffer left_rank = left->rank().create_buffer();
     common::List<Uint>::Buffer left_glb_idx = left->glb_idx().create_buffer();
-    for(Uint j = 0; j < y_segments; ++j)
+    local_elems.rows(0, begin, end);
+    for(Uint j = begin; j < end; ++j)
     {
-      if (hash.subhash(ELEMS).part_owns(part,j*x_segments))
+      if (local_elems.is_local(j*x_segments))
       {
         glb_node_idx = j * (x_segments+1);
         if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
@@ -467,10 +700,9 @@ void SimpleMeshGenerator::create_rectangle()
           line_nodes[1] = glb_node_idx-glb_node_start_idx;
 
         left_connectivity.add_row(line_nodes);
-        left_rank.add_row(part);
-        left_glb_idx.add_row(glb_elem_idx);
+        left_rank.add_row(local_elems.rank(j*x_segments));
+        left_glb_idx.add_row(bdry_start + j);
       }
-      ++glb_elem_idx;
     }
 
     Handle<Faces> right = mesh.topology().create_region("right").create_component<Faces>("Line");
@@ -479,9 +711,10 @@ void SimpleMeshGenerator::create_rectangle()
     common::List<Uint>::Buffer right_rank = right->rank().create_buffer();
     common::List<Uint>::Buffer right_glb_idx = right->glb_idx().create_buffer();
 
-    for(Uint j = 0; j < y_segments; ++j)
+    local_elems.rows(0, begin, end);
+    for(Uint j = begin; j < end; ++j)
     {
-      if (hash.subhash(ELEMS).part_owns(part,j*x_segments+x_segments-1))
+      if (local_elems.is_local(j*x_segments+x_segments-1))
       {
         glb_node_idx = j * (x_segments+1) + x_segments;
         if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
@@ -496,11 +729,10 @@ void SimpleMeshGenerator::create_rectangle()
           line_nodes[0] = glb_node_idx-glb_node_start_idx;
 
         right_connectivity.add_row(line_nodes);
-        right_rank.add_row(part);
-        right_glb_idx.add_row(glb_elem_idx);
+        right_rank.add_row(local_elems.rank(j*x_segments+x_segments-1));
+        right_glb_idx.add_row(bdry_start + y_segments + j);
 
       }
-      ++glb_elem_idx;
     }
 
     Handle<Faces> bottom = mesh.topology().create_region("bottom").create_component<Faces>("Line");
@@ -509,9 +741,10 @@ void SimpleMeshGenerator::create_rectangle()
     common::List<Uint>::Buffer bottom_rank = bottom->rank().create_buffer();
     common::List<Uint>::Buffer bottom_glb_idx = bottom->glb_idx().create_buffer();
 
-    for(Uint i = 0; i < x_segments; ++i)
+    local_elems.columns(0, 0, begin, end);
+    for(Uint i = begin; i < end; ++i)
     {
-      if (hash.subhash(ELEMS).part_owns(part,i))
+      if (local_elems.is_local(i))
       {
         glb_node_idx = i;
         if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
@@ -526,10 +759,9 @@ void SimpleMeshGenerator::create_rectangle()
           line_nodes[1] = glb_node_idx-glb_node_start_idx;
 
         bottom_connectivity.add_row(line_nodes);
-        bottom_rank.add_row(part);
-        bottom_glb_idx.add_row(glb_elem_idx);
+        bottom_rank.add_row(local_elems.rank(i));
+        bottom_glb_idx.add_row(bdry_start + 2*y_segments + i);
       }
-      ++glb_elem_idx;
     }
 
     Handle<Faces> top = mesh.topology().create_region("top").create_component<Faces>("Line");
@@ -538,9 +770,10 @@ void SimpleMeshGenerator::create_rectangle()
     common::List<Uint>::Buffer top_rank = top->rank().create_buffer();
     common::List<Uint>::Buffer top_glb_idx = top->glb_idx().create_buffer();
 
-    for(Uint i = 0; i < x_segments; ++i)
+    local_elems.columns(0, y_segments-1, begin, end);
+    for(Uint i = begin; i < end; ++i)
     {
-      if (hash.subhash(ELEMS).part_owns(part,y_segments*(x_segments)+i))
+      if (local_elems.is_local((y_segments-1)*x_segments+i))
       {
         glb_node_idx = y_segments * (x_segments+1) + i;
         if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
@@ -555,10 +788,9 @@ void SimpleMeshGenerator::create_rectangle()
           line_nodes[0] = glb_node_idx-glb_node_start_idx;
 
         top_connectivity.add_row(line_nodes);
-        top_rank.add_row(part);
-        top_glb_idx.add_row(glb_elem_idx);
+        top_rank.add_row(local_elems.rank((y_segments-1)*x_segments+i));
+        top_glb_idx.add_row(bdry_start + 2*y_segments + x_segments + i);
       }
-      ++glb_elem_idx;
     }
   }
 
@@ -569,7 +801,7 @@ void SimpleMeshGenerator::create_rectangle()
     cf3_assert_desc(elements.uri().string() + " ( "+to_str(elements.size())+"!="+to_str(elements.rank().size()),elements.size() == elements.rank().size());
     boost_foreach(Uint r, elements.rank().array())
     {
-      cf3_assert( r == part);
+      cf3_assert( r == part || options().value<Uint>("overlap") != 0 );
     }
   }
 
@@ -609,70 +841,67 @@ void SimpleMeshGenerator::create_box()
   Dictionary& nodes = mesh.geometry_fields();
 
 
+  // local elements: the owned range followed by the ghost elements of the overlap layers
+  const detail::StructuredPartition local_elems(hash.subhash(ELEMS), part, options().value<Uint>("overlap"), x_segments, y_segments, z_segments);
+
   // find ghost nodes
   std::map<Uint,Uint> ghost_nodes_loc;
   Uint glb_node_idx;
   Uint glb_elem_idx;
-  for(Uint k = 0; k < z_segments; ++k)
+  for(Uint e = 0; e != local_elems.size(); ++e)
   {
-    for(Uint j = 0; j < y_segments; ++j)
+    glb_elem_idx = local_elems.glb_idx(e);
+    const Uint k = glb_elem_idx / (x_segments*y_segments);
+    const Uint j = (glb_elem_idx - k*x_segments*y_segments) / x_segments;
+    const Uint i = glb_elem_idx - (k*y_segments + j)*x_segments;
+    glb_node_idx = node_idx(i,j,k, x_segments,y_segments,z_segments);
+    if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
     {
-      for(Uint i = 0; i < x_segments; ++i)
-      {
-        glb_elem_idx = elem_idx(i,j,k, x_segments,y_segments,z_segments);
-        if (hash.subhash(ELEMS).part_owns(part,glb_elem_idx))
-        {
-          glb_node_idx = node_idx(i,j,k, x_segments,y_segments,z_segments);
-          if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
-          {
-            ghost_nodes_loc[glb_node_idx]=0; // this value will be set further
-          }
-
-          glb_node_idx = node_idx(i+1,j,k, x_segments,y_segments,z_segments);
-          if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
-          {
-            ghost_nodes_loc[glb_node_idx]=0; // this value will be set further
-          }
+      ghost_nodes_loc[glb_node_idx]=0; // this value will be set further
+    }
 
-          glb_node_idx = node_idx(i,j+1,k, x_segments,y_segments,z_segments);
-          if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
-          {
-            ghost_nodes_loc[glb_node_idx]=0; // this value will be set further
-          }
+    glb_node_idx = node_idx(i+1,j,k, x_segments,y_segments,z_segments);
+    if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
+    {
+      ghost_nodes_loc[glb_node_idx]=0; // this value will be set further
+    }
 
-          glb_node_idx = node_idx(i+1,j+1,k, x_segments,y_segments,z_segments);
-          if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
-          {
-            ghost_nodes_loc[glb_node_idx]=0; // this value will be set further
-          }
+    glb_node_idx = node_idx(i,j+1,k, x_segments,y_segments,z_segments);
+    if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
+    {
+      ghost_nodes_loc[glb_node_idx]=0; // this value will be set further
+    }
 
-          glb_node_idx = node_idx(i,j,k+1, x_segments,y_segments,z_segments);
-          if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
-          {
-            ghost_nodes_loc[glb_node_idx]=0; // this value will be set further
-          }
+    glb_node_idx = node_idx(i+1,j+1,k, x_segments,y_segments,z_segments);
+    if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
+    {
+      ghost_nodes_loc[glb_node_idx]=0; // this value will be set further
+    }
 
-          glb_node_idx = node_idx(i+1,j,k+1, x_segments,y_segments,z_segments);
-          if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
-          {
-            ghost_nodes_loc[glb_node_idx]=0; // this value will be set further
-          }
+    glb_node_idx = node_idx(i,j,k+1, x_segments,y_segments,z_segments);
+    if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
+    {
+      ghost_nodes_loc[glb_node_idx]=0; // this value will be set further
+    }
 
-          glb_node_idx = node_idx(i,j+1,k+1, x_segments,y_segments,z_segments);
-          if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
-          {
-            ghost_nodes_loc[glb_node_idx]=0; // this value will be set further
-          }
+    glb_node_idx = node_idx(i+1,j,k+1, x_segments,y_segments,z_segments);
+    if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
+    {
+      ghost_nodes_loc[glb_node_idx]=0; // this value will be set further
+    }
 
-          glb_node_idx = node_idx(i+1,j+1,k+1, x_segments,y_segments,z_segments);
-          if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
-          {
-            ghost_nodes_loc[glb_node_idx]=0; // this value will be set further
-          }
+    glb_node_idx = node_idx(i,j+1,k+1, x_segments,y_segments,z_segments);
+    if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
+    {
+      ghost_nodes_loc[glb_node_idx]=0; // this value will be set further
+    }
 
-        }
-      }
+    glb_node_idx = node_idx(i+1,j+1,k+1, x_segments,y_segments,z_segments);
+    if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
+    {
+      ghost_nodes_loc[glb_node_idx]=0; // this value will be set further
     }
+
   }
 
   mesh.initialize_nodes(hash.subhash(NODES).nb_objects_in_part(part)+ghost_nodes_loc.size(), DIM_3D);
@@ -683,30 +912,24 @@ void SimpleMeshGenerator::create_box()
   const Real z_step = z_len / static_cast<Real>(z_segments);
 
   Real x,y,z;
-  for(Uint k = 0; k <= z_segments; ++k)
+  const Uint glb_node_end_idx = glb_node_start_idx + hash.subhash(NODES).nb_objects_in_part(part);
+  for(glb_node_idx = glb_node_start_idx; glb_node_idx != glb_node_end_idx; ++glb_node_idx)
   {
+    const Uint k = glb_node_idx / ((x_segments+1)*(y_segments+1));
+    const Uint j = (glb_node_idx - k*(x_segments+1)*(y_segments+1)) / (x_segments+1);
+    const Uint i = glb_node_idx - (k*(y_segments+1) + j)*(x_segments+1);
     z = static_cast<Real>(k) * z_step;
-    for(Uint j = 0; j <= y_segments; ++j)
-    {
-      y = static_cast<Real>(j) * y_step;
-      for(Uint i = 0; i <= x_segments; ++i)
-      {
-        x = static_cast<Real>(i) * x_step;
-        glb_node_idx = node_idx(i,j,k, x_segments,y_segments,z_segments);
-        if (hash.subhash(NODES).part_owns(part,glb_node_idx))
-        {
-          cf3_assert(glb_node_idx-glb_node_start_idx < nodes.size());
-          common::Table<Real>::Row row = nodes.coordinates()[glb_node_idx-glb_node_start_idx];
-          for (Uint d=0; d<m_coord_dim; ++d)
-            row[d]=0.;
-          row[XX] = x + x_offset;
-          row[YY] = y + y_offset;
-          row[ZZ] = z + z_offset;
-          nodes.rank()[glb_node_idx-glb_node_start_idx]=part;
-          nodes.glb_idx()[glb_node_idx-glb_node_start_idx]=glb_node_idx;
-        }
-      }
-    }
+    y = static_cast<Real>(j) * y_step;
+    x = static_cast<Real>(i) * x_step;
+    cf3_assert(glb_node_idx-glb_node_start_idx < nodes.size());
+    common::Table<Real>::Row row = nodes.coordinates()[glb_node_idx-glb_node_start_idx];
+    for (Uint d=0; d<m_coord_dim; ++d)
+      row[d]=0.;
+    row[XX] = x + x_offset;
+    row[YY] = y + y_offset;
+    row[ZZ] = z + z_offset;
+    nodes.rank()[glb_node_idx-glb_node_start_idx]=part;
+    nodes.glb_idx()[glb_node_idx-glb_node_start_idx]=glb_node_idx;
   }
   // add ghost nodes
   Uint glb_ghost_node_start_idx = hash.subhash(NODES).nb_objects_in_part(part);
@@ -732,85 +955,82 @@ void SimpleMeshGenerator::create_box()
       nodes.glb_idx()[loc_ghost_node_idx]=glb_ghost_node_idx;
     }
   }
+  // the ghost nodes and their owners are known analytically, so the comm pattern can be built without communication
+  if(PE::Comm::instance().is_active() && nb_parts == PE::Comm::instance().size() && part == PE::Comm::instance().rank())
+    detail::build_comm_pattern(nodes, hash.subhash(NODES), hash.subhash(ELEMS), part, options().value<Uint>("overlap"), DIM_3D, x_segments, y_segments, z_segments, ghost_nodes_loc);
   Handle<Cells> cells = region.create_component<Cells>("Hexa");
   cells->initialize("cf3.mesh.LagrangeP1.Hexa"+to_str(m_coord_dim)+"D",nodes);
 
-  cells->resize(hash.subhash(ELEMS).nb_objects_in_part(part));
+  cells->resize(local_elems.size());
   Connectivity& connectivity = cells->geometry_space().connectivity();
   common::List<Uint>& elem_rank = cells->rank();
   common::List<Uint>& elem_glb_idx = cells->glb_idx();
 
-  Uint glb_elem_start_idx = hash.subhash(ELEMS).start_idx_in_part(part);
-  for(Uint k = 0; k < z_segments; ++k)
+  for(Uint loc_elem_idx = 0; loc_elem_idx != local_elems.size(); ++loc_elem_idx)
   {
-    for(Uint j = 0; j < y_segments; ++j)
-    {
-      for(Uint i = 0; i < x_segments; ++i)
-      {
-        glb_elem_idx = (k * y_segments + j) * x_segments + i;
+    glb_elem_idx = local_elems.glb_idx(loc_elem_idx);
+    const Uint k = glb_elem_idx / (x_segments*y_segments);
+    const Uint j = (glb_elem_idx - k*x_segments*y_segments) / x_segments;
+    const Uint i = glb_elem_idx - (k*y_segments + j)*x_segments;
+    Connectivity::Row nodes = connectivity[loc_elem_idx];
+    elem_rank[loc_elem_idx] = local_elems.rank(glb_elem_idx);
+    elem_glb_idx[loc_elem_idx] = glb_elem_idx;
+
+    glb_node_idx = node_idx(i,j,k , x_segments,y_segments,z_segments);
+    if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
+      nodes[0] = ghost_nodes_loc[glb_node_idx];
+    else
+      nodes[0] = glb_node_idx-glb_node_start_idx;
+
+    glb_node_idx = node_idx(i+1,j,k, x_segments,y_segments,z_segments);
+    if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
+      nodes[1] = ghost_nodes_loc[glb_node_idx];
+    else
+      nodes[1] = glb_node_idx-glb_node_start_idx;
+
+    glb_node_idx = node_idx(i+1,j+1,k, x_segments,y_segments,z_segments);
+    if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
+      nodes[2] = ghost_nodes_loc[glb_node_idx];
+    else
+      nodes[2] = glb_node_idx-glb_node_start_idx;
+
+    glb_node_idx = node_idx(i,j+1,k, x_segments,y_segments,z_segments);
+    if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
+      nodes[3] = ghost_nodes_loc[glb_node_idx];
+    else
+      nodes[3] = glb_node_idx-glb_node_start_idx;
+
+    glb_node_idx = node_idx(i,j,k+1 , x_segments,y_segments,z_segments);
+    if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
+      nodes[4] = ghost_nodes_loc[glb_node_idx];
+    else
+      nodes[4] = glb_node_idx-glb_node_start_idx;
+
+    glb_node_idx = node_idx(i+1,j,k+1, x_segments,y_segments,z_segments);
+    if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
+      nodes[5] = ghost_nodes_loc[glb_node_idx];
+    else
+      nodes[5] = glb_node_idx-glb_node_start_idx;
+
+    glb_node_idx = node_idx(i+1,j+1,k+1, x_segments,y_segments,z_segments);
+    if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
+      nodes[6] = ghost_nodes_loc[glb_node_idx];
+    else
+      nodes[6] = glb_node_idx-glb_node_start_idx;
+
+    glb_node_idx = node_idx(i,j+1,k+1, x_segments,y_segments,z_segments);
+    if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
+      nodes[7] = ghost_nodes_loc[glb_node_idx];
+    else
+      nodes[7] = glb_node_idx-glb_node_start_idx;
 
-        if (hash.subhash(ELEMS).part_owns(part,glb_elem_idx))
-        {
-          Connectivity::Row nodes = connectivity[glb_elem_idx-glb_elem_start_idx];
-          elem_rank[glb_elem_idx-glb_elem_start_idx] = part;
-          elem_glb_idx[glb_elem_idx-glb_elem_start_idx] = glb_elem_idx;
-
-          glb_node_idx = node_idx(i,j,k , x_segments,y_segments,z_segments);
-          if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
-            nodes[0] = ghost_nodes_loc[glb_node_idx];
-          else
-            nodes[0] = glb_node_idx-glb_node_start_idx;
-
-          glb_node_idx = node_idx(i+1,j,k, x_segments,y_segments,z_segments);
-          if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
-            nodes[1] = ghost_nodes_loc[glb_node_idx];
-          else
-            nodes[1] = glb_node_idx-glb_node_start_idx;
-
-          glb_node_idx = node_idx(i+1,j+1,k, x_segments,y_segments,z_segments);
-          if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
-            nodes[2] = ghost_nodes_loc[glb_node_idx];
-          else
-            nodes[2] = glb_node_idx-glb_node_start_idx;
-
-          glb_node_idx = node_idx(i,j+1,k, x_segments,y_segments,z_segments);
-          if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
-            nodes[3] = ghost_nodes_loc[glb_node_idx];
-          else
-            nodes[3] = glb_node_idx-glb_node_start_idx;
-
-          glb_node_idx = node_idx(i,j,k+1 , x_segments,y_segments,z_segments);
-          if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
-            nodes[4] = ghost_nodes_loc[glb_node_idx];
-          else
-            nodes[4] = glb_node_idx-glb_node_start_idx;
-
-          glb_node_idx = node_idx(i+1,j,k+1, x_segments,y_segments,z_segments);
-          if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
-            nodes[5] = ghost_nodes_loc[glb_node_idx];
-          else
-            nodes[5] = glb_node_idx-glb_node_start_idx;
-
-          glb_node_idx = node_idx(i+1,j+1,k+1, x_segments,y_segments,z_segments);
-          if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
-            nodes[6] = ghost_nodes_loc[glb_node_idx];
-          else
-            nodes[6] = glb_node_idx-glb_node_start_idx;
-
-          glb_node_idx = node_idx(i,j+1,k+1, x_segments,y_segments,z_segments);
-          if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
-            nodes[7] = ghost_nodes_loc[glb_node_idx];
-          else
-            nodes[7] = glb_node_idx-glb_node_start_idx;
-
-        }
-
-      }
-    }
   }
   if (bdry)
   {
-    glb_elem_idx =  (x_segments+1) * (y_segments+1) * (z_segments+1);
+    // boundary elements are numbered after the nodes, per boundary; only the layers, rows and columns with local elements are visited
+    const Uint bdry_start = (x_segments+1) * (y_segments+1) * (z_segments+1);
+    Uint layers_begin, layers_end, rows_begin, rows_end, columns_begin, columns_end;
+    local_elems.layers(layers_begin, layers_end);
     std::vector<Uint> quad_nodes(4);
 
     // LEFT BDRY (elems i=0)
@@ -821,11 +1041,12 @@ void SimpleMeshGenerator::create_box()
       common::List<Uint>::Buffer faces_rank = faces->rank().create_buffer();
       common::List<Uint>::Buffer faces_glb_idx = faces->glb_idx().create_buffer();
       const Uint i=0;
-      for(Uint k = 0; k < z_segments; ++k)
+      for(Uint k = layers_begin; k < layers_end; ++k)
       {
-        for(Uint j = 0; j < y_segments; ++j)
+        local_elems.rows(k, rows_begin, rows_end);
+        for(Uint j = rows_begin; j < rows_end; ++j)
         {
-          if (hash.subhash(ELEMS).part_owns(part, elem_idx(i,j,k,x_segments,y_segments,z_segments)))
+          if (local_elems.is_local(elem_idx(i,j,k, x_segments,y_segments,z_segments)))
           {
             glb_node_idx = node_idx(i,j,k, x_segments,y_segments,z_segments);
             if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
@@ -852,10 +1073,9 @@ void SimpleMeshGenerator::create_box()
               quad_nodes[3] = glb_node_idx-glb_node_start_idx;
 
             faces_connectivity.add_row(quad_nodes);
-            faces_rank.add_row(part);
-            faces_glb_idx.add_row(glb_elem_idx);
+            faces_rank.add_row(local_elems.rank(elem_idx(i,j,k, x_segments,y_segments,z_segments)));
+            faces_glb_idx.add_row(bdry_start + k*y_segments + j);
           }
-          ++glb_elem_idx;
         }
       }
     }
@@ -869,11 +1089,12 @@ void SimpleMeshGenerator::create_box()
       common::List<Uint>::Buffer faces_glb_idx = faces->glb_idx().create_buffer();
 
       Uint i=x_segments-1;
-      for(Uint k = 0; k < z_segments; ++k)
+      for(Uint k = layers_begin; k < layers_end; ++k)
       {
-        for(Uint j = 0; j < y_segments; ++j)
+        local_elems.rows(k, rows_begin, rows_end);
+        for(Uint j = rows_begin; j < rows_end; ++j)
         {
-          if (hash.subhash(ELEMS).part_owns(part, elem_idx(i,j,k, x_segments,y_segments,z_segments) ))
+          if (local_elems.is_local(elem_idx(i,j,k, x_segments,y_segments,z_segments)))
           {
             glb_node_idx = node_idx(i+1,j,k, x_segments,y_segments,z_segments);
             if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
@@ -900,11 +1121,10 @@ void SimpleMeshGenerator::create_box()
               quad_nodes[3] = glb_node_idx-glb_node_start_idx;
 
             faces_connectivity.add_row(quad_nodes);
-            faces_rank.add_row(part);
-            faces_glb_idx.add_row(glb_elem_idx);
+            faces_rank.add_row(local_elems.rank(elem_idx(i,j,k, x_segments,y_segments,z_segments)));
+            faces_glb_idx.add_row(bdry_start + y_segments*z_segments + k*y_segments + j);
 
           }
-          ++glb_elem_idx;
         }
       }
     }
@@ -918,11 +1138,12 @@ void SimpleMeshGenerator::create_box()
       common::List<Uint>::Buffer faces_glb_idx = faces->glb_idx().create_buffer();
 
       Uint j=0;
-      for(Uint k = 0; k < z_segments; ++k)
+      for(Uint k = layers_begin; k < layers_end; ++k)
       {
-        for(Uint i = 0; i < x_segments; ++i)
+        local_elems.columns(k, 0, columns_begin, columns_end);
+        for(Uint i = columns_begin; i < columns_end; ++i)
         {
-          if (hash.subhash(ELEMS).part_owns(part, elem_idx(i,j,k, x_segments,y_segments,z_segments) ))
+          if (local_elems.is_local(elem_idx(i,j,k, x_segments,y_segments,z_segments)))
           {
             glb_node_idx = node_idx(i,j,k, x_segments,y_segments,z_segments);
             if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
@@ -949,11 +1170,10 @@ void SimpleMeshGenerator::create_box()
               quad_nodes[3] = glb_node_idx-glb_node_start_idx;
 
             faces_connectivity.add_row(quad_nodes);
-            faces_rank.add_row(part);
-            faces_glb_idx.add_row(glb_elem_idx);
+            faces_rank.add_row(local_elems.rank(elem_idx(i,j,k, x_segments,y_segments,z_segments)));
+            faces_glb_idx.add_row(bdry_start + 2*y_segments*z_segments + k*x_segments + i);
 
           }
-          ++glb_elem_idx;
         }
       }
     }
@@ -967,11 +1187,12 @@ void SimpleMeshGenerator::create_box()
       common::List<Uint>::Buffer faces_glb_idx = faces->glb_idx().create_buffer();
 
       Uint j=y_segments-1;
-      for(Uint k = 0; k < z_segments; ++k)
+      for(Uint k = layers_begin; k < layers_end; ++k)
       {
-        for(Uint i = 0; i < x_segments; ++i)
+        local_elems.columns(k, y_segments-1, columns_begin, columns_end);
+        for(Uint i = columns_begin; i < columns_end; ++i)
         {
-          if (hash.subhash(ELEMS).part_owns(part, elem_idx(i,j,k, x_segments,y_segments,z_segments) ))
+          if (local_elems.is_local(elem_idx(i,j,k, x_segments,y_segments,z_segments)))
           {
             glb_node_idx = node_idx(i,j+1,k, x_segments,y_segments,z_segments);
             if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
@@ -998,11 +1219,10 @@ void SimpleMeshGenerator::create_box()
               quad_nodes[3] = glb_node_idx-glb_node_start_idx;
 
             faces_connectivity.add_row(quad_nodes);
-            faces_rank.add_row(part);
-            faces_glb_idx.add_row(glb_elem_idx);
+            faces_rank.add_row(local_elems.rank(elem_idx(i,j,k, x_segments,y_segments,z_segments)));
+            faces_glb_idx.add_row(bdry_start + 2*y_segments*z_segments + x_segments*z_segments + k*x_segments + i);
 
           }
-          ++glb_elem_idx;
         }
       }
     }
@@ -1016,11 +1236,13 @@ void SimpleMeshGenerator::create_box()
       common::List<Uint>::Buffer faces_glb_idx = faces->glb_idx().create_buffer();
 
       Uint k=0;
-      for(Uint j = 0; j < y_segments; ++j)
+      local_elems.rows(0, rows_begin, rows_end);
+      for(Uint j = rows_begin; j < rows_end; ++j)
       {
-        for(Uint i = 0; i < x_segments; ++i)
+        local_elems.columns(0, j, columns_begin, columns_end);
+        for(Uint i = columns_begin; i < columns_end; ++i)
         {
-          if (hash.subhash(ELEMS).part_owns(part, elem_idx(i,j,k, x_segments,y_segments,z_segments) ))
+          if (local_elems.is_local(elem_idx(i,j,k, x_segments,y_segments,z_segments)))
           {
             glb_node_idx = node_idx(i,j,k, x_segments,y_segments,z_segments);
             if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
@@ -1047,11 +1269,10 @@ void SimpleMeshGenerator::create_box()
               quad_nodes[3] = glb_node_idx-glb_node_start_idx;
 
             faces_connectivity.add_row(quad_nodes);
-            faces_rank.add_row(part);
-            faces_glb_idx.add_row(glb_elem_idx);
+            faces_rank.add_row(local_elems.rank(elem_idx(i,j,k, x_segments,y_segments,z_segments)));
+            faces_glb_idx.add_row(bdry_start + 2*y_segments*z_segments + 2*x_segments*z_segments + j*x_segments + i);
 
           }
-          ++glb_elem_idx;
         }
       }
     }
@@ -1065,11 +1286,13 @@ void SimpleMeshGenerator::create_box()
       common::List<Uint>::Buffer faces_glb_idx = faces->glb_idx().create_buffer();
 
       Uint k=z_segments-1;
-      for(Uint j = 0; j < y_segments; ++j)
+      local_elems.rows(z_segments-1, rows_begin, rows_end);
+      for(Uint j = rows_begin; j < rows_end; ++j)
       {
-        for(Uint i = 0; i < x_segments; ++i)
+        local_elems.columns(z_segments-1, j, columns_begin, columns_end);
+        for(Uint i = columns_begin; i < columns_end; ++i)
         {
-          if (hash.subhash(ELEMS).part_owns(part, elem_idx(i,j,k, x_segments,y_segments,z_segments) ))
+          if (local_elems.is_local(elem_idx(i,j,k, x_segments,y_segments,z_segments)))
           {
             glb_node_idx = node_idx(i,j,k+1, x_segments,y_segments,z_segments);
             if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
@@ -1096,11 +1319,10 @@ void SimpleMeshGenerator::create_box()
               quad_nodes[3] = glb_node_idx-glb_node_start_idx;
 
             faces_connectivity.add_row(quad_nodes);
-            faces_rank.add_row(part);
-            faces_glb_idx.add_row(glb_elem_idx);
+            faces_rank.add_row(local_elems.rank(elem_idx(i,j,k, x_segments,y_segments,z_segments)));
+            faces_glb_idx.add_row(bdry_start + 2*y_segments*z_segments + 2*x_segments*z_segments + x_segments*y_segments + j*x_segments + i);
 
           }
-          ++glb_elem_idx;
         }
       }
     }
@@ -1115,7 +1337,7 @@ void SimpleMeshGenerator::create_box()
     cf3_assert_desc(elements.uri().string() + " ( "+to_str(elements.size())+"!="+to_str(elements.rank().size()),elements.size() == elements.rank().size());
     boost_foreach(Uint r, elements.rank().array())
     {
-      cf3_assert( r == part);
+      cf3_assert( r == part || options().value<Uint>("overlap") != 0 );
     }
   }
 
@@ -114,7 +114,8 @@ void WriteMesh::update_list_of_available_writers()
     ("cf3.mesh.tecplot.Writer")
     ("cf3.mesh.smurf.Writer")
     ("cf3.mesh.VTKLegacy.Writer")
-    ("cf3.mesh.VTKXML.Writer");
+    ("cf3.mesh.VTKXML.Writer")
+    ("cf3.mesh.XDMF.Writer");
 
   boost_foreach(const std::string& writer_name, known_writers)
   {
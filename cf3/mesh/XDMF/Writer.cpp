@@ -0,0 +1,495 @@
+// Copyright (C) 2010-2013 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#include <set>
+
+#include <boost/assign/list_of.hpp>
+
+#include "common/BoostFilesystem.hpp"
+#include "common/Builder.hpp"
+#include "common/FindComponents.hpp"
+#include "common/Foreach.hpp"
+#include "common/Log.hpp"
+#include "common/OptionArray.hpp"
+#include "common/OptionList.hpp"
+#include "common/OptionT.hpp"
+#include "common/PE/Comm.hpp"
+#include "common/StringConversion.hpp"
+
+#include "common/XML/FileOperations.hpp"
+#include "common/XML/XmlDoc.hpp"
+#include "common/XML/XmlNode.hpp"
+
+#include "mesh/XDMF/Writer.hpp"
+#include "mesh/Connectivity.hpp"
+#include "mesh/Dictionary.hpp"
+#include "mesh/ElementType.hpp"
+#include "mesh/Elements.hpp"
+#include "mesh/Field.hpp"
+#include "mesh/GeoShape.hpp"
+#include "mesh/Mesh.hpp"
+#include "mesh/Region.hpp"
+#include "mesh/Space.hpp"
+
+//////////////////////////////////////////////////////////////////////////////
+
+using namespace cf3::common;
+using namespace cf3::common::XML;
+
+namespace cf3 {
+namespace mesh {
+namespace XDMF {
+
+namespace detail
+{
+  /// Number of values gathered from each rank for each snapshot
+  const Uint nb_rank_values = 5;
+
+  /// XDMF code for each supported shape, in a mixed topology
+  std::map<GeoShape::Type,boost::int32_t> xdmf_shapes()
+  {
+    return boost::assign::map_list_of
+      (GeoShape::LINE, 2)
+      (GeoShape::TRIAG, 4)
+      (GeoShape::QUAD, 5)
+      (GeoShape::TETRA, 6)
+      (GeoShape::PRISM, 8)
+      (GeoShape::HEXA, 9);
+  }
+
+  /// Write the values as doubles or floats
+  void write_values(std::ostream& out, const std::vector<Real>& values, const Uint precision)
+  {
+    if(values.empty())
+      return;
+
+    if(precision == sizeof(Real))
+    {
+      out.write(reinterpret_cast<const char*>(&values[0]), values.size()*sizeof(Real));
+      return;
+    }
+
+    cf3_assert(precision == sizeof(float));
+    std::vector<float> single_values(values.begin(), values.end());
+    out.write(reinterpret_cast<const char*>(&single_values[0]), single_values.size()*sizeof(float));
+  }
+
+  /// Add a binary DataItem to the node
+  XmlNode add_data_item(XmlNode& parent, const std::string& number_type, const Uint precision, const boost::uint64_t seek, const std::string& dimensions, const std::string& file_name)
+  {
+    XmlNode item = parent.add_node("DataItem", file_name);
+    item.set_attribute("Format", "Binary");
+    item.set_attribute("NumberType", number_type);
+    item.set_attribute("Precision", to_str(precision));
+    item.set_attribute("Endian", "Native");
+    item.set_attribute("Seek", to_str(seek));
+    item.set_attribute("Dimensions", dimensions);
+    return item;
+  }
+
+  std::string geometry_name(const Uint rank, const Uint revision)
+  {
+    return "P" + to_str(rank) + "_geometry" + to_str(revision);
+  }
+} // namespace detail
+
+////////////////////////////////////////////////////////////////////////////////
+
+common::ComponentBuilder < XDMF::Writer, MeshWriter, LibXDMF> aXDMFWriter_Builder;
+
+//////////////////////////////////////////////////////////////////////////////
+
+Writer::Writer( const std::string& name ) :
+  MeshWriter(name),
+  m_series_mesh(0),
+  m_nb_snapshots(0),
+  m_geometry_revision(0),
+  m_fields_offset(0),
+  m_index_end(0)
+{
+  options().add("time", -1.)
+    .pretty_name("Time")
+    .description("Time of the next snapshot. When negative, the index of the snapshot is used.")
+    .mark_basic();
+
+  options().add("single_precision_fields", std::vector<URI>())
+    .pretty_name("Single Precision Fields")
+    .description("Fields that are stored in single precision, halving their size at a relative error of at most 6e-8. "
+                 "URIs can be relative to the mesh.");
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+std::vector<std::string> Writer::get_extensions()
+{
+  std::vector<std::string> extensions;
+  extensions.push_back(".xmf");
+  return extensions;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void Writer::start_series()
+{
+  m_series_path = m_file_path.path();
+  m_series_mesh = m_mesh.get();
+  m_nb_snapshots = 0;
+  m_geometry_revision = 0;
+  m_geometry_coordinates.clear();
+  m_geometry_topology.clear();
+  m_fields_offset = 0;
+  m_index_end = 0;
+  m_geometry_snapshots.clear();
+
+  const URI my_path(m_file_path.path());
+  const URI fields_path = my_path.base_path() / (my_path.base_name() + "_P" + to_str(PE::Comm::instance().rank()) + "_fields.bin");
+  boost::filesystem::fstream fields_file(fields_path.path(), std::ios_base::out | std::ios_base::trunc | std::ios_base::binary);
+  if(!fields_file)
+    throw FileSystemError(FromHere(), "Could not open file " + fields_path.path());
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void Writer::write()
+{
+  if(m_file_path.path() != m_series_path || m_mesh.get() != m_series_mesh)
+    start_series();
+
+  PE::Comm& comm = PE::Comm::instance();
+  const Uint rank = comm.rank();
+  const Uint nb_ranks = comm.is_active() ? comm.size() : 1u;
+
+  const URI my_path(m_file_path.path());
+  const URI my_dir = my_path.base_path();
+  const std::string basename = my_path.base_name();
+  const std::string rank_prefix = basename + "_P" + to_str(rank);
+
+  const Field& coords = m_mesh->geometry_fields().coordinates();
+  const Uint nb_points = coords.size();
+  const Uint dim = coords.row_size();
+
+  const std::map<GeoShape::Type,boost::int32_t> xdmf_shapes = detail::xdmf_shapes();
+
+  // Elements that are written, in the same order as the cells in the file
+  std::vector<Handle<Elements const> > written_elements;
+  boost_foreach(const Elements& elements, find_components_recursively<Elements>(m_mesh->topology()) )
+  {
+    if(elements.element_type().dimensionality() == dim && elements.element_type().order() == 1 && xdmf_shapes.count(elements.element_type().shape()))
+      written_elements.push_back(elements.handle<Elements const>());
+  }
+
+  // Geometry, padded to 3 coordinates
+  std::vector<Real> coordinates;
+  coordinates.reserve(3*nb_points);
+  for(Uint i = 0; i != nb_points; ++i)
+  {
+    const Field::ConstRow row = coords[i];
+    for(Uint j = 0; j != dim; ++j)
+      coordinates.push_back(row[j]);
+    for(Uint j = dim; j < 3; ++j)
+      coordinates.push_back(0.);
+  }
+
+  // Mixed topology: the shape code followed by the nodes of each cell, with the number of nodes for lines
+  std::vector<boost::int32_t> topology;
+  Uint nb_cells = 0;
+  boost_foreach(const Handle<Elements const>& elements, written_elements)
+  {
+    const boost::int32_t shape_code = xdmf_shapes.find(elements->element_type().shape())->second;
+    const Connectivity& conn_table = elements->geometry_space().connectivity();
+    const Uint nb_elem_nodes = elements->element_type().nb_nodes();
+    const Uint nb_elems = elements->size();
+    for(Uint i = 0; i != nb_elems; ++i)
+    {
+      topology.push_back(shape_code);
+      if(elements->element_type().shape() == GeoShape::LINE)
+        topology.push_back(nb_elem_nodes);
+      const Connectivity::ConstRow row = conn_table[i];
+      for(Uint j = 0; j != nb_elem_nodes; ++j)
+        topology.push_back(static_cast<boost::int32_t>(row[j]));
+    }
+    nb_cells += nb_elems;
+  }
+
+  // Only write the geometry if it changed since the previous snapshot
+  if(m_geometry_revision == 0 || coordinates != m_geometry_coordinates || topology != m_geometry_topology)
+  {
+    const URI geometry_path = my_dir / (rank_prefix + "_geometry" + to_str(m_geometry_revision) + ".bin");
+    boost::filesystem::fstream geometry_file(geometry_path.path(), std::ios_base::out | std::ios_base::trunc | std::ios_base::binary);
+    if(!geometry_file)
+      throw FileSystemError(FromHere(), "Could not open file " + geometry_path.path());
+    detail::write_values(geometry_file, coordinates, sizeof(Real));
+    if(!topology.empty())
+      geometry_file.write(reinterpret_cast<const char*>(&topology[0]), topology.size()*sizeof(boost::int32_t));
+    geometry_file.close();
+
+    m_geometry_coordinates.swap(coordinates);
+    m_geometry_topology.swap(topology);
+    ++m_geometry_revision;
+  }
+
+  // Fields that are stored in single precision
+  std::set<const Component*> single_precision_fields;
+  boost_foreach(const URI& field_uri, options().value< std::vector<URI> >("single_precision_fields"))
+    single_precision_fields.insert(m_mesh->access_component_checked(field_uri).get());
+
+  // Fields that can be written on this rank. The index written by rank 0 lists the same attributes for all ranks,
+  // so a field is only written if it can be written everywhere.
+  std::vector<Handle<Field const> > candidate_fields;
+  std::vector<Uint> local_writable;
+  std::set<std::string> added_fields;
+  boost_foreach(const Handle<Field const>& field_ptr, m_fields)
+  {
+    const Field& field = *field_ptr;
+
+    if(!added_fields.insert(field.uri().string()).second)
+      continue;
+
+    candidate_fields.push_back(field_ptr);
+    local_writable.push_back(0u);
+
+    if(field.continuous() && &field.dict() != &m_mesh->geometry_fields())
+    {
+      CFwarn << "Skipping field " << field.uri().path() << " in XDMF output: only continuous fields on the geometry are supported" << CFendl;
+      continue;
+    }
+
+    bool defined = true;
+    boost_foreach(const Handle<Elements const>& elements, written_elements)
+      defined = defined && field.dict().defined_for_entities(elements);
+    if(!defined)
+    {
+      CFwarn << "Skipping field " << field.uri().path() << " in XDMF output: it is not defined for all written elements" << CFendl;
+      continue;
+    }
+
+    local_writable.back() = 1u;
+  }
+
+  std::vector<Uint> writable(local_writable.size());
+  if(comm.is_active())
+    comm.all_reduce(PE::min(), local_writable, writable);
+  else
+    writable = local_writable;
+
+  // Append the field values
+  const boost::uint64_t snapshot_offset = m_fields_offset;
+  std::vector<AttributeInfo> attributes;
+  boost::filesystem::fstream fields_file((my_dir / (rank_prefix + "_fields.bin")).path(), std::ios_base::out | std::ios_base::app | std::ios_base::binary);
+  std::vector<Real> values;
+  for(Uint field_idx = 0; field_idx != candidate_fields.size(); ++field_idx)
+  {
+    const Field& field = *candidate_fields[field_idx];
+
+    if(!writable[field_idx])
+    {
+      if(local_writable[field_idx])
+        CFwarn << "Skipping field " << field.uri().path() << " in XDMF output: it can not be written on all ranks" << CFendl;
+      continue;
+    }
+
+    for(Uint var_idx = 0; var_idx != field.nb_vars(); ++var_idx)
+    {
+      const Uint var_begin = field.var_offset(var_idx);
+      const Uint var_size = static_cast<Uint>(field.var_length(var_idx));
+      const Uint var_end = var_begin + var_size;
+
+      AttributeInfo attribute;
+      attribute.name = field.var_name(var_idx);
+      attribute.cell_centered = field.discontinuous();
+      attribute.precision = single_precision_fields.count(&field) ? sizeof(float) : sizeof(Real);
+      // 2D vectors are padded to 3 components, as readers expect
+      attribute.nb_components = var_size == 2 ? 3 : var_size;
+      if(var_size == 1)
+        attribute.type = "Scalar";
+      else if(var_size <= 3)
+        attribute.type = "Vector";
+      else if(var_size == 6)
+        attribute.type = "Tensor6";
+      else if(var_size == 9)
+        attribute.type = "Tensor";
+      else
+        attribute.type = "Matrix";
+
+      values.clear();
+      if(field.continuous())
+      {
+        values.reserve(nb_points*attribute.nb_components);
+        for(Uint i = 0; i != nb_points; ++i)
+        {
+          for(Uint j = var_begin; j != var_end; ++j)
+            values.push_back(field[i][j]);
+          if(var_size == 2)
+            values.push_back(0.);
+        }
+      }
+      else
+      {
+        values.reserve(nb_cells*attribute.nb_components);
+        boost_foreach(const Handle<Elements const>& elements, written_elements)
+        {
+          const Connectivity& field_connectivity = field.dict().space(*elements).connectivity();
+          const Uint nb_elems = elements->size();
+          for(Uint i = 0; i != nb_elems; ++i)
+          {
+            /// @bug the field values of the space should be interpolated to the cell-centre, similar to the tecplot writer
+            for(Uint j = var_begin; j != var_end; ++j)
+              values.push_back(field[field_connectivity[i][0]][j]);
+            if(var_size == 2)
+              values.push_back(0.);
+          }
+        }
+      }
+
+      detail::write_values(fields_file, values, attribute.precision);
+      m_fields_offset += values.size()*attribute.precision;
+      attributes.push_back(attribute);
+    }
+  }
+  fields_file.close();
+  if(!fields_file)
+    throw FileSystemError(FromHere(), "Error writing fields for " + m_file_path.path());
+
+  // Collect the sizes and offsets of all ranks
+  std::vector<boost::uint64_t> my_rank_values = boost::assign::list_of<boost::uint64_t>
+    (m_geometry_revision-1)
+    (nb_points)
+    (nb_cells)
+    (m_geometry_topology.size())
+    (snapshot_offset);
+  std::vector<boost::uint64_t> rank_values;
+  if(comm.is_active())
+    comm.all_gather(my_rank_values, rank_values);
+  else
+    rank_values = my_rank_values;
+  cf3_assert(rank_values.size() == detail::nb_rank_values*nb_ranks);
+
+  ++m_nb_snapshots;
+
+  if(rank != 0)
+    return;
+
+  const Real time = options().value<Real>("time");
+
+  Snapshot snapshot;
+  snapshot.time = time < 0. ? static_cast<Real>(m_nb_snapshots-1) : time;
+  snapshot.attributes = attributes;
+  snapshot.ranks.resize(nb_ranks);
+  for(Uint i = 0; i != nb_ranks; ++i)
+  {
+    const boost::uint64_t* values_begin = &rank_values[detail::nb_rank_values*i];
+    RankInfo& rank_info = snapshot.ranks[i];
+    rank_info.geometry_revision = static_cast<Uint>(values_begin[0]);
+    rank_info.nb_points = static_cast<Uint>(values_begin[1]);
+    rank_info.nb_cells = static_cast<Uint>(values_begin[2]);
+    rank_info.topology_size = static_cast<Uint>(values_begin[3]);
+    rank_info.fields_offset = values_begin[4];
+  }
+
+  append_to_index(snapshot);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void Writer::append_to_index(const Snapshot& snapshot)
+{
+  const URI my_path(m_file_path.path());
+  const std::string basename = my_path.base_name();
+  const Uint snapshot_idx = m_nb_snapshots - 1;
+
+  XmlDoc doc;
+  XmlNode snapshot_grid = doc.add_node("Grid");
+  snapshot_grid.set_attribute("Name", "snapshot_" + to_str(snapshot_idx));
+  snapshot_grid.set_attribute("GridType", "Collection");
+  snapshot_grid.set_attribute("CollectionType", "Spatial");
+  snapshot_grid.add_node("Time").set_attribute("Value", to_str(snapshot.time));
+
+  for(Uint rank = 0; rank != snapshot.ranks.size(); ++rank)
+  {
+    const RankInfo& rank_info = snapshot.ranks[rank];
+    const std::string name = detail::geometry_name(rank, rank_info.geometry_revision);
+
+    XmlNode grid = snapshot_grid.add_node("Grid");
+    grid.set_attribute("Name", "P" + to_str(rank));
+    grid.set_attribute("GridType", "Uniform");
+
+    XmlNode topology = grid.add_node("Topology");
+    topology.set_attribute("TopologyType", "Mixed");
+    topology.set_attribute("NumberOfElements", to_str(rank_info.nb_cells));
+
+    XmlNode geometry = grid.add_node("Geometry");
+    geometry.set_attribute("GeometryType", "XYZ");
+
+    // Each geometry is declared in the first snapshot that uses it, and referenced by the later ones
+    const std::pair<Uint, Uint> geometry_key(rank, rank_info.geometry_revision);
+    const std::map<std::pair<Uint, Uint>, Uint>::const_iterator declared = m_geometry_snapshots.find(geometry_key);
+    if(declared == m_geometry_snapshots.end())
+    {
+      const std::string file_name = basename + "_P" + to_str(rank) + "_geometry" + to_str(rank_info.geometry_revision) + ".bin";
+      detail::add_data_item(topology, "Int", 4, static_cast<boost::uint64_t>(rank_info.nb_points)*3*sizeof(Real), to_str(rank_info.topology_size), file_name)
+        .set_attribute("Name", name + "_topology");
+      detail::add_data_item(geometry, "Float", sizeof(Real), 0, to_str(rank_info.nb_points) + " 3", file_name)
+        .set_attribute("Name", name + "_coordinates");
+      m_geometry_snapshots[geometry_key] = snapshot_idx;
+    }
+    else
+    {
+      const std::string declaring_grid = "/Xdmf/Domain/Grid/Grid[@Name=\"snapshot_" + to_str(declared->second) + "\"]/Grid[@Name=\"P" + to_str(rank) + "\"]";
+      topology.add_node("DataItem", declaring_grid + "/Topology/DataItem[@Name=\"" + name + "_topology\"]").set_attribute("Reference", "XML");
+      geometry.add_node("DataItem", declaring_grid + "/Geometry/DataItem[@Name=\"" + name + "_coordinates\"]").set_attribute("Reference", "XML");
+    }
+
+    const std::string fields_file_name = basename + "_P" + to_str(rank) + "_fields.bin";
+    boost::uint64_t offset = rank_info.fields_offset;
+    boost_foreach(const AttributeInfo& attribute_info, snapshot.attributes)
+    {
+      const Uint nb_rows = attribute_info.cell_centered ? rank_info.nb_cells : rank_info.nb_points;
+
+      XmlNode attribute = grid.add_node("Attribute");
+      attribute.set_attribute("Name", attribute_info.name);
+      attribute.set_attribute("AttributeType", attribute_info.type);
+      attribute.set_attribute("Center", attribute_info.cell_centered ? "Cell" : "Node");
+      detail::add_data_item(attribute, "Float", attribute_info.precision, offset, to_str(nb_rows) + " " + to_str(attribute_info.nb_components), fields_file_name);
+
+      offset += static_cast<boost::uint64_t>(nb_rows)*attribute_info.nb_components*attribute_info.precision;
+    }
+  }
+
+  std::string snapshot_text;
+  to_string(snapshot_grid, snapshot_text);
+
+  // The new snapshot overwrites the closing tags, which are written again after it
+  const std::string index_path = (my_path.base_path() / (basename + ".xmf")).path();
+  boost::filesystem::fstream index_file;
+  if(snapshot_idx == 0)
+  {
+    index_file.open(index_path, std::ios_base::out | std::ios_base::trunc | std::ios_base::binary);
+    index_file << "<?xml version=\"1.0\" encoding=\"ISO-8859-1\"?>\n"
+               << "<Xdmf Version=\"2.0\">\n"
+               << "<Domain>\n"
+               << "<Grid Name=\"" << basename << "\" GridType=\"Collection\" CollectionType=\"Temporal\">\n";
+  }
+  else
+  {
+    index_file.open(index_path, std::ios_base::in | std::ios_base::out | std::ios_base::binary);
+    index_file.seekp(static_cast<std::streamoff>(m_index_end));
+  }
+  if(!index_file)
+    throw FileSystemError(FromHere(), "Could not open file " + index_path);
+
+  index_file << snapshot_text;
+  m_index_end = static_cast<boost::uint64_t>(static_cast<std::streamoff>(index_file.tellp()));
+  index_file << "</Grid>\n</Domain>\n</Xdmf>\n";
+  index_file.close();
+  if(!index_file)
+    throw FileSystemError(FromHere(), "Error writing index " + index_path);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // XDMF
+} // mesh
+} // cf3
@@ -0,0 +1,126 @@
+// Copyright (C) 2010-2013 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef cf3_mesh_XDMF_Writer_hpp
+#define cf3_mesh_XDMF_Writer_hpp
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <map>
+
+#include <boost/cstdint.hpp>
+
+#include "mesh/MeshWriter.hpp"
+
+#include "mesh/XDMF/LibXDMF.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace mesh {
+namespace XDMF {
+
+//////////////////////////////////////////////////////////////////////////////
+
+/// Writes a time series of a mesh and its fields, using an XDMF index file and raw binary data files.
+/// Each call to execute adds a snapshot to the series that is named by the file option:
+///  - The coordinates and the connectivity are written to <basename>_P<rank>_geometry<n>.bin only when they changed since
+///    the previous snapshot, and all snapshots that share the same geometry refer to the same data in the index
+///  - The values of the fields are appended to <basename>_P<rank>_fields.bin
+///  - Rank 0 appends each snapshot to the index <basename>.xmf, a temporal collection that can be opened directly in
+///    ParaView or VisIt. The index is complete after each snapshot, and writing a snapshot does not depend on the
+///    number of earlier snapshots.
+/// Changing the file option starts a new series, truncating the data of any earlier series with the same name.
+/// The writer keeps the state of the series, so it must be kept alive between snapshots (WriteMesh builds
+/// a new writer for each call, so through WriteMesh each file only contains a single snapshot).
+class XDMF_API Writer : public MeshWriter
+{
+public: // functions
+
+  /// constructor
+  Writer( const std::string& name );
+
+  /// Gets the Class name
+  static std::string type_name() { return "Writer"; }
+
+  virtual void write();
+
+  virtual std::string get_format() { return "XDMF"; }
+
+  virtual std::vector<std::string> get_extensions();
+
+  /// Number of snapshots in the current series
+  Uint nb_snapshots() const { return m_nb_snapshots; }
+
+  /// Number of times the geometry was written for the current series on this rank
+  Uint nb_geometry_writes() const { return m_geometry_revision; }
+
+private:
+  /// Description of an attribute in a snapshot, identical on all ranks
+  struct AttributeInfo
+  {
+    std::string name;
+    std::string type;
+    bool cell_centered;
+    Uint nb_components;
+    Uint precision;
+  };
+
+  /// Per-rank data of a snapshot, as gathered on rank 0
+  struct RankInfo
+  {
+    Uint geometry_revision;
+    Uint nb_points;
+    Uint nb_cells;
+    Uint topology_size;
+    boost::uint64_t fields_offset;
+  };
+
+  struct Snapshot
+  {
+    Real time;
+    std::vector<AttributeInfo> attributes;
+    std::vector<RankInfo> ranks;
+  };
+
+  /// Forget the current series and truncate the data files
+  void start_series();
+
+  /// Append a snapshot to the index file, replacing its closing tags
+  void append_to_index(const Snapshot& snapshot);
+
+  /// File the current series is written to
+  std::string m_series_path;
+  /// Mesh of the current series
+  const Mesh* m_series_mesh;
+
+  Uint m_nb_snapshots;
+
+  /// Number of geometry files written on this rank for the current series
+  Uint m_geometry_revision;
+  /// Coordinates and connectivity that were last written, to detect changes exactly
+  std::vector<Real> m_geometry_coordinates;
+  std::vector<boost::int32_t> m_geometry_topology;
+
+  /// Size of the fields file of this rank
+  boost::uint64_t m_fields_offset;
+
+  /// Position of the closing tags in the index file, only on the rank that writes the index
+  boost::uint64_t m_index_end;
+  /// Snapshot that declares each geometry, indexed by rank and revision, only on the rank that writes the index
+  std::map<std::pair<Uint, Uint>, Uint> m_geometry_snapshots;
+}; // end Writer
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // XDMF
+} // mesh
+} // cf3
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // cf3_mesh_XDMF_Writer_hpp
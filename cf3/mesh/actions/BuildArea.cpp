@@ -19,6 +19,8 @@
 #include "mesh/Mesh.hpp"
 #include "mesh/Field.hpp"
 #include "mesh/Connectivity.hpp"
+#include "mesh/ElementTypeLoop.hpp"
+#include "mesh/LagrangeP1/ElementTypes.hpp"
 
 //////////////////////////////////////////////////////////////////////////////
 
@@ -34,6 +36,36 @@ common::ComponentBuilder < BuildArea, MeshTransformer, mesh::actions::LibActions
 
 //////////////////////////////////////////////////////////////////////////////
 
+namespace detail
+{
+  /// Computes the area of each face with the static functions of the element type
+  struct ComputeArea
+  {
+    ComputeArea(Field& area_field, const Connectivity& field_connectivity) :
+      area(area_field),
+      connectivity(field_connectivity)
+    {
+    }
+
+    template<typename ETYPE>
+    void operator()(const ETYPE&, const Entities& faces)
+    {
+      for_each_element<ETYPE>(faces, *this);
+    }
+
+    template<typename ETYPE>
+    void operator()(const ETYPE&, const Uint face_idx, const typename ETYPE::NodesT& nodes)
+    {
+      area[connectivity[face_idx][0]][0] = ETYPE::area(nodes);
+    }
+
+    Field& area;
+    const Connectivity& connectivity;
+  };
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
 BuildArea::BuildArea( const std::string& name )
 : MeshTransformer(name)
 {
@@ -66,6 +98,11 @@ void BuildArea::execute()
 
   boost_foreach(const Handle<Space>& space, area.spaces() )
   {
+    // Resolve the element type once, and fall back to the virtual interface for other than LagrangeP1 types
+    detail::ComputeArea compute_area(area, space->connectivity());
+    if(dispatch_element_type<LagrangeP1::FaceTypes>(space->support(), compute_area))
+      continue;
+
     RealMatrix coordinates;  space->support().geometry_space().allocate_coordinates(coordinates);
     const Connectivity& field_connectivity = space->connectivity();
     for (Uint face_idx = 0; face_idx<space->size(); ++face_idx)
@@ -4,10 +4,12 @@
 // GNU Lesser General Public License version 3 (LGPLv3).
 // See doc/lgpl.txt and doc/gpl.txt for the license text.
 
+#include <algorithm>
 #include <set>
 
 #include <boost/foreach.hpp>
 #include <boost/functional/hash.hpp>
+#include <boost/scoped_ptr.hpp>
 
 #include "common/Log.hpp"
 #include "common/Builder.hpp"
@@ -31,6 +33,7 @@
 #include "mesh/Region.hpp"
 #include "mesh/MeshElements.hpp"
 #include "mesh/FaceCellConnectivity.hpp"
+#include "mesh/FaceHashTable.hpp"
 #include "mesh/NodeElementConnectivity.hpp"
 #include "mesh/Node2FaceCellConnectivity.hpp"
 #include "mesh/Cells.hpp"
@@ -67,13 +70,76 @@ struct FaceCompare
 
 ////////////////////////////////////////////////////////////////////////////////
 
+/// Faces of a set of FaceCellConnectivity components, looked up by their nodes in any order.
+/// Replaces the search through a Node2FaceCellConnectivity if BuildFaces is hashed.
+struct FaceIndex
+{
+  FaceIndex() : m_max_nb_nodes(1) {}
+
+  void add_used(FaceCellConnectivity& f2c)
+  {
+    m_used.push_back(&f2c);
+  }
+
+  void build()
+  {
+    Uint nb_faces = 0;
+    boost_foreach(FaceCellConnectivity* f2c, m_used)
+    {
+      for (Uint idx=0; idx<f2c->size(); ++idx)
+        m_max_nb_nodes = std::max(m_max_nb_nodes, Face2Cell(*f2c,idx).element_type().nb_nodes());
+      nb_faces += f2c->size();
+    }
+
+    m_table.reset(new FaceHashTable(m_max_nb_nodes, nb_faces));
+    m_faces.reserve(nb_faces);
+    boost_foreach(FaceCellConnectivity* f2c, m_used)
+    {
+      for (Uint idx=0; idx<f2c->size(); ++idx)
+      {
+        const std::vector<Uint> nodes = f2c->face_nodes(idx);
+        bool inserted = false;
+        m_table->insert(&nodes[0], nodes.size(), inserted);
+        if (inserted)
+          m_faces.push_back(Face2Cell(*f2c,idx));
+      }
+    }
+  }
+
+  /// Find the face with the given nodes
+  /// @return true if the face was found
+  template<typename NodesT>
+  bool find(const NodesT& nodes, Face2Cell& face)
+  {
+    if (nodes.size() > m_max_nb_nodes)
+      return false;
+    m_nodes.assign(nodes.begin(), nodes.end());
+    const Uint idx = m_table->find(&m_nodes[0], m_nodes.size());
+    if (idx == FaceHashTable::npos())
+      return false;
+    face = m_faces[idx];
+    return true;
+  }
+
+private:
+  std::vector<FaceCellConnectivity*> m_used;
+  Uint m_max_nb_nodes;
+  boost::scoped_ptr<FaceHashTable> m_table;
+  std::vector<Face2Cell> m_faces;
+  std::vector<Uint> m_nodes;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
 common::ComponentBuilder < BuildFaces, MeshTransformer, mesh::actions::LibActions> BuildFaces_Builder;
 
 //////////////////////////////////////////////////////////////////////////////
 
 BuildFaces::BuildFaces( const std::string& name )
 : MeshTransformer(name),
-  m_store_cell2face(false)
+  m_store_cell2face(false),
+  m_hashed(false),
+  m_nb_threads(1)
 {
 
   properties()["brief"] = std::string("Print information of the mesh");
@@ -89,6 +155,17 @@ BuildFaces::BuildFaces( const std::string& name )
       .pretty_name("Store Cell to Face")
       .mark_basic()
       .link_to(&m_store_cell2face);
+
+  options().add("hashed", m_hashed)
+      .description("Match faces through hash tables of their sorted nodes, and match boundary faces across processes "
+                   "by the global indices of their nodes")
+      .pretty_name("Hashed")
+      .link_to(&m_hashed);
+
+  options().add("nb_threads", m_nb_threads)
+      .description("Number of threads used to build the faces of each region, if hashed is true")
+      .pretty_name("Number of Threads")
+      .link_to(&m_nb_threads);
 }
 
 /////////////////////////////////////////////////////////////////////////////
@@ -193,6 +270,8 @@ void BuildFaces::build_face_cell_connectivity_bottom_up(Component& parent)
 //      CFdebug << PERank << "building face_cell connectivity for region " << region.uri().path() << CFendl;
       Handle<FaceCellConnectivity> face_to_cell = region.create_component<FaceCellConnectivity>("face_to_cell");
       face_to_cell->options().set("face_building_algorithm",true);
+      face_to_cell->options().set("hashed",m_hashed);
+      face_to_cell->options().set("nb_threads",m_nb_threads);
       face_to_cell->add_tag(mesh::Tags::inner_faces());
       face_to_cell->setup(region);
       PE::Comm::instance().barrier();
@@ -385,6 +464,11 @@ void BuildFaces::build_face_elements(Region& region, FaceCellConnectivity& face_
 
     faces.geometry_space().connectivity().set_row_size(faces.geometry_space().shape_function().nb_nodes());
     faces.resize(f2c.size());
+
+    std::vector<Uint> owners;
+    if (m_hashed && !is_inner && PE::Comm::instance().is_active() && PE::Comm::instance().size() > 1)
+      owners = boundary_face_owners(f2c);
+
     for (Uint f=0; f<faces.size(); ++f)
     {
       if (PE::Comm::instance().size()==1)
@@ -409,8 +493,8 @@ void BuildFaces::build_face_elements(Region& region, FaceCellConnectivity& face_
         }
         else
         {
-          // It is impossible to know if another cpu of lower rank owns this face as well.
-          faces.rank()[f] = math::Consts::uint_max();
+          // Without matching the faces across processes, it is impossible to know if another cpu of lower rank owns this face as well.
+          faces.rank()[f] = owners.empty() ? math::Consts::uint_max() : owners[f];
         }
       }
       faces.glb_idx()[f]= math::Consts::uint_max();
@@ -462,9 +546,10 @@ boost::shared_ptr< FaceCellConnectivity > BuildFaces::match_faces(Region& region
   std::map<FaceCellConnectivity*,boost::shared_ptr<common::Table<bool>::Buffer> > buf_cell_orientation;
   std::map<FaceCellConnectivity*,boost::shared_ptr<common::Table<Uint>::Buffer> > buf_cell_rotation;
 
-  // Build a node to face connectivity matching faces2
+  // Build a node to face connectivity matching faces2, or a hash table of faces2
   boost::shared_ptr<Node2FaceCellConnectivity> node2faces2_ptr = allocate_component<Node2FaceCellConnectivity>("node2faces");
   Node2FaceCellConnectivity& node2faces2 = *node2faces2_ptr;
+  FaceIndex faces2_index;
   boost_foreach(FaceCellConnectivity& faces2, find_components_recursively_with_tag<FaceCellConnectivity>(region2,mesh::Tags::inner_faces()))
   {
     buf_fnb [&faces2] = boost::shared_ptr<common::Table<Uint>::Buffer> ( new common::Table<Uint>::Buffer(faces2.face_number().create_buffer()));
@@ -472,10 +557,20 @@ boost::shared_ptr< FaceCellConnectivity > BuildFaces::match_faces(Region& region
     buf_f2c [&faces2] = boost::shared_ptr<ElementConnectivity::Buffer> ( new ElementConnectivity::Buffer(faces2.connectivity().create_buffer()));
     buf_cell_rotation [&faces2] = boost::shared_ptr<common::Table<Uint>::Buffer> ( new common::Table<Uint>::Buffer(faces2.cell_rotation().create_buffer()));
     buf_cell_orientation [&faces2] = boost::shared_ptr<common::Table<bool>::Buffer> ( new common::Table<bool>::Buffer(faces2.cell_orientation().create_buffer()));
-    node2faces2.add_used(faces2); // it is assumed this is only face types
+    if (m_hashed)
+      faces2_index.add_used(faces2);
+    else
+      node2faces2.add_used(faces2); // it is assumed this is only face types
+  }
+  if (m_hashed)
+  {
+    faces2_index.build();
+  }
+  else
+  {
+    node2faces2.set_nodes(mesh.geometry_fields());
+    node2faces2.build_connectivity();
   }
-  node2faces2.set_nodes(mesh.geometry_fields());
-  node2faces2.build_connectivity();
 
   Uint f1(0);
   Uint faces1_idx(0);
@@ -504,75 +599,88 @@ boost::shared_ptr< FaceCellConnectivity > BuildFaces::match_faces(Region& region
       face1_nodes = face1.nodes();
       const Uint nb_nodes_per_face = face1_nodes.size();
 
-      std::map<Face2Cell,Uint,FaceCompare> found_faces;
-      std::map<Face2Cell,Uint,FaceCompare>::iterator not_found = found_faces.end();
-
       bool match_found = false;
-      boost_foreach(const Uint face1_node, face1_nodes)
+      Face2Cell face2;
+      if (m_hashed)
       {
-        boost_foreach(Face2Cell face2, node2faces2.connectivity()[face1_node])
+        match_found = faces2_index.find(face1_nodes, face2);
+      }
+      else
+      {
+        std::map<Face2Cell,Uint,FaceCompare> found_faces;
+        std::map<Face2Cell,Uint,FaceCompare>::iterator not_found = found_faces.end();
+
+        boost_foreach(const Uint face1_node, face1_nodes)
         {
-          std::map<Face2Cell,Uint,FaceCompare>::iterator it = found_faces.find(face2);
-          if ( it == not_found)
+          boost_foreach(const Face2Cell& candidate, node2faces2.connectivity()[face1_node])
           {
-            found_faces[face2]=1;
-          }
-          else
-          {
-            Uint& nb_faces = it->second;
-            ++nb_faces;
-            if (nb_faces == nb_nodes_per_face)
+            std::map<Face2Cell,Uint,FaceCompare>::iterator it = found_faces.find(candidate);
+            if ( it == not_found)
             {
-              match_found = true;
-              elems[LEFT]  = face1.cells()[0];
-              elems[RIGHT] = face2.cells()[0];
-              face_nb[LEFT] = face1.face_nb_in_cells()[0];
-              face_nb[RIGHT] = face2.face_nb_in_cells()[0];
-              orientation[LEFT] = FaceCellConnectivity::MATCHED;
-              orientation[RIGHT] = FaceCellConnectivity::INVERTED;
-              rotation[LEFT] = 0;
-
-              // NOW find the rotation and orientation of this new face to the RIGHT cell
-
-              // Find orientation ( or find match between first face-nodes of both neighbouring elements )
-              face2_nodes = face2.nodes();
-
-              Uint rot;
-              for (rot=0; rot<=nb_nodes_per_face; ++rot)
+              found_faces[candidate]=1;
+            }
+            else
+            {
+              Uint& nb_faces = it->second;
+              ++nb_faces;
+              if (nb_faces == nb_nodes_per_face)
               {
-                if (face2_nodes[rot] == face1_nodes[0])
-                {
-                  rotation[RIGHT] = rot;
-                  break;
-                }
+                match_found = true;
+                face2 = candidate;
+                break;
               }
-              cf3_assert(rot != nb_nodes_per_face); // means that the break worked and the rotation was found
-
-
-              // Remove matches from the 2 connectivity tables and add to the interface
-              i2c.add_row(elems);
-              fnb.add_row(face_nb);
-              bdry.add_row(false);
-              cell_rotation.add_row(rotation);
-              cell_orientation.add_row(orientation);
-
-              buf_f2c [face1.comp]->rm_row(face1.idx);
-              buf_f2c [face2.comp]->rm_row(face2.idx);
-              buf_fnb [face1.comp]->rm_row(face1.idx);
-              buf_fnb [face2.comp]->rm_row(face2.idx);
-              buf_bdry[face1.comp]->rm_row(face1.idx);
-              buf_bdry[face2.comp]->rm_row(face2.idx);
-              buf_cell_orientation[face1.comp]->rm_row(face1.idx);
-              buf_cell_orientation[face2.comp]->rm_row(face2.idx);
-              buf_cell_rotation[face1.comp]->rm_row(face1.idx);
-              buf_cell_rotation[face2.comp]->rm_row(face2.idx);
-              ++nb_matches;
-              break;
             }
           }
+          if (match_found)
+            break;
+        }
+      }
+
+      if (match_found)
+      {
+        elems[LEFT]  = face1.cells()[0];
+        elems[RIGHT] = face2.cells()[0];
+        face_nb[LEFT] = face1.face_nb_in_cells()[0];
+        face_nb[RIGHT] = face2.face_nb_in_cells()[0];
+        orientation[LEFT] = FaceCellConnectivity::MATCHED;
+        orientation[RIGHT] = FaceCellConnectivity::INVERTED;
+        rotation[LEFT] = 0;
+
+        // NOW find the rotation and orientation of this new face to the RIGHT cell
+
+        // Find orientation ( or find match between first face-nodes of both neighbouring elements )
+        face2_nodes = face2.nodes();
+
+        Uint rot;
+        for (rot=0; rot<=nb_nodes_per_face; ++rot)
+        {
+          if (face2_nodes[rot] == face1_nodes[0])
+          {
+            rotation[RIGHT] = rot;
+            break;
+          }
         }
-        if (match_found)
-          break;
+        cf3_assert(rot != nb_nodes_per_face); // means that the break worked and the rotation was found
+
+
+        // Remove matches from the 2 connectivity tables and add to the interface
+        i2c.add_row(elems);
+        fnb.add_row(face_nb);
+        bdry.add_row(false);
+        cell_rotation.add_row(rotation);
+        cell_orientation.add_row(orientation);
+
+        buf_f2c [face1.comp]->rm_row(face1.idx);
+        buf_f2c [face2.comp]->rm_row(face2.idx);
+        buf_fnb [face1.comp]->rm_row(face1.idx);
+        buf_fnb [face2.comp]->rm_row(face2.idx);
+        buf_bdry[face1.comp]->rm_row(face1.idx);
+        buf_bdry[face2.comp]->rm_row(face2.idx);
+        buf_cell_orientation[face1.comp]->rm_row(face1.idx);
+        buf_cell_orientation[face2.comp]->rm_row(face2.idx);
+        buf_cell_rotation[face1.comp]->rm_row(face1.idx);
+        buf_cell_rotation[face2.comp]->rm_row(face2.idx);
+        ++nb_matches;
       }
       ++f1;
     }
@@ -596,9 +704,10 @@ void BuildFaces::match_boundary(Region& bdry_region, Region& inner_region)
   std::map<FaceCellConnectivity*,boost::shared_ptr<common::Table<bool>::Buffer> >  buf_inner_orientation;
   std::map<FaceCellConnectivity*,boost::shared_ptr<common::Table<Uint>::Buffer> >  buf_inner_rotation;
 
-  // Build a node to face connectivity matching faces2
+  // Build a node to face connectivity matching faces2, or a hash table of the inner faces
   boost::shared_ptr<Node2FaceCellConnectivity> nodes_to_inner_faces_ptr = allocate_component<Node2FaceCellConnectivity>("node2faces");
   Node2FaceCellConnectivity& nodes_to_inner_faces = *nodes_to_inner_faces_ptr;
+  FaceIndex inner_faces_index;
   boost_foreach(FaceCellConnectivity& f2c, find_components_recursively_with_tag<FaceCellConnectivity>(inner_region,mesh::Tags::inner_faces()))
   {
     buf_inner_face_nb          [&f2c] = boost::shared_ptr<common::Table<Uint>::Buffer> ( new common::Table<Uint>::Buffer(f2c.face_number().create_buffer()));
@@ -607,10 +716,20 @@ void BuildFaces::match_boundary(Region& bdry_region, Region& inner_region)
     buf_inner_rotation          [&f2c] = boost::shared_ptr<common::Table<Uint>::Buffer> ( new common::Table<Uint>::Buffer(f2c.cell_rotation().create_buffer()));
     buf_inner_orientation       [&f2c] = boost::shared_ptr<common::Table<bool>::Buffer> ( new common::Table<bool>::Buffer(f2c.cell_orientation().create_buffer()));
 
-    nodes_to_inner_faces.add_used(f2c);
+    if (m_hashed)
+      inner_faces_index.add_used(f2c);
+    else
+      nodes_to_inner_faces.add_used(f2c);
+  }
+  if (m_hashed)
+  {
+    inner_faces_index.build();
+  }
+  else
+  {
+    nodes_to_inner_faces.set_nodes(mesh.geometry_fields());
+    nodes_to_inner_faces.build_connectivity();
   }
-  nodes_to_inner_faces.set_nodes(mesh.geometry_fields());
-  nodes_to_inner_faces.build_connectivity();
 
   boost_foreach(Elements& bdry_faces, find_components<Elements>(bdry_region))
   {
@@ -649,91 +768,88 @@ void BuildFaces::match_boundary(Region& bdry_region, Region& inner_region)
       Connectivity::ConstRow bdry_face_nodes = bdry_entity.get_nodes();
       const Uint nb_nodes_per_face = bdry_face_nodes.size();
 
-      std::map<Face2Cell,Uint,FaceCompare> found_faces;
-      std::map<Face2Cell,Uint,FaceCompare>::iterator not_found = found_faces.end();
-
       bool match_found = false;
-      boost_foreach(const Uint bdry_face_node, bdry_face_nodes)
+      Face2Cell inner_face;
+      if (m_hashed)
+      {
+        match_found = inner_faces_index.find(bdry_face_nodes, inner_face);
+      }
+      else
       {
-        boost_foreach( Face2Cell& inner_face, nodes_to_inner_faces.connectivity()[bdry_face_node])
+        std::map<Face2Cell,Uint,FaceCompare> found_faces;
+        std::map<Face2Cell,Uint,FaceCompare>::iterator not_found = found_faces.end();
+
+        boost_foreach(const Uint bdry_face_node, bdry_face_nodes)
         {
-          std::map<Face2Cell,Uint,FaceCompare>::iterator it = found_faces.find(inner_face);
-          if ( it == not_found)
+          boost_foreach( const Face2Cell& candidate, nodes_to_inner_faces.connectivity()[bdry_face_node])
           {
-            found_faces[inner_face]=1;
-
-            it = found_faces.find(inner_face);
+            std::map<Face2Cell,Uint,FaceCompare>::iterator it = found_faces.find(candidate);
+            if ( it == not_found)
+            {
+              found_faces[candidate]=1;
+              it = found_faces.find(candidate);
+            }
+            else
+            {
+              ++it->second;
+            }
 
-            if (nb_nodes_per_face == 1)
+            if (it->second == nb_nodes_per_face)
             {
               match_found = true;
-              elems[INNER] = inner_face.cells()[INNER];
-
-              // Remove matches from the inner_faces_connectivity tables and add to the boundary
-              bdry_face_connectivity.set_row(bdry_entity.idx,elems);
-              bdry_face_nb[bdry_entity.idx][INNER] = inner_face.face_nb_in_cells()[INNER];
-              bdry_face_is_bdry[bdry_entity.idx] = true;
-              bdry_rotation[bdry_entity.idx][INNER] = 0;
-              bdry_orientation[bdry_entity.idx][INNER] = FaceCellConnectivity::MATCHED;
-
-              buf_inner_face_connectivity[inner_face.comp]->rm_row(inner_face.idx);
-              buf_inner_face_nb[inner_face.comp]->rm_row(inner_face.idx);
-              buf_inner_face_is_bdry[inner_face.comp]->rm_row(inner_face.idx);
-              buf_inner_orientation[inner_face.comp]->rm_row(inner_face.idx);
-              buf_inner_rotation[inner_face.comp]->rm_row(inner_face.idx);
-
-              ++nb_matches;
+              inner_face = candidate;
               break;
             }
           }
-          else
-          {
-            Uint& nb_faces = it->second;
-            ++nb_faces;
-
-            if (nb_faces == nb_nodes_per_face)
-            {
-              match_found = true;
-              elems[0] = inner_face.cells()[INNER];
+          if (match_found)
+            break;
+        }
+      }
 
-              // Remove matches from the inner_faces_connectivity tables and add to the boundary
-              bdry_face_connectivity.set_row(bdry_entity.idx,elems);
-              bdry_face_nb[bdry_entity.idx][INNER] = inner_face.face_nb_in_cells()[INNER];
-              bdry_face_is_bdry[bdry_entity.idx] = true;
+      if (match_found)
+      {
+        elems[INNER] = inner_face.cells()[INNER];
 
-              std::vector<Uint> inner_face_nodes = inner_face.nodes();
-              Uint rot;
-              for (rot=0; rot<=nb_nodes_per_face; ++rot)
-              {
-                if (inner_face_nodes[rot] == bdry_face_nodes[0])
-                {
-                  bdry_rotation[bdry_entity.idx][INNER] = rot;
-                  break;
-                }
-              }
+        // Remove matches from the inner_faces_connectivity tables and add to the boundary
+        bdry_face_connectivity.set_row(bdry_entity.idx,elems);
+        bdry_face_nb[bdry_entity.idx][INNER] = inner_face.face_nb_in_cells()[INNER];
+        bdry_face_is_bdry[bdry_entity.idx] = true;
 
-              // Now find the orientation (outward or inward)
-              Uint next_node = rot+1;
-              if (next_node == nb_nodes_per_face)
-                next_node = 0;
-              if (inner_face_nodes[next_node]==bdry_face_nodes[1])
-                bdry_orientation[bdry_entity.idx][INNER] = FaceCellConnectivity::MATCHED;
-              else
-                bdry_orientation[bdry_entity.idx][INNER] = FaceCellConnectivity::INVERTED;
-
-              buf_inner_face_connectivity[inner_face.comp]->rm_row(inner_face.idx);
-              buf_inner_face_nb[inner_face.comp]->rm_row(inner_face.idx);
-              buf_inner_face_is_bdry[inner_face.comp]->rm_row(inner_face.idx);
-              buf_inner_orientation[inner_face.comp]->rm_row(inner_face.idx);
-              buf_inner_rotation[inner_face.comp]->rm_row(inner_face.idx);
-
-              ++nb_matches;
+        if (nb_nodes_per_face == 1)
+        {
+          bdry_rotation[bdry_entity.idx][INNER] = 0;
+          bdry_orientation[bdry_entity.idx][INNER] = FaceCellConnectivity::MATCHED;
+        }
+        else
+        {
+          std::vector<Uint> inner_face_nodes = inner_face.nodes();
+          Uint rot;
+          for (rot=0; rot<=nb_nodes_per_face; ++rot)
+          {
+            if (inner_face_nodes[rot] == bdry_face_nodes[0])
+            {
+              bdry_rotation[bdry_entity.idx][INNER] = rot;
               break;
             }
           }
+
+          // Now find the orientation (outward or inward)
+          Uint next_node = rot+1;
+          if (next_node == nb_nodes_per_face)
+            next_node = 0;
+          if (inner_face_nodes[next_node]==bdry_face_nodes[1])
+            bdry_orientation[bdry_entity.idx][INNER] = FaceCellConnectivity::MATCHED;
+          else
+            bdry_orientation[bdry_entity.idx][INNER] = FaceCellConnectivity::INVERTED;
         }
-        if (match_found)
-          break;
+
+        buf_inner_face_connectivity[inner_face.comp]->rm_row(inner_face.idx);
+        buf_inner_face_nb[inner_face.comp]->rm_row(inner_face.idx);
+        buf_inner_face_is_bdry[inner_face.comp]->rm_row(inner_face.idx);
+        buf_inner_orientation[inner_face.comp]->rm_row(inner_face.idx);
+        buf_inner_rotation[inner_face.comp]->rm_row(inner_face.idx);
+
+        ++nb_matches;
       }
     }
   }
@@ -789,6 +905,83 @@ void BuildFaces::build_cell_face_connectivity(Component& parent)
 
 //////////////////////////////////////////////////////////////////////////////
 
+std::vector<Uint> BuildFaces::boundary_face_owners(FaceCellConnectivity& face_to_cell)
+{
+  PE::Comm& comm = PE::Comm::instance();
+  const Uint nb_procs = comm.size();
+  const Uint my_rank = comm.rank();
+  const common::List<Uint>& nodes_glb_idx = m_mesh->geometry_fields().glb_idx();
+
+  // All processes must agree to do the exchange
+  int valid_glb_idx = nodes_glb_idx.size() == m_mesh->geometry_fields().size();
+  for (Uint n=0; valid_glb_idx && n<nodes_glb_idx.size(); ++n)
+    valid_glb_idx = nodes_glb_idx[n] != math::Consts::uint_max();
+  comm.all_reduce(PE::logical_and(), &valid_glb_idx, 1, &valid_glb_idx);
+  if (!valid_glb_idx)
+    return std::vector<Uint>();
+
+  // Send the sorted global node indices of each face to the rank given by their hash, as [nb_nodes, nodes...]
+  std::vector< std::vector<Uint> > send(nb_procs);
+  std::vector<Uint> face_dest(face_to_cell.size());
+  std::vector<Uint> glb_nodes;
+  for (Uint f=0; f<face_to_cell.size(); ++f)
+  {
+    glb_nodes.clear();
+    boost_foreach(const Uint node, face_to_cell.face_nodes(f))
+      glb_nodes.push_back(nodes_glb_idx[node]);
+    std::sort(glb_nodes.begin(), glb_nodes.end());
+
+    face_dest[f] = boost::hash_range(glb_nodes.begin(), glb_nodes.end()) % nb_procs;
+    send[face_dest[f]].push_back(glb_nodes.size());
+    send[face_dest[f]].insert(send[face_dest[f]].end(), glb_nodes.begin(), glb_nodes.end());
+  }
+  std::vector< std::vector<Uint> > recv(nb_procs);
+  comm.all_to_all(send, recv);
+
+  // Other ranks may send larger faces than the local ones, so the directory is sized from what was received
+  Uint max_nb_nodes = 1;
+  for (Uint p=0; p<nb_procs; ++p)
+  {
+    for (Uint i=0; i<recv[p].size(); i+=recv[p][i]+1)
+      max_nb_nodes = std::max(max_nb_nodes, recv[p][i]);
+  }
+
+  // The owner of each face is the lowest rank that sent it
+  FaceHashTable directory(max_nb_nodes);
+  std::vector<Uint> directory_owner;
+  for (Uint p=0; p<nb_procs; ++p)
+  {
+    for (Uint i=0; i<recv[p].size(); i+=recv[p][i]+1)
+    {
+      // processes are handled in increasing order, so the first one to insert a face is its owner
+      bool inserted = false;
+      directory.insert(&recv[p][i+1], recv[p][i], inserted);
+      if (inserted)
+        directory_owner.push_back(p);
+    }
+  }
+
+  // Reply with the owner of each face, in the order the faces were received
+  for (Uint p=0; p<nb_procs; ++p)
+  {
+    send[p].clear();
+    for (Uint i=0; i<recv[p].size(); i+=recv[p][i]+1)
+      send[p].push_back(directory_owner[directory.find(&recv[p][i+1], recv[p][i])]);
+  }
+  comm.all_to_all(send, recv);
+
+  std::vector<Uint> owners(face_to_cell.size());
+  std::vector<Uint> next_reply(nb_procs, 0);
+  for (Uint f=0; f<face_to_cell.size(); ++f)
+  {
+    owners[f] = recv[face_dest[f]][next_reply[face_dest[f]]++];
+    cf3_assert(owners[f] <= my_rank);
+  }
+  return owners;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
 } // actions
 } // mesh
 } // cf3
@@ -54,10 +54,23 @@ private: // functions
 
   void build_cell_face_connectivity(Component& parent);
 
+  /// Rank owning each boundary face of the given connectivity, being the lowest rank that has the face
+  /// as a boundary face. Faces are matched across ranks through the global indices of their nodes,
+  /// exchanged with the rank given by a hash of these indices.
+  /// This is a collective operation.
+  /// @return the owner of each face, or an empty vector if the nodes have no valid global indices
+  std::vector<Uint> boundary_face_owners(FaceCellConnectivity& face_to_cell);
+
 private: // data
 
   bool m_store_cell2face;
 
+  /// Match faces through hash tables of their sorted nodes
+  bool m_hashed;
+
+  /// Number of threads for building the face to cell connectivity of each region, if m_hashed is true
+  Uint m_nb_threads;
+
 }; // end BuildFaces
 
 
@@ -19,6 +19,8 @@
 #include "mesh/Mesh.hpp"
 #include "mesh/Field.hpp"
 #include "mesh/Connectivity.hpp"
+#include "mesh/ElementTypeLoop.hpp"
+#include "mesh/LagrangeP1/ElementTypes.hpp"
 
 //////////////////////////////////////////////////////////////////////////////
 
@@ -34,6 +36,36 @@ common::ComponentBuilder < BuildVolume, MeshTransformer, mesh::actions::LibActio
 
 //////////////////////////////////////////////////////////////////////////////
 
+namespace detail
+{
+  /// Computes the volume of each cell with the static functions of the element type
+  struct ComputeVolume
+  {
+    ComputeVolume(Field& volume_field, const Connectivity& field_connectivity) :
+      volume(volume_field),
+      connectivity(field_connectivity)
+    {
+    }
+
+    template<typename ETYPE>
+    void operator()(const ETYPE&, const Entities& cells)
+    {
+      for_each_element<ETYPE>(cells, *this);
+    }
+
+    template<typename ETYPE>
+    void operator()(const ETYPE&, const Uint cell_idx, const typename ETYPE::NodesT& nodes)
+    {
+      volume[connectivity[cell_idx][0]][0] = ETYPE::volume(nodes);
+    }
+
+    Field& volume;
+    const Connectivity& connectivity;
+  };
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
 BuildVolume::BuildVolume( const std::string& name )
 : MeshTransformer(name)
 {
@@ -66,6 +98,11 @@ void BuildVolume::execute()
 
   boost_foreach( const Handle<Space>& space, volume.spaces() )
   {
+    // Resolve the element type once, and fall back to the virtual interface for other than LagrangeP1 types
+    detail::ComputeVolume compute_volume(volume, space->connectivity());
+    if(dispatch_element_type<LagrangeP1::CellTypes>(space->support(), compute_volume))
+      continue;
+
     RealMatrix coordinates;  space->support().geometry_space().allocate_coordinates(coordinates);
 
     const Connectivity& space_connectivity = space->connectivity();
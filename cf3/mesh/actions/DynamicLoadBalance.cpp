@@ -0,0 +1,206 @@
+// Copyright (C) 2010-2013 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#include <algorithm>
+
+#include "common/Builder.hpp"
+#include "common/FindComponents.hpp"
+#include "common/Foreach.hpp"
+#include "common/Log.hpp"
+#include "common/OptionList.hpp"
+#include "common/PropertyList.hpp"
+#include "common/TimedComponent.hpp"
+
+#include "common/PE/Comm.hpp"
+
+#include "mesh/actions/DynamicLoadBalance.hpp"
+#include "mesh/actions/LoadBalance.hpp"
+#include "mesh/actions/RemoveGhostElements.hpp"
+#include "mesh/Entities.hpp"
+#include "mesh/Mesh.hpp"
+#include "mesh/Region.hpp"
+
+//////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace mesh {
+namespace actions {
+
+using namespace common;
+using namespace common::PE;
+
+////////////////////////////////////////////////////////////////////////////////
+
+common::ComponentBuilder < DynamicLoadBalance, MeshTransformer, mesh::actions::LibActions> DynamicLoadBalance_Builder;
+
+//////////////////////////////////////////////////////////////////////////////
+
+namespace detail
+{
+  /// True for timed components that loop over regions
+  bool is_timed_region_action(const Component& component)
+  {
+    return is_not_null(dynamic_cast<const TimedComponent*>(&component)) && component.properties().check("timer_mean") && component.options().check("regions");
+  }
+
+  /// True if a descendant of the component is a timed region action, in which case its time is counted there
+  bool has_timed_region_action_below(const Component& component)
+  {
+    boost_foreach(const Component& child, find_components_recursively(component))
+    {
+      if(is_timed_region_action(child))
+        return true;
+    }
+    return false;
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+DynamicLoadBalance::DynamicLoadBalance( const std::string& name ) :
+  MeshTransformer(name),
+  m_threshold(0.1)
+{
+  properties()["brief"] = std::string("Repartition the mesh if the measured load is unbalanced");
+  properties()["description"] = std::string("Derives element load weights from the timings of the actions below timed_component, "
+                                            "and repartitions the mesh with these weights if the load imbalance exceeds the threshold");
+
+  options().add("timed_component", m_timed_component)
+    .pretty_name("Timed Component")
+    .description("Root of the timed actions whose time is divided over the elements of their regions")
+    .link_to(&m_timed_component)
+    .mark_basic();
+
+  options().add("threshold", m_threshold)
+    .pretty_name("Threshold")
+    .description("Repartition if the maximum load over the processes exceeds the mean load by more than this fraction")
+    .link_to(&m_threshold)
+    .mark_basic();
+
+  properties().add("imbalance", 0.);
+  properties().add("nb_rebalances", 0u);
+
+  m_remove_ghosts = create_static_component<RemoveGhostElements>("RemoveGhostElements");
+  m_load_balance = create_static_component<LoadBalance>("LoadBalance");
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void DynamicLoadBalance::execute()
+{
+  Comm& comm = Comm::instance();
+  if( !comm.is_active() || comm.size() == 1 )
+    return;
+
+  if(is_null(m_timed_component))
+    throw SetupError(FromHere(), "Option timed_component is not set for " + uri().string());
+
+  Mesh& mesh = *m_mesh;
+
+  std::map<const Entities*, Uint> entities_idx;
+  for(Uint i = 0; i != mesh.elements().size(); ++i)
+    entities_idx[mesh.elements()[i].get()] = i;
+
+  // Time spent by each action since the previous execution and number of elements it looped over.
+  // The component tree is the same on all processes, so the actions are visited in the same order everywhere.
+  store_timings(*m_timed_component);
+  std::vector<Real> local_costs;
+  std::vector< std::vector<Uint> > action_entities;
+  Real local_load = 0.;
+  boost_foreach(Component& action, find_components_recursively(*m_timed_component))
+  {
+    if(!detail::is_timed_region_action(action) || detail::has_timed_region_action_below(action))
+      continue;
+
+    const Real total = action.properties().value<Real>("timer_mean") * static_cast<Real>(action.properties().value<Uint>("timer_count"));
+    Real& previous = m_previous_times[action.uri().path()];
+    const Real elapsed = std::max(total - previous, 0.);
+    previous = total;
+
+    std::vector<Uint> covered;
+    Real nb_elems = 0.;
+    boost_foreach(const URI& region_uri, action.options().value< std::vector<URI> >("regions"))
+    {
+      Handle<Component> region = action.access_component(region_uri);
+      if(is_null(region))
+        continue;
+      boost_foreach(const Entities& entities, find_components_recursively<Entities>(*region))
+      {
+        std::map<const Entities*, Uint>::const_iterator it = entities_idx.find(&entities);
+        if(it == entities_idx.end())
+          continue;
+        covered.push_back(it->second);
+        nb_elems += static_cast<Real>(entities.size());
+      }
+    }
+
+    local_costs.push_back(elapsed);
+    local_costs.push_back(nb_elems);
+    action_entities.push_back(covered);
+    local_load += elapsed;
+  }
+
+  Real max_load = 0.;
+  Real total_load = 0.;
+  comm.all_reduce(PE::max(), &local_load, 1, &max_load);
+  comm.all_reduce(PE::plus(), &local_load, 1, &total_load);
+  const Real mean_load = total_load / static_cast<Real>(comm.size());
+  const Real imbalance = mean_load > 0. ? max_load / mean_load - 1. : 0.;
+  properties()["imbalance"] = imbalance;
+
+  CFinfo << "DynamicLoadBalance: load imbalance " << imbalance << " over " << action_entities.size() << " timed actions" << CFendl;
+  if(imbalance <= m_threshold)
+    return;
+
+  // Cost per element of each action, from the time and elements summed over all processes
+  std::vector<Real> global_costs(local_costs.size());
+  comm.all_reduce(PE::plus(), local_costs, global_costs);
+
+  const Uint nb_entities = mesh.elements().size();
+  std::vector<Real> weights(nb_entities, 0.);
+  for(Uint action_idx = 0; action_idx != action_entities.size(); ++action_idx)
+  {
+    const Real nb_elems = global_costs[2*action_idx+1];
+    if(nb_elems == 0.)
+      continue;
+    const Real cost_per_element = global_costs[2*action_idx] / nb_elems;
+    boost_foreach(const Uint idx, action_entities[action_idx])
+      weights[idx] += cost_per_element;
+  }
+
+  // Scale so the mean weight of an element is 1
+  Real local_sums[2] = {0., 0.};
+  for(Uint idx = 0; idx != nb_entities; ++idx)
+  {
+    local_sums[0] += weights[idx] * static_cast<Real>(mesh.elements()[idx]->size());
+    local_sums[1] += static_cast<Real>(mesh.elements()[idx]->size());
+  }
+  Real global_sums[2];
+  comm.all_reduce(PE::plus(), local_sums, 2, global_sums);
+  const Real scale = global_sums[0] > 0. ? global_sums[1] / global_sums[0] : 1.;
+
+  // The partitioners need positive loads, also for entities that no action loops over
+  const Real min_weight = 0.01;
+  for(Uint idx = 0; idx != nb_entities; ++idx)
+    mesh.elements()[idx]->properties()["load_weight"] = std::max(weights[idx] * scale, min_weight);
+
+  CFinfo << "DynamicLoadBalance: repartitioning mesh " << mesh.uri().path() << CFendl;
+
+  // Avoid rebuilding the linear systems on the intermediate meshes
+  mesh.block_mesh_changed(true);
+  m_remove_ghosts->transform(mesh);
+  m_load_balance->transform(mesh);
+  mesh.block_mesh_changed(false);
+  mesh.raise_mesh_changed();
+
+  properties()["nb_rebalances"] = properties().value<Uint>("nb_rebalances") + 1u;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+} // actions
+} // mesh
+} // cf3
@@ -0,0 +1,75 @@
+// Copyright (C) 2010-2013 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef cf3_mesh_actions_DynamicLoadBalance_hpp
+#define cf3_mesh_actions_DynamicLoadBalance_hpp
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <map>
+
+#include "mesh/MeshTransformer.hpp"
+#include "mesh/actions/LibActions.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace mesh {
+namespace actions {
+
+class LoadBalance;
+class RemoveGhostElements;
+
+//////////////////////////////////////////////////////////////////////////////
+
+/// @brief Repartition the mesh during a run, based on the measured cost of the actions that loop over it
+///
+/// The timed actions below the "timed_component" that have a "regions" option are taken into account.
+/// The time each of them spent since the previous execution is divided over the elements of its regions,
+/// which gives a cost per element for each Entities, averaged over all processes. If the measured load
+/// of the busiest process exceeds the mean load by more than "threshold", these costs are set as the
+/// "load_weight" property of the Entities, the ghost elements are removed and LoadBalance repartitions
+/// the mesh and grows the overlap again. Fields are migrated with their nodes, and a single mesh_changed
+/// event is raised at the end, so solvers can rebuild their linear systems.
+///
+/// Timings are only collected if the build has CF3_ENABLE_COMPONENT_TIMING enabled, otherwise this does nothing.
+class mesh_actions_API DynamicLoadBalance : public MeshTransformer
+{
+public: // functions
+
+  /// constructor
+  DynamicLoadBalance( const std::string& name );
+
+  /// Gets the Class name
+  static std::string type_name() { return "DynamicLoadBalance"; }
+
+  virtual void execute();
+
+private:
+
+  /// Root of the actions whose timings are used
+  Handle<common::Component> m_timed_component;
+
+  /// Relative excess of the maximum over the mean load that triggers a repartitioning
+  Real m_threshold;
+
+  /// Accumulated time of each action at the previous execution, keyed by path
+  std::map<std::string, Real> m_previous_times;
+
+  Handle<RemoveGhostElements> m_remove_ghosts;
+  Handle<LoadBalance> m_load_balance;
+
+}; // end DynamicLoadBalance
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // actions
+} // mesh
+} // cf3
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // cf3_mesh_actions_DynamicLoadBalance_hpp
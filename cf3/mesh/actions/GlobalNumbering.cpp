@@ -21,6 +21,7 @@
 
 #include "common/PE/Comm.hpp"
 #include "common/PE/debug.hpp"
+#include "common/PE/DistributedDirectory.hpp"
 
 #include "math/MatrixTypesConversion.hpp"
 #include "math/Hilbert.hpp"
@@ -185,16 +186,7 @@ void GlobalNumbering::execute()
 
   // now renumber
 
-  //------------------------------------------------------------------------------
-  // create node_hilbert2loc mapping
   Dictionary& nodes = mesh.geometry_fields();
-  std::map<boost::uint64_t,Uint> node_hilbert2loc;
-  Uint loc_node_idx(0);
-  boost_foreach(boost::uint64_t hilbert_idx, hilbert_indices.data())
-    node_hilbert2loc[hilbert_idx]=loc_node_idx++;
-
-  // Check if all nodes have been added to the map
-  cf3_assert(loc_node_idx==nodes.size());
 
   //------------------------------------------------------------------------------
   // get tot nb of owned indexes and communicate
@@ -244,10 +236,13 @@ void GlobalNumbering::execute()
 
 
   //------------------------------------------------------------------------------
-  // add glb_idx to owned nodes, broadcast/receive glb_idx for ghost nodes
+  // add glb_idx to owned nodes, look up the glb_idx of ghost nodes in a directory
+  // that is distributed over the ranks by hilbert key range
 
   std::vector<boost::uint64_t> node_from(nb_owned_nodes);
-  std::vector<boost::uint64_t> node_to(nb_owned_nodes);
+  std::vector<Uint> node_to(nb_owned_nodes);
+  std::vector<boost::uint64_t> ghost_node_hilbert;
+  std::vector<Uint> ghost_node_loc;
 
   common::List<Uint>& nodes_glb_idx = mesh.geometry_fields().glb_idx();
   nodes_glb_idx.resize(nodes.size());
@@ -267,53 +262,31 @@ void GlobalNumbering::execute()
     else
     {
       nodes_glb_idx[i] = uint_max();
+      ghost_node_hilbert.push_back(hilbert_indices.data()[i]);
+      ghost_node_loc.push_back(i);
     }
   }
 
-  for (Uint root=0; root<PE::Comm::instance().size(); ++root)
   {
+    PE::DistributedDirectory<boost::uint64_t> node_directory(compute_glb_idx.max_key());
+    node_directory.insert(node_from, node_to);
 
-    std::vector<boost::uint64_t> rcv_node_from(0);
-    PE::Comm::instance().broadcast(node_from,rcv_node_from,root);
-    std::vector<boost::uint64_t>        rcv_node_to(0);
-    PE::Comm::instance().broadcast(node_to,rcv_node_to,root);
+    std::vector<Uint> ghost_node_glb_idx;
+    std::vector<Uint> ghost_node_rank;
+    node_directory.find(ghost_node_hilbert, ghost_node_glb_idx, ghost_node_rank);
 
-    if (m_debug)
+    for (Uint g=0; g<ghost_node_loc.size(); ++g)
     {
-      std::cout << "["<<PE::Comm::instance().rank() << "]  received nodes from " << root << std::endl;
-    }
+      if (ghost_node_rank[g] == node_directory.unknown())
+        continue;
 
-    if (PE::Comm::instance().rank() != root)
-    {
-      for (Uint p=0; p<PE::Comm::instance().size(); ++p)
-      {
-        if (p == PE::Comm::instance().rank())
-        {
-          Uint rcv_idx(0);
-          boost_foreach(const boost::uint64_t hilbert_idx, rcv_node_from)
-          {
-            if ( node_hilbert2loc.count(hilbert_idx) )
-            {
-              const Uint loc_idx = node_hilbert2loc[hilbert_idx];
-              if (m_debug)
-                std::cout << "["<<PE::Comm::instance().rank() << "]  will change node "<< hilbert_idx << " (local " << loc_idx<< ") to (global " << rcv_node_to[rcv_idx] << ")" << std::endl;
-              cf3_assert(rcv_idx < rcv_node_to.size());
-              nodes_glb_idx[loc_idx]=rcv_node_to[rcv_idx];
-              cf3_assert(loc_idx < nodes_rank.size());
-              cf3_assert_desc("node "+to_str(loc_idx)+ " with hilbert_idx " +to_str(hilbert_idx) +" must be a ghost, but is owned by "+to_str(nodes_rank[loc_idx]),nodes.is_ghost(loc_idx));
-              nodes_rank[loc_idx]=std::min(root,nodes_rank[loc_idx]);
-            }
-            ++rcv_idx;
-          }
-          break;
-        }
-      }
-    }
-    if (m_debug)
-    {
-      std::cout << "["<<PE::Comm::instance().rank() << "]  changed nodes based on " << root << std::endl;
+      const Uint loc_idx = ghost_node_loc[g];
+      if (m_debug)
+        std::cout << "["<<PE::Comm::instance().rank() << "]  will change node "<< ghost_node_hilbert[g] << " (local " << loc_idx<< ") to (global " << ghost_node_glb_idx[g] << ")" << std::endl;
+      cf3_assert(loc_idx < nodes_rank.size());
+      nodes_glb_idx[loc_idx]=ghost_node_glb_idx[g];
+      nodes_rank[loc_idx]=std::min(ghost_node_rank[g],nodes_rank[loc_idx]);
     }
-
   }
 
   if (m_debug)
@@ -341,23 +314,17 @@ void GlobalNumbering::execute()
     common::List<Uint>& elem_rank = elements.rank();
     elem_rank.resize(elements.size());
 
-    //------------------------------------------------------------------------------
-    // create elem_glb2loc mapping
     Uint nb_owned_elems=0;
-    std::map<boost::uint64_t,Uint> elem_glb2loc;
-    std::map<boost::uint64_t,Uint>::iterator elem_glb2loc_it;
-    std::map<boost::uint64_t,Uint>::iterator hash_not_found = elem_glb2loc.end();
-
     for (Uint e=0; e<elements.size(); ++e)
     {
-      elem_glb2loc [ hilbert_indices[e] ] = e;
       if ( ! elements.is_ghost(e) )
         ++nb_owned_elems;
     }
 
-
     std::vector<boost::uint64_t> send_hash(nb_owned_elems);
-    std::vector<boost::uint64_t>   send_id(nb_owned_elems);
+    std::vector<Uint>   send_id(nb_owned_elems);
+    std::vector<boost::uint64_t> ghost_hash;
+    std::vector<Uint> ghost_loc;
 
     common::List<Uint>& elements_glb_idx = elements.glb_idx();
     elements_glb_idx.resize(elements.size());
@@ -380,43 +347,29 @@ void GlobalNumbering::execute()
       else
       {
         elements_glb_idx[e] = uint_max();
+        ghost_hash.push_back(hilbert_indices[e]);
+        ghost_loc.push_back(e);
       }
     } // end foreach elem_idx
     cf3_assert(cnt == nb_owned_elems);
 
-    for (Uint root=0; root<PE::Comm::instance().size(); ++root)
-    {
-      std::vector<boost::uint64_t> recv_hash(0);
-      PE::Comm::instance().broadcast(send_hash,recv_hash,root);
-      std::vector<boost::uint64_t>        recv_id(0);
-      PE::Comm::instance().broadcast(send_id,recv_id,root);
-      if (PE::Comm::instance().rank() != root)
-      {
-        for (Uint p=0; p<PE::Comm::instance().size(); ++p)
-        {
-          if (p == PE::Comm::instance().rank())
-          {
-            Uint recv_idx(0);
-            boost_foreach(const boost::uint64_t hash, recv_hash)
-            {
-              elem_glb2loc_it = elem_glb2loc.find(hash);
-              if ( elem_glb2loc_it != hash_not_found )
-              {
-                if (m_debug)
-                  std::cout << "["<<PE::Comm::instance().rank() << "]  will change ghost elem "<< elem_glb2loc_it->first << " (" << elements.uri() << "[" << elem_glb2loc_it->second << "]) to " << recv_id[recv_idx] << std::endl;
-                elements_glb_idx[elem_glb2loc_it->second]=recv_id[recv_idx];
-                cf3_assert(elements.is_ghost(elem_glb2loc_it->second));
-                elem_rank[elem_glb2loc_it->second]=root;
-              }
-              ++recv_idx;
-            }
-            break;
-          }
-        }
-      }
-    } // end foreach broadcasting process
+    PE::DistributedDirectory<boost::uint64_t> elem_directory(compute_glb_idx.max_key());
+    elem_directory.insert(send_hash, send_id);
+
+    std::vector<Uint> ghost_glb_idx;
+    std::vector<Uint> ghost_rank;
+    elem_directory.find(ghost_hash, ghost_glb_idx, ghost_rank);
 
+    for (Uint g=0; g<ghost_loc.size(); ++g)
+    {
+      if (ghost_rank[g] == elem_directory.unknown())
+        continue;
 
+      if (m_debug)
+        std::cout << "["<<PE::Comm::instance().rank() << "]  will change ghost elem "<< ghost_hash[g] << " (" << elements.uri() << "[" << ghost_loc[g] << "]) to " << ghost_glb_idx[g] << std::endl;
+      elements_glb_idx[ghost_loc[g]]=ghost_glb_idx[g];
+      elem_rank[ghost_loc[g]]=ghost_rank[g];
+    }
 
   } // end foreach elements
 
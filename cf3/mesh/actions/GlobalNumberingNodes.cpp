@@ -10,6 +10,7 @@
 #include <boost/functional/hash.hpp>
 
 #include <boost/static_assert.hpp>
+#include <limits>
 #include <set>
 
 #include "common/Log.hpp"
@@ -26,6 +27,7 @@
 #include "common/OptionT.hpp"
 #include "common/PE/Comm.hpp"
 #include "common/PE/debug.hpp"
+#include "common/PE/DistributedDirectory.hpp"
 
 #include "mesh/actions/GlobalNumberingNodes.hpp"
 #include "mesh/Region.hpp"
@@ -121,16 +123,6 @@ void GlobalNumberingNodes::execute()
 
   // now renumber
 
-  //------------------------------------------------------------------------------
-  // create node_glb2loc mapping
-  std::map<std::size_t,Uint> node_glb2loc;
-  Uint loc_node_idx(0);
-  boost_foreach(std::size_t hash, glb_node_hash.data())
-    node_glb2loc[hash]=loc_node_idx++;
-  std::map<std::size_t,Uint>::iterator node_glb2loc_it;
-  std::map<std::size_t,Uint>::iterator hash_not_found = node_glb2loc.end();
-
-
   //------------------------------------------------------------------------------
   // get tot nb of owned indexes and communicate
 
@@ -171,10 +163,15 @@ void GlobalNumberingNodes::execute()
 
 
   //------------------------------------------------------------------------------
-  // add glb_idx to owned nodes, broadcast/receive glb_idx for ghost nodes
+  // add glb_idx to owned nodes, look up the glb_idx of ghost nodes in a directory
+  // that is distributed over the ranks by hash range
 
   std::vector<size_t> node_from(nodes.size()-nb_ghost);
   std::vector<Uint>   node_to(nodes.size()-nb_ghost);
+  std::vector<size_t> ghost_node_hash;
+  std::vector<Uint>   ghost_node_loc;
+  ghost_node_hash.reserve(nb_ghost);
+  ghost_node_loc.reserve(nb_ghost);
 
   common::List<Uint>& nodes_glb_idx = mesh.geometry_fields().glb_idx();
   nodes_glb_idx.resize(nodes.size());
@@ -190,42 +187,29 @@ void GlobalNumberingNodes::execute()
       node_to[cnt]   = nodes_glb_idx[i];
       ++cnt;
     }
+    else
+    {
+      ghost_node_hash.push_back(glb_node_hash.data()[i]);
+      ghost_node_loc.push_back(i);
+    }
   }
 
-  for (Uint root=0; root<PE::Comm::instance().size(); ++root)
+  PE::DistributedDirectory<std::size_t> node_directory(std::numeric_limits<std::size_t>::max());
+  node_directory.insert(node_from, node_to);
+
+  std::vector<Uint> ghost_node_glb_idx;
+  std::vector<Uint> ghost_node_rank;
+  node_directory.find(ghost_node_hash, ghost_node_glb_idx, ghost_node_rank);
+
+  for (Uint g=0; g<ghost_node_loc.size(); ++g)
   {
-    //std::vector<std::size_t> rcv_node_from = MPI::broadcast(node_from, root);
-    //std::vector<Uint>        rcv_node_to   = MPI::broadcast(node_to, root);
-    // PECheckPoint(100,"001");
-    std::vector<std::size_t> rcv_node_from(0);//node_from.size());
-    PE::Comm::instance().broadcast(node_from,rcv_node_from,root);
-    //PECheckPoint(100,"002");
-    std::vector<Uint>        rcv_node_to(0);//node_to.size());
-    PE::Comm::instance().broadcast(node_to,rcv_node_to,root);
-    //PECheckPoint(100,"003");
-    if (PE::Comm::instance().rank() != root)
-    {
-      for (Uint p=0; p<PE::Comm::instance().size(); ++p)
-      {
-        if (p == PE::Comm::instance().rank())
-        {
-          Uint rcv_idx(0);
-          boost_foreach(const std::size_t node_hash, rcv_node_from)
-          {
-            node_glb2loc_it = node_glb2loc.find(node_hash);
-            if ( node_glb2loc_it != hash_not_found )
-            {
-              if (m_debug)
-                std::cout << "["<<PE::Comm::instance().rank() << "]  will change node "<< node_glb2loc_it->first << " (" << node_glb2loc_it->second << ") to " << rcv_node_to[rcv_idx] << std::endl;
-              nodes_glb_idx[node_glb2loc_it->second]=rcv_node_to[rcv_idx];
-              nodes_rank[node_glb2loc_it->second]=root;
-            }
-            ++rcv_idx;
-          }
-          break;
-        }
-      }
-    }
+    if (ghost_node_rank[g] == node_directory.unknown())
+      continue;
+
+    if (m_debug)
+      std::cout << "["<<PE::Comm::instance().rank() << "]  will change node "<< ghost_node_hash[g] << " (" << ghost_node_loc[g] << ") to " << ghost_node_glb_idx[g] << std::endl;
+    nodes_glb_idx[ghost_node_loc[g]]=ghost_node_glb_idx[g];
+    nodes_rank[ghost_node_loc[g]]=ghost_node_rank[g];
   }
 
 }
@@ -0,0 +1,245 @@
+// Copyright (C) 2010-2013 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+#include <boost/cstdint.hpp>
+
+#include "common/Log.hpp"
+#include "common/Builder.hpp"
+#include "common/ComponentIterator.hpp"
+#include "common/DynTable.hpp"
+#include "common/Foreach.hpp"
+#include "common/List.hpp"
+#include "common/Map.hpp"
+#include "common/OptionList.hpp"
+#include "common/OSystem.hpp"
+#include "common/OSystemLayer.hpp"
+#include "common/PropertyList.hpp"
+#include "common/Table.hpp"
+
+#include "common/PE/Comm.hpp"
+
+#include "mesh/Entities.hpp"
+#include "mesh/FaceCellConnectivity.hpp"
+#include "mesh/Mesh.hpp"
+#include "mesh/Space.hpp"
+
+#include "mesh/actions/MemoryInfo.hpp"
+
+//////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace mesh {
+namespace actions {
+
+  using namespace common;
+
+namespace detail
+{
+  /// Add the memory used by the component, if it is of type ArrayT
+  template<typename ArrayT>
+  bool add_memory_usage(const Component& component, Real& bytes)
+  {
+    const ArrayT* array = dynamic_cast<const ArrayT*>(&component);
+    if (is_null(array))
+      return false;
+    bytes += array->memory_usage();
+    return true;
+  }
+
+  /// Release the unused capacity of the component, if it is of type ArrayT
+  template<typename ArrayT>
+  bool shrink_to_fit(Component& component)
+  {
+    ArrayT* array = dynamic_cast<ArrayT*>(&component);
+    if (is_null(array))
+      return false;
+    array->shrink_to_fit();
+    return true;
+  }
+
+  /// Memory used by the values stored in a component, not counting its children.
+  /// Only the array types that are used in the mesh are counted.
+  Real memory_usage(const Component& component)
+  {
+    Real bytes = 0;
+    add_memory_usage< common::Table<Real> >(component, bytes) // includes Field
+      || add_memory_usage< common::Table<Uint> >(component, bytes) // includes Connectivity
+      || add_memory_usage< common::Table<Entity> >(component, bytes)
+      || add_memory_usage< common::Table<bool> >(component, bytes)
+      || add_memory_usage< common::List<Uint> >(component, bytes)
+      || add_memory_usage< common::List<Real> >(component, bytes)
+      || add_memory_usage< common::List<bool> >(component, bytes)
+      || add_memory_usage< common::DynTable<Uint> >(component, bytes)
+      || add_memory_usage< common::DynTable<SpaceElem> >(component, bytes)
+      || add_memory_usage< common::DynTable<Entity> >(component, bytes)
+      || add_memory_usage< common::DynTable<Face2Cell> >(component, bytes)
+      || add_memory_usage< common::Map<Uint,Uint> >(component, bytes)
+      || add_memory_usage< common::Map<boost::uint64_t,Uint> >(component, bytes);
+    return bytes;
+  }
+
+  /// Memory used by a component and all its children
+  Real total_memory_usage(const Component& component)
+  {
+    Real bytes = memory_usage(component);
+    boost_foreach(const Component& child, component)
+      bytes += total_memory_usage(child);
+    return bytes;
+  }
+
+  /// Release the unused capacity of the DynTables and Maps in a component and all its children
+  void shrink_to_fit_recursively(Component& component)
+  {
+    shrink_to_fit< common::DynTable<Uint> >(component)
+      || shrink_to_fit< common::DynTable<SpaceElem> >(component)
+      || shrink_to_fit< common::DynTable<Entity> >(component)
+      || shrink_to_fit< common::DynTable<Face2Cell> >(component)
+      || shrink_to_fit< common::Map<Uint,Uint> >(component)
+      || shrink_to_fit< common::Map<boost::uint64_t,Uint> >(component);
+    boost_foreach(Component& child, component)
+      shrink_to_fit_recursively(child);
+  }
+
+  /// Memory in readable units
+  std::string memory_str(const Real bytes)
+  {
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(1);
+    if (bytes < 1024.)
+      out << bytes << " B";
+    else if (bytes < 1024.*1024.)
+      out << bytes/1024. << " KB";
+    else if (bytes < 1024.*1024.*1024.)
+      out << bytes/1024./1024. << " MB";
+    else
+      out << bytes/1024./1024./1024. << " GB";
+    return out.str();
+  }
+
+  bool larger_memory(const std::pair<std::string,Real>& a, const std::pair<std::string,Real>& b)
+  {
+    return a.second > b.second;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+common::ComponentBuilder < MemoryInfo, MeshTransformer, mesh::actions::LibActions> MemoryInfo_Builder;
+
+//////////////////////////////////////////////////////////////////////////////
+
+MemoryInfo::MemoryInfo( const std::string& name )
+: MeshTransformer(name),
+  m_compact(false),
+  m_threshold(0.01)
+{
+  properties()["brief"] = std::string("Print the memory used by the mesh");
+  properties()["description"] = std::string("Prints the memory used by the tables, lists and maps of the mesh, per component and per component type.\n"
+                                            "The total over all processes and the maximum per process are stored in the properties total_memory and max_memory.");
+
+  properties().add("total_memory", 0.);
+  properties().add("max_memory", 0.);
+
+  options().add("compact", m_compact)
+      .pretty_name("Compact")
+      .description("Release the unused capacity of the dynamic tables and maps before reporting")
+      .link_to(&m_compact);
+
+  options().add("threshold", m_threshold)
+      .pretty_name("Threshold")
+      .description("Fraction of the total memory below which components are not listed")
+      .link_to(&m_threshold);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void MemoryInfo::execute()
+{
+  Mesh& mesh = *m_mesh;
+
+  Real compacted = 0.;
+  if (m_compact)
+  {
+    const Real before = detail::total_memory_usage(mesh);
+    detail::shrink_to_fit_recursively(mesh);
+    compacted = before - detail::total_memory_usage(mesh);
+  }
+
+  Real local_memory = detail::total_memory_usage(mesh);
+  Real total_memory = local_memory;
+  Real max_memory = local_memory;
+  if (PE::Comm::instance().is_active())
+  {
+    PE::Comm::instance().all_reduce(PE::plus(), &local_memory, 1, &total_memory);
+    PE::Comm::instance().all_reduce(PE::max(), &local_memory, 1, &max_memory);
+  }
+  properties()["total_memory"] = total_memory;
+  properties()["max_memory"] = max_memory;
+
+  std::ostringstream out;
+  out << "Memory used by mesh " << mesh.uri().path() << ": " << detail::memory_str(total_memory)
+      << " (maximum per process: " << detail::memory_str(max_memory) << ")\n";
+  out << "Process memory usage: " << common::OSystem::instance().layer()->memory_usage_str() << "\n";
+  if (m_compact)
+    out << "Released by compacting: " << detail::memory_str(compacted) << "\n";
+
+  out << "\nPer component, on this process:\n";
+  print_tree(mesh, m_threshold*local_memory, 0, out);
+
+  std::map<std::string,Real> memory_per_type;
+  sum_per_type(mesh, memory_per_type);
+  std::vector< std::pair<std::string,Real> > sorted_types(memory_per_type.begin(), memory_per_type.end());
+  std::sort(sorted_types.begin(), sorted_types.end(), detail::larger_memory);
+
+  out << "\nPer component type, on this process:\n";
+  for (Uint i=0; i<sorted_types.size(); ++i)
+  {
+    if (sorted_types[i].second == 0.)
+      break;
+    out << "  " << std::setw(40) << std::left << sorted_types[i].first
+        << std::setw(12) << std::right << detail::memory_str(sorted_types[i].second)
+        << std::setw(8) << std::fixed << std::setprecision(1) << 100.*sorted_types[i].second/local_memory << " %\n";
+  }
+
+  CFinfo << out.str() << CFflush;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void MemoryInfo::print_tree(const Component& component, const Real threshold, const Uint level, std::ostream& out)
+{
+  const Real total = detail::total_memory_usage(component);
+  if (total < threshold || total == 0.)
+    return;
+
+  out << std::string(2*level+2, ' ') << component.name() << " [" << component.derived_type_name() << "]: " << detail::memory_str(total);
+  const Real own = detail::memory_usage(component);
+  if (own != 0. && own != total)
+    out << " (own " << detail::memory_str(own) << ")";
+  out << "\n";
+
+  boost_foreach(const Component& child, component)
+    print_tree(child, threshold, level+1, out);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void MemoryInfo::sum_per_type(const Component& component, std::map<std::string,Real>& memory_per_type)
+{
+  memory_per_type[component.derived_type_name()] += detail::memory_usage(component);
+  boost_foreach(const Component& child, component)
+    sum_per_type(child, memory_per_type);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+} // actions
+} // mesh
+} // cf3
@@ -0,0 +1,64 @@
+// Copyright (C) 2010-2013 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef cf3_mesh_actions_MemoryInfo_hpp
+#define cf3_mesh_actions_MemoryInfo_hpp
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include "mesh/MeshTransformer.hpp"
+#include "mesh/actions/LibActions.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace mesh {
+namespace actions {
+
+//////////////////////////////////////////////////////////////////////////////
+
+/// Reports the memory used by the tables, lists and maps of the mesh, per component and per component type.
+/// The totals over all processes are stored in the properties "total_memory" and "max_memory" (in bytes).
+/// With the option "compact", the unused capacity of the DynTables and Maps is released first.
+class mesh_actions_API MemoryInfo : public MeshTransformer
+{
+public: // functions
+
+  /// constructor
+  MemoryInfo( const std::string& name );
+
+  /// Gets the Class name
+  static std::string type_name() { return "MemoryInfo"; }
+
+  virtual void execute();
+
+private: // functions
+
+  /// Print the memory used by the given component and its children, for the components that use more than the threshold
+  void print_tree(const common::Component& component, const Real threshold, const Uint level, std::ostream& out);
+
+  /// Memory used by each component type, summed over the children of the given component
+  void sum_per_type(const common::Component& component, std::map<std::string,Real>& memory_per_type);
+
+private: // data
+
+  /// Release unused capacity before reporting
+  bool m_compact;
+
+  /// Fraction of the total memory below which components are not listed
+  Real m_threshold;
+
+}; // end MemoryInfo
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // actions
+} // mesh
+} // cf3
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // cf3_mesh_actions_MemoryInfo_hpp
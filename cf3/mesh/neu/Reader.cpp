@@ -4,6 +4,8 @@
 // GNU Lesser General Public License version 3 (LGPLv3).
 // See doc/lgpl.txt and doc/gpl.txt for the license text.
 
+#include <cstdlib>
+#include <cstring>
 #include <set>
 
 #include "common/Log.hpp"
@@ -18,6 +20,7 @@
 #include "common/DynTable.hpp"
 #include "common/List.hpp"
 #include "common/PropertyList.hpp"
+#include "common/PE/Comm.hpp"
 
 #include "mesh/Mesh.hpp"
 #include "mesh/Region.hpp"
@@ -42,6 +45,126 @@ namespace neu {
 
 ////////////////////////////////////////////////////////////////////////////////
 
+namespace detail {
+
+/// Reads a stream in large blocks and returns it line by line, together with the position of each line.
+/// The returned lines are null-terminated in place, and remain valid until the next call.
+class LineReader
+{
+public:
+  LineReader(std::istream& stream, const boost::uint64_t position) :
+    m_stream(stream),
+    m_buffer(block_size+1),
+    m_begin(0),
+    m_end(0),
+    m_position(position)
+  {
+    m_stream.clear();
+    m_stream.seekg(static_cast<std::streamoff>(position), std::ios::beg);
+  }
+
+  /// Leave the stream usable, positioned after the last returned line. Reading whole blocks sets the
+  /// eof and fail bits at the end of the file, which would turn later seekg and tellg calls into no-ops.
+  ~LineReader()
+  {
+    m_stream.clear();
+    m_stream.seekg(static_cast<std::streamoff>(m_position + m_begin), std::ios::beg);
+  }
+
+  /// Get the next line, without its end of line
+  /// @return false at the end of the stream
+  bool next(const char*& line, boost::uint64_t& position)
+  {
+    while (true)
+    {
+      char* begin = &m_buffer[m_begin];
+      char* newline = static_cast<char*>(std::memchr(begin, '\n', m_end - m_begin));
+      if (newline)
+      {
+        *newline = '\0';
+        line = begin;
+        position = m_position + m_begin;
+        m_begin = newline - &m_buffer[0] + 1;
+        return true;
+      }
+
+      // Move the incomplete line to the start of the buffer and read the next block
+      m_position += m_begin;
+      std::copy(m_buffer.begin()+m_begin, m_buffer.begin()+m_end, m_buffer.begin());
+      m_end -= m_begin;
+      m_begin = 0;
+      if (m_end + block_size + 1 > m_buffer.size())
+        m_buffer.resize(m_end + block_size + 1);
+      m_stream.read(&m_buffer[m_end], block_size);
+      const std::size_t nb_read = m_stream.gcount();
+      m_end += nb_read;
+
+      if (nb_read == 0)
+      {
+        // Last line, without end of line
+        if (m_end == 0)
+          return false;
+        m_buffer[m_end] = '\0';
+        line = &m_buffer[0];
+        position = m_position;
+        m_position += m_end;
+        m_end = 0;
+        return true;
+      }
+    }
+  }
+
+private:
+  static const std::size_t block_size = 1 << 20;
+
+  std::istream& m_stream;
+  std::vector<char> m_buffer;
+  /// Start and end of the data in the buffer that was not returned yet
+  std::size_t m_begin;
+  std::size_t m_end;
+  /// Position of the start of the buffer in the stream
+  boost::uint64_t m_position;
+};
+
+inline void skip_blanks(const char*& c)
+{
+  while (*c == ' ' || *c == '\t' || *c == '\r')
+    ++c;
+}
+
+/// Parse an unsigned integer, skipping leading blanks
+/// @return false if there is no number at c
+inline bool parse_uint(const char*& c, Uint& value)
+{
+  skip_blanks(c);
+  if (*c < '0' || *c > '9')
+    return false;
+  Uint result = 0;
+  do
+  {
+    result = 10*result + static_cast<Uint>(*c - '0');
+    ++c;
+  } while (*c >= '0' && *c <= '9');
+  value = result;
+  return true;
+}
+
+/// Parse a real, skipping leading blanks
+/// @return false if there is no number at c
+inline bool parse_real(const char*& c, Real& value)
+{
+  char* end;
+  value = std::strtod(c, &end);
+  if (end == c)
+    return false;
+  c = end;
+  return true;
+}
+
+} // detail
+
+////////////////////////////////////////////////////////////////////////////////
+
 cf3::common::ComponentBuilder < neu::Reader, MeshReader, LibNeu > aneuReader_Builder;
 
 //////////////////////////////////////////////////////////////////////////////
@@ -105,9 +228,6 @@ void Reader::do_read_mesh_into(const URI& file, Mesh& mesh)
   // set the internal mesh pointer
   m_mesh = Handle<Mesh>(mesh.handle<Component>());
 
-  // Read file once and store positions
-  get_file_positions();
-
   // Read mesh information
   read_headerData();
 
@@ -122,13 +242,16 @@ void Reader::do_read_mesh_into(const URI& file, Mesh& mesh)
   num_obj[1] = m_headerData.NELEM;
   m_hash->options().set("nb_obj",num_obj);
 
+  // Read file once on the first rank and store positions
+  get_file_positions();
+
   // Create a region component inside the mesh with the name mesh_name
   //if (option("new_api").value<bool>())
   m_region = m_mesh->topology().handle<Region>();
   //else
   //  m_region = m_mesh->create_region(m_headerData.mesh_name,!option("Serial Handle<Region>(Merge").value<bool>()).handle<Component>());
 
-  find_ghost_nodes();
+  read_element_records();
   read_coordinates();
   read_connectivity();
   if (options().value<bool>("read_boundaries"))
@@ -174,31 +297,121 @@ void Reader::do_read_mesh_into(const URI& file, Mesh& mesh)
 
 void Reader::get_file_positions()
 {
-  std::string nodal_coordinates("NODAL COORDINATES");
-  std::string elements_cells("ELEMENTS/CELLS");
-  std::string element_group("ELEMENT GROUP");
-  std::string boundary_condition("BOUNDARY CONDITIONS");
+  PE::Comm& comm = PE::Comm::instance();
+  const Uint nb_procs = comm.is_active() ? comm.size() : 1u;
 
-  m_element_group_positions.resize(0);
-  m_boundary_condition_positions.resize(0);
+  // Layout: section positions, number of groups and boundary condition sets with their positions,
+  // then the position of the first node and the first element of each rank
+  std::vector<boost::uint64_t> positions;
 
-  int p;
-  std::string line;
-  while (!m_file.eof())
+  if (comm.rank() == 0)
   {
-    p = m_file.tellg();
-    getline(m_file,line);
-    if (line.find(nodal_coordinates)!=std::string::npos)
-      m_nodal_coordinates_position=p;
-    else if (line.find(elements_cells)!=std::string::npos)
-      m_elements_cells_position=p;
-    else if (line.find(element_group)!=std::string::npos)
-      m_element_group_positions.push_back(p);
-    else if (line.find(boundary_condition)!=std::string::npos)
-      m_boundary_condition_positions.push_back(p);
+    const ParallelDistribution& node_hash = m_hash->subhash(NODES);
+    const ParallelDistribution& elem_hash = m_hash->subhash(ELEMS);
+
+    m_nodal_coordinates_position = 0;
+    m_elements_cells_position = 0;
+    m_element_group_positions.resize(0);
+    m_boundary_condition_positions.resize(0);
+
+    std::vector<boost::uint64_t> node_positions(nb_procs, 0);
+    std::vector<boost::uint64_t> element_positions(nb_procs, 0);
+    Uint next_node_proc = 0;
+    Uint next_element_proc = 0;
+    Uint node_idx = 0;
+    Uint element_idx = 0;
+    Uint remaining_element_nodes = 0;
+
+    enum Section { OTHER, NODAL_COORDINATES, ELEMENTS_CELLS };
+    Section section = OTHER;
+
+    detail::LineReader reader(m_file, 0);
+    const char* line;
+    boost::uint64_t p;
+    while (reader.next(line, p))
+    {
+      const char* c = line;
+      detail::skip_blanks(c);
+
+      if (*c == '\0')
+        continue;
+
+      // Section headers and ENDOFSECTION don't start with a number
+      if (*c < '0' || *c > '9')
+      {
+        section = OTHER;
+        if (std::strstr(line, "NODAL COORDINATES"))
+        {
+          m_nodal_coordinates_position = p;
+          section = NODAL_COORDINATES;
+        }
+        else if (std::strstr(line, "ELEMENTS/CELLS"))
+        {
+          m_elements_cells_position = p;
+          section = ELEMENTS_CELLS;
+        }
+        else if (std::strstr(line, "ELEMENT GROUP"))
+          m_element_group_positions.push_back(p);
+        else if (std::strstr(line, "BOUNDARY CONDITIONS"))
+          m_boundary_condition_positions.push_back(p);
+        continue;
+      }
+
+      if (section == NODAL_COORDINATES)
+      {
+        while (next_node_proc != nb_procs && node_hash.start_idx_in_proc(next_node_proc) == node_idx)
+          node_positions[next_node_proc++] = p;
+        ++node_idx;
+      }
+      else if (section == ELEMENTS_CELLS)
+      {
+        // Elements with many nodes continue on the next lines
+        if (remaining_element_nodes == 0)
+        {
+          while (next_element_proc != nb_procs && elem_hash.start_idx_in_proc(next_element_proc) == element_idx)
+            element_positions[next_element_proc++] = p;
+          ++element_idx;
+
+          Uint elementNumber, elementType;
+          if (!detail::parse_uint(c, elementNumber) || !detail::parse_uint(c, elementType) || !detail::parse_uint(c, remaining_element_nodes))
+            throw FileFormatError(FromHere(), "Failed to read neutral file: bad element description for element " + to_str(element_idx));
+        }
+        Uint node;
+        while (remaining_element_nodes != 0 && detail::parse_uint(c, node))
+          --remaining_element_nodes;
+      }
+    }
+
+    positions.push_back(m_nodal_coordinates_position);
+    positions.push_back(m_elements_cells_position);
+    positions.push_back(m_element_group_positions.size());
+    positions.insert(positions.end(), m_element_group_positions.begin(), m_element_group_positions.end());
+    positions.push_back(m_boundary_condition_positions.size());
+    positions.insert(positions.end(), m_boundary_condition_positions.begin(), m_boundary_condition_positions.end());
+    positions.insert(positions.end(), node_positions.begin(), node_positions.end());
+    positions.insert(positions.end(), element_positions.begin(), element_positions.end());
   }
-  m_file.clear();
 
+  if (nb_procs > 1)
+  {
+    std::vector<boost::uint64_t> received;
+    comm.broadcast(positions, received, 0);
+    positions.swap(received);
+  }
+
+  std::vector<boost::uint64_t>::const_iterator it = positions.begin();
+  m_nodal_coordinates_position = *it++;
+  m_elements_cells_position = *it++;
+  const Uint nb_groups = static_cast<Uint>(*it++);
+  m_element_group_positions.assign(it, it+nb_groups);
+  it += nb_groups;
+  const Uint nb_bcs = static_cast<Uint>(*it++);
+  m_boundary_condition_positions.assign(it, it+nb_bcs);
+  it += nb_bcs;
+  m_first_node_position = *(it + comm.rank());
+  m_first_element_position = *(it + nb_procs + comm.rank());
+
+  m_file.clear();
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -237,61 +450,61 @@ void Reader::read_headerData()
 
 //////////////////////////////////////////////////////////////////////////////
 
-void Reader::find_ghost_nodes()
+void Reader::read_element_records()
 {
-  m_ghost_nodes.clear();
+  const ParallelDistribution& node_hash = m_hash->subhash(NODES);
+  const ParallelDistribution& elem_hash = m_hash->subhash(ELEMS);
+  const Uint rank = PE::Comm::instance().rank();
+  const Uint first_element = elem_hash.start_idx_in_proc(rank);
+  const Uint nb_elements = elem_hash.nb_objects_in_proc(rank);
 
-  // Only find ghost nodes if the domain is split up
-  if (options().value<Uint>("nb_parts") > 1)
+  m_ghost_nodes.clear();
+  m_element_types.clear();
+  m_element_types.reserve(nb_elements);
+  m_element_nodes.clear();
+  m_element_nodes_start.assign(1, 0);
+  m_element_nodes_start.reserve(nb_elements+1);
+
+  if (nb_elements == 0)
+    return;
+
+  detail::LineReader reader(m_file, m_first_element_position);
+  const char* line;
+  boost::uint64_t p;
+  for (Uint i=0; i<nb_elements; ++i)
   {
-    m_file.seekg(m_elements_cells_position,std::ios::beg);
-    // skip next line
-    std::string line;
-    getline(m_file,line);
+    // element description
+    Uint elementNumber, elementType, nbElementNodes;
+    if (!reader.next(line, p))
+      throw FileFormatError(FromHere(), "Failed to read neutral file: unexpected end of file in the elements");
+    const char* c = line;
+    if (!detail::parse_uint(c, elementNumber) || !detail::parse_uint(c, elementType) || !detail::parse_uint(c, nbElementNodes)
+        || elementNumber != first_element+i+1)
+      throw FileFormatError(FromHere(), "Failed to read neutral file: bad element description for element " + to_str(first_element+i+1));
 
+    if(!m_supported_neu_types.count(elementType))
+      throw common::NotSupported(FromHere(), "Failed to read neutral file: unsupported element type " + common::to_str(elementType));
 
-    // read every line and store the connectivity in the correct region through the buffer
-    Uint elementNumber, elementType, nbElementNodes, dummy_node;
-    for (Uint i=0; i<m_headerData.NELEM; ++i)
-    {
-      if (m_headerData.NELEM > 100000)
-      {
-        if(i%(m_headerData.NELEM/20)==0)
-          CFinfo << 100*i/m_headerData.NELEM << "% " << CFendl;
-      }
+    m_element_types.push_back(elementType);
 
-      if (m_hash->subhash(ELEMS).owns(i))
-      {
-        // element description
-        m_file >> elementNumber >> elementType >> nbElementNodes;
-        cf3_assert_desc(to_str(elementNumber)+" == "+to_str(i+1),elementNumber == i+1);
-        // check if element nodes are ghost
-        std::vector<Uint> neu_element_nodes(nbElementNodes);
-        for (Uint j=0; j<nbElementNodes; ++j)
-        {
-          m_file >> neu_element_nodes[j];
-          if (!m_hash->subhash(NODES).owns(neu_element_nodes[j]-1))
-          {
-            m_ghost_nodes.insert(neu_element_nodes[j]);
-          }
-        }
-      }
-      else
+    // element nodes, which may continue on the next lines
+    Uint nb_read = 0;
+    Uint neu_node_number;
+    while (nb_read != nbElementNodes)
+    {
+      if (!detail::parse_uint(c, neu_node_number))
       {
-        // element description
-        m_file >> elementNumber >> elementType >> nbElementNodes;
-        cf3_assert_desc(to_str(elementNumber)+" == "+to_str(i+1),elementNumber == i+1);
-        // check if element nodes are ghost
-        std::vector<Uint> neu_element_nodes(nbElementNodes);
-        for (Uint j=0; j<nbElementNodes; ++j)
-        {
-          m_file >> dummy_node;
-        }
+        if (!reader.next(line, p))
+          throw FileFormatError(FromHere(), "Failed to read neutral file: unexpected end of file in the elements");
+        c = line;
+        continue;
       }
-      // finish the line
-      getline(m_file,line);
+      m_element_nodes.push_back(neu_node_number);
+      if (!node_hash.owns(neu_node_number-1))
+        m_ghost_nodes.insert(neu_node_number);
+      ++nb_read;
     }
-    getline(m_file,line);  // ENDOFSECTION
+    m_element_nodes_start.push_back(m_element_nodes.size());
   }
 }
 
@@ -299,62 +512,103 @@ void Reader::find_ghost_nodes()
 
 void Reader::read_coordinates()
 {
-  m_file.seekg(m_nodal_coordinates_position,std::ios::beg);
-
-  // Create the nodes
+  PE::Comm& comm = PE::Comm::instance();
+  const Uint rank = comm.rank();
+  const Uint nb_procs = comm.is_active() ? comm.size() : 1u;
+  const ParallelDistribution& node_hash = m_hash->subhash(NODES);
+  const Uint first_node = node_hash.start_idx_in_proc(rank);
+  const Uint nb_owned_nodes = node_hash.nb_objects_in_proc(rank);
+  const Uint dim = m_headerData.NDFCD;
+
+  // Parse the nodes owned by this rank
+  std::vector<Real> owned_coordinates(nb_owned_nodes*dim);
+  if (nb_owned_nodes != 0)
+  {
+    detail::LineReader reader(m_file, m_first_node_position);
+    const char* line;
+    boost::uint64_t p;
+    for (Uint i=0; i<nb_owned_nodes; ++i)
+    {
+      Uint nodeNumber;
+      bool ok = reader.next(line, p);
+      const char* c = line;
+      ok = ok && detail::parse_uint(c, nodeNumber) && nodeNumber == first_node+i+1;
+      for (Uint d=0; d<dim; ++d)
+        ok = ok && detail::parse_real(c, owned_coordinates[i*dim+d]);
+      if (!ok)
+        throw FileFormatError(FromHere(), "Failed to read neutral file: bad coordinates for node " + to_str(first_node+i+1));
+    }
+  }
 
-  Dictionary& nodes = m_mesh->geometry_fields();
+  // Get the coordinates of the ghost nodes from the ranks that own them.
+  // The ghost nodes are sorted, so the requests to each rank and their answers are too.
+  std::vector<Real> ghost_coordinates(m_ghost_nodes.size()*dim);
+  if (nb_procs > 1)
+  {
+    std::vector< std::vector<Uint> > requested_nodes(nb_procs);
+    boost_foreach(const Uint neu_node_idx, m_ghost_nodes)
+      requested_nodes[node_hash.proc_of_obj(neu_node_idx-1)].push_back(neu_node_idx);
 
-  nodes.resize(m_hash->subhash(NODES).nb_objects_in_part(PE::Comm::instance().rank()) + m_ghost_nodes.size());
-  std::string line;
-  // skip one line
-  getline(m_file,line);
+    std::vector< std::vector<Uint> > nodes_to_send;
+    comm.all_to_all(requested_nodes, nodes_to_send);
 
-  // declare and allocate one coordinate row
-  std::vector<Real> rowVector(m_headerData.NDFCD);
+    std::vector< std::vector<Real> > sent_coordinates(nb_procs);
+    for (Uint proc=0; proc<nb_procs; ++proc)
+    {
+      sent_coordinates[proc].reserve(nodes_to_send[proc].size()*dim);
+      boost_foreach(const Uint neu_node_idx, nodes_to_send[proc])
+      {
+        cf3_assert(node_hash.owns(neu_node_idx-1));
+        const Uint owned_idx = neu_node_idx-1-first_node;
+        sent_coordinates[proc].insert(sent_coordinates[proc].end(), owned_coordinates.begin()+owned_idx*dim, owned_coordinates.begin()+(owned_idx+1)*dim);
+      }
+    }
 
-  std::set<Uint>::const_iterator not_found = m_ghost_nodes.end();
+    std::vector< std::vector<Real> > received_coordinates;
+    comm.all_to_all(sent_coordinates, received_coordinates);
 
-  Uint coord_idx=0;
-  for (Uint neu_node_idx=1; neu_node_idx<=m_headerData.NUMNP; ++neu_node_idx)
-  {
-    if (m_headerData.NUMNP > 100000)
+    std::vector<Uint> next_received(nb_procs, 0);
+    Uint ghost_idx = 0;
+    boost_foreach(const Uint neu_node_idx, m_ghost_nodes)
     {
-      if(neu_node_idx%(m_headerData.NUMNP/20)==0)
-        CFinfo << 100*neu_node_idx/m_headerData.NUMNP << "% " << CFendl;
+      const Uint proc = node_hash.proc_of_obj(neu_node_idx-1);
+      std::copy(received_coordinates[proc].begin()+next_received[proc]*dim, received_coordinates[proc].begin()+(next_received[proc]+1)*dim, ghost_coordinates.begin()+ghost_idx*dim);
+      ++next_received[proc];
+      ++ghost_idx;
     }
-    getline(m_file,line);
-    if (m_hash->subhash(NODES).owns(neu_node_idx-1))
+  }
+
+  // Create the nodes, owned and ghost nodes in the order of their neu index
+
+  Dictionary& nodes = m_mesh->geometry_fields();
+
+  nodes.resize(nb_owned_nodes + m_ghost_nodes.size());
+
+  std::set<Uint>::const_iterator ghost_it = m_ghost_nodes.begin();
+  Uint ghost_idx = 0;
+  Uint owned_idx = 0;
+  for (Uint coord_idx=0; coord_idx<nodes.size(); ++coord_idx)
+  {
+    const Real* row;
+    Uint neu_node_idx;
+    if (ghost_it == m_ghost_nodes.end() || (owned_idx < nb_owned_nodes && first_node+owned_idx+1 < *ghost_it))
     {
-      nodes.rank()[coord_idx] = m_hash->subhash(NODES).part_of_obj(neu_node_idx-1);
-      nodes.glb_idx()[coord_idx] = neu_node_idx;
-      m_neu_node_to_coord_idx[neu_node_idx]=coord_idx;
-      std::stringstream ss(line);
-      Uint nodeNumber;
-      ss >> nodeNumber;
-      cf3_assert(nodeNumber == neu_node_idx);
-      for (Uint dim=0; dim<m_headerData.NDFCD; ++dim)
-        ss >> nodes.coordinates()[coord_idx][dim];
-      coord_idx++;
+      neu_node_idx = first_node+owned_idx+1;
+      row = &owned_coordinates[owned_idx*dim];
+      ++owned_idx;
     }
     else
     {
-      if (m_ghost_nodes.find(neu_node_idx) != not_found)
-      {
-        // add global node index
-        nodes.rank()[coord_idx] = m_hash->subhash(NODES).part_of_obj(neu_node_idx-1);
-        nodes.glb_idx()[coord_idx] = neu_node_idx;
-        m_neu_node_to_coord_idx[neu_node_idx]=coord_idx;
-        std::stringstream ss(line);
-        Uint nodeNumber;
-        ss >> nodeNumber;
-        for (Uint dim=0; dim<m_headerData.NDFCD; ++dim)
-          ss >> nodes.coordinates()[coord_idx][dim];
-        coord_idx++;
-      }
+      neu_node_idx = *ghost_it++;
+      row = &ghost_coordinates[ghost_idx*dim];
+      ++ghost_idx;
     }
+    nodes.rank()[coord_idx] = node_hash.part_of_obj(neu_node_idx-1);
+    nodes.glb_idx()[coord_idx] = neu_node_idx;
+    m_neu_node_to_coord_idx[neu_node_idx]=coord_idx;
+    for (Uint d=0; d<dim; ++d)
+      nodes.coordinates()[coord_idx][d] = row[d];
   }
-  getline(m_file,line);
 }
 
 
@@ -366,70 +620,42 @@ void Reader::read_connectivity()
   m_tmp = Handle<Region>(m_region->create_region("main").handle<Component>());
 
   m_global_to_tmp.clear();
-  m_file.seekg(m_elements_cells_position,std::ios::beg);
 
   std::map<std::string,Handle< Elements > > elements = create_cells_in_region(*m_tmp,nodes,m_supported_types);
   std::map<std::string,boost::shared_ptr< Connectivity::Buffer > > buffer = create_connectivity_buffermap(elements);
 
-  // skip next line
-  std::string line;
-  getline(m_file,line);
-
-  // read every line and store the connectivity in the correct region through the buffer
+  // store the connectivity of the elements read by read_element_records in the correct region through the buffer
+  const Uint first_element = m_hash->subhash(ELEMS).start_idx_in_proc(PE::Comm::instance().rank());
   std::string etype_CF;
   std::vector<Uint> cf_element;
-  Uint neu_node_number;
   Uint cf_node_number;
   Uint cf_idx;
   Uint table_idx;
 
-  for (Uint i=0; i<m_headerData.NELEM; ++i)
+  for (Uint i=0; i<m_element_types.size(); ++i)
   {
-    if (m_headerData.NELEM > 100000)
-    {
-      if(i%(m_headerData.NELEM/20)==0)
-        CFinfo << 100*i/m_headerData.NELEM << "% " << CFendl;
-    }
-
-    // element description
-    Uint elementNumber, elementType, nbElementNodes;
-    m_file >> elementNumber >> elementType >> nbElementNodes;
-    
-    if(!m_supported_neu_types.count(elementType))
-      throw common::NotSupported(FromHere(), "Failed to read neutral file: unsupported element type " + common::to_str(elementType));
+    const Uint elementType = m_element_types[i];
+    const Uint nbElementNodes = m_element_nodes_start[i+1] - m_element_nodes_start[i];
+    const Uint* neu_nodes = &m_element_nodes[m_element_nodes_start[i]];
 
-    // get element nodes
-    if (m_hash->subhash(ELEMS).owns(i))
+    cf_element.resize(nbElementNodes);
+    for (Uint j=0; j<nbElementNodes; ++j)
     {
-      cf_element.resize(nbElementNodes);
-      for (Uint j=0; j<nbElementNodes; ++j)
-      {
-        cf_idx = m_nodes_neu_to_cf[elementType][j];
-        m_file >> neu_node_number;
-        cf3_assert(m_neu_node_to_coord_idx.count(neu_node_number));
-        cf_node_number = m_neu_node_to_coord_idx[neu_node_number];
-        cf3_assert(cf_node_number < nodes.size());
-        cf_element[cf_idx] = cf_node_number;
-      }
-      etype_CF = element_type(elementType,nbElementNodes);
-      table_idx = buffer[etype_CF]->add_row(cf_element);
-      m_global_to_tmp[elementNumber] = std::make_pair(elements[etype_CF],table_idx);
+      cf_idx = m_nodes_neu_to_cf[elementType][j];
+      cf3_assert(m_neu_node_to_coord_idx.count(neu_nodes[j]));
+      cf_node_number = m_neu_node_to_coord_idx[neu_nodes[j]];
+      cf3_assert(cf_node_number < nodes.size());
+      cf_element[cf_idx] = cf_node_number;
     }
-    else
-    {
-      for (Uint j=0; j<nbElementNodes; ++j)
-      {
-        m_file >> neu_node_number;
-      }
-    }
-
-    // finish the line
-    getline(m_file,line);
+    etype_CF = element_type(elementType,nbElementNodes);
+    table_idx = buffer[etype_CF]->add_row(cf_element);
+    m_global_to_tmp[first_element+i+1] = std::make_pair(elements[etype_CF],table_idx);
   }
-  getline(m_file,line);  // ENDOFSECTION
 
   m_neu_node_to_coord_idx.clear();
-
+  m_element_types.clear();
+  m_element_nodes.clear();
+  m_element_nodes_start.clear();
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -447,6 +673,7 @@ void Reader::read_groups()
 
   for (Uint g=0; g<m_headerData.NGRPS; ++g)
   {
+    m_file.clear();
     m_file.seekg(m_element_group_positions[g],std::ios::beg);
 
     std::string ELMMAT;
@@ -478,27 +705,25 @@ void Reader::read_groups()
     //    and the elements from the tmp region have to be distributed among
     //    these new regions.
 
-    // Read first to see howmany elements to allocate
-    int p = m_file.tellg();
-    Uint nb_elems_in_group = 0;
-    for (Uint i=0; i<NELGP; ++i)
-    {
-      m_file >> I;
-      if (m_hash->subhash(ELEMS).owns(I-1))
-        nb_elems_in_group++;
-    }
-    // now allocate and read again
-    groups[g].ELEM.reserve(nb_elems_in_group);
-    m_file.seekg(p,std::ios::beg);
-    for (Uint i=0; i<NELGP; ++i)
+    // Read the element indices, starting after the flags
+    detail::LineReader reader(m_file, static_cast<boost::uint64_t>(std::streamoff(m_file.tellg())));
+    const char* c = "";
+    const char* element_line;
+    boost::uint64_t p;
+    Uint nb_read = 0;
+    while (nb_read != NELGP)
     {
-      m_file >> I;
+      if (!detail::parse_uint(c, I))
+      {
+        if (!reader.next(element_line, p))
+          throw FileFormatError(FromHere(), "Failed to read neutral file: unexpected end of file in element group " + ELMMAT);
+        c = element_line;
+        continue;
+      }
       if (m_hash->subhash(ELEMS).owns(I-1))
         groups[g].ELEM.push_back(I);     // set element index
+      ++nb_read;
     }
-
-    getline(m_file,line);  // finish the line (read new line)
-    getline(m_file,line);  // ENDOFSECTION
   }
 
   // Create Region for each group
@@ -539,6 +764,7 @@ void Reader::read_boundaries()
   std::string line;
   for (Uint t=0; t<m_headerData.NBSETS; ++t) {
 
+    m_file.clear();
     m_file.seekg(m_boundary_condition_positions[t],std::ios::beg);
 
     std::string NAME;
@@ -9,6 +9,8 @@
 
 ////////////////////////////////////////////////////////////////////////////////
 
+#include <boost/cstdint.hpp>
+
 #include "mesh/MeshReader.hpp"
 #include "common/Table.hpp"
 #include "mesh/Dictionary.hpp"
@@ -28,6 +30,9 @@ namespace neu {
 //////////////////////////////////////////////////////////////////////////////
 
 /// This class defines neutral mesh format reader
+/// The file is read cooperatively: the first rank scans it once to find the sections and the position of the first node
+/// and element of each rank, after which each rank only parses its own block of nodes and elements. The coordinates
+/// of the ghost nodes are obtained from the ranks that own them.
 /// @author Willem Deconinck
 class neu_API Reader : public MeshReader, public Shared
 {
@@ -52,7 +57,7 @@ private: // functions
 
   void read_headerData();
 
-  void find_ghost_nodes();
+  void read_element_records();
 
   void read_coordinates();
 
@@ -84,10 +89,21 @@ private: // data
   std::set<Uint> m_ghost_nodes;
   std::map<Uint,Uint> m_neu_node_to_coord_idx;
 
-  Uint m_nodal_coordinates_position;
-  Uint m_elements_cells_position;
-  std::vector<Uint> m_element_group_positions;
-  std::vector<Uint> m_boundary_condition_positions;
+  boost::uint64_t m_nodal_coordinates_position;
+  boost::uint64_t m_elements_cells_position;
+  std::vector<boost::uint64_t> m_element_group_positions;
+  std::vector<boost::uint64_t> m_boundary_condition_positions;
+
+  /// Position of the line of the first node owned by this rank
+  boost::uint64_t m_first_node_position;
+  /// Position of the line of the first element owned by this rank
+  boost::uint64_t m_first_element_position;
+
+  /// neu type of each element owned by this rank
+  std::vector<Uint> m_element_types;
+  /// neu nodes of the elements owned by this rank, starting at m_element_nodes_start[i] for element i
+  std::vector<Uint> m_element_nodes;
+  std::vector<Uint> m_element_nodes_start;
 
   struct HeaderData
   {
@@ -4,6 +4,8 @@
 // GNU Lesser General Public License version 3 (LGPLv3).
 // See doc/lgpl.txt and doc/gpl.txt for the license text.
 
+#include <algorithm>
+
 // coolfluid
 #include "common/Builder.hpp"
 #include "common/OptionList.hpp"
@@ -85,13 +87,24 @@ void Partitioner::build_graph()
 
   list_of_connected_objects_in_part(Comm::instance().rank(),edgeloctab);
 
+  // PT-Scotch takes integer vertex loads, so the weights are scaled to keep two significant digits
+  veloloctab.clear();
+  if (has_object_weights())
+  {
+    std::vector<Real> weights(vertlocnbr);
+    list_of_object_weights_in_part(Comm::instance().rank(),weights);
+    veloloctab.resize(vertlocnbr);
+    for (int i=0; i<vertlocnbr; ++i)
+      veloloctab[i] = std::max(static_cast<SCOTCH_Num>(1), static_cast<SCOTCH_Num>(100.*weights[i] + 0.5));
+  }
+
   if (SCOTCH_dgraphBuild(&graph,
                          baseval,
                          vertlocnbr,      // number of local vertices (for creation of proccnttab)
                          vertlocmax,          // max number of local vertices to be created (for creation of procvrttab)
                          &vertloctab[0],  // local adjacency index array (size = vertlocnbr+1 if vendloctab matches or is null)
                          &vertloctab[1],  //   (optional) local adjacency end index array
-                         NULL, //veloloctab,  //   (optional) local vertex load array
+                         veloloctab.empty() ? NULL : &veloloctab[0],  //   (optional) local vertex load array
                          NULL,  //vlblocltab,  //   (optional) local vertex label array (size = vertlocnbr+1)
                          edgelocnbr,      // total number of arcs (twice number of edges)
                          edgelocsiz,      // minimum size of the edge array required to encompass all used adjacency values (at least equal to the max of vendloctab entries)
@@ -9,8 +9,10 @@
 
 ////////////////////////////////////////////////////////////////////////////////
 
+#include <boost/noncopyable.hpp>
 #include <boost/scoped_ptr.hpp>
 
+#include "common/BasicExceptions.hpp"
 #include "common/Component.hpp"
 
 #include "math/VariablesDescriptor.hpp"
@@ -230,6 +232,141 @@ public:
 
   virtual math::VariablesDescriptor& description() { return *m_description; }
 
+  /// Statically typed access to PHYS, for use in loops over many states.
+  /// All arguments are the fixed-size types of the model, and the properties are computed into a single
+  /// work object owned by the kernel, so evaluating a state involves no virtual calls and no allocation.
+  /// A kernel is obtained once from the physical model, and is not thread-safe: each thread needs its own.
+  class Kernel : public boost::noncopyable
+  {
+  public:
+    typedef typename PHYS::MODEL MODEL;
+    typedef typename MODEL::Properties PropertiesT;
+
+    enum { NDIM = MODEL::_ndim };
+    enum { NEQS = MODEL::_neqs };
+
+    typedef typename MODEL::GeoV GeoV;                ///< coordinates or direction
+    typedef typename MODEL::SolV SolV;                ///< state, flux in a direction, eigen values or residual
+    typedef typename MODEL::SolM SolM;                ///< gradient of the state, or flux in all directions
+    typedef Eigen::Matrix<Real, NEQS, NEQS> JacM;     ///< flux jacobian
+
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+    /// @param model Physical model providing the constants of the properties
+    /// @throws common::BadValue if the model is not of type PHYS::MODEL
+    explicit Kernel(PhysModel& model) :
+      m_properties_ptr(model.create_properties()),
+      m_properties(static_cast<PropertiesT&>(*m_properties_ptr))
+    {
+      if(model.type() != MODEL::type_name())
+        throw common::BadValue(FromHere(), "Variables " + PHYS::type_name() + " require a physical model of type " + MODEL::type_name() + ", got " + model.type());
+
+      m_zero_gradient.setZero();
+      for(Uint d = 0; d != NDIM; ++d)
+        m_jacobians[d].setZero();
+    }
+
+    /// Properties of the last evaluated state
+    const PropertiesT& properties() const { return m_properties; }
+    PropertiesT& properties() { return m_properties; }
+
+    /// @name Single state
+    /// The other functions act on the properties computed by the last call to compute_properties
+    //@{
+
+    void compute_properties(const GeoV& coord, const SolV& sol, const SolM& grad_sol)
+    {
+      PHYS::compute_properties(coord, sol, grad_sol, m_properties);
+    }
+
+    void flux(SolM& flux) const
+    {
+      PHYS::flux(m_properties, flux);
+    }
+
+    void flux(const GeoV& direction, SolV& flux) const
+    {
+      PHYS::flux(m_properties, direction, flux);
+    }
+
+    void flux_jacobian_eigen_values(const GeoV& direction, SolV& evalues) const
+    {
+      PHYS::flux_jacobian_eigen_values(m_properties, direction, evalues);
+    }
+
+    template<typename OpT>
+    void flux_jacobian_eigen_values(const GeoV& direction, SolV& evalues, OpT& op) const
+    {
+      PHYS::flux_jacobian_eigen_values(m_properties, direction, evalues, op);
+    }
+
+    void flux_jacobian_eigen_structure(const GeoV& direction, JacM& Rv, JacM& Lv, SolV& evalues) const
+    {
+      PHYS::flux_jacobian_eigen_structure(m_properties, direction, Rv, Lv, evalues);
+    }
+
+    void residual(SolV& res)
+    {
+      PHYS::residual(m_properties, m_jacobians, res);
+    }
+
+    //@}
+
+    /// @name Arrays of states
+    /// Each function computes the properties of state i from coords[i], states[i] and gradients[i], and writes result i.
+    /// gradients may be null, in which case a zero gradient is used.
+    //@{
+
+    void flux(const Uint nb_states, const GeoV* coords, const SolV* states, const SolM* gradients, SolM* fluxes)
+    {
+      for(Uint i = 0; i != nb_states; ++i)
+      {
+        compute_properties(i, coords, states, gradients);
+        PHYS::flux(m_properties, fluxes[i]);
+      }
+    }
+
+    void flux(const Uint nb_states, const GeoV* coords, const SolV* states, const SolM* gradients, const GeoV* directions, SolV* fluxes)
+    {
+      for(Uint i = 0; i != nb_states; ++i)
+      {
+        compute_properties(i, coords, states, gradients);
+        PHYS::flux(m_properties, directions[i], fluxes[i]);
+      }
+    }
+
+    void flux_jacobian_eigen_values(const Uint nb_states, const GeoV* coords, const SolV* states, const SolM* gradients, const GeoV* directions, SolV* evalues)
+    {
+      for(Uint i = 0; i != nb_states; ++i)
+      {
+        compute_properties(i, coords, states, gradients);
+        PHYS::flux_jacobian_eigen_values(m_properties, directions[i], evalues[i]);
+      }
+    }
+
+    void residual(const Uint nb_states, const GeoV* coords, const SolV* states, const SolM* gradients, SolV* residuals)
+    {
+      for(Uint i = 0; i != nb_states; ++i)
+      {
+        compute_properties(i, coords, states, gradients);
+        PHYS::residual(m_properties, m_jacobians, residuals[i]);
+      }
+    }
+
+    //@}
+
+  private:
+    void compute_properties(const Uint i, const GeoV* coords, const SolV* states, const SolM* gradients)
+    {
+      PHYS::compute_properties(coords[i], states[i], gradients == 0 ? m_zero_gradient : gradients[i], m_properties);
+    }
+
+    boost::scoped_ptr<physics::Properties> m_properties_ptr;
+    PropertiesT& m_properties;
+    SolM m_zero_gradient;
+    JacM m_jacobians[NDIM];
+  };
+
 private:
   boost::shared_ptr<math::VariablesDescriptor> m_description;
 
@@ -12,6 +12,7 @@
 #include "common/BasicExceptions.hpp"
 #include "common/Component.hpp"
 #include "common/ComponentIterator.hpp"
+#include "common/ConfigurationBatch.hpp"
 #include "common/Log.hpp"
 #include "common/Foreach.hpp"
 #include "common/Option.hpp"
@@ -385,6 +386,26 @@ void configure_option_recursively(ComponentWrapper& self, const std::string& opt
     self.component().configure_option_recursively(option_name, python_to_any(value));
 }
 
+/// Apply a list of (path, option name, value) tuples, with paths relative to self
+void configure_batch(ComponentWrapper& self, const boost::python::list& values)
+{
+  common::ConfigurationBatch batch;
+  const Uint nb_values = boost::python::len(values);
+  for(Uint i = 0; i != nb_values; ++i)
+  {
+    boost::python::tuple entry = boost::python::extract<boost::python::tuple>(values[i]);
+    if(boost::python::len(entry) != 3)
+      throw common::BadValue(FromHere(), "configure_batch expects a list of (path, option, value) tuples");
+
+    boost::python::extract<common::URI> uri_extractor(entry[0]);
+    const common::URI path = uri_extractor.check() ? uri_extractor() : common::URI(boost::python::extract<std::string>(entry[0])());
+    const std::string option_name = boost::python::extract<std::string>(entry[1]);
+    batch.add(path, option_name, python_to_any(entry[2]));
+  }
+
+  batch.apply(self.component());
+}
+
 Uint get_len(ComponentWrapper& self)
 {
   if(is_null(self.get_list_interface()))
@@ -711,6 +732,7 @@ void def_component()
     .def("uri", uri)
     .def("derived_type_name", derived_type_name, "Derived type name, i.e. the type of the concrete component")
     .def("configure_option_recursively", configure_option_recursively, "Configure the given option recursively")
+    .def("configure_batch", configure_batch, "Set the options in a list of (path, option, value) tuples, resolving each path once")
     .def("mark_basic", component_mark_basic, "Mark the component as basic")
     .def("__len__", get_len)
     .def("__getitem__", get_item)
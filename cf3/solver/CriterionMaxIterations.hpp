@@ -7,6 +7,8 @@
 #ifndef cf3_solver_CriterionMaxIterations_hpp
 #define cf3_solver_CriterionMaxIterations_hpp
 
+#include "common/CachedOption.hpp"
+
 #include "solver/Criterion.hpp"
 
 namespace cf3 {
@@ -39,6 +41,9 @@ private:
   /// component where to access the current iteration
   Handle<Component> m_iter_comp;
 
+  /// value of the option "maxiter"
+  common::CachedOption<Uint> m_max_iter;
+
 };
 
 ////////////////////////////////////////////////////////////////////////////////////////////
@@ -86,6 +86,9 @@ void Iterate::execute ()
 
     ActionDirector::execute();
 
+    // write the SYNC_SCREEN messages of this iteration
+    Logger::instance().synchronize();
+
     // update the iteration
     ++m_iter;
   }
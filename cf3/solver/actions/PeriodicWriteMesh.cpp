@@ -5,12 +5,14 @@
 // See doc/lgpl.txt and doc/gpl.txt for the license text.
 
 #include "common/Builder.hpp"
+#include "common/OptionArray.hpp"
 #include "common/OptionT.hpp"
 #include "common/OptionList.hpp"
 #include "common/PropertyList.hpp"
 #include "common/Foreach.hpp"
 #include "common/FindComponents.hpp"
 
+#include "mesh/MeshWriter.hpp"
 #include "mesh/WriteMesh.hpp"
 #include "mesh/Mesh.hpp"
 #include "mesh/Field.hpp"
@@ -48,6 +50,19 @@ PeriodicWriteMesh::PeriodicWriteMesh ( const std::string& name ) : solver::Actio
   options().add( "filepath", URI() )
       .pretty_name("File Path")
       .description("Path where to save the mesh");
+
+  options().add( "fields", std::vector<URI>() )
+      .pretty_name("Fields")
+      .description("Fields to save. All fields of the mesh are saved when empty.");
+
+  options().add( "incremental", false )
+      .pretty_name("Incremental")
+      .description("Save all iterations as a single XDMF time series (the file path must end in .xmf), "
+                   "writing the geometry only when it changes and appending the fields at each save");
+
+  m_saverate.attach(options(), "saverate");
+  m_filepath.attach(options(), "filepath");
+  m_incremental.attach(options(), "incremental");
 }
 
 
@@ -58,24 +73,38 @@ void PeriodicWriteMesh::execute()
 
   const Uint iteration = boost::any_cast<Uint> ( m_iterator->properties().property("iteration") );
 
-  const Uint saverate = options().value<Uint>("saverate");
+  const Uint saverate = m_saverate.value();
 
   if (saverate == 0) return;
 
   if ( iteration % saverate == 0 ) // write mesh
   {
-    URI filepath = options().value<URI>("filepath");
+    const URI& filepath = m_filepath.value();
 
-    /// @note writes all fields to the mesh
+    /// @note writes all fields to the mesh, unless the fields option was set
 
-    std::vector<URI> state_fields;
-    boost_foreach(const Field& field, find_components_recursively<Field>( mesh() ) )
+    std::vector<URI> state_fields = options().value< std::vector<URI> >("fields");
+    if(state_fields.empty())
     {
-      state_fields.push_back(field.uri());
+      boost_foreach(const Field& field, find_components_recursively<Field>( mesh() ) )
+      {
+        state_fields.push_back(field.uri());
+      }
     }
 
-    m_writer.write_mesh( mesh(), filepath, state_fields );
+    if(m_incremental.value())
+    {
+      if(is_null(m_incremental_writer))
+        m_incremental_writer = create_component<MeshWriter>("IncrementalWriter", "cf3.mesh.XDMF.Writer");
 
+      m_incremental_writer->options().set("fields", state_fields);
+      m_incremental_writer->options().set("time", static_cast<Real>(iteration));
+      m_incremental_writer->write_from_to( mesh(), filepath );
+    }
+    else
+    {
+      m_writer.write_mesh( mesh(), filepath, state_fields );
+    }
 
   }
 
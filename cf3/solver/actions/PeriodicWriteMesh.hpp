@@ -7,13 +7,16 @@
 #ifndef cf3_solver_actions_PeriodicWriteMesh_hpp
 #define cf3_solver_actions_PeriodicWriteMesh_hpp
 
+#include "common/CachedOption.hpp"
+#include "common/URI.hpp"
+
 #include "solver/actions/LibActions.hpp"
 #include "solver/Action.hpp"
 
 /////////////////////////////////////////////////////////////////////////////////////
 
 namespace cf3 {
-namespace mesh   { class Field; class Mesh; class WriteMesh; }
+namespace mesh   { class Field; class Mesh; class MeshWriter; class WriteMesh; }
 namespace solver {
 namespace actions {
 
@@ -39,6 +42,13 @@ private: // data
 
   mesh::WriteMesh& m_writer; ///< mesh writer
 
+  /// Writer that keeps the geometry between saves, built on the first incremental save
+  Handle<mesh::MeshWriter> m_incremental_writer;
+
+  common::CachedOption<Uint> m_saverate;        ///< value of the option "saverate"
+  common::CachedOption<common::URI> m_filepath; ///< value of the option "filepath"
+  common::CachedOption<bool> m_incremental;     ///< value of the option "incremental"
+
 };
 
 ////////////////////////////////////////////////////////////////////////////////
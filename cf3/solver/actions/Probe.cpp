@@ -55,7 +55,8 @@ Probe::Probe( const std::string& name  ) : common::Action(name)
     .pretty_name("Coordinate")
     .description("Coordinate to interpolate fields to")
     .mark_basic();
-    
+  m_coordinate.attach(options(), "coordinate");
+
   options().add("dict",m_dict)
       .description("Dictionary that will be probed")
       .link_to(&m_dict)
@@ -87,7 +88,7 @@ void Probe::execute()
     throw SetupError(FromHere(), "Option \"dict\" was not configured in "+uri().string());
 
   // Take the coordinate from the options
-  std::vector<Real> opt_coord = options().value< std::vector<Real> >("coordinate");
+  const std::vector<Real>& opt_coord = m_coordinate.value();
   RealVector coord(opt_coord.size());
   math::copy(opt_coord,coord);
 
@@ -183,7 +184,7 @@ void Probe::set(const std::string& var_name, const Real& var_value)
   {
     if (m_variables->nb_vars() == 0)
     {
-      m_variables->options().set("dimension",(Uint)options().value<std::vector<Real> >("coordinate").size());
+      m_variables->options().set("dimension",(Uint)m_coordinate.value().size());
     }
 
     m_variables->push_back(var_name,math::VariablesDescriptor::Dimensionalities::SCALAR);
@@ -11,6 +11,7 @@
 
 
 #include "common/Action.hpp"
+#include "common/CachedOption.hpp"
 #include "solver/actions/LibActions.hpp"
 
 namespace cf3 {
@@ -79,6 +80,7 @@ private: // data
   Handle<mesh::Dictionary>            m_dict;                ///< Dictionary to interpolate
   Handle<mesh::PointInterpolator>     m_point_interpolator;  ///< Interpolator for one point
   Handle< math::VariablesDescriptor > m_variables;           ///< Variable description
+  common::CachedOption< std::vector<Real> > m_coordinate;   ///< value of the option "coordinate"
 
 };
 
@@ -31,21 +31,22 @@ struct DirichletBCTag
 typedef LSSWrapper<DirichletBCTag> DirichletBC;
 
 /// Helper function for assignment
-inline void assign_dirichlet(math::LSS::System& lss, const Real new_value, const Real old_value, const int node_idx, const Uint offset)
+template<typename DataT>
+inline void assign_dirichlet(math::LSS::System& lss, const Real new_value, const Real old_value, const int node_idx, const Uint offset, DataT& data)
 {
   if(node_idx < 0)
     return;
-  lss.dirichlet(node_idx, offset, new_value - old_value, true);
+  data.lss_dirichlet(lss, node_idx, offset, new_value - old_value);
 }
 
 /// Overload for vector types
-template<typename NewT, typename OldT>
-inline void assign_dirichlet(math::LSS::System& lss, const NewT& new_value, const OldT& old_value, const int node_idx, const Uint offset)
+template<typename NewT, typename OldT, typename DataT>
+inline void assign_dirichlet(math::LSS::System& lss, const NewT& new_value, const OldT& old_value, const int node_idx, const Uint offset, DataT& data)
 {
   if(node_idx < 0)
     return;
   for(Uint i = 0; i != OldT::RowsAtCompileTime; ++i)
-    lss.dirichlet(node_idx, offset+i, new_value[i] - old_value[i], true);
+    data.lss_dirichlet(lss, node_idx, offset+i, new_value[i] - old_value[i]);
 }
 
 /// Sets whole-variable dirichlet BC, allowing the use of a complete vector as value
@@ -69,7 +70,8 @@ struct DirichletBCSetter :
         state,
         data.var_data(boost::proto::value(boost::proto::child_c<1>(expr))).value(), // old value
         boost::proto::value( boost::proto::child_c<0>(expr) ).node_to_lss(data.node_idx),
-        data.var_data(boost::proto::value(boost::proto::child_c<1>(expr))).offset
+        data.var_data(boost::proto::value(boost::proto::child_c<1>(expr))).offset,
+        data
       );
     }
   };
@@ -97,7 +99,8 @@ struct DirichletBCComponentSetter :
         state,
         data.var_data(boost::proto::value(boost::proto::left(boost::proto::child_c<1>(expr)))).value()[vec_component], // old value
         boost::proto::value( boost::proto::child_c<0>(expr) ).node_to_lss(data.node_idx),
-        data.var_data(boost::proto::value(boost::proto::left(boost::proto::child_c<1>(expr)))).offset + vec_component
+        data.var_data(boost::proto::value(boost::proto::left(boost::proto::child_c<1>(expr)))).offset + vec_component,
+        data
       );
     }
   };
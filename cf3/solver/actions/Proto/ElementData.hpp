@@ -37,6 +37,7 @@
 
 #include "ElementMatrix.hpp"
 #include "ElementOperations.hpp"
+#include "JacobianCache.hpp"
 #include "FieldSync.hpp"
 #include "Terminals.hpp"
 
@@ -83,13 +84,23 @@ public:
   /// Return type of the value() method
   typedef const ValueT& ValueResultT;
 
+  /// Cached jacobians for a block of elements
+  typedef JacobianCache<EtypeT> JacobianCacheT;
+
   /// We store nodes as a fixed-size Eigen matrix, so we need to make sure alignment is respected
   EIGEN_MAKE_ALIGNED_OPERATOR_NEW
 
   GeometricSupport(const mesh::Elements& elements) :
     m_coordinates(elements.geometry_fields().coordinates()),
-    m_connectivity(elements.geometry_space().connectivity())
+    m_connectivity(elements.geometry_space().connectivity()),
+    m_jacobian_cache(m_coordinates, m_connectivity)
+  {
+  }
+
+  /// Precompute the jacobians for elements [begin, begin+count). count must not exceed JacobianCacheT::width
+  void cache_jacobians(const Uint begin, const Uint count)
   {
+    m_jacobian_cache.load(begin, count);
   }
 
   /// Update nodes for the current element and set the connectivity for the passed block accumulator
@@ -216,8 +227,16 @@ private:
 
   void compute_jacobian_dispatch(boost::mpl::true_, const typename EtypeT::MappedCoordsT& mapped_coords) const
   {
-    EtypeT::compute_jacobian(mapped_coords, m_nodes, m_jacobian_matrix);
+    // Affine element in the cached block: the jacobian was already computed
     bool is_invertible;
+    if(m_jacobian_cache.contains(m_element_idx))
+    {
+      m_jacobian_cache.jacobian(m_element_idx, m_jacobian_matrix, m_jacobian_inverse, m_jacobian_determinant, is_invertible);
+      cf3_assert(is_invertible);
+      return;
+    }
+
+    EtypeT::compute_jacobian(mapped_coords, m_nodes, m_jacobian_matrix);
     m_jacobian_matrix.computeInverseAndDetWithCheck(m_jacobian_inverse, m_jacobian_determinant, is_invertible);
     cf3_assert(is_invertible);
   }
@@ -231,6 +250,9 @@ private:
   /// Connectivity table
   const common::Table<Uint>& m_connectivity;
 
+  /// Jacobians for the block of elements that is currently evaluated
+  JacobianCacheT m_jacobian_cache;
+
   /// Index for the current element
   Uint m_element_idx;
 
@@ -852,6 +874,15 @@ public:
     boost::mpl::for_each< boost::mpl::range_c<int, 0, NbVarsT::value> >(DeleteVariablesData(m_variables_data));
   }
 
+  /// Number of elements for which cache_jacobians computes the jacobians at once
+  static const Uint jacobian_cache_width = GeometricSupport<SupportEtypeT>::JacobianCacheT::width;
+
+  /// Precompute the jacobians of the elements [begin, begin+count), if the support is affine
+  void cache_jacobians(const Uint begin, const Uint count)
+  {
+    m_support.cache_jacobians(begin, count);
+  }
+
   /// Update element index
   void set_element(const Uint element_idx)
   {
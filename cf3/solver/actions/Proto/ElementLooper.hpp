@@ -7,6 +7,8 @@
 #ifndef cf3_solver_actions_Proto_ElementLooper_hpp
 #define cf3_solver_actions_Proto_ElementLooper_hpp
 
+#include <algorithm>
+
 #include <boost/fusion/algorithm/iteration/for_each.hpp>
 #include <boost/fusion/adapted/mpl.hpp>
 #include <boost/fusion/mpl.hpp>
@@ -19,6 +21,7 @@
 #include "ElementData.hpp"
 #include "ElementExpressionWrapper.hpp"
 #include "ElementGrammar.hpp"
+#include "FieldSync.hpp"
 
 #include "mesh/Mesh.hpp"
 #include "mesh/Space.hpp"
@@ -159,23 +162,59 @@ template<typename DataT>
 struct ElementLooperImpl
 {
   template<typename ExprT>
-  void operator()(const ExprT& expr, DataT& data, const Uint nb_elems) const
+  void operator()(const ExprT& expr, DataT& data, const mesh::Elements& elements) const
   {
     const typename DataT::SupportShapeFunction::MappedCoordsT mapped_coords; // needed to deduce proper return type when wrapping
-    run(WrapExpression()(expr, mapped_coords, data), data, nb_elems);
+    const Uint nb_elems = elements.size();
+    FieldSynchronizer& synchronizer = FieldSynchronizer::instance();
+    if(!synchronizer.exchange_in_progress())
+    {
+      run(WrapExpression()(expr, mapped_coords, data), data, 0, nb_elems);
+      return;
+    }
+
+    // Ghost values are still arriving: first loop over the elements that only use owned nodes
+    std::vector<bool> ghost_dependent;
+    synchronizer.mark_ghost_dependent(elements, ghost_dependent);
+    for(int pass = 0; pass != 2; ++pass)
+    {
+      const bool run_ghost_dependent = pass == 1;
+      if(run_ghost_dependent)
+        synchronizer.finish_exchange();
+      // Loop over contiguous ranges, to keep caching the jacobians of consecutive elements
+      Uint range_begin = 0;
+      while(range_begin != nb_elems)
+      {
+        Uint range_end = range_begin;
+        while(range_end != nb_elems && ghost_dependent[range_end] == ghost_dependent[range_begin])
+          ++range_end;
+        if(ghost_dependent[range_begin] == run_ghost_dependent)
+          run(WrapExpression()(expr, mapped_coords, data), data, range_begin, range_end);
+        range_begin = range_end;
+      }
+    }
   }
 
 private:
   template<typename FilteredExprT>
-  void run(const FilteredExprT& expr, DataT& data, const Uint nb_elems) const
+  void run(const FilteredExprT& expr, DataT& data, const Uint begin, const Uint end) const
   {
     ElementGrammar grammar;
-    for(Uint elem = 0; elem != nb_elems; ++elem)
+    // Elements are processed in blocks, so the constant jacobians of affine elements are computed for the whole block at once.
+    // With the cache disabled, nothing is cached and the jacobians are computed at every quadrature point.
+    const bool use_cache = jacobian_cache_enabled();
+    const Uint block_width = use_cache ? DataT::jacobian_cache_width : 1;
+    for(Uint block_begin = begin; block_begin < end; block_begin += block_width)
     {
-      // Update the data for the element
-      data.set_element(elem);
-      // Run the expression using a proto transform, passing as arguments in the standard proto sense: the expression, a state and the data
-      grammar(expr, elem, data);
+      const Uint block_end = std::min(block_begin + block_width, end);
+      data.cache_jacobians(block_begin, use_cache ? block_end - block_begin : 0);
+      for(Uint elem = block_begin; elem != block_end; ++elem)
+      {
+        // Update the data for the element
+        data.set_element(elem);
+        // Run the expression using a proto transform, passing as arguments in the standard proto sense: the expression, a state and the data
+        grammar(expr, elem, data);
+      }
     }
   }
 };
@@ -198,7 +237,7 @@ struct ExpressionRunner<ElementTypesT, ExprT, SupportETYPE, VariablesT, Variable
 
     DataT data(variables, elements);
 
-    ElementLooperImpl<DataT>()(expression, data, elements.size());
+    ElementLooperImpl<DataT>()(expression, data, elements);
   }
 
 private:
@@ -254,7 +293,7 @@ struct ElementLooper
 
     DataT data(m_variables, m_elements);
 
-    ElementLooperImpl<DataT>()(m_expr, data, m_elements.size());
+    ElementLooperImpl<DataT>()(m_expr, data, m_elements);
   }
 
   /// Static dispatch in case different ETYPE are possible
@@ -293,12 +332,18 @@ void for_each_element(mesh::Region& root_region, const ExprT& expr)
   CopyNumberedVars<VariablesT> ctx(vars); // This is a proto context
   boost::proto::eval(expr, ctx); // calling eval using the above context stores all variables in vars
 
+  // Fields left unsynchronized by previous loops are exchanged while the first elements are processed
+  if(FieldSynchronizer::instance().has_pending())
+    FieldSynchronizer::instance().start_exchange();
+
   // Traverse all Elements under the root and evaluate the expression
   BOOST_FOREACH(mesh::Elements& elements, common::find_components_recursively<mesh::Elements>(root_region))
   {
     // We skip order 0 functions in the top-call, because first the support shape function is determined, and order 0 is not allowed there
     boost::mpl::for_each< boost::mpl::filter_view< ElementTypesT, mesh::IsMinimalOrder<1> > >( ElementLooper<ElementTypesT, ExprT>(elements, expr, vars) );
   }
+
+  FieldSynchronizer::instance().finish_exchange();
 };
 
 } // namespace Proto
@@ -65,6 +65,9 @@ public:
   /// value: space library name, to indicate what kind of field is expected
   virtual void insert_field_info(std::map<std::string, std::string>& tags) const = 0;
 
+  /// Set the maximum number of threads used by loop. Only loops over nodes use threads.
+  virtual void set_nb_threads(const Uint nb_threads) {}
+
   virtual ~Expression() {}
 };
 
@@ -252,11 +255,17 @@ public:
 
   void loop(mesh::Region& region)
   {
+    // Fields left unsynchronized by previous loops are exchanged while the first elements are processed
+    if(FieldSynchronizer::instance().has_pending())
+      FieldSynchronizer::instance().start_exchange();
+
     // Traverse all Elements under the region and evaluate the expression
     BOOST_FOREACH(mesh::Elements& elements, common::find_components_recursively<mesh::Elements>(region) )
     {
       boost::mpl::for_each<boost::mpl::filter_view< ElementTypes, mesh::IsMinimalOrder<1> > >( ElementLooper<ElementTypes, typename BaseT::CopiedExprT>(elements, BaseT::m_expr, BaseT::m_variables) );
     }
+
+    FieldSynchronizer::instance().finish_exchange();
   }
 };
 
@@ -267,7 +276,7 @@ class NodesExpression : public ExpressionBase<ExprT>
   typedef ExpressionBase<ExprT> BaseT;
 public:
 
-  NodesExpression(const ExprT& expr) : BaseT(expr)
+  NodesExpression(const ExprT& expr) : BaseT(expr), m_nb_threads(1)
   {
   }
 
@@ -279,8 +288,16 @@ public:
       INVALID_NODE_EXPRESSION,
       (NodeGrammar));
 
-    boost::mpl::for_each< boost::mpl::range_c<Uint, 1, 4> >( NodeLooper<typename BaseT::CopiedExprT>(BaseT::m_expr, region, BaseT::m_variables) );
+    boost::mpl::for_each< boost::mpl::range_c<Uint, 1, 4> >( NodeLooper<typename BaseT::CopiedExprT>(BaseT::m_expr, region, BaseT::m_variables, m_nb_threads) );
+  }
+
+  void set_nb_threads(const Uint nb_threads)
+  {
+    m_nb_threads = nb_threads;
   }
+
+private:
+  Uint m_nb_threads;
 };
 
 /// Default element types supported by elements expressions
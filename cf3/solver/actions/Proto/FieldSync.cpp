@@ -5,6 +5,12 @@
 // See doc/lgpl.txt and doc/gpl.txt for the license text.
 
 #include "common/PE/Comm.hpp"
+#include "common/PE/CommPattern.hpp"
+
+#include "mesh/Connectivity.hpp"
+#include "mesh/Dictionary.hpp"
+#include "mesh/Elements.hpp"
+#include "mesh/Space.hpp"
 
 #include "FieldSync.hpp"
 
@@ -13,7 +19,7 @@ namespace solver {
 namespace actions {
 namespace Proto {
 
-FieldSynchronizer::FieldSynchronizer()
+FieldSynchronizer::FieldSynchronizer() : m_deferred(false)
 {
 }
 
@@ -31,6 +37,11 @@ void FieldSynchronizer::insert(cf3::mesh::Field& f)
 
 void FieldSynchronizer::synchronize()
 {
+  if(m_deferred)
+    return;
+
+  finish_exchange();
+
   if(common::PE::Comm::instance().is_active())
   {
     for(FieldsT::iterator field_it = m_fields.begin(); field_it != m_fields.end(); ++field_it)
@@ -42,6 +53,93 @@ void FieldSynchronizer::synchronize()
   m_fields.clear();
 }
 
+void FieldSynchronizer::start_exchange()
+{
+  finish_exchange();
+
+  if(!common::PE::Comm::instance().is_active())
+  {
+    m_fields.clear();
+    return;
+  }
+
+  // Group the fields per comm pattern, keeping the same order on each cpu
+  typedef std::map< std::string, std::pair< Handle<common::PE::CommPattern>, std::vector< Handle<common::PE::CommWrapper> > > > PatternsT;
+  PatternsT patterns;
+  for(FieldsT::iterator field_it = m_fields.begin(); field_it != m_fields.end(); ++field_it)
+  {
+    mesh::Field& field = *field_it->second;
+    const Handle<common::PE::CommPattern>& comm_pattern = field.comm_pattern();
+    if(is_null(comm_pattern))
+      continue;
+
+    std::pair< Handle<common::PE::CommPattern>, std::vector< Handle<common::PE::CommWrapper> > >& entry = patterns[comm_pattern->uri().path()];
+    entry.first = comm_pattern;
+    entry.second.push_back(Handle<common::PE::CommWrapper>(comm_pattern->get_child(field.name())));
+    m_exchanging_fields.insert(*field_it);
+  }
+  m_fields.clear();
+
+  for(PatternsT::iterator pattern_it = patterns.begin(); pattern_it != patterns.end(); ++pattern_it)
+  {
+    pattern_it->second.first->start_synchronize(pattern_it->second.second);
+    m_exchanging.push_back(pattern_it->second.first);
+  }
+}
+
+void FieldSynchronizer::finish_exchange()
+{
+  for(std::vector< Handle<common::PE::CommPattern> >::iterator it = m_exchanging.begin(); it != m_exchanging.end(); ++it)
+  {
+    if(is_not_null(*it))
+      (*it)->finish_synchronize();
+  }
+  m_exchanging.clear();
+  m_exchanging_fields.clear();
+}
+
+Uint FieldSynchronizer::mark_ghost_dependent(const mesh::Elements& elements, std::vector<bool>& ghost_dependent) const
+{
+  const Uint nb_elems = elements.size();
+  ghost_dependent.assign(nb_elems, false);
+
+  // Dictionaries of the fields that are being exchanged
+  std::map<std::string, const mesh::Dictionary*> dicts;
+  for(FieldsT::const_iterator field_it = m_exchanging_fields.begin(); field_it != m_exchanging_fields.end(); ++field_it)
+  {
+    if(is_not_null(field_it->second))
+      dicts[field_it->second->dict().uri().path()] = &field_it->second->dict();
+  }
+
+  Uint nb_marked = 0;
+  for(std::map<std::string, const mesh::Dictionary*>::const_iterator dict_it = dicts.begin(); dict_it != dicts.end(); ++dict_it)
+  {
+    const mesh::Dictionary& dict = *dict_it->second;
+    if(!dict.defined_for_entities(elements.handle<mesh::Entities const>()))
+      continue;
+
+    const mesh::Connectivity& connectivity = dict.space(elements).connectivity();
+    const Uint nb_nodes = connectivity.row_size();
+    for(Uint elem = 0; elem != nb_elems; ++elem)
+    {
+      if(ghost_dependent[elem])
+        continue;
+      const mesh::Connectivity::ConstRow row = connectivity[elem];
+      for(Uint i = 0; i != nb_nodes; ++i)
+      {
+        if(dict.is_ghost(row[i]))
+        {
+          ghost_dependent[elem] = true;
+          ++nb_marked;
+          break;
+        }
+      }
+    }
+  }
+
+  return nb_marked;
+}
+
 } // namespace Proto
 } // namespace actions
 } // namespace solver
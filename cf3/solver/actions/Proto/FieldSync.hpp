@@ -7,6 +7,8 @@
 #ifndef cf3_solver_actions_Proto_FieldSync_hpp
 #define cf3_solver_actions_Proto_FieldSync_hpp
 
+#include <vector>
+
 #include "mesh/Field.hpp"
 
 /// @file
@@ -28,9 +30,33 @@ public:
   /// Insert a field to synchronize
   void insert(mesh::Field& f);
 
-  /// Sync fields and clear the list
+  /// Sync fields and clear the list. In deferred mode, the fields are kept for a later start_exchange.
   void synchronize();
 
+  /// In deferred mode, synchronize() does not communicate. The fields stay pending until the next element loop
+  /// exchanges them with start_exchange and finish_exchange, overlapping the communication with the elements
+  /// that do not use ghost values. Setting this to false does not synchronize the pending fields.
+  void set_deferred(const bool deferred) { m_deferred = deferred; }
+  bool deferred() const { return m_deferred; }
+
+  /// True if there are fields that were modified, but whose ghost values were not exchanged yet
+  bool has_pending() const { return !m_fields.empty(); }
+
+  /// Start a non-blocking exchange of the ghost values of the pending fields.
+  /// Fields that share a comm pattern are sent in a single message per rank.
+  void start_exchange();
+
+  /// Wait for the exchange started by start_exchange to complete
+  void finish_exchange();
+
+  /// True between start_exchange and finish_exchange
+  bool exchange_in_progress() const { return !m_exchanging.empty(); }
+
+  /// Mark the elements that have at least one ghost node in the space of a field that is being exchanged.
+  /// These must wait for finish_exchange before using the field values.
+  /// @return the number of marked elements
+  Uint mark_ghost_dependent(const mesh::Elements& elements, std::vector<bool>& ghost_dependent) const;
+
 private:
   FieldSynchronizer();
 
@@ -38,6 +64,12 @@ private:
   // on each cpu.
   typedef std::map< std::string, Handle<mesh::Field> > FieldsT;
   FieldsT m_fields;
+
+  bool m_deferred;
+
+  /// Comm patterns with an exchange in progress, and the fields that are exchanged
+  std::vector< Handle<common::PE::CommPattern> > m_exchanging;
+  FieldsT m_exchanging_fields;
 };
 
 
@@ -0,0 +1,36 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#include "JacobianCache.hpp"
+
+namespace cf3 {
+namespace solver {
+namespace actions {
+namespace Proto {
+
+namespace detail
+{
+  bool& jacobian_cache_flag()
+  {
+    static bool enabled = true;
+    return enabled;
+  }
+}
+
+void set_jacobian_cache_enabled(const bool enabled)
+{
+  detail::jacobian_cache_flag() = enabled;
+}
+
+bool jacobian_cache_enabled()
+{
+  return detail::jacobian_cache_flag();
+}
+
+} // namespace Proto
+} // namespace actions
+} // namespace solver
+} // namespace cf3
@@ -0,0 +1,234 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef cf3_solver_actions_Proto_JacobianCache_hpp
+#define cf3_solver_actions_Proto_JacobianCache_hpp
+
+// Number of consecutive elements for which the jacobians are computed together before evaluating an element expression. Set to 1 to disable the cache.
+#ifndef CF3_PROTO_JACOBIAN_CACHE_WIDTH
+  #define CF3_PROTO_JACOBIAN_CACHE_WIDTH 8
+#endif
+
+#include <cmath>
+
+#include <boost/mpl/bool.hpp>
+
+#include "common/Assertions.hpp"
+
+#include "common/Table.hpp"
+
+#include "math/MatrixTypes.hpp"
+
+#include "mesh/GeoShape.hpp"
+
+/// @file
+/// Cache for the jacobians of a block of consecutive elements. For supports with an affine mapping (linear lines, triangles and
+/// tetrahedra) the jacobian, its inverse and its determinant are constant over the element, so they are computed once per
+/// element for the whole block, in loops over the elements of the block, instead of at every quadrature point.
+/// The expressions themselves are evaluated one element at a time.
+
+namespace cf3 {
+namespace solver {
+namespace actions {
+namespace Proto {
+
+/// Enable or disable the jacobian cache at run time, e.g. to measure what it gains. When disabled, element loops compute
+/// the jacobians at every quadrature point. Enabled by default.
+void set_jacobian_cache_enabled(const bool enabled);
+bool jacobian_cache_enabled();
+
+/// True if the mapping from mapped to real coordinates is affine for the given element type, i.e. the jacobian is constant
+template<typename ETYPE>
+struct IsAffineSupport :
+  boost::mpl::bool_
+  <
+    ETYPE::order == 1 &&
+    ETYPE::dimension == ETYPE::dimensionality &&
+    (ETYPE::shape == mesh::GeoShape::LINE || ETYPE::shape == mesh::GeoShape::TRIAG || ETYPE::shape == mesh::GeoShape::TETRA)
+  >
+{
+};
+
+/// Lane-wise inverse and determinant of a block of square matrices, stored as m[row][col][lane]
+template<Uint Dim, Uint Width>
+struct BlockInverse;
+
+template<Uint Width>
+struct BlockInverse<1, Width>
+{
+  static void apply(const Real (&m)[1][1][Width], Real (&inv)[1][1][Width], Real (&det)[Width], const Uint count)
+  {
+    for(Uint l = 0; l != count; ++l)
+    {
+      det[l] = m[0][0][l];
+      inv[0][0][l] = 1. / det[l];
+    }
+  }
+};
+
+template<Uint Width>
+struct BlockInverse<2, Width>
+{
+  static void apply(const Real (&m)[2][2][Width], Real (&inv)[2][2][Width], Real (&det)[Width], const Uint count)
+  {
+    for(Uint l = 0; l != count; ++l)
+    {
+      det[l] = m[0][0][l]*m[1][1][l] - m[0][1][l]*m[1][0][l];
+      const Real inv_det = 1. / det[l];
+      inv[0][0][l] =  m[1][1][l] * inv_det;
+      inv[0][1][l] = -m[0][1][l] * inv_det;
+      inv[1][0][l] = -m[1][0][l] * inv_det;
+      inv[1][1][l] =  m[0][0][l] * inv_det;
+    }
+  }
+};
+
+template<Uint Width>
+struct BlockInverse<3, Width>
+{
+  static void apply(const Real (&m)[3][3][Width], Real (&inv)[3][3][Width], Real (&det)[Width], const Uint count)
+  {
+    for(Uint l = 0; l != count; ++l)
+    {
+      const Real c00 = m[1][1][l]*m[2][2][l] - m[1][2][l]*m[2][1][l];
+      const Real c01 = m[1][2][l]*m[2][0][l] - m[1][0][l]*m[2][2][l];
+      const Real c02 = m[1][0][l]*m[2][1][l] - m[1][1][l]*m[2][0][l];
+      det[l] = m[0][0][l]*c00 + m[0][1][l]*c01 + m[0][2][l]*c02;
+      const Real inv_det = 1. / det[l];
+      inv[0][0][l] = c00 * inv_det;
+      inv[1][0][l] = c01 * inv_det;
+      inv[2][0][l] = c02 * inv_det;
+      inv[0][1][l] = (m[0][2][l]*m[2][1][l] - m[0][1][l]*m[2][2][l]) * inv_det;
+      inv[1][1][l] = (m[0][0][l]*m[2][2][l] - m[0][2][l]*m[2][0][l]) * inv_det;
+      inv[2][1][l] = (m[0][1][l]*m[2][0][l] - m[0][0][l]*m[2][1][l]) * inv_det;
+      inv[0][2][l] = (m[0][1][l]*m[1][2][l] - m[0][2][l]*m[1][1][l]) * inv_det;
+      inv[1][2][l] = (m[0][2][l]*m[1][0][l] - m[0][0][l]*m[1][2][l]) * inv_det;
+      inv[2][2][l] = (m[0][0][l]*m[1][1][l] - m[0][1][l]*m[1][0][l]) * inv_det;
+    }
+  }
+};
+
+/// Jacobian cache. The general case disables the cache: each block contains a single element and nothing is precomputed.
+template<typename ETYPE, bool IsCached = IsAffineSupport<ETYPE>::value && (CF3_PROTO_JACOBIAN_CACHE_WIDTH > 1)>
+class JacobianCache
+{
+public:
+  static const Uint width = 1;
+
+  JacobianCache(const common::Table<Real>&, const common::Table<Uint>&)
+  {
+  }
+
+  void load(const Uint, const Uint)
+  {
+  }
+
+  bool contains(const Uint) const
+  {
+    return false;
+  }
+
+  void jacobian(const Uint, typename ETYPE::JacobianT&, typename ETYPE::JacobianT&, Real&, bool&) const
+  {
+  }
+};
+
+/// Jacobian cache for affine supports
+template<typename ETYPE>
+class JacobianCache<ETYPE, true>
+{
+public:
+  static const Uint width = CF3_PROTO_JACOBIAN_CACHE_WIDTH;
+  static const Uint nb_nodes = ETYPE::nb_nodes;
+  static const Uint dimension = ETYPE::dimension;
+
+  JacobianCache(const common::Table<Real>& coordinates, const common::Table<Uint>& connectivity) :
+    m_coordinates(coordinates),
+    m_connectivity(connectivity),
+    m_begin(0),
+    m_end(0)
+  {
+    // The gradient is constant for affine elements, so any mapped coordinate will do
+    ETYPE::SF::compute_gradient(ETYPE::MappedCoordsT::Zero(), m_mapped_gradient);
+  }
+
+  /// Compute the jacobians of elements [begin, begin+count)
+  void load(const Uint begin, const Uint count)
+  {
+    cf3_assert(count <= width);
+    m_begin = begin;
+    m_end = begin + count;
+
+    // J(i,j) = sum_n dN_n/dxi_i * x_n,j
+    for(Uint i = 0; i != dimension; ++i)
+      for(Uint j = 0; j != dimension; ++j)
+        for(Uint l = 0; l != count; ++l)
+          m_jacobian[i][j][l] = 0.;
+
+    for(Uint l = 0; l != count; ++l)
+    {
+      const common::Table<Uint>::ConstRow conn = m_connectivity[begin+l];
+      for(Uint n = 0; n != nb_nodes; ++n)
+      {
+        const common::Table<Real>::ConstRow coords = m_coordinates[conn[n]];
+        for(Uint i = 0; i != dimension; ++i)
+        {
+          const Real g = m_mapped_gradient(i, n);
+          for(Uint j = 0; j != dimension; ++j)
+            m_jacobian[i][j][l] += g * coords[j];
+        }
+      }
+    }
+
+    BlockInverse<dimension, width>::apply(m_jacobian, m_jacobian_inverse, m_jacobian_determinant, count);
+  }
+
+  /// True if the given element is in the currently loaded block
+  bool contains(const Uint element_idx) const
+  {
+    return element_idx >= m_begin && element_idx < m_end;
+  }
+
+  /// Copy the precomputed jacobian, its inverse and determinant for the given element out of the cache.
+  /// is_invertible uses the same criterion as Eigen's computeInverseAndDetWithCheck
+  void jacobian(const Uint element_idx, typename ETYPE::JacobianT& jac, typename ETYPE::JacobianT& jac_inverse, Real& jac_det, bool& is_invertible) const
+  {
+    const Uint l = element_idx - m_begin;
+    for(Uint i = 0; i != dimension; ++i)
+    {
+      for(Uint j = 0; j != dimension; ++j)
+      {
+        jac(i, j) = m_jacobian[i][j][l];
+        jac_inverse(i, j) = m_jacobian_inverse[i][j][l];
+      }
+    }
+    jac_det = m_jacobian_determinant[l];
+    is_invertible = std::abs(jac_det) > Eigen::NumTraits<Real>::dummy_precision();
+  }
+
+private:
+  const common::Table<Real>& m_coordinates;
+  const common::Table<Uint>& m_connectivity;
+
+  /// Range of the loaded elements
+  Uint m_begin;
+  Uint m_end;
+
+  /// Constant gradient of the shape functions in mapped coordinates
+  typename ETYPE::SF::GradientT m_mapped_gradient;
+
+  /// Cached data, with the element (lane) index last
+  Real m_jacobian[dimension][dimension][width];
+  Real m_jacobian_inverse[dimension][dimension][width];
+  Real m_jacobian_determinant[width];
+};
+
+} // namespace Proto
+} // namespace actions
+} // namespace solver
+} // namespace cf3
+
+#endif // cf3_solver_actions_Proto_JacobianCache_hpp
@@ -11,6 +11,7 @@
 
 #include <boost/mpl/for_each.hpp>
 #include <boost/mpl/range_c.hpp>
+#include <boost/scoped_ptr.hpp>
 
 #include "common/FindComponents.hpp"
 #include "common/PE/Comm.hpp"
@@ -27,6 +28,7 @@
 #include "mesh/Space.hpp"
 
 #include "FieldSync.hpp"
+#include "NodeThreading.hpp"
 #include "Transforms.hpp"
 
 /// @file
@@ -74,6 +76,8 @@ struct NodeVarData
 
   void set_node(const Uint) {}
 
+  void join(const NodeVarData&) {}
+
   /// By default, value just returns the supplied value
   ValueResultT value()
   {
@@ -101,7 +105,8 @@ struct NodeVarData< ScalarField >
 
   NodeVarData(const ScalarField& placeholder, mesh::Region& region) :
     m_field(find_field(region, placeholder.field_tag())),
-    m_need_synchronization(false)
+    m_need_synchronization(false),
+    m_is_thread_copy(false)
   {
     const math::VariablesDescriptor& descriptor = m_field.descriptor();
     m_var_begin = descriptor.offset(placeholder.name());
@@ -113,9 +118,20 @@ struct NodeVarData< ScalarField >
     nb_dofs = descriptor.size();
   }
 
+  /// Copy for another thread, which leaves the synchronization to the original
+  NodeVarData(const NodeVarData& other) :
+    offset(other.offset),
+    nb_dofs(other.nb_dofs),
+    m_field(other.m_field),
+    m_var_begin(other.m_var_begin),
+    m_need_synchronization(false),
+    m_is_thread_copy(true)
+  {
+  }
+
   ~NodeVarData()
   {
-    if(common::PE::Comm::instance().is_active())
+    if(!m_is_thread_copy && common::PE::Comm::instance().is_active())
     {
       const Uint my_sync = m_need_synchronization ? 1 : 0;
       Uint global_sync = 0;
@@ -131,6 +147,12 @@ struct NodeVarData< ScalarField >
     m_value = m_field[idx][m_var_begin];
   }
 
+  /// Take over the synchronization state of a thread copy
+  void join(const NodeVarData& thread_copy)
+  {
+    m_need_synchronization = m_need_synchronization || thread_copy.m_need_synchronization;
+  }
+
   typedef Real ValueT;
   typedef Real ValueResultT;
 
@@ -174,6 +196,7 @@ private:
   Uint m_idx;
   Real m_value;
   bool m_need_synchronization;
+  bool m_is_thread_copy;
 };
 
 template<Uint Dim>
@@ -188,7 +211,8 @@ struct NodeVarData<VectorField, Dim>
 
   NodeVarData(const VectorField& placeholder, mesh::Region& region) :
     m_field( find_field(region, placeholder.field_tag()) ),
-    m_need_synchronization(false)
+    m_need_synchronization(false),
+    m_is_thread_copy(false)
   {
     const math::VariablesDescriptor& descriptor = m_field.descriptor();
     m_var_begin = descriptor.offset(placeholder.name());
@@ -200,9 +224,20 @@ struct NodeVarData<VectorField, Dim>
     nb_dofs = descriptor.size();
   }
 
+  /// Copy for another thread, which leaves the synchronization to the original
+  NodeVarData(const NodeVarData& other) :
+    offset(other.offset),
+    nb_dofs(other.nb_dofs),
+    m_field(other.m_field),
+    m_var_begin(other.m_var_begin),
+    m_need_synchronization(false),
+    m_is_thread_copy(true)
+  {
+  }
+
   ~NodeVarData()
   {
-    if(common::PE::Comm::instance().is_active())
+    if(!m_is_thread_copy && common::PE::Comm::instance().is_active())
     {
       const Uint my_sync = m_need_synchronization ? 1 : 0;
       Uint global_sync = 0;
@@ -219,6 +254,12 @@ struct NodeVarData<VectorField, Dim>
       m_value[i] = m_field[idx][m_var_begin + i];
   }
 
+  /// Take over the synchronization state of a thread copy
+  void join(const NodeVarData& thread_copy)
+  {
+    m_need_synchronization = m_need_synchronization || thread_copy.m_need_synchronization;
+  }
+
   /// Return a reference to the stored value
   ValueResultT value() const
   {
@@ -286,6 +327,7 @@ private:
   ValueT m_value;
   Uint m_idx;
   bool m_need_synchronization;
+  bool m_is_thread_copy;
 };
 
 /// MPL transform operator to wrap a variable in its data type
@@ -344,6 +386,8 @@ public:
   /// Type of the coordinates
   typedef Eigen::Matrix<Real, NbDims::value, 1> CoordsT;
 
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
   template<typename ExprT>
   NodeData(VariablesT& variables, mesh::Region& region, const common::Table<Real>& coords, const ExprT& expr) :
     m_variables(variables),
@@ -353,6 +397,21 @@ public:
     boost::mpl::for_each< boost::mpl::range_c<int, 0, NbVarsT::value> >(InitVariablesData(m_variables, m_region, m_variables_data));
   }
 
+  /// Copy of the data for a thread of a threaded node loop. The copy defers its changes to linear systems and keeps its own
+  /// value for each of the given reductions, until it is passed to join.
+  NodeData(const NodeData& master, const std::vector<ScalarReduction>& reductions) :
+    m_variables(master.m_variables),
+    m_region(master.m_region),
+    m_coordinates(master.m_coordinates),
+    m_reductions(reductions),
+    m_deferred_writes(new DeferredLSSWrites())
+  {
+    boost::mpl::for_each< boost::mpl::range_c<int, 0, NbVarsT::value> >(CopyVariablesData(master.m_variables_data, m_variables_data));
+    const Uint nb_reductions = m_reductions.size();
+    for(Uint i = 0; i != nb_reductions; ++i)
+      m_reductions[i].start();
+  }
+
   ~NodeData()
   {
     boost::mpl::for_each< boost::mpl::range_c<int, 0, NbVarsT::value> >(DeleteVariablesData(m_variables_data));
@@ -368,6 +427,55 @@ public:
   /// Current node index
   Uint node_idx;
 
+  /// Merge the results of a thread copy. Copies must be joined in the order of their nodes.
+  void join(NodeData& thread_data)
+  {
+    boost::mpl::for_each< boost::mpl::range_c<int, 0, NbVarsT::value> >(JoinVariablesData(m_variables_data, thread_data.m_variables_data));
+    const Uint nb_reductions = thread_data.m_reductions.size();
+    for(Uint i = 0; i != nb_reductions; ++i)
+      thread_data.m_reductions[i].finish();
+    thread_data.m_deferred_writes->apply();
+  }
+
+  /// Value to use for a Real that is referred to by the expression, which is local to the thread in case of a reduction
+  Real& scalar(Real& value)
+  {
+    const Uint nb_reductions = m_reductions.size();
+    for(Uint i = 0; i != nb_reductions; ++i)
+    {
+      if(m_reductions[i].target == &value)
+        return m_reductions[i].value;
+    }
+    return value;
+  }
+
+  /// Set a value in an LSS vector
+  void lss_set_value(math::LSS::Vector& vector, const Uint row, const Real value)
+  {
+    if(is_null(m_deferred_writes.get()))
+      vector.set_value(row, value);
+    else
+      m_deferred_writes->set_value(vector, row, value);
+  }
+
+  /// Set a value in a blocked LSS vector
+  void lss_set_value(math::LSS::Vector& vector, const Uint block_row, const Uint eq, const Real value)
+  {
+    if(is_null(m_deferred_writes.get()))
+      vector.set_value(block_row, eq, value);
+    else
+      m_deferred_writes->set_value(vector, block_row, eq, value);
+  }
+
+  /// Apply a Dirichlet condition, preserving the symmetry of the system
+  void lss_dirichlet(math::LSS::System& lss, const Uint block_row, const Uint eq, const Real value)
+  {
+    if(is_null(m_deferred_writes.get()))
+      lss.dirichlet(block_row, eq, value, true);
+    else
+      m_deferred_writes->dirichlet(lss, block_row, eq, value);
+  }
+
   /// Access to the current coordinates
   const CoordsT& coordinates() const
   {
@@ -395,6 +503,12 @@ private:
   /// Current coordinates
   mutable CoordsT m_position;
 
+  /// Per-thread values of the reductions
+  std::vector<ScalarReduction> m_reductions;
+
+  /// Changes to linear systems, for thread copies
+  boost::scoped_ptr<DeferredLSSWrites> m_deferred_writes;
+
   ///////////// helper functions and structs /////////////
 private:
   /// Initializes the pointers in a VariablesDataT fusion sequence
@@ -431,6 +545,51 @@ private:
     VariablesDataT& variables_data;
   };
 
+  /// Copy the per-variable data of another NodeData
+  struct CopyVariablesData
+  {
+    CopyVariablesData(const VariablesDataT& from_data, VariablesDataT& to_data) :
+      from(from_data),
+      to(to_data)
+    {
+    }
+
+    template<typename I>
+    void operator()(const I&)
+    {
+      apply(boost::fusion::at<I>(from), boost::fusion::at<I>(to));
+    }
+
+    template<typename VarDataT>
+    void apply(VarDataT* from_var, VarDataT*& to_var)
+    {
+      to_var = is_null(from_var) ? 0 : new VarDataT(*from_var);
+    }
+
+    const VariablesDataT& from;
+    VariablesDataT& to;
+  };
+
+  /// Join the per-variable data of a thread copy
+  struct JoinVariablesData
+  {
+    JoinVariablesData(VariablesDataT& master_data, VariablesDataT& thread_data) :
+      master(master_data),
+      thread(thread_data)
+    {
+    }
+
+    template<typename I>
+    void operator()(const I&)
+    {
+      if(is_not_null(boost::fusion::at<I>(master)))
+        boost::fusion::at<I>(master)->join(*boost::fusion::at<I>(thread));
+    }
+
+    VariablesDataT& master;
+    VariablesDataT& thread;
+  };
+
   /// Delete stored per-variable data
   struct DeleteVariablesData
   {
@@ -66,6 +66,26 @@ struct CoordinatesGrammar :
 {
 };
 
+/// Reals referred to through lit(), which are replaced by a per-thread value if they are reduced in a threaded loop
+struct ScalarReference :
+  boost::proto::transform<ScalarReference>
+{
+  template<typename ExprT, typename StateT, typename DataT>
+  struct impl : boost::proto::transform_impl<ExprT, StateT, DataT>
+  {
+    typedef Real& result_type;
+
+    result_type operator ()(
+                typename impl::expr_param expr
+              , typename impl::state_param state
+              , typename impl::data_param data
+    ) const
+    {
+      return data.scalar(boost::proto::value(expr));
+    }
+  };
+};
+
 /// Handle modification of a field
 struct NodeAssign :
   boost::proto::transform<NodeAssign>
@@ -154,6 +174,11 @@ struct NodeMath;
 struct NodeMathBase :
   boost::proto::or_
   <
+    boost::proto::when
+    <
+      boost::proto::terminal<Real&>,
+      ScalarReference
+    >,
     boost::proto::or_<MathTerminals, ParsedFunctionGrammar, boost::proto::terminal< IndexTag<boost::proto::_> > >, // Scalars and matrices
     // Value of numbered variables
     boost::proto::when
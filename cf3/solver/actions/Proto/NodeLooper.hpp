@@ -7,11 +7,14 @@
 #ifndef cf3_solver_actions_Proto_NodeLooper_hpp
 #define cf3_solver_actions_Proto_NodeLooper_hpp
 
+#include <boost/ptr_container/ptr_vector.hpp>
+
 #include "mesh/Functions.hpp"
 
 #include "FieldSync.hpp"
 #include "NodeData.hpp"
 #include "NodeGrammar.hpp"
+#include "NodeThreading.hpp"
 
 /// @file
 /// Loop over the nodes for a region
@@ -36,10 +39,11 @@ struct NodeLooperDim
 
   typedef NodeData<VariablesT, NbDimsT> DataT;
 
-  NodeLooperDim(const ExprT& expr, mesh::Region& region, VariablesT& variables) :
+  NodeLooperDim(const ExprT& expr, mesh::Region& region, VariablesT& variables, const Uint nb_threads = 1) :
     m_expr(expr),
     m_region(region),
-    m_variables(variables)
+    m_variables(variables),
+    m_nb_threads(nb_threads)
   {
   }
 
@@ -130,16 +134,6 @@ struct NodeLooperDim
     const mesh::Field& coordinates = dict->coordinates();
     DataT node_data(m_variables, m_region, coordinates, m_expr);
 
-    // Wrap things up so that we can store the intermediate product results
-    do_run(WrapExpression()(m_expr, 0, node_data), node_data, *dict);
-  }
-
-private:
-  template<typename FilteredExprT>
-  void do_run(const FilteredExprT& expr, DataT& data, const mesh::Dictionary& dict) const
-  {
-    NodeGrammar grammar;
-
     // Build a list of used entities
     std::vector< Handle<mesh::Entities const> > used_entities;
     BOOST_FOREACH(const mesh::Entities& entities, common::find_components_recursively<mesh::Entities>(m_region))
@@ -147,17 +141,100 @@ private:
       used_entities.push_back(entities.handle<mesh::Entities>());
     }
 
-    boost::shared_ptr< common::List<Uint> > used_nodes_ptr = mesh::build_used_nodes_list(used_entities, dict, true);
-
+    boost::shared_ptr< common::List<Uint> > used_nodes_ptr = mesh::build_used_nodes_list(used_entities, *dict, true);
     const common::List<Uint>& nodes = *used_nodes_ptr;
-    const Uint nb_nodes = nodes.size();
-    for(Uint i = 0; i != nb_nodes; ++i)
+
+    // Split the nodes between the threads, if the expression allows it
+    NodeThreadingInfo threading;
+    std::vector<Uint> chunks;
+    if(m_nb_threads > 1)
+    {
+      const AnalyzeNodeThreading analyze(threading);
+      analyze(m_expr);
+      if(threading.is_thread_safe())
+        node_chunks(nodes, m_nb_threads, chunks);
+    }
+
+    if(chunks.size() < 3)
+    {
+      // Wrap things up so that we can store the intermediate product results
+      run_nodes(WrapExpression()(m_expr, 0, node_data), node_data, nodes, 0, nodes.size());
+      return;
+    }
+
+    // Each thread works on its own copy of the data, joined in node order afterwards
+    const Uint nb_chunks = chunks.size() - 1;
+    boost::ptr_vector<DataT> thread_data;
+    for(Uint i = 0; i != nb_chunks; ++i)
+      thread_data.push_back(new DataT(node_data, threading.reductions));
+
+    std::vector<std::string> errors(nb_chunks);
+    std::vector<NodeThreadPool::TaskT> tasks;
+    tasks.reserve(nb_chunks);
+    for(Uint i = 0; i != nb_chunks; ++i)
+      tasks.push_back(NodeChunk(m_expr, thread_data[i], nodes, chunks[i], chunks[i+1], errors[i]));
+    NodeThreadPool::instance().run(tasks);
+
+    for(Uint i = 0; i != nb_chunks; ++i)
+    {
+      if(!errors[i].empty())
+        throw common::SetupError(FromHere(), "Error evaluating node expression on region " + m_region.uri().path() + ": " + errors[i]);
+    }
+
+    for(Uint i = 0; i != nb_chunks; ++i)
+      node_data.join(thread_data[i]);
+  }
+
+private:
+  template<typename FilteredExprT>
+  static void run_nodes(const FilteredExprT& expr, DataT& data, const common::List<Uint>& nodes, const Uint begin, const Uint end)
+  {
+    NodeGrammar grammar;
+    for(Uint i = begin; i != end; ++i)
     {
       data.set_node(nodes[i]);
       grammar(expr, 0, data); // The "0" is the proto state, which is unused at the top-level expression
     }
   }
 
+  /// Evaluates the expression for a range of the nodes, executed by one thread
+  struct NodeChunk
+  {
+    NodeChunk(const ExprT& expr, DataT& data, const common::List<Uint>& nodes, const Uint begin, const Uint end, std::string& error) :
+      m_expr(expr),
+      m_data(data),
+      m_nodes(nodes),
+      m_begin(begin),
+      m_end(end),
+      m_error(error)
+    {
+    }
+
+    void operator()()
+    {
+      try
+      {
+        // Each thread wraps its own copy, since the wrapped expression stores intermediate results
+        run_nodes(WrapExpression()(m_expr, 0, m_data), m_data, m_nodes, m_begin, m_end);
+      }
+      catch(std::exception& e)
+      {
+        m_error = e.what();
+      }
+      catch(...)
+      {
+        m_error = "unknown exception";
+      }
+    }
+
+    const ExprT& m_expr;
+    DataT& m_data;
+    const common::List<Uint>& m_nodes;
+    const Uint m_begin;
+    const Uint m_end;
+    std::string& m_error;
+  };
+
   struct FindDict
   {
     FindDict(const mesh::Mesh& mesh, Handle<mesh::Dictionary const>& dict) :m_mesh(mesh), m_dict(dict)
@@ -188,6 +265,7 @@ private:
   const ExprT& m_expr;
   mesh::Region& m_region;
   VariablesT& m_variables;
+  const Uint m_nb_threads;
 };
 
 /// Loop over nodes, using static-sized vectors to store coordinates
@@ -197,10 +275,13 @@ struct NodeLooper
   /// Type of a fusion vector that can contain a copy of each variable that is used in the expression
   typedef typename ExpressionProperties<ExprT>::VariablesT VariablesT;
 
-  NodeLooper(const ExprT& expr, mesh::Region& region, VariablesT& variables) :
+  /// @param nb_threads Maximum number of threads to use. Expressions that can't be split between threads are always
+  ///                   evaluated sequentially, see AnalyzeNodeThreading
+  NodeLooper(const ExprT& expr, mesh::Region& region, VariablesT& variables, const Uint nb_threads = 1) :
     m_expr(expr),
     m_region(region),
-    m_variables(variables)
+    m_variables(variables),
+    m_nb_threads(nb_threads)
   {
   }
 
@@ -213,8 +294,16 @@ struct NodeLooper
     if(NbDimsT::value != coords.row_size())
       return;
 
+    // Node loops also visit the ghost nodes, so fields left unsynchronized by previous loops are exchanged first
+    FieldSynchronizer& synchronizer = FieldSynchronizer::instance();
+    if(synchronizer.has_pending())
+    {
+      synchronizer.start_exchange();
+      synchronizer.finish_exchange();
+    }
+
     // Execute with known dimension
-    NodeLooperDim<ExprT, NbDimsT>(m_expr, m_region, m_variables)();
+    NodeLooperDim<ExprT, NbDimsT>(m_expr, m_region, m_variables, m_nb_threads)();
     
     FieldSynchronizer::instance().synchronize();
   }
@@ -224,10 +313,11 @@ private:
   const ExprT& m_expr;
   mesh::Region& m_region;
   VariablesT& m_variables;
+  const Uint m_nb_threads;
 };
 
 template<Uint dim, typename ExprT>
-void for_each_node(mesh::Region& root_region, const ExprT& expr)
+void for_each_node(mesh::Region& root_region, const ExprT& expr, const Uint nb_threads = 1)
 {
   // IF COMPILATION FAILS HERE: the espression passed is invalid
   BOOST_MPL_ASSERT_MSG(
@@ -241,18 +331,19 @@ void for_each_node(mesh::Region& root_region, const ExprT& expr)
   CopyNumberedVars<VariablesT> ctx(vars);
   boost::proto::eval(expr, ctx);
 
-  NodeLooper<ExprT>(expr, root_region, vars)(boost::mpl::int_<dim>());
+  NodeLooper<ExprT>(expr, root_region, vars, nb_threads)(boost::mpl::int_<dim>());
 }
 
 /// Visit all nodes used by root_region exactly once, executing expr
 /// @param variable_names Name of each of the variables, in case a linear system is solved
 /// @param variable_sizes Size (number of scalars) that makes up each variable in the linear system, if any
+/// @param nb_threads Maximum number of threads to use
 template<typename ExprT>
-void for_each_node(mesh::Region& root_region, const ExprT& expr)
+void for_each_node(mesh::Region& root_region, const ExprT& expr, const Uint nb_threads = 1)
 {
-  for_each_node<1>(root_region, expr);
-  for_each_node<2>(root_region, expr);
-  for_each_node<3>(root_region, expr);
+  for_each_node<1>(root_region, expr, nb_threads);
+  for_each_node<2>(root_region, expr, nb_threads);
+  for_each_node<3>(root_region, expr, nb_threads);
 }
 
 
@@ -0,0 +1,107 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#include <boost/bind.hpp>
+
+#include "NodeThreading.hpp"
+
+namespace cf3 {
+namespace solver {
+namespace actions {
+namespace Proto {
+
+NodeThreadPool& NodeThreadPool::instance()
+{
+  static NodeThreadPool pool;
+  return pool;
+}
+
+NodeThreadPool::NodeThreadPool() :
+  m_nb_workers(0),
+  m_tasks(nullptr),
+  m_nb_pending(0),
+  m_generation(0),
+  m_stop(false)
+{
+}
+
+NodeThreadPool::~NodeThreadPool()
+{
+  {
+    boost::mutex::scoped_lock lock(m_mutex);
+    m_stop = true;
+  }
+  m_start.notify_all();
+  m_threads.join_all();
+}
+
+void NodeThreadPool::run(const std::vector<TaskT>& tasks)
+{
+  if(tasks.empty())
+    return;
+
+  boost::mutex::scoped_lock run_lock(m_run_mutex);
+
+  {
+    boost::mutex::scoped_lock lock(m_mutex);
+    // New workers skip the runs that happened before they were started
+    while(m_nb_workers < tasks.size() - 1)
+    {
+      m_threads.create_thread(boost::bind(&NodeThreadPool::work, this, m_nb_workers, m_generation));
+      ++m_nb_workers;
+    }
+    m_tasks = &tasks;
+    m_nb_pending = tasks.size() - 1;
+    ++m_generation;
+  }
+  m_start.notify_all();
+
+  tasks.front()();
+
+  boost::mutex::scoped_lock lock(m_mutex);
+  while(m_nb_pending != 0)
+    m_done.wait(lock);
+  m_tasks = nullptr;
+}
+
+Uint NodeThreadPool::nb_workers() const
+{
+  boost::mutex::scoped_lock lock(m_mutex);
+  return m_nb_workers;
+}
+
+void NodeThreadPool::work(const Uint worker, Uint generation)
+{
+  while(true)
+  {
+    const TaskT* task = nullptr;
+    {
+      boost::mutex::scoped_lock lock(m_mutex);
+      while(!m_stop && m_generation == generation)
+        m_start.wait(lock);
+      if(m_stop)
+        return;
+      generation = m_generation;
+      // Runs with fewer tasks leave the last workers idle, and an idle worker may only wake up after the run ended
+      if(is_not_null(m_tasks) && worker + 1 < m_tasks->size())
+        task = &(*m_tasks)[worker + 1];
+    }
+
+    if(is_null(task))
+      continue;
+
+    (*task)();
+
+    boost::mutex::scoped_lock lock(m_mutex);
+    if(--m_nb_pending == 0)
+      m_done.notify_one();
+  }
+}
+
+} // namespace Proto
+} // namespace actions
+} // namespace solver
+} // namespace cf3
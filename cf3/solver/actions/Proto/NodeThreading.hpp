@@ -0,0 +1,648 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef cf3_solver_actions_Proto_NodeThreading_hpp
+#define cf3_solver_actions_Proto_NodeThreading_hpp
+
+#include <vector>
+
+#include <boost/function.hpp>
+#include <boost/fusion/algorithm/iteration/for_each.hpp>
+#include <boost/mpl/bool.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/proto/core.hpp>
+#include <boost/proto/fusion.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/type_traits/is_arithmetic.hpp>
+#include <boost/type_traits/is_base_of.hpp>
+#include <boost/type_traits/is_const.hpp>
+#include <boost/type_traits/is_empty.hpp>
+#include <boost/type_traits/is_function.hpp>
+#include <boost/type_traits/is_pointer.hpp>
+#include <boost/type_traits/is_reference.hpp>
+#include <boost/type_traits/is_same.hpp>
+#include <boost/type_traits/remove_pointer.hpp>
+#include <boost/type_traits/remove_reference.hpp>
+
+#include "common/List.hpp"
+
+#include "math/LSS/System.hpp"
+#include "math/LSS/Vector.hpp"
+
+#include "ElementOperations.hpp"
+#include "Functions.hpp"
+#include "IndexLooping.hpp"
+#include "LSSWrapper.hpp"
+#include "Terminals.hpp"
+
+/// Size of a cache line in bytes, used to split node loops between threads
+#ifndef CF3_PROTO_CACHE_LINE_SIZE
+  #define CF3_PROTO_CACHE_LINE_SIZE 64
+#endif
+
+/// @file
+/// Support for evaluating node expressions with several threads
+
+namespace cf3 {
+namespace solver {
+namespace actions {
+namespace Proto {
+
+/// A Real, referred to in an expression through lit(), that is updated at each node. Each thread accumulates
+/// its own value, which is combined with the referred Real after the loop.
+struct ScalarReduction
+{
+  enum OpT { SUM, MAX, MIN };
+
+  ScalarReduction(Real& reduced, const OpT reduction_op) :
+    target(&reduced),
+    op(reduction_op),
+    value(0.)
+  {
+  }
+
+  /// Set the initial value for a thread
+  void start()
+  {
+    value = op == SUM ? 0. : *target;
+  }
+
+  /// Combine the value of a thread with the target
+  void finish() const
+  {
+    switch(op)
+    {
+      case SUM:
+        *target += value;
+        break;
+      case MAX:
+        *target = max(*target, value);
+        break;
+      case MIN:
+        *target = min(*target, value);
+        break;
+    }
+  }
+
+  Real* target;
+  OpT op;
+  Real value;
+};
+
+/// Changes to linear systems made by a thread of a node loop. The LSS backends can't be modified concurrently, so the
+/// changes are recorded and applied after the threads finished, in the order of the threads.
+class DeferredLSSWrites
+{
+public:
+  /// Record vector.set_value(row, value)
+  void set_value(math::LSS::Vector& vector, const Uint row, const Real value)
+  {
+    const Write write = { SET_ROW, 0, &vector, row, 0, value };
+    m_writes.push_back(write);
+  }
+
+  /// Record vector.set_value(block_row, eq, value)
+  void set_value(math::LSS::Vector& vector, const Uint block_row, const Uint eq, const Real value)
+  {
+    const Write write = { SET_BLOCK, 0, &vector, block_row, eq, value };
+    m_writes.push_back(write);
+  }
+
+  /// Record lss.dirichlet(block_row, eq, value, true)
+  void dirichlet(math::LSS::System& lss, const Uint block_row, const Uint eq, const Real value)
+  {
+    const Write write = { DIRICHLET, &lss, 0, block_row, eq, value };
+    m_writes.push_back(write);
+  }
+
+  /// Apply and forget the recorded changes
+  void apply()
+  {
+    const Uint nb_writes = m_writes.size();
+    for(Uint i = 0; i != nb_writes; ++i)
+    {
+      const Write& write = m_writes[i];
+      switch(write.type)
+      {
+        case SET_ROW:
+          write.vector->set_value(write.row, write.value);
+          break;
+        case SET_BLOCK:
+          write.vector->set_value(write.row, write.eq, write.value);
+          break;
+        case DIRICHLET:
+          write.system->dirichlet(write.row, write.eq, write.value, true);
+          break;
+      }
+    }
+    m_writes.clear();
+  }
+
+private:
+  enum WriteTypeT { SET_ROW, SET_BLOCK, DIRICHLET };
+
+  struct Write
+  {
+    WriteTypeT type;
+    math::LSS::System* system;
+    math::LSS::Vector* vector;
+    Uint row;
+    Uint eq;
+    Real value;
+  };
+
+  std::vector<Write> m_writes;
+};
+
+/// Result of the analysis of a node expression by AnalyzeNodeThreading
+struct NodeThreadingInfo
+{
+  NodeThreadingInfo() :
+    thread_safe(true),
+    lss_reads(false),
+    lss_writes(false)
+  {
+  }
+
+  /// Register a Real that is updated using op
+  void add_reduction(Real& target, const ScalarReduction::OpT op)
+  {
+    const Uint nb_reductions = reductions.size();
+    for(Uint i = 0; i != nb_reductions; ++i)
+    {
+      if(reductions[i].target == &target)
+      {
+        if(reductions[i].op != op)
+          thread_safe = false;
+        return;
+      }
+    }
+    reductions.push_back(ScalarReduction(target, op));
+  }
+
+  /// True if the expression can be evaluated by several threads
+  bool is_thread_safe() const
+  {
+    if(!thread_safe || (lss_reads && lss_writes))
+      return false;
+
+    // The partial values of a reduction can't be used anywhere else in the expression
+    const Uint nb_reductions = reductions.size();
+    const Uint nb_reads = reads.size();
+    for(Uint i = 0; i != nb_reductions; ++i)
+    {
+      for(Uint j = 0; j != nb_reads; ++j)
+      {
+        if(reductions[i].target == reads[j])
+          return false;
+      }
+    }
+
+    return true;
+  }
+
+  /// False if the expression has side effects that can't be split between threads
+  bool thread_safe;
+  /// Reals that are updated by the expression
+  std::vector<ScalarReduction> reductions;
+  /// Reals that are used by the expression
+  std::vector<const Real*> reads;
+  /// True if values of a linear system are used
+  bool lss_reads;
+  /// True if a linear system is modified
+  bool lss_writes;
+};
+
+/// True if ExprT is a terminal holding a reference to a Real
+template<typename ExprT, typename TagT = typename boost::proto::tag_of<ExprT>::type>
+struct IsRealReference : boost::mpl::false_
+{
+};
+
+template<typename ExprT>
+struct IsRealReference<ExprT, boost::proto::tag::terminal> :
+  boost::is_same<typename ExprT::proto_child0, Real&>
+{
+};
+
+/// True if ExprT is a terminal holding a non-const reference
+template<typename ExprT, typename TagT = typename boost::proto::tag_of<ExprT>::type>
+struct IsMutableReference : boost::mpl::false_
+{
+};
+
+template<typename ExprT>
+struct IsMutableReference<ExprT, boost::proto::tag::terminal> :
+  boost::mpl::bool_
+  <
+    boost::is_reference<typename ExprT::proto_child0>::value &&
+    !boost::is_const<typename boost::remove_reference<typename ExprT::proto_child0>::type>::value
+  >
+{
+};
+
+/// True for the terminal values that several threads can use at once: numbers, Eigen matrices, field variables,
+/// linear systems, index placeholders, the node coordinates, function pointers and FunctionBase functions without
+/// data members. Assignments to references are checked separately by AnalyzeNodeThreading.
+template<typename T>
+struct IsThreadSafeTerminal :
+  boost::mpl::bool_
+  <
+    boost::is_arithmetic<T>::value ||
+    (boost::is_pointer<T>::value && boost::is_function<typename boost::remove_pointer<T>::type>::value) ||
+    (boost::is_base_of<FunctionBase, T>::value && boost::is_empty<T>::value)
+  >
+{
+};
+
+template<int Rows, int Cols, int Options, int MaxRows, int MaxCols>
+struct IsThreadSafeTerminal< Eigen::Matrix<Real, Rows, Cols, Options, MaxRows, MaxCols> > : boost::mpl::true_
+{
+};
+
+template<typename I, typename T>
+struct IsThreadSafeTerminal< Var<I, T> > : boost::mpl::true_
+{
+};
+
+template<typename TagT>
+struct IsThreadSafeTerminal< LSSWrapperImpl<TagT> > : boost::mpl::true_
+{
+};
+
+template<typename I>
+struct IsThreadSafeTerminal< IndexTag<I> > : boost::mpl::true_
+{
+};
+
+template<>
+struct IsThreadSafeTerminal< SFOp<CoordinatesOp> > : boost::mpl::true_
+{
+};
+
+template<>
+struct IsThreadSafeTerminal<ZeroTag> : boost::mpl::true_
+{
+};
+
+template<>
+struct IsThreadSafeTerminal<IdentityTag> : boost::mpl::true_
+{
+};
+
+/// Walks a node expression to find out if it can be evaluated by several threads. This is the case if, apart from
+/// assignments to fields, the expression only:
+///  - uses terminals for which IsThreadSafeTerminal is true, or Reals referred to through lit()
+///  - updates Reals referred to through lit() using x += a, x -= a (sums), x = _max(x, a) or x = _min(x, a)
+///  - either writes to a linear system or reads from one, but not both
+/// Any other terminal, such as a stream, a parsed function, an accumulator or a user-defined functor, keeps the
+/// expression sequential.
+struct AnalyzeNodeThreading
+{
+  typedef Real (*BinaryFunctionT)(Real, Real);
+
+  AnalyzeNodeThreading(NodeThreadingInfo& threading_info) : info(threading_info)
+  {
+  }
+
+  template<typename ExprT>
+  void operator()(const ExprT& expr) const
+  {
+    visit(expr, typename boost::proto::tag_of<ExprT>::type());
+  }
+
+  NodeThreadingInfo& info;
+
+private:
+  /// Recurse into the children
+  template<typename ExprT, typename TagT>
+  void visit(const ExprT& expr, TagT) const
+  {
+    boost::fusion::for_each(expr, *this);
+  }
+
+  template<typename ExprT>
+  void visit(const ExprT& expr, boost::proto::tag::terminal) const
+  {
+    terminal(boost::proto::value(expr));
+  }
+
+  template<typename ExprT>
+  void visit(const ExprT& expr, boost::proto::tag::function) const
+  {
+    if(is_lss(boost::proto::child_c<0>(expr)))
+      info.lss_reads = true;
+    boost::fusion::for_each(expr, *this);
+  }
+
+  template<typename ExprT>
+  void visit(const ExprT& expr, boost::proto::tag::assign) const
+  {
+    assignment(boost::proto::left(expr), boost::proto::right(expr), boost::proto::tag::assign());
+  }
+
+  template<typename ExprT>
+  void visit(const ExprT& expr, boost::proto::tag::plus_assign) const
+  {
+    assignment(boost::proto::left(expr), boost::proto::right(expr), boost::proto::tag::plus_assign());
+  }
+
+  template<typename ExprT>
+  void visit(const ExprT& expr, boost::proto::tag::minus_assign) const
+  {
+    assignment(boost::proto::left(expr), boost::proto::right(expr), boost::proto::tag::minus_assign());
+  }
+
+  // Other modifications of variables are not supported
+  template<typename ExprT> void visit(const ExprT&, boost::proto::tag::multiplies_assign) const { info.thread_safe = false; }
+  template<typename ExprT> void visit(const ExprT&, boost::proto::tag::divides_assign) const { info.thread_safe = false; }
+  template<typename ExprT> void visit(const ExprT&, boost::proto::tag::modulus_assign) const { info.thread_safe = false; }
+  template<typename ExprT> void visit(const ExprT&, boost::proto::tag::pre_inc) const { info.thread_safe = false; }
+  template<typename ExprT> void visit(const ExprT&, boost::proto::tag::pre_dec) const { info.thread_safe = false; }
+  template<typename ExprT> void visit(const ExprT&, boost::proto::tag::post_inc) const { info.thread_safe = false; }
+  template<typename ExprT> void visit(const ExprT&, boost::proto::tag::post_dec) const { info.thread_safe = false; }
+
+  void terminal(Real& value) const
+  {
+    info.reads.push_back(&value);
+  }
+
+  template<typename T>
+  void terminal(const T&) const
+  {
+    if(!IsThreadSafeTerminal<T>::value)
+      info.thread_safe = false;
+  }
+
+  template<typename LeftT, typename RightT, typename TagT>
+  void assignment(const LeftT& left, const RightT& right, TagT) const
+  {
+    assignment(left, right, TagT(), boost::mpl::bool_<IsRealReference<LeftT>::value>());
+  }
+
+  /// Assignment to a field or a linear system
+  template<typename LeftT, typename RightT, typename TagT>
+  void assignment(const LeftT& left, const RightT& right, TagT, boost::mpl::false_) const
+  {
+    if(is_mutable_reference(left))
+      info.thread_safe = false;
+
+    assigned(left, typename boost::proto::tag_of<LeftT>::type(), typename boost::proto::arity_of<LeftT>::type());
+    (*this)(right);
+  }
+
+  /// Visit the left hand side of an assignment
+  template<typename LeftT, typename TagT, typename ArityT>
+  void assigned(const LeftT& left, TagT, ArityT) const
+  {
+    (*this)(left);
+  }
+
+  /// Left hand side of the form lss(u), which writes to the linear system
+  template<typename LeftT>
+  void assigned(const LeftT& left, boost::proto::tag::function, boost::mpl::long_<2>) const
+  {
+    if(is_lss(boost::proto::child_c<0>(left)))
+    {
+      info.lss_writes = true;
+      (*this)(boost::proto::child_c<1>(left));
+    }
+    else
+    {
+      (*this)(left);
+    }
+  }
+
+  template<typename LeftT, typename RightT>
+  void assignment(const LeftT& left, const RightT& right, boost::proto::tag::plus_assign, boost::mpl::true_) const
+  {
+    info.add_reduction(boost::proto::value(left), ScalarReduction::SUM);
+    (*this)(right);
+  }
+
+  template<typename LeftT, typename RightT>
+  void assignment(const LeftT& left, const RightT& right, boost::proto::tag::minus_assign, boost::mpl::true_) const
+  {
+    info.add_reduction(boost::proto::value(left), ScalarReduction::SUM);
+    (*this)(right);
+  }
+
+  template<typename LeftT, typename RightT>
+  void assignment(const LeftT& left, const RightT& right, boost::proto::tag::assign, boost::mpl::true_) const
+  {
+    min_max(boost::proto::value(left), right, typename boost::proto::tag_of<RightT>::type(), typename boost::proto::arity_of<RightT>::type());
+  }
+
+  /// Plain assignment to a Real, which is only supported for x = _max(x, a) and x = _min(x, a)
+  template<typename RightT, typename TagT, typename ArityT>
+  void min_max(Real&, const RightT&, TagT, ArityT) const
+  {
+    info.thread_safe = false;
+  }
+
+  template<typename RightT>
+  void min_max(Real& target, const RightT& right, boost::proto::tag::function, boost::mpl::long_<3>) const
+  {
+    const BinaryFunctionT function = binary_function(boost::proto::child_c<0>(right));
+    const bool first_is_target = refers_to(boost::proto::child_c<1>(right), target);
+    const bool second_is_target = refers_to(boost::proto::child_c<2>(right), target);
+    if((function != &max && function != &min) || (!first_is_target && !second_is_target))
+    {
+      info.thread_safe = false;
+      return;
+    }
+
+    info.add_reduction(target, function == &max ? ScalarReduction::MAX : ScalarReduction::MIN);
+    if(!first_is_target)
+      (*this)(boost::proto::child_c<1>(right));
+    if(!second_is_target)
+      (*this)(boost::proto::child_c<2>(right));
+  }
+
+  template<typename ExprT>
+  static bool refers_to(const ExprT& expr, const Real& target)
+  {
+    return refers_to(expr, target, boost::mpl::bool_<IsRealReference<ExprT>::value>());
+  }
+
+  template<typename ExprT>
+  static bool refers_to(const ExprT& expr, const Real& target, boost::mpl::true_)
+  {
+    return &boost::proto::value(expr) == &target;
+  }
+
+  template<typename ExprT>
+  static bool refers_to(const ExprT&, const Real&, boost::mpl::false_)
+  {
+    return false;
+  }
+
+  template<typename ExprT>
+  static BinaryFunctionT binary_function(const ExprT& expr)
+  {
+    return binary_function(expr, typename boost::proto::tag_of<ExprT>::type());
+  }
+
+  template<typename ExprT>
+  static BinaryFunctionT binary_function(const ExprT& expr, boost::proto::tag::terminal)
+  {
+    return to_binary_function(boost::proto::value(expr));
+  }
+
+  template<typename ExprT, typename TagT>
+  static BinaryFunctionT binary_function(const ExprT&, TagT)
+  {
+    return 0;
+  }
+
+  static BinaryFunctionT to_binary_function(const BinaryFunctionT function)
+  {
+    return function;
+  }
+
+  template<typename T>
+  static BinaryFunctionT to_binary_function(const T&)
+  {
+    return 0;
+  }
+
+  /// True if expr is a terminal holding a non-const reference, or an index into one
+  template<typename ExprT>
+  static bool is_mutable_reference(const ExprT& expr)
+  {
+    return is_mutable_reference(expr, typename boost::proto::tag_of<ExprT>::type());
+  }
+
+  template<typename ExprT>
+  static bool is_mutable_reference(const ExprT&, boost::proto::tag::terminal)
+  {
+    return IsMutableReference<ExprT>::value;
+  }
+
+  template<typename ExprT>
+  static bool is_mutable_reference(const ExprT& expr, boost::proto::tag::subscript)
+  {
+    return is_mutable_reference(boost::proto::left(expr));
+  }
+
+  template<typename ExprT, typename TagT>
+  static bool is_mutable_reference(const ExprT&, TagT)
+  {
+    return false;
+  }
+
+  /// True if expr is a terminal wrapping a linear system
+  template<typename ExprT>
+  static bool is_lss(const ExprT& expr)
+  {
+    return is_lss(expr, typename boost::proto::tag_of<ExprT>::type());
+  }
+
+  template<typename ExprT>
+  static bool is_lss(const ExprT& expr, boost::proto::tag::terminal)
+  {
+    return is_lss_value(boost::proto::value(expr));
+  }
+
+  template<typename ExprT, typename TagT>
+  static bool is_lss(const ExprT&, TagT)
+  {
+    return false;
+  }
+
+  template<typename TagT>
+  static bool is_lss_value(const LSSWrapperImpl<TagT>&)
+  {
+    return true;
+  }
+
+  template<typename T>
+  static bool is_lss_value(const T&)
+  {
+    return false;
+  }
+};
+
+/// Split the list of nodes into at most nb_chunks contiguous ranges of similar size, one for each thread.
+/// The ranges are adjusted so that the field rows of nodes in different ranges never share a cache line,
+/// relative to the start of the field storage.
+/// @param boundaries Filled with the first index of each range, followed by nodes.size()
+inline void node_chunks(const common::List<Uint>& nodes, const Uint nb_chunks, std::vector<Uint>& boundaries)
+{
+  // The rows of this many consecutive nodes fill a whole number of cache lines, whatever the row size
+  static const Uint nodes_per_line = CF3_PROTO_CACHE_LINE_SIZE / sizeof(Real);
+  // Smaller ranges are not worth starting a thread for
+  static const Uint min_chunk_size = 32*nodes_per_line;
+
+  const Uint nb_nodes = nodes.size();
+  const Uint nb_used_chunks = std::max(1u, std::min(nb_chunks, nb_nodes / min_chunk_size));
+
+  boundaries.clear();
+  boundaries.push_back(0);
+  for(Uint i = 1; i < nb_used_chunks; ++i)
+  {
+    Uint boundary = i*nb_nodes/nb_used_chunks;
+    if(boundary <= boundaries.back())
+      continue;
+    while(boundary != nb_nodes && nodes[boundary] / nodes_per_line == nodes[boundary-1] / nodes_per_line)
+      ++boundary;
+    if(boundary == nb_nodes)
+      break;
+    boundaries.push_back(boundary);
+  }
+  boundaries.push_back(nb_nodes);
+}
+
+/// Worker threads that evaluate the node loops. The threads are started by the first loop that needs them and then
+/// wait for the next loop, so a loop does not pay for the creation of its threads.
+class NodeThreadPool : public boost::noncopyable
+{
+public:
+  typedef boost::function<void ()> TaskT;
+
+  /// Singleton implementation
+  static NodeThreadPool& instance();
+
+  ~NodeThreadPool();
+
+  /// Execute the tasks concurrently and return when all of them are finished. The first task runs on the calling
+  /// thread, the others on the workers. Only one set of tasks runs at a time.
+  /// @pre The tasks don't throw
+  void run(const std::vector<TaskT>& tasks);
+
+  /// Number of worker threads that were started so far
+  Uint nb_workers() const;
+
+private:
+  NodeThreadPool();
+
+  /// Main loop of a worker, which executes the task at index worker+1 of each set of tasks
+  void work(const Uint worker, Uint generation);
+
+  /// Serializes the calls to run
+  boost::mutex m_run_mutex;
+  /// Protects the members below
+  mutable boost::mutex m_mutex;
+  boost::condition_variable m_start;
+  boost::condition_variable m_done;
+  boost::thread_group m_threads;
+  Uint m_nb_workers;
+  /// Tasks of the current run, and the number of them that is not finished yet
+  const std::vector<TaskT>* m_tasks;
+  Uint m_nb_pending;
+  /// Incremented for each run, so the workers know there is new work
+  Uint m_generation;
+  bool m_stop;
+};
+
+} // namespace Proto
+} // namespace actions
+} // namespace solver
+} // namespace cf3
+
+#endif // cf3_solver_actions_Proto_NodeThreading_hpp
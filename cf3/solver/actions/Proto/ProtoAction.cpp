@@ -37,9 +37,15 @@ struct ProtoAction::Implementation
 {
   Implementation(Component& comp, const Handle<PhysModel>& physical_model) :
     m_component(comp),
-    m_physical_model(physical_model)
+    m_physical_model(physical_model),
+    m_nb_threads(1)
   {
     m_component.options().option(Tags::physical_model()).attach_trigger(boost::bind(&Implementation::trigger_physical_model, this));
+
+    m_component.options().add("nb_threads", m_nb_threads)
+      .pretty_name("Number of Threads")
+      .description("Maximum number of threads used to loop over nodes. Loops over elements are always sequential.")
+      .link_to(&m_nb_threads);
   }
 
   void trigger_physical_model()
@@ -64,6 +70,8 @@ struct ProtoAction::Implementation
 
   const Handle<PhysModel>& m_physical_model;
 
+  Uint m_nb_threads;
+
   struct PhysicsConstantLink
   {
     PhysicsConstantLink(const Handle<PhysModel>& physical_model, const std::string& constant_name, Real& value, const std::string& parent_path) :
@@ -123,6 +131,7 @@ void ProtoAction::execute()
     if(is_null(m_implementation->m_expression))
       throw SetupError(FromHere(), "Expression for ProtoAction " + uri().path() + " is not set.");
     CFdebug << "  Action " << name() << ": running over region " << region->uri().path() << CFendl;
+    m_implementation->m_expression->set_nb_threads(m_implementation->m_nb_threads);
     m_implementation->m_expression->loop(*region);
   }
 }
@@ -39,7 +39,7 @@ struct SetRHSSetter :
       if(node_idx < 0)
         return;
       const Uint sys_idx = node_idx*data.var_data(boost::proto::value(boost::proto::child_c<1>(expr))).nb_dofs + data.var_data(boost::proto::value(boost::proto::child_c<1>(expr))).offset;
-      boost::proto::value( boost::proto::child_c<0>(expr) ).rhs().set_value(sys_idx, state);
+      data.lss_set_value(boost::proto::value( boost::proto::child_c<0>(expr) ).rhs(), sys_idx, state);
     }
   };
 };
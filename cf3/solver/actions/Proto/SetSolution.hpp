@@ -40,22 +40,22 @@ struct SetSolutionSetter :
       if(node_idx < 0)
         return;
       typedef boost::mpl::int_< VarDataType<typename VarChild<ExprT, 1>::type, DataT>::type::dimension > DimT;
-      set_value(DimT(), state, node_idx, data.var_data(boost::proto::value(boost::proto::child_c<1>(expr))).offset, boost::proto::value( boost::proto::child_c<0>(expr) ).solution());
+      set_value(DimT(), state, node_idx, data.var_data(boost::proto::value(boost::proto::child_c<1>(expr))).offset, boost::proto::value( boost::proto::child_c<0>(expr) ).solution(), data);
     }
 
     template<typename DimT, typename ValueT>
-    void set_value(DimT, const ValueT& val, const Uint node_idx, const Uint var_offset, math::LSS::Vector& vec) const
+    void set_value(DimT, const ValueT& val, const Uint node_idx, const Uint var_offset, math::LSS::Vector& vec, typename impl::data_param data) const
     {
       for(Uint i = 0; i != DimT::value; ++i)
       {
         const Uint eq_idx = var_offset + i;
-        vec.set_value(node_idx, eq_idx, val[i]);
+        data.lss_set_value(vec, node_idx, eq_idx, val[i]);
       }
     }
 
-    void set_value(boost::mpl::int_<1>, const Real val, const Uint node_idx, const Uint eq_idx, math::LSS::Vector& vec) const
+    void set_value(boost::mpl::int_<1>, const Real val, const Uint node_idx, const Uint eq_idx, math::LSS::Vector& vec, typename impl::data_param data) const
     {
-      vec.set_value(node_idx, eq_idx, val);
+      data.lss_set_value(vec, node_idx, eq_idx, val);
     }
 
   };
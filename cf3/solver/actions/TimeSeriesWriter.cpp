@@ -10,6 +10,7 @@
 #include "common/Builder.hpp"
 #include "common/FindComponents.hpp"
 #include "common/OptionList.hpp"
+#include "common/TypeInfo.hpp"
 
 #include "solver/actions/TimeSeriesWriter.hpp"
 #include "solver/Tags.hpp"
@@ -66,6 +67,9 @@ void TimeSeriesWriter::execute()
       boost::algorithm::replace_all(rewritten_path, "{time}", current_time_str);
       boost::algorithm::replace_all(rewritten_path, "{iteration}", current_iter_str);
       action.options().set("file", common::URI(rewritten_path, original_uri.scheme()));
+      // Writers of time series, such as the XDMF writer, take the time of the snapshot
+      if(action.options().check("time") && action.options()["time"].type() == common::class_name<Real>())
+        action.options().set("time", m_time->current_time());
       action.execute();
       action.options().set("file", original_uri); // Set back the original URI, so we can replace the patterns on the next write
     }
@@ -25,6 +25,8 @@ namespace actions {
 /// Filename templates can include {time} (with the{}) to include the current timestep and
 /// {iteration} to include the current iteration number
 /// The interval option controls the number of timesteps after which a solution is to be written
+/// Children with a "time" option of type Real get the current time before each write. Such writers (i.e. the XDMF writer)
+/// append to a single series when the file name contains no template.
 class solver_actions_API TimeSeriesWriter : public common::Action
 {
 public: // functions
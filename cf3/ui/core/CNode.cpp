@@ -681,6 +681,13 @@ void CNode::request_signal_signature(const QString & name)
 
 ////////////////////////////////////////////////////////////////////////////
 
+void CNode::content_outdated()
+{
+  m_content_listed = is_local_component();
+}
+
+////////////////////////////////////////////////////////////////////////////
+
 void CNode::reply_update_tree(SignalArgs & node)
 {
   NTree::global()->update_tree();
@@ -318,6 +318,10 @@ namespace core {
 
     void request_signal_signature(const QString & name);
 
+    /// Marks the content (options, properties and signals) as outdated, so
+    /// that it is fetched again from the server the next time it is needed.
+    void content_outdated();
+
     /// @name Signals
     //@{
 
@@ -10,6 +10,7 @@
 
 #include "common/Signal.hpp"
 #include "common/FindComponents.hpp"
+#include "common/XML/SignalOptions.hpp"
 
 #include "ui/core/TreeThread.hpp"
 #include "ui/core/NetworkQueue.hpp"
@@ -36,7 +37,8 @@ namespace core {
 NTree::NTree(Handle< NRoot > rootNode)
   : CNode(CLIENT_TREE, "NTree", CNode::DEBUG_NODE),
     m_advanced_mode(false),
-    m_debug_mode_enabled(false)
+    m_debug_mode_enabled(false),
+    m_revision(0)
 {
 
   m_root_node = new TreeNode(rootNode, nullptr, 0);
@@ -50,6 +52,10 @@ NTree::NTree(Handle< NRoot > rootNode)
   regist_signal( "list_tree" )
     .description("New tree")
     .pretty_name("").connect(boost::bind(&NTree::list_tree_reply, this, _1));
+
+  regist_signal( "list_tree_diff" )
+    .description("Changes in the tree")
+    .pretty_name("").connect(boost::bind(&NTree::list_tree_diff_reply, this, _1));
 }
 
 ////////////////////////////////////////////////////////////////////////////
@@ -589,6 +595,123 @@ QVariant NTree::headerData(int section, Qt::Orientation orientation,
 ////////////////////////////////////////////////////////////////////////////
 
 void NTree::list_tree_reply(SignalArgs & args)
+{
+  replace_tree( XmlNode(args.main_map.content.content->first_node()) );
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+void NTree::list_tree_diff_reply(SignalArgs & args)
+{
+  SignalOptions options( args );
+
+  m_revision = options.value<Uint>("revision");
+  m_log_id = options.value<std::string>("log_id");
+
+  XmlNode tree_node = args.map("tree").main_map.content;
+
+  if( options.value<bool>("full") )
+    replace_tree( XmlNode(tree_node.content->first_node()) );
+  else
+    apply_tree_diff( args );
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+void NTree::apply_tree_diff(SignalArgs & args)
+{
+  SignalOptions options( args );
+  std::vector<std::string> removed = options.value< std::vector<std::string> >("removed");
+  std::vector<std::string> modified = options.value< std::vector<std::string> >("modified");
+  XmlNode tree_node = args.map("tree").main_map.content;
+
+  emit begin_update_tree();
+  beginResetModel();
+
+  try
+  {
+    URI currentIndexPath;
+
+    if(m_current_index.isValid())
+    {
+      currentIndexPath = index_to_tree_node(m_current_index)->node()->uri();
+    }
+
+    //
+    // remove the deleted nodes
+    //
+    BOOST_FOREACH(const std::string& path, removed)
+    {
+      Handle< CNode > node = node_by_path( URI(path, URI::Scheme::CPATH) );
+
+      if( is_not_null(node) && !node->is_root() && !node->is_local_component() && is_not_null(node->parent()) )
+      {
+        Handle< CNode > parent = node->parent()->handle<CNode>();
+        node->about_to_be_removed();
+        parent->remove_node( node->name().c_str() );
+      }
+    }
+
+    //
+    // add the new nodes, replacing any older version
+    //
+    for(rapidxml::xml_node<>* added = tree_node.content->first_node("added") ; added != nullptr ; added = added->next_sibling("added"))
+    {
+      XmlNode added_node(added);
+      Handle< CNode > parent = node_by_path( URI(added_node.attribute_value("parent"), URI::Scheme::CPATH) );
+
+      if( is_null(parent) || added->first_node() == nullptr )
+        continue;
+
+      boost::shared_ptr< CNode > node = CNode::create_from_xml( XmlNode(added->first_node()) );
+
+      if( node.get() == nullptr )
+        continue;
+
+      Handle< Component > old_node = parent->get_child( node->name() );
+      if( is_not_null(old_node) )
+      {
+        old_node->handle<CNode>()->about_to_be_removed();
+        parent->remove_node( node->name().c_str() );
+      }
+
+      parent->add_node( node );
+      node->setup_finished();
+    }
+
+    //
+    // modified nodes will fetch their content again when it is needed
+    //
+    BOOST_FOREACH(const std::string& path, modified)
+    {
+      Handle< CNode > node = node_by_path( URI(path, URI::Scheme::CPATH) );
+
+      if( is_not_null(node) )
+        node->content_outdated();
+    }
+
+    // child count may have changed, ask the root TreeNode to update its internal data
+    m_root_node->update_child_list();
+
+    // retrieve the previous index, if it still exists
+    if(!currentIndexPath.path().empty())
+      m_current_index = this->index_from_path(currentIndexPath);
+  }
+  catch(XmlError & xe)
+  {
+    NLog::global()->add_exception(xe.what());
+  }
+
+  endResetModel();
+
+  emit end_update_tree();
+
+  emit current_index_changed(m_current_index, QModelIndex());
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+void NTree::replace_tree(XmlNode node)
 {
   //QMutexLocker locker(m_mutex);
   emit begin_update_tree();
@@ -597,7 +720,7 @@ void NTree::list_tree_reply(SignalArgs & args)
   try
   {
     Handle< NRoot > tree_root = m_root_node->node()->castTo<NRoot>();
-    boost::shared_ptr< CNode > root_node = CNode::create_from_xml(args.main_map.content.content->first_node());
+    boost::shared_ptr< CNode > root_node = CNode::create_from_xml(node);
     ComponentIterator<CNode> it = component_begin<CNode>(*root_node->root());
     ComponentIterator<CNode> root_end = component_end<CNode>(*root_node->root());
     URI currentIndexPath;
@@ -677,6 +800,9 @@ void NTree::clear_tree()
 {
   beginResetModel();
 
+  // the next update needs the complete tree
+  m_revision = 0;
+
   //QMutexLocker locker(m_mutex);
 
   Handle< NRoot > treeRoot = m_root_node->node()->castTo<NRoot>();
@@ -741,7 +867,13 @@ void NTree::content_listed(Handle< Component > node)
 
 void NTree::update_tree()
 {
-  SignalFrame frame("list_tree", CLIENT_TREE_PATH, SERVER_ROOT_PATH);
+  // ask only for the changes since the last update, the server sends the complete tree if needed
+  SignalOptions options;
+
+  options.add("revision", m_revision);
+  options.add("log_id", m_log_id);
+
+  SignalFrame frame = options.create_frame("list_tree_diff", CLIENT_TREE_PATH, SERVER_ROOT_PATH);
   NetworkQueue::global()->send( frame );
 }
 
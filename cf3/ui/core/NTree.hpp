@@ -300,6 +300,13 @@ namespace core {
     /// @param node New tree
     void list_tree_reply(cf3::common::SignalArgs & node);
 
+    /// @brief Signal called with the changes in the tree since the last update
+
+    /// If the server could not provide the changes, the reply contains the
+    /// complete tree.
+    /// @param node The changes, or the new tree
+    void list_tree_diff_reply(cf3::common::SignalArgs & node);
+
     /// @} END Signals
 
     void content_listed(Handle< Component > node);
@@ -361,6 +368,21 @@ namespace core {
     /// @brief Mutex to control concurrent access.
     QMutex * m_mutex;
 
+    /// @brief Revision of the server tree the client tree corresponds to.
+    /// 0 if the tree was never received.
+    cf3::Uint m_revision;
+
+    /// @brief Identifier of the server tree change log the revision refers to
+    std::string m_log_id;
+
+    /// @brief Replaces all remote nodes by the tree in the given XML node
+    /// @param node XML node of the root component
+    void replace_tree(common::XML::XmlNode node);
+
+    /// @brief Applies the changes listed in a @c list_tree_diff reply
+    /// @param args The reply
+    void apply_tree_diff(cf3::common::SignalArgs & args);
+
     /// @brief Converts an index to a tree node
 
     /// @param index Node index to convert
@@ -79,7 +79,9 @@ int main(int argc, char *argv[])
     // cf_env.set_mpi_hostfile("./machine.txt"); // must be called before MPI_Init !
     cf_env.initiate ( argc, argv );        // initiate the environemnt
 
-    PE::Comm::instance().init( argc, argv );
+    // the worker groups are listened to in a separate thread, which needs MPI_THREAD_MULTIPLE.
+    // Without workers there is no listening thread, so the default level is enough.
+    PE::Comm::instance().init( argc, argv, nb_workers != 0 ? MPI_THREAD_MULTIPLE : MPI_THREAD_SINGLE );
     ServerRoot::instance().root();
 
     if( Comm::instance().size() != 1 )
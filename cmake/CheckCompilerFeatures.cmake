@@ -293,6 +293,18 @@ include(CheckNullPtr)
 
   check_function_exists(gettimeofday  CF3_HAVE_GETTIMEOFDAY)
 
+#######################################################################################
+
+  # hardware performance counters, used by the benchmarks
+  check_include_file( linux/perf_event.h CF3_HAVE_PERF_EVENT_H )
+
+  coolfluid_log_file( "+++++  Checking for the linux/perf_event.h header -- ${CF3_HAVE_PERF_EVENT_H}" )
+
+  # memory advice for large tables, such as transparent huge pages
+  check_include_file( sys/mman.h CF3_HAVE_SYS_MMAN_H )
+
+  coolfluid_log_file( "+++++  Checking for the sys/mman.h header -- ${CF3_HAVE_SYS_MMAN_H}" )
+
 #######################################################################################
 # Win32 specific
 #######################################################################################
@@ -46,6 +46,7 @@ option( CF3_ENABLE_COMPONENT_TIMING   "Enables global timing of action execution
 option( CF3_ENABLE_UNIT_TESTS        "Enable creation of unit tests"    ON  )
 option( CF3_ENABLE_PERFORMANCE_TESTS "Run the performance tests"        OFF )
 option( CF3_ENABLE_ACCEPTANCE_TESTS  "Run the acceptance tests"         ON  )
+option( CF3_ENABLE_BENCHMARKS        "Build the benchmark suite"        OFF )
 
 option( CF3_INSTALL_UNIT_TESTS       "Enable testing applications install"   OFF )
 
@@ -44,3 +44,10 @@ coolfluid_set_package( PACKAGE CGNS
                        TYPE OPTIONAL
                        VARS CGNS_INCLUDE_DIRS CGNS_LIBRARIES
                        QUIET )
+
+# parallel CGNS (pcgnslib.h) is only available when CGNS was built with parallel HDF5
+if( CF3_HAVE_CGNS AND EXISTS ${CGNS_INCLUDE_DIRS}/pcgnslib.h )
+  set( CF3_HAVE_PCGNS 1 CACHE BOOL "Found parallel CGNS" )
+else()
+  set( CF3_HAVE_PCGNS 0 )
+endif()
@@ -13,6 +13,8 @@
 #include "cf3/common/Log.hpp"
 #include "cf3/common/Core.hpp"
 #include "cf3/common/Environment.hpp"
+#include "cf3/physics/lineuler/Cons2D.hpp"
+#include "cf3/physics/lineuler/LinEuler2D.hpp"
 #include "cf3/physics/lineuler/lineuler2d/Functions.hpp"
 
 using namespace std;
@@ -105,6 +107,57 @@ BOOST_AUTO_TEST_CASE( Test_LinEuler2d_riemann )
 
 ////////////////////////////////////////////////////////////////////////////////
 
+BOOST_AUTO_TEST_CASE( Test_LinEuler2d_static_kernel )
+{
+  using namespace cf3::physics::LinEuler;
+  typedef Cons2D::Kernel KernelT;
+
+  boost::shared_ptr<LinEuler2D> model = allocate_component<LinEuler2D>("model");
+  boost::shared_ptr<Cons2D> vars = allocate_component<Cons2D>("vars");
+  KernelT kernel(*model);
+
+  const Uint nb_states = 3;
+  std::vector<KernelT::GeoV, Eigen::aligned_allocator<KernelT::GeoV> > coords(nb_states), normals(nb_states);
+  std::vector<KernelT::SolV, Eigen::aligned_allocator<KernelT::SolV> > states(nb_states), fluxes(nb_states), evalues(nb_states);
+  std::vector<KernelT::SolM, Eigen::aligned_allocator<KernelT::SolM> > gradients(nb_states), flux_matrices(nb_states);
+  for(Uint i = 0; i != nb_states; ++i)
+  {
+    coords[i] << i, 0.5*i;
+    normals[i] << 1., i;
+    states[i] << 0.1*(i+1), 0.2, 0.3*i, 0.4;
+    gradients[i].setConstant(0.1*i);
+  }
+
+  kernel.flux(nb_states, &coords[0], &states[0], &gradients[0], &flux_matrices[0]);
+  kernel.flux(nb_states, &coords[0], &states[0], &gradients[0], &normals[0], &fluxes[0]);
+  kernel.flux_jacobian_eigen_values(nb_states, &coords[0], &states[0], 0, &normals[0], &evalues[0]);
+
+  // Compare with the dynamically sized interface
+  physics::Variables& dynamic_vars = *vars;
+  std::auto_ptr<physics::Properties> props = model->create_properties();
+  for(Uint i = 0; i != nb_states; ++i)
+  {
+    RealVector coord = coords[i], state = states[i], normal = normals[i];
+    RealMatrix grad = gradients[i];
+    dynamic_vars.compute_properties(coord, state, grad, *props);
+
+    RealMatrix flux_matrix(4, 2);
+    RealVector flux(4), ev(4);
+    dynamic_vars.flux(*props, flux_matrix);
+    dynamic_vars.flux(*props, normal, flux);
+    dynamic_vars.flux_jacobian_eigen_values(*props, normal, ev);
+    for(Uint j = 0; j != 4; ++j)
+    {
+      BOOST_CHECK_CLOSE(flux[j], fluxes[i][j], 1e-12);
+      BOOST_CHECK_CLOSE(ev[j], evalues[i][j], 1e-12);
+      for(Uint d = 0; d != 2; ++d)
+        BOOST_CHECK_CLOSE(flux_matrix(j, d), flux_matrices[i](j, d), 1e-12);
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 BOOST_AUTO_TEST_SUITE_END()
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -14,6 +14,8 @@
 #include "common/Signal.hpp"
 #include "common/Builder.hpp"
 #include "common/OptionT.hpp"
+#include "common/Core.hpp"
+#include "common/EventHandler.hpp"
 
 #include "common/XML/SignalOptions.hpp"
 
@@ -22,13 +24,18 @@
 
 #include "math/LSS/System.hpp"
 
+#include "mesh/Connectivity.hpp"
 #include "mesh/Dictionary.hpp"
+#include "mesh/ElementType.hpp"
 #include "mesh/Elements.hpp"
 #include "mesh/Entities.hpp"
 #include "mesh/Field.hpp"
 #include "mesh/Mesh.hpp"
 #include "mesh/Region.hpp"
 #include "mesh/ConnectivityData.hpp"
+#include "mesh/ShapeFunction.hpp"
+#include "mesh/Space.hpp"
+#include "mesh/Tags.hpp"
 
 #include "physics/PhysModel.hpp"
 
@@ -58,7 +65,21 @@ AdjacentCellToFace::AdjacentCellToFace(const std::string& name) : solver::Action
 
   options().add("field_tag", "")
     .pretty_name("Field Tag")
-    .description("Tag for the field in which the initial conditions will be set");
+    .description("Tag for the field in which the initial conditions will be set")
+    .attach_trigger(boost::bind(&AdjacentCellToFace::trigger_tags, this));
+
+  options().add("source_field_tag", "")
+    .pretty_name("Source Field Tag")
+    .description("Tag for the field containing source_variable")
+    .attach_trigger(boost::bind(&AdjacentCellToFace::trigger_tags, this));
+
+  options().add("source_variable", "")
+    .pretty_name("Source Variable")
+    .description("If set, store the gradient of this scalar variable in the adjacent element, evaluated at its centroid, "
+                 "in the first columns of field_tag on the surface elements, instead of copying the element values of field_tag")
+    .attach_trigger(boost::bind(&AdjacentCellToFace::trigger_tags, this));
+
+  Core::instance().event_handler().connect_to_event(mesh::Tags::event_mesh_changed(), this, &AdjacentCellToFace::on_mesh_changed);
 }
 
 AdjacentCellToFace::~AdjacentCellToFace()
@@ -67,6 +88,8 @@ AdjacentCellToFace::~AdjacentCellToFace()
 
 void AdjacentCellToFace::on_regions_set()
 {
+  m_transfers.clear();
+
   if(m_loop_regions.empty())
     return;
 
@@ -106,32 +129,156 @@ void AdjacentCellToFace::on_regions_set()
 }
 
 
-void AdjacentCellToFace::execute()
+void AdjacentCellToFace::on_mesh_changed(SignalArgs& args)
+{
+  if(m_loop_regions.empty() || is_null(m_loop_regions.front()))
+  {
+    m_transfers.clear();
+    return;
+  }
+
+  SignalOptions options(args);
+  const URI mesh_uri = options.value<URI>("mesh_uri");
+  if(common::find_parent_component<mesh::Mesh>(*m_loop_regions.front()).uri() != mesh_uri)
+    return;
+
+  // The face to cell connectivity and the field rows are no longer valid
+  BOOST_FOREACH(const Handle<Region>& region, m_loop_regions)
+  {
+    if(is_null(region))
+      continue;
+    BOOST_FOREACH(Elements& elements, find_components_recursively_with_filter<Elements>(*region, IsElementsSurface()))
+    {
+      Handle<Component> face_conn = find_component_ptr_with_tag(elements, "face_to_cell_connectivity");
+      if(is_not_null(face_conn))
+        elements.remove_component(*face_conn);
+    }
+  }
+
+  on_regions_set();
+}
+
+void AdjacentCellToFace::trigger_tags()
+{
+  m_transfers.clear();
+}
+
+void AdjacentCellToFace::build_transfers()
 {
   const std::string field_tag = options()["field_tag"].value<std::string>();
   if(field_tag.empty())
     throw common::SetupError(FromHere(), "field_tag option is not set for " + uri().path());
 
+  const std::string source_variable = options()["source_variable"].value<std::string>();
+  const bool compute_gradient = !source_variable.empty();
+  const std::string source_field_tag = compute_gradient ? options()["source_field_tag"].value<std::string>() : field_tag;
+  if(source_field_tag.empty())
+    throw common::SetupError(FromHere(), "source_field_tag option is not set for " + uri().path());
+
+  m_transfers.clear();
+  m_transfers.reserve(m_loop_regions.size());
   BOOST_FOREACH(const Handle<Region>& region, m_loop_regions)
   {
     mesh::Mesh& mesh = common::find_parent_component<mesh::Mesh>(*region);
-    mesh::Field& field = common::find_component_recursively_with_tag<mesh::Field>(mesh, field_tag);
+    m_transfers.push_back(Transfer());
+    Transfer& transfer = m_transfers.back();
+    transfer.target = find_component_recursively_with_tag<mesh::Field>(mesh, field_tag).handle<mesh::Field>();
+    transfer.source = find_component_recursively_with_tag<mesh::Field>(mesh, source_field_tag).handle<mesh::Field>();
+    const mesh::Field& target = *transfer.target;
+    const mesh::Field& source = *transfer.source;
+    const Uint source_offset = compute_gradient ? source.descriptor().offset(source_variable) : 0;
+
+    transfer.entries_begin.push_back(0);
     BOOST_FOREACH(Elements& elements, find_components_recursively_with_filter<Elements>(*region, IsElementsSurface()))
     {
       CFaceConnectivity& face_conn = find_component_with_tag<CFaceConnectivity>(elements, "face_to_cell_connectivity");
-      const Uint own_field_elements_begin = field.dict().space(elements).connectivity()[0][0];
+      const Connectivity& target_conn = target.dict().space(elements).connectivity();
       const Uint nb_elems = elements.size();
       for(Uint i = 0; i != nb_elems; ++i)
       {
         cf3_assert(face_conn.has_adjacent_element(i, 0));
         const CFaceConnectivity::ElementReferenceT adj_elem = face_conn.adjacent_element(i, 0);
-        const Uint other_field_elements_begin = field.dict().space(*adj_elem.first).connectivity()[0][0];
-        field.set_row(own_field_elements_begin + i, field[other_field_elements_begin + adj_elem.second]);
+        const Uint target_row = target_conn[i][0];
+        const Connectivity::ConstRow source_nodes = source.dict().space(*adj_elem.first).connectivity()[adj_elem.second];
+
+        if(!compute_gradient)
+        {
+          // Straight copy of the element row
+          const Uint row_size = target.row_size();
+          for(Uint j = 0; j != row_size; ++j)
+          {
+            transfer.target_rows.push_back(target_row);
+            transfer.target_cols.push_back(j);
+            transfer.source_rows.push_back(source_nodes[0]);
+            transfer.source_cols.push_back(j);
+            transfer.weights.push_back(1.);
+            transfer.entries_begin.push_back(transfer.source_rows.size());
+          }
+          continue;
+        }
+
+        // Gradient at the centroid: J^-1 * dN/dxi, with the jacobian from the geometry and dN/dxi from the source space
+        const ElementType& etype = adj_elem.first->element_type();
+        const ShapeFunction& source_sf = source.dict().space(*adj_elem.first).shape_function();
+        const Uint dim = etype.dimension();
+        if(etype.dimensionality() != dim)
+          throw common::NotSupported(FromHere(), "Gradient transfer in " + uri().path() + " needs volume elements next to the boundary, but " + adj_elem.first->uri().path() + " has dimensionality " + common::to_str(etype.dimensionality()));
+        if(target.row_size() < dim)
+          throw common::SetupError(FromHere(), "Field " + target.uri().path() + " is too small to store a gradient");
+
+        const RealVector centroid = etype.shape_function().local_coordinates().colwise().mean().transpose();
+        const RealMatrix nodes = adj_elem.first->geometry_space().get_coordinates(adj_elem.second);
+        const RealMatrix gradient = etype.jacobian(centroid, nodes).inverse() * source_sf.gradient(centroid);
+
+        const Uint nb_nodes = source_nodes.size();
+        for(Uint d = 0; d != dim; ++d)
+        {
+          transfer.target_rows.push_back(target_row);
+          transfer.target_cols.push_back(d);
+          for(Uint n = 0; n != nb_nodes; ++n)
+          {
+            transfer.source_rows.push_back(source_nodes[n]);
+            transfer.source_cols.push_back(source_offset);
+            transfer.weights.push_back(gradient(d, n));
+          }
+          transfer.entries_begin.push_back(transfer.source_rows.size());
+        }
       }
     }
   }
 }
 
+void AdjacentCellToFace::execute()
+{
+  // Rebuild if the fields were recreated since the last execution
+  BOOST_FOREACH(const Transfer& transfer, m_transfers)
+  {
+    if(is_null(transfer.target) || is_null(transfer.source))
+    {
+      m_transfers.clear();
+      break;
+    }
+  }
+
+  if(m_transfers.empty())
+    build_transfers();
+
+  BOOST_FOREACH(const Transfer& transfer, m_transfers)
+  {
+    mesh::Field& target = *transfer.target;
+    const mesh::Field& source = *transfer.source;
+    const Uint nb_entries = transfer.target_rows.size();
+    for(Uint i = 0; i != nb_entries; ++i)
+    {
+      Real value = 0.;
+      const Uint entries_end = transfer.entries_begin[i+1];
+      for(Uint k = transfer.entries_begin[i]; k != entries_end; ++k)
+        value += transfer.weights[k] * source[transfer.source_rows[k]][transfer.source_cols[k]];
+      target[transfer.target_rows[i]][transfer.target_cols[i]] = value;
+    }
+  }
+}
+
 
 
 } // UFEM
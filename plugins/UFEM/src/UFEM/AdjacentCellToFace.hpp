@@ -8,16 +8,23 @@
 #define cf3_UFEM_AdjacentCellToFace_hpp
 
 
+#include <vector>
+
 #include "solver/Action.hpp"
 
 #include "LibUFEM.hpp"
 
 namespace cf3 {
-  namespace mesh { class CNodeConnectivity; }
+  namespace mesh { class CNodeConnectivity; class Field; }
 namespace UFEM {
 
 /// Copy field values from elements adjacent to a surface patch to the corresponding surface patch
 /// Useful to store values from element fields in the boundary elements for later use
+/// If the source_variable option is set, the gradient of that variable in the adjacent element, evaluated at the element centroid,
+/// is stored instead. This avoids computing the gradient in the whole adjacent region when only the boundary needs it.
+/// The adjacent elements are matched once, and the transfer is stored as a sparse operator from the rows of the source field
+/// to the rows of the surface elements, so each execution is a single sparse product. The operator is rebuilt when the
+/// regions or the tags change, when the fields are recreated or when the mesh changes.
 class UFEM_API AdjacentCellToFace : public solver::Action
 {
 
@@ -37,7 +44,32 @@ public: // functions
 private:
   virtual void on_regions_set();
 
+  /// Forget the transfer operators, so they are rebuilt on the next execution
+  void trigger_tags();
+
+  /// Build the transfer operators for the current regions and tags
+  void build_transfers();
+
+  /// Rebuild the face connectivity and forget the transfer operators when the mesh of the regions changed
+  void on_mesh_changed(common::SignalArgs& args);
+
   Handle<mesh::CNodeConnectivity> m_node_connectivity;
+
+  /// Sparse transfer operator for one region. Entry i of the target field is set to the sum over k in
+  /// [entries_begin[i], entries_begin[i+1]) of weights[k] * source(source_rows[k], source_cols[k])
+  struct Transfer
+  {
+    Handle<mesh::Field> target;
+    Handle<mesh::Field const> source;
+    std::vector<Uint> target_rows;
+    std::vector<Uint> target_cols;
+    std::vector<Uint> entries_begin;
+    std::vector<Uint> source_rows;
+    std::vector<Uint> source_cols;
+    std::vector<Real> weights;
+  };
+
+  std::vector<Transfer> m_transfers;
 };
 
 } // UFEM
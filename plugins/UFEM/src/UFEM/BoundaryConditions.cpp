@@ -9,6 +9,7 @@
 
 #include "common/FindComponents.hpp"
 #include "common/Foreach.hpp"
+#include "common/Link.hpp"
 #include "common/Log.hpp"
 #include "common/OptionArray.hpp"
 #include "common/Signal.hpp"
@@ -73,6 +74,12 @@ struct BoundaryConditions::Implementation
       .link_to(&m_physical_model);
   }
 
+  /// Tag for the actions that only set Dirichlet conditions, so they can be applied as a batch
+  static const char* dirichlet_tag()
+  {
+    return "dirichlet_bc";
+  }
+
   boost::shared_ptr< Action > create_constant_scalar_bc(const std::string& region_name, const std::string& variable_name)
   {
     FieldVariable<0, ScalarField> var(variable_name, m_solution_tag);
@@ -225,6 +232,47 @@ BoundaryConditions::~BoundaryConditions()
 {
 }
 
+void BoundaryConditions::execute()
+{
+  Handle<LSS::System> lss = options().value< Handle<LSS::System> >("lss");
+  if(is_null(lss) || !lss->is_created())
+  {
+    ActionDirector::execute();
+    return;
+  }
+
+  // The per-node dirichlet calls of consecutive Dirichlet BCs are collected and applied together. The batch is closed
+  // before any other action, so all actions see the system in the order in which they were added.
+  bool in_batch = false;
+  try
+  {
+    BOOST_FOREACH(Component& child, *this)
+    {
+      Handle<Action> action(follow_link(child));
+      if(is_null(action) || is_disabled(action->name()))
+        continue;
+
+      const bool is_dirichlet = action->has_tag(Implementation::dirichlet_tag());
+      if(is_dirichlet && !in_batch)
+        lss->begin_constraint_batch();
+      else if(!is_dirichlet && in_batch)
+        lss->end_constraint_batch();
+      in_batch = is_dirichlet;
+
+      CFdebug << name() << ": Executing action " << action->uri().path() << CFendl;
+      action->execute();
+    }
+  }
+  catch(...)
+  {
+    if(in_batch)
+      lss->end_constraint_batch();
+    throw;
+  }
+  if(in_batch)
+    lss->end_constraint_batch();
+}
+
 Handle<common::Action> BoundaryConditions::add_constant_bc(const std::string& region_name, const std::string& variable_name)
 {
   const VariablesDescriptor& descriptor = find_component_with_tag<VariablesDescriptor>(m_implementation->physical_model().variable_manager(), m_implementation->m_solution_tag);
@@ -233,7 +281,7 @@ Handle<common::Action> BoundaryConditions::add_constant_bc(const std::string& re
     m_implementation->create_constant_scalar_bc(region_name, variable_name) :
     m_implementation->create_constant_vector_bc(region_name, variable_name);
 
-
+  result->add_tag(Implementation::dirichlet_tag());
   add_component(result); // Append action
 
   m_implementation->configure_bc(*result, region_name);
@@ -256,6 +304,7 @@ Handle< common::Action > BoundaryConditions::add_constant_component_bc(const std
   boost::shared_ptr< common::Action > result = create_proto_action("BC"+region_name+variable_name,
                                                 nodes_expression(m_implementation->dirichlet(var[component_idx]) = value));
 
+  result->add_tag(Implementation::dirichlet_tag());
   add_component(result);
   m_implementation->configure_bc(*result, region_name);
 
@@ -266,6 +315,7 @@ Handle< common::Action > BoundaryConditions::add_constant_component_bc(const std
 Handle< common::Action > BoundaryConditions::add_function_bc(const std::string& region_name, const std::string& variable_name)
 {
   Handle<ParsedFunctionExpression> result = create_component<ParsedFunctionExpression>("BC"+region_name+variable_name);
+  result->add_tag(Implementation::dirichlet_tag());
 
   const VariablesDescriptor& descriptor = find_component_with_tag<VariablesDescriptor>(m_implementation->physical_model().variable_manager(), m_implementation->m_solution_tag);
 
@@ -63,6 +63,9 @@ public: // functions
 
   void set_solution_tag(const std::string& solution_tag);
 
+  /// Execute all boundary conditions, applying the Dirichlet and periodic constraints on the LSS in a single pass at the end
+  virtual void execute();
+
 private:
   class Implementation;
   boost::scoped_ptr<Implementation> m_implementation;
@@ -56,11 +56,12 @@ HeatCouplingFlux::HeatCouplingFlux(const std::string& name) :
     .description("Tag for the temperature field in the region where the gradient needs to be calculated")
     .attach_trigger(boost::bind(&HeatCouplingFlux::trigger_setup, this));
 
-  // First compute the gradient
+  // Compute the gradient in the whole gradient region, e.g. for output
   create_static_component<ProtoAction>("ComputeGradient");
-  // Then set the gradient on the boundary elements, and configure its tag
+  // Set the gradient of the temperature in the adjacent cells on the boundary elements, and configure its tag
   Handle<AdjacentCellToFace> set_boundary_gradient = create_static_component<AdjacentCellToFace>("SetBoundaryGradient");
   set_boundary_gradient->options().set("field_tag", std::string("gradient_field"));
+  set_boundary_gradient->options().set("source_variable", std::string("Temperature"));
   // Finally set the boundary condition
   create_static_component<ProtoAction>("NeumannHeatFlux");
 }
@@ -100,6 +101,8 @@ void HeatCouplingFlux::trigger_setup()
   Handle<AdjacentCellToFace> set_boundary_gradient(get_child("SetBoundaryGradient"));
   Handle<ProtoAction> neumann_heat_flux(get_child("NeumannHeatFlux"));
 
+  set_boundary_gradient->options().set("source_field_tag", temperature_field_tag);
+
   // Represents the temperature field, as calculated
   FieldVariable<0, ScalarField> T("Temperature", temperature_field_tag);
   // Represents the gradient of the temperature, to be stored in an (element based) field
@@ -25,6 +25,9 @@ namespace UFEM {
 /// is calculated
 /// The "lss" option determines the linear system to which the boundary condition is applied
 /// The "temperature_field_tag" option determines the tag to use when looking for the temperature field
+/// The gradient on the boundary is computed from the cells next to the boundary, through a transfer operator that is built once
+/// (see AdjacentCellToFace). Add "ComputeGradient" to the "disabled_actions" option to skip computing it
+/// in the whole gradient region when it is not needed elsewhere.
 class UFEM_API HeatCouplingFlux : public solver::ActionDirector
 {
 public:
@@ -23,6 +23,7 @@
 #include "mesh/Field.hpp"
 
 #include "solver/Tags.hpp"
+#include "solver/actions/Proto/FieldSync.hpp"
 #include "solver/actions/Proto/ProtoAction.hpp"
 
 #include "physics/PhysModel.hpp"
@@ -43,6 +44,25 @@ using namespace solver::actions::Proto;
 
 common::ComponentBuilder < LSSAction, common::ActionDirector, LibUFEM > LSSAction_Builder;
 
+namespace detail
+{
+  /// Sets the deferred mode of the field synchronizer, restoring the previous mode when going out of scope
+  struct DeferSynchronization
+  {
+    DeferSynchronization(const bool deferred) : m_previous(FieldSynchronizer::instance().deferred())
+    {
+      FieldSynchronizer::instance().set_deferred(deferred || m_previous);
+    }
+
+    ~DeferSynchronization()
+    {
+      FieldSynchronizer::instance().set_deferred(m_previous);
+    }
+
+    const bool m_previous;
+  };
+}
+
 struct LSSAction::Implementation
 {
   Implementation(Component& comp) :
@@ -112,6 +132,12 @@ LSSAction::LSSAction(const std::string& name) :
     .pretty_name("Solution Strategy")
     .description("Builder to use when creating the initial LSS solution strategy")
     .mark_basic();
+
+  options().add("pipelined", false)
+    .pretty_name("Pipelined")
+    .description("Do not wait for the ghost values of the fields updated by this action. They are exchanged at the start of the next element loop "
+                 "(usually the assembly of the next step), while that loop processes the elements that do not touch ghost nodes. "
+                 "Actions that read ghost values outside of Proto element loops may see the values of the previous step.");
 }
 
 LSSAction::~LSSAction()
@@ -127,6 +153,7 @@ void LSSAction::execute()
 
   CFdebug << "Running with LSS " << options().option("lss").value_str() << CFendl;
 
+  detail::DeferSynchronization defer(options().option("pipelined").value<bool>());
   solver::ActionDirector::execute();
 }
 
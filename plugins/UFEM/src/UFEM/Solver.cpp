@@ -33,6 +33,7 @@
 #include "physics/PhysModel.hpp"
 
 #include "InitialConditions.hpp"
+#include "LSSAction.hpp"
 #include "Solver.hpp"
 #include "SparsityBuilder.hpp"
 #include "Tags.hpp"
@@ -346,6 +347,14 @@ void Solver::mesh_loaded(mesh::Mesh& mesh)
 void Solver::mesh_changed(Mesh& mesh)
 {
   CFdebug << "UFEM::Solver: Reacting to mesh_changed signal" << CFendl;
+
+  // Linear systems built for the previous mesh have the wrong sparsity, they are rebuilt when the dictionary is set
+  BOOST_FOREACH(LSSAction& lss_action, find_components_recursively<LSSAction>(*this))
+  {
+    Handle<math::LSS::System> lss = lss_action.options().value< Handle<math::LSS::System> >("lss");
+    if(is_not_null(lss) && lss->is_created())
+      lss->destroy();
+  }
   configure_option_recursively("dictionary", mesh.geometry_fields().handle<Dictionary>());
   m_need_field_creation = true;
 }
@@ -29,14 +29,20 @@
 
 #include "mesh/LagrangeP1/Line1D.hpp"
 #include "solver/Model.hpp"
+#include "solver/ModelUnsteady.hpp"
+#include "solver/Time.hpp"
 
 #include "math/LSS/SolveLSS.hpp"
+#include "math/LSS/ZeroLSS.hpp"
 #include "solver/actions/Proto/ProtoAction.hpp"
 #include "solver/actions/Proto/Expression.hpp"
+#include "solver/actions/Proto/FieldSync.hpp"
 
 #include "Tools/MeshGeneration/MeshGeneration.hpp"
 
+#include "UFEM/BoundaryConditions.hpp"
 #include "UFEM/LSSAction.hpp"
+#include "UFEM/LSSActionUnsteady.hpp"
 #include "UFEM/Solver.hpp"
 #include "UFEM/Tags.hpp"
 
@@ -74,6 +80,52 @@ struct ProtoHeatFixture
 
 };
 
+/// Add an unsteady heat conduction solver for the given variable, which must be the only one with the given tag
+Handle<UFEM::LSSActionUnsteady> add_unsteady_heat(UFEM::Solver& solver, const std::string& variable_name, const std::string& tag, const bool pipelined)
+{
+  Handle<UFEM::LSSActionUnsteady> lss_action(solver.add_unsteady_solver("cf3.UFEM.LSSActionUnsteady"));
+  lss_action->rename(variable_name + "Solver");
+  lss_action->set_solution_tag(tag);
+  lss_action->options().set("pipelined", pipelined);
+
+  FieldVariable<0, ScalarField> temperature(variable_name, tag);
+  boost::mpl::vector1<mesh::LagrangeP1::Quad2D> allowed_elements;
+
+  boost::shared_ptr<UFEM::BoundaryConditions> bc = allocate_component<UFEM::BoundaryConditions>("BoundaryConditions");
+  bc->set_solution_tag(tag);
+
+  // The RHS uses the temperature of the previous step, including the ghost values
+  *lss_action
+    << allocate_component<math::LSS::ZeroLSS>("ZeroLSS")
+    << create_proto_action
+    (
+      "Assembly",
+      elements_expression
+      (
+        allowed_elements,
+        group
+        (
+          _A = _0, _T = _0,
+          element_quadrature
+          (
+            _A(temperature) += transpose(nabla(temperature)) * nabla(temperature),
+            _T(temperature) += lss_action->invdt() * transpose(N(temperature)) * N(temperature)
+          ),
+          lss_action->system_matrix += _T + 0.5 * _A,
+          lss_action->system_rhs += -_A * nodal_values(temperature)
+        )
+      )
+    )
+    << bc
+    << allocate_component<math::LSS::SolveLSS>("SolveLSS")
+    << create_proto_action("Increment", nodes_expression(temperature += lss_action->solution(temperature)));
+
+  Handle<common::ActionDirector> ic(solver.get_child("InitialConditions"));
+  *ic << create_proto_action("Initialize" + variable_name, nodes_expression(temperature = coordinates(0,0) * (5. - coordinates(0,0))));
+
+  return lss_action;
+}
+
 BOOST_FIXTURE_TEST_SUITE( ProtoHeatSuite, ProtoHeatFixture )
 
 BOOST_AUTO_TEST_CASE( InitMPI )
@@ -174,6 +226,59 @@ BOOST_AUTO_TEST_CASE( Heat2DParallel)
 //   lss.solution()->print("utest-proto-heat-parallel_solution-" + boost::lexical_cast<std::string>(common::PE::Comm::instance().rank()) + ".plt");
 }
 
+// The pipelined solver must give the same result as the one that synchronizes after each step
+BOOST_AUTO_TEST_CASE( Heat2DPipelined )
+{
+  const Real length = 5.;
+  const Uint nb_segments = 16;
+
+  ModelUnsteady& model = *root.create_component<ModelUnsteady>("PipelinedModel");
+  Domain& domain = model.create_domain("Domain");
+  UFEM::Solver& solver = *model.create_component<UFEM::Solver>("Solver");
+
+  // The pipelined solver runs last, so its deferred exchange is still pending at the end of each step
+  Handle<UFEM::LSSActionUnsteady> reference_action = add_unsteady_heat(solver, "ReferenceTemperature", "reference_solution", false);
+  Handle<UFEM::LSSActionUnsteady> pipelined_action = add_unsteady_heat(solver, "PipelinedTemperature", "pipelined_solution", true);
+
+  model.create_physics("cf3.physics.DynamicModel");
+
+  Mesh& mesh = *domain.create_component<Mesh>("Mesh");
+  BlockMesh::BlockArrays& blocks = *domain.create_component<BlockMesh::BlockArrays>("blocks");
+
+  *blocks.create_points(2, 4) << 0. << 0. << length << 0. << length << length << 0. << length;
+  *blocks.create_blocks(1) << 0 << 1 << 2 << 3;
+  *blocks.create_block_subdivisions() << nb_segments << nb_segments;
+  *blocks.create_block_gradings() << 1. << 1. << 1. << 1.;
+
+  *blocks.create_patch("bottom", 1) << 0 << 1;
+  *blocks.create_patch("right", 1) << 1 << 2;
+  *blocks.create_patch("top", 1) << 2 << 3;
+  *blocks.create_patch("left", 1) << 3 << 0;
+
+  blocks.partition_blocks(PE::Comm::instance().size(), YY);
+  blocks.create_mesh(mesh);
+
+  solver.configure_option_recursively("regions", std::vector<URI>(1, mesh.topology().uri()));
+
+  // The temperature stays 0 at the left and right, the increment is 0 there
+  Handle<UFEM::BoundaryConditions>(reference_action->get_child("BoundaryConditions"))->add_constant_bc("left", "ReferenceTemperature", 0.);
+  Handle<UFEM::BoundaryConditions>(reference_action->get_child("BoundaryConditions"))->add_constant_bc("right", "ReferenceTemperature", 0.);
+  Handle<UFEM::BoundaryConditions>(pipelined_action->get_child("BoundaryConditions"))->add_constant_bc("left", "PipelinedTemperature", 0.);
+  Handle<UFEM::BoundaryConditions>(pipelined_action->get_child("BoundaryConditions"))->add_constant_bc("right", "PipelinedTemperature", 0.);
+
+  Time& time = model.create_time();
+  time.options().set("time_step", 0.1);
+  time.options().set("end_time", 0.5);
+
+  model.simulate();
+
+  // The node loop exchanges the pending ghost values before the comparison
+  FieldVariable<0, ScalarField> reference("ReferenceTemperature", "reference_solution");
+  FieldVariable<1, ScalarField> pipelined("PipelinedTemperature", "pipelined_solution");
+  for_each_node(mesh.topology(), _check_close(pipelined, reference, 1e-8));
+  BOOST_CHECK(!FieldSynchronizer::instance().has_pending());
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 BOOST_AUTO_TEST_SUITE_END()
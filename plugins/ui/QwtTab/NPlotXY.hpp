@@ -13,6 +13,7 @@
 #include <boost/signals2/signal.hpp>
 
 #include "common/BoostArray.hpp"
+#include "common/Table_fwd.hpp"
 
 #include "ui/core/CNode.hpp"
 #include "ui/QwtTab/LibQwtTab.hpp"
@@ -36,7 +37,7 @@ public: //typedefs
   typedef boost::shared_ptr<NPlotXY> Ptr;
   typedef boost::shared_ptr<NPlotXY const> ConstPtr;
 
-  typedef boost::multi_array<Real, 2> PlotData;
+  typedef common::TableArray<Real>::type PlotData;
   typedef boost::shared_ptr< PlotData > PlotDataPtr;
 
 public:
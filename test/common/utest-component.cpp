@@ -14,11 +14,13 @@
 
 #include "common/Log.hpp"
 #include "common/Component.hpp"
+#include "common/Core.hpp"
 #include "common/FindComponents.hpp"
 #include "common/Group.hpp"
 #include "common/Link.hpp"
 #include "common/OptionList.hpp"
 #include "common/PropertyList.hpp"
+#include "common/TreeChangeLog.hpp"
 
 #include "common/XML/Protocol.hpp"
 #include "common/XML/SignalFrame.hpp"
@@ -297,6 +299,81 @@ BOOST_AUTO_TEST_CASE( clear )
 
 ////////////////////////////////////////////////////////////////////////////////
 
+BOOST_AUTO_TEST_CASE( tree_change_log )
+{
+  TreeChangeLog& change_log = TreeChangeLog::instance();
+
+  // nothing is recorded as long as no client follows the changes
+  BOOST_CHECK(!change_log.is_enabled());
+  const Uint disabled_revision = change_log.revision();
+  Handle<Component> root = Core::instance().root().create_component<Group>("diffroot");
+  BOOST_CHECK_EQUAL(change_log.revision(), disabled_revision);
+
+  // the option change recorder is only attached once the log is enabled
+  BOOST_CHECK(!root->options().has_trigger_on_all());
+  boost::shared_ptr<Component> early = allocate_component<Group> ( "early" );
+  change_log.enable();
+  BOOST_CHECK(root->options().has_trigger_on_all());
+  BOOST_CHECK(!early->options().has_trigger_on_all());
+
+  // components outside of the Core tree are not recorded
+  boost::shared_ptr<Component> detached = allocate_component<Group> ( "detached" );
+  detached->create_component<Component>("child");
+  BOOST_CHECK_EQUAL(change_log.revision(), disabled_revision);
+
+  const Uint start_revision = change_log.revision();
+  Handle<Component> c1 = root->create_component<Component>("c1");
+  root->create_component<Component>("c2");
+  c1->create_component<Component>("c1_1");
+  root->remove_component("c2");
+  c1->mark_basic();
+
+  // c1_1 is sent as part of c1, and c2 was removed after being added
+  TreeChangeLog::ChangesT changes;
+  BOOST_CHECK(change_log.changes_since(start_revision, changes));
+  BOOST_CHECK_EQUAL(changes.size(), 2u);
+  BOOST_CHECK(changes["/diffroot/c1"] == TreeChangeLog::ADDED);
+  BOOST_CHECK(changes["/diffroot/c2"] == TreeChangeLog::REMOVED);
+
+  const Uint renamed_revision = change_log.revision();
+  c1->rename("c3");
+  BOOST_CHECK(change_log.changes_since(renamed_revision, changes));
+  BOOST_CHECK_EQUAL(changes.size(), 2u);
+  BOOST_CHECK(changes["/diffroot/c1"] == TreeChangeLog::REMOVED);
+  BOOST_CHECK(changes["/diffroot/c3"] == TreeChangeLog::ADDED);
+
+  // nothing changed since the current revision
+  BOOST_CHECK(change_log.changes_since(change_log.revision(), changes));
+  BOOST_CHECK(changes.empty());
+
+  // options set directly are recorded as well, also when added after construction
+  root->options().add("diff_option", 1);
+  const Uint option_revision = change_log.revision();
+  root->options().set("diff_option", 2);
+  BOOST_CHECK(change_log.changes_since(option_revision, changes));
+  BOOST_CHECK_EQUAL(changes.size(), 1u);
+  BOOST_CHECK(changes["/diffroot"] == TreeChangeLog::MODIFIED);
+
+  // components built before the log was enabled get the recorder when they are added to the tree
+  early->options().add("early_option", 1);
+  root->add_component(early);
+  BOOST_CHECK(early->options().has_trigger_on_all());
+  const Uint early_revision = change_log.revision();
+  early->options().set("early_option", 2);
+  BOOST_CHECK(change_log.changes_since(early_revision, changes));
+  BOOST_CHECK_EQUAL(changes.size(), 1u);
+  BOOST_CHECK(changes["/diffroot/early"] == TreeChangeLog::MODIFIED);
+
+  // a revision that is no longer in the log can't be used
+  change_log.set_capacity(1);
+  BOOST_CHECK(!change_log.changes_since(renamed_revision, changes));
+  change_log.set_capacity(10000);
+
+  Core::instance().root().remove_component("diffroot");
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 BOOST_AUTO_TEST_SUITE_END()
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,198 @@
+// Copyright (C) 2010-2013 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "Test module for the batched configuration of options"
+
+#include <boost/assign/std/vector.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include "common/BasicExceptions.hpp"
+#include "common/ConfigurationBatch.hpp"
+#include "common/Core.hpp"
+#include "common/Group.hpp"
+#include "common/Journal.hpp"
+#include "common/OptionArray.hpp"
+#include "common/OptionComponent.hpp"
+#include "common/OptionList.hpp"
+#include "common/OptionT.hpp"
+#include "common/OptionURI.hpp"
+
+#include "common/XML/SignalFrame.hpp"
+#include "common/XML/SignalOptions.hpp"
+
+using namespace boost::assign;
+
+using namespace cf3;
+using namespace cf3::common;
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Trigger that stores the value of the count option at the time it is called
+struct CountRecorder
+{
+  CountRecorder(const Component& component, Uint& recorded) : m_component(component), m_recorded(recorded) {}
+
+  void operator()()
+  {
+    m_recorded = m_component.options().value<Uint>("count");
+  }
+
+  const Component& m_component;
+  Uint& m_recorded;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+struct ConfigurationBatchFixture
+{
+  ConfigurationBatchFixture()
+  {
+    ExceptionManager::instance().ExceptionDumps = false;
+    ExceptionManager::instance().ExceptionAborts = false;
+    ExceptionManager::instance().ExceptionOutputs = false;
+
+    Component& root = Core::instance().root();
+    if(is_not_null(root.get_child("BatchTest")))
+      root.remove_component("BatchTest");
+
+    group = root.create_component<Group>("BatchTest");
+    first = group->create_component<Component>("First");
+    second = first->create_component<Component>("Second");
+
+    first->options().add("flag", false);
+    first->options().add("count", 0u);
+    first->options().add("offset", 0);
+    second->options().add("factor", 1.);
+    second->options().add("label", std::string());
+    second->options().add("target", URI());
+    second->options().add("weights", std::vector<Real>());
+  }
+
+  Handle<Group> group;
+  Handle<Component> first;
+  Handle<Component> second;
+};
+
+BOOST_FIXTURE_TEST_SUITE( ConfigurationBatchSuite, ConfigurationBatchFixture )
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( Apply )
+{
+  std::vector<Real> weights;
+  weights += 0.25, 0.5, 0.25;
+
+  ConfigurationBatch batch;
+  batch.add(first->uri(), "flag", true);
+  batch.add(first->uri(), "count", 3u);
+  batch.add(URI("First/Second", URI::Scheme::CPATH), "factor", 2.5);
+  batch.add(URI("./First/../First/Second", URI::Scheme::CPATH), "label", std::string("batched"));
+  batch.add(second->uri(), "weights", weights);
+  BOOST_CHECK_EQUAL(batch.size(), 5u);
+
+  batch.apply(*group);
+
+  BOOST_CHECK_EQUAL(first->options().value<bool>("flag"), true);
+  BOOST_CHECK_EQUAL(first->options().value<Uint>("count"), 3u);
+  BOOST_CHECK_EQUAL(second->options().value<Real>("factor"), 2.5);
+  BOOST_CHECK_EQUAL(second->options().value<std::string>("label"), "batched");
+  const std::vector<Real> result = second->options().value< std::vector<Real> >("weights");
+  BOOST_CHECK_EQUAL_COLLECTIONS(result.begin(), result.end(), weights.begin(), weights.end());
+}
+
+BOOST_AUTO_TEST_CASE( BinaryRoundTrip )
+{
+  std::vector<Real> weights;
+  weights += 1., -2.;
+
+  ConfigurationBatch batch;
+  batch.add(first->uri(), "flag", true);
+  batch.add(first->uri(), "count", 42u);
+  batch.add(first->uri(), "offset", -7);
+  batch.add(second->uri(), "factor", 0.125);
+  batch.add(second->uri(), "label", std::string("binary"));
+  batch.add(second->uri(), "target", first->uri());
+  batch.add(second->uri(), "weights", weights);
+
+  std::string buffer;
+  batch.to_binary(buffer);
+
+  ConfigurationBatch copy;
+  copy.from_binary(buffer.data(), buffer.size());
+  BOOST_CHECK_EQUAL(copy.size(), batch.size());
+
+  copy.apply(*group);
+
+  BOOST_CHECK_EQUAL(first->options().value<bool>("flag"), true);
+  BOOST_CHECK_EQUAL(first->options().value<Uint>("count"), 42u);
+  BOOST_CHECK_EQUAL(first->options().value<int>("offset"), -7);
+  BOOST_CHECK_EQUAL(second->options().value<Real>("factor"), 0.125);
+  BOOST_CHECK_EQUAL(second->options().value<std::string>("label"), "binary");
+  BOOST_CHECK_EQUAL(second->options().value<URI>("target").path(), first->uri().path());
+  const std::vector<Real> result = second->options().value< std::vector<Real> >("weights");
+  BOOST_CHECK_EQUAL_COLLECTIONS(result.begin(), result.end(), weights.begin(), weights.end());
+
+  BOOST_CHECK_THROW(copy.from_binary(buffer.data(), buffer.size() / 2), ParsingFailed);
+  BOOST_CHECK_THROW(copy.from_binary(buffer.data() + 1, buffer.size() - 1), ParsingFailed);
+}
+
+BOOST_AUTO_TEST_CASE( Errors )
+{
+  ConfigurationBatch batch;
+  batch.add(URI("First/Missing", URI::Scheme::CPATH), "factor", 3.);
+  batch.add(first->uri(), "missing", 1);
+  batch.add(second->uri(), "factor", 4.);
+
+  BOOST_CHECK_THROW(batch.apply(*group), ValueNotFound);
+
+  // Collecting the errors applies the remaining values
+  std::vector<std::string> errors;
+  batch.apply(*group, &errors);
+  BOOST_CHECK_EQUAL(errors.size(), 2u);
+  BOOST_CHECK_EQUAL(second->options().value<Real>("factor"), 4.);
+}
+
+BOOST_AUTO_TEST_CASE( JournalReplay )
+{
+  second->options().add("link", Handle<Component>());
+  Uint count_at_link = 0;
+  second->options().option("link").attach_trigger(CountRecorder(*first, count_at_link));
+
+  Handle<Journal> journal = group->create_component<Journal>("Journal");
+
+  // A handle option has no generic option builder, so it is set between the batched values
+  XML::SignalOptions first_options;
+  first_options.add("flag", true);
+  first_options.add("count", 5u);
+  SignalFrame first_frame = first_options.create_frame("configure", journal->uri(), first->uri());
+  journal->add_signal(first_frame);
+
+  XML::SignalOptions link_options;
+  link_options.add("link", first);
+  SignalFrame link_frame = link_options.create_frame("configure", journal->uri(), second->uri());
+  journal->add_signal(link_frame);
+
+  XML::SignalOptions count_options;
+  count_options.add("count", 7u);
+  SignalFrame count_frame = count_options.create_frame("configure", journal->uri(), first->uri());
+  journal->add_signal(count_frame);
+
+  const URI journal_file("journal-replay.xml", URI::Scheme::FILE);
+  journal->dump_journal_to(journal_file);
+  journal->execute_signals(journal_file);
+
+  BOOST_CHECK_EQUAL(first->options().value<bool>("flag"), true);
+  BOOST_CHECK_EQUAL(first->options().value<Uint>("count"), 7u);
+  BOOST_CHECK(second->options().value< Handle<Component> >("link") == first);
+  BOOST_CHECK_EQUAL(count_at_link, 5u);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END()
+
+////////////////////////////////////////////////////////////////////////////////
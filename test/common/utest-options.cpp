@@ -13,6 +13,7 @@
 #include <boost/type_traits/is_base_of.hpp>
 
 #include "common/BasicExceptions.hpp"
+#include "common/CachedOption.hpp"
 #include "common/Group.hpp"
 #include "common/Core.hpp"
 #include "common/OptionArray.hpp"
@@ -113,6 +114,49 @@ BOOST_AUTO_TEST_CASE( ResetOptions )
   BOOST_CHECK_EQUAL(root.options().option("test_reset").value_str(), "test01");
 }
 
+BOOST_AUTO_TEST_CASE( CachedOptions )
+{
+  Component& root = Core::instance().root();
+
+  root.options().add("test_cached_uint", 1u);
+  CachedOption<Uint> cached_uint(root.options(), "test_cached_uint");
+  BOOST_CHECK_EQUAL(cached_uint.value(), 1u);
+  root.options().set("test_cached_uint", 2u);
+  BOOST_CHECK_EQUAL(cached_uint.value(), 2u);
+
+  // Component options hold handles
+  const Handle<Group> group = root.create_component<Group>("CachedGroup");
+  root.options().add("test_cached_group", Handle<Group>());
+  CachedOption< Handle<Group> > cached_group(root.options(), "test_cached_group");
+  BOOST_CHECK(is_null(cached_group.value()));
+  root.options().set("test_cached_group", group);
+  BOOST_CHECK(cached_group.value() == group);
+
+  std::vector<Real> coords; coords += 1., 2.;
+  root.options().add("test_cached_array", std::vector<Real>());
+  CachedOption< std::vector<Real> > cached_array(root.options(), "test_cached_array");
+  BOOST_CHECK(cached_array.value().empty());
+  root.options().set("test_cached_array", coords);
+  BOOST_CHECK(cached_array.value() == coords);
+
+  // The type is checked when attaching, not when reading
+  CachedOption<int> wrong_type;
+  BOOST_CHECK_THROW(wrong_type.attach(root.options(), "test_cached_uint"), CastingFailed);
+  BOOST_CHECK(!wrong_type.is_attached());
+
+  // A detached value is no longer updated
+  cached_uint.detach();
+  root.options().set("test_cached_uint", 3u);
+  BOOST_CHECK_EQUAL(cached_uint.value(), 2u);
+
+  // Going out of scope removes the trigger from the option
+  {
+    CachedOption<Uint> scoped(root.options(), "test_cached_uint");
+    BOOST_CHECK_EQUAL(scoped.value(), 3u);
+  }
+  root.options().set("test_cached_uint", 4u);
+}
+
 
 //////////////////////////////////////////////////////////////////////////////
 
@@ -378,8 +378,8 @@ BOOST_AUTO_TEST_CASE( ObjectWrapperVector )
 BOOST_AUTO_TEST_CASE( ObjectWrapperMultiArray )
 {
   int i,j;
-  boost::multi_array<Uint,1> i1;
-  boost::multi_array<double,2> d2;
+  boost::multi_array<Uint,1,HugePagesAllocator<Uint> > i1;
+  boost::multi_array<double,2,HugePagesAllocator<double> > d2;
   std::vector<int> map(4);
   i1.resize(boost::extents[16]);
   d2.resize(boost::extents[8][3]);
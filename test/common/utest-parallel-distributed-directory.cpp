@@ -0,0 +1,125 @@
+// Copyright (C) 2010-2013 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+//
+// IMPORTANT:
+// run it both on 1 and many cores
+// for example: mpirun -np 4 ./test-parallel-distributed-directory --report_level=confirm or --report_level=detailed
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "Test module for cf3::common 's parallel environment - part of testing the distributed directory."
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <boost/test/unit_test.hpp>
+
+#include "common/Log.hpp"
+#include "common/PE/Comm.hpp"
+#include "common/PE/DistributedDirectory.hpp"
+#include "common/PE/debug.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+using namespace cf3;
+using namespace cf3::common;
+
+////////////////////////////////////////////////////////////////////////////////
+
+struct DistributedDirectoryFixture
+{
+  /// common setup for each test case
+  DistributedDirectoryFixture()
+  {
+    m_argc = boost::unit_test::framework::master_test_suite().argc;
+    m_argv = boost::unit_test::framework::master_test_suite().argv;
+  }
+
+  /// common tear-down for each test case
+  ~DistributedDirectoryFixture()
+  {
+  }
+
+  /// common params
+  int m_argc;
+  char** m_argv;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_FIXTURE_TEST_SUITE( DistributedDirectorySuite, DistributedDirectoryFixture )
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( init )
+{
+  PE::Comm::instance().init(m_argc,m_argv);
+  BOOST_CHECK_EQUAL( PE::Comm::instance().is_active() , true );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( insert_and_find )
+{
+  const Uint rank = PE::Comm::instance().rank();
+  const Uint nproc = PE::Comm::instance().size();
+  const Uint nb_keys = 10;
+  const Uint shared_key = 1000;
+  const Uint missing_key = 1999;
+
+  PE::DistributedDirectory<Uint> directory(2000);
+
+  // Every rank inserts its own keys, with key+1 as value, and a key that is shared by all ranks
+  std::vector<Uint> keys;
+  std::vector<Uint> values;
+  for (Uint i=0; i<nb_keys; ++i)
+  {
+    keys.push_back(rank*nb_keys + i);
+    values.push_back(rank*nb_keys + i + 1);
+  }
+  keys.push_back(shared_key);
+  values.push_back(100 + rank);
+  directory.insert(keys, values);
+
+  // Look up the keys of the next rank, the shared key and a key nobody inserted
+  const Uint next_rank = (rank+1) % nproc;
+  std::vector<Uint> requested_keys;
+  for (Uint i=0; i<nb_keys; ++i)
+    requested_keys.push_back(next_rank*nb_keys + i);
+  requested_keys.push_back(shared_key);
+  requested_keys.push_back(missing_key);
+
+  std::vector<Uint> found_values;
+  std::vector<Uint> found_ranks;
+  directory.find(requested_keys, found_values, found_ranks);
+
+  BOOST_CHECK_EQUAL(found_values.size(), requested_keys.size());
+  BOOST_CHECK_EQUAL(found_ranks.size(), requested_keys.size());
+  for (Uint i=0; i<nb_keys; ++i)
+  {
+    BOOST_CHECK_EQUAL(found_values[i], requested_keys[i] + 1);
+    BOOST_CHECK_EQUAL(found_ranks[i], next_rank);
+  }
+
+  // The lowest rank wins
+  BOOST_CHECK_EQUAL(found_values[nb_keys], 100u);
+  BOOST_CHECK_EQUAL(found_ranks[nb_keys], 0u);
+
+  BOOST_CHECK_EQUAL(found_values[nb_keys+1], directory.unknown());
+  BOOST_CHECK_EQUAL(found_ranks[nb_keys+1], directory.unknown());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( finalize )
+{
+  PE::Comm::instance().finalize();
+  BOOST_CHECK_EQUAL( PE::Comm::instance().is_active() , false );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END()
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,193 @@
+// Copyright (C) 2010-2013 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+//
+// IMPORTANT:
+// run it both on 1 and many cores
+// for example: mpirun -np 4 ./test-parallel-log-buffer --report_level=confirm or --report_level=detailed
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "Test module for cf3::common 's parallel environment - part of testing the buffered logging."
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <fstream>
+#include <sstream>
+
+#include <boost/test/unit_test.hpp>
+
+#include "common/Log.hpp"
+#include "common/LogBuffer.hpp"
+#include "common/PE/Comm.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+using namespace cf3;
+using namespace cf3::common;
+
+////////////////////////////////////////////////////////////////////////////////
+
+struct LogBufferFixture
+{
+  /// common setup for each test case
+  LogBufferFixture()
+  {
+    m_argc = boost::unit_test::framework::master_test_suite().argc;
+    m_argv = boost::unit_test::framework::master_test_suite().argv;
+  }
+
+  /// common tear-down for each test case
+  ~LogBufferFixture()
+  {
+  }
+
+  /// common params
+  int m_argc;
+  char** m_argv;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_FIXTURE_TEST_SUITE( LogBufferSuite, LogBufferFixture )
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( init )
+{
+  PE::Comm::instance().init(m_argc,m_argv);
+  BOOST_CHECK_EQUAL( PE::Comm::instance().is_active() , true );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( gather_ordered )
+{
+  const Uint rank = PE::Comm::instance().rank();
+  const Uint nb_procs = PE::Comm::instance().size();
+
+  LogBuffer buffer;
+  // Unbalanced number of messages: no rank waits for the others while appending
+  for(Uint i = 0; i != rank+1; ++i)
+  {
+    std::stringstream msg;
+    msg << rank << " " << i << "\n";
+    buffer.append(msg.str());
+  }
+  BOOST_CHECK_EQUAL(buffer.size(), rank+1);
+
+  std::stringstream out;
+  buffer.gather(out);
+  BOOST_CHECK_EQUAL(buffer.size(), 0u);
+
+  if(rank == 0)
+  {
+    // The messages of each rank arrive in the order they were appended
+    std::vector<Uint> next(nb_procs, 0);
+    Uint nb_lines = 0;
+    Uint msg_rank, msg_idx;
+    while(out >> msg_rank >> msg_idx)
+    {
+      BOOST_REQUIRE(msg_rank < nb_procs);
+      BOOST_CHECK_EQUAL(msg_idx, next[msg_rank]);
+      ++next[msg_rank];
+      ++nb_lines;
+    }
+    BOOST_CHECK_EQUAL(nb_lines, nb_procs*(nb_procs+1)/2);
+  }
+  else
+  {
+    BOOST_CHECK(out.str().empty());
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( capacity )
+{
+  LogBuffer buffer(2);
+  buffer.append("a\n");
+  buffer.append("b\n");
+  buffer.append("c\n");
+  BOOST_CHECK_EQUAL(buffer.size(), 2u);
+
+  std::stringstream out;
+  buffer.gather(out);
+  if(PE::Comm::instance().rank() == 0)
+  {
+    BOOST_CHECK(out.str().find("1 log messages dropped") != std::string::npos);
+    BOOST_CHECK(out.str().find("a\n") == std::string::npos);
+    BOOST_CHECK(out.str().find("c\n") != std::string::npos);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( drain_to_file )
+{
+  std::stringstream filename;
+  filename << "utest-parallel-log-buffer-p" << PE::Comm::instance().rank() << ".log";
+
+  {
+    LogBuffer buffer;
+    buffer.drain_to_file(filename.str());
+    for(Uint i = 0; i != 100; ++i)
+    {
+      std::stringstream msg;
+      msg << i << "\n";
+      buffer.append(msg.str());
+    }
+  } // joins the drain thread
+
+  std::ifstream file(filename.str().c_str());
+  Uint expected = 0;
+  Uint i;
+  while(file >> i)
+  {
+    BOOST_CHECK_EQUAL(i, expected);
+    ++expected;
+  }
+  BOOST_CHECK_EQUAL(expected, 100u);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( sync_screen )
+{
+  // Unequal numbers of messages on the ranks used to deadlock the SYNC_SCREEN destination
+  CFinfo.useDestination(LogStream::SYNC_SCREEN, true);
+  for(Uint i = 0; i != PE::Comm::instance().rank(); ++i)
+    CFinfo << "message " << i << " from rank " << PE::Comm::instance().rank() << CFendl;
+  Logger::instance().synchronize();
+  BOOST_CHECK_EQUAL(CFinfo.nb_sync_messages(), 0u);
+
+  // With the rank zero filter, the other ranks don't buffer anything
+  CFinfo.setFilterRankZero(LogStream::SYNC_SCREEN, true);
+  CFinfo << "filtered message from rank " << PE::Comm::instance().rank() << CFendl;
+  BOOST_CHECK_EQUAL(CFinfo.nb_sync_messages(), PE::Comm::instance().rank() == 0 ? 1u : 0u);
+  CFinfo.setFilterRankZero(LogStream::SYNC_SCREEN, false);
+  Logger::instance().synchronize();
+
+  // Left in the buffers, to be written by finalize
+  CFinfo << "last message from rank " << PE::Comm::instance().rank() << CFendl;
+  BOOST_CHECK_EQUAL(CFinfo.nb_sync_messages(), 1u);
+  CFinfo.useDestination(LogStream::SYNC_SCREEN, false);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( finalize )
+{
+  PE::Comm::instance().finalize();
+  BOOST_CHECK_EQUAL( PE::Comm::instance().is_active() , false );
+
+  // The buffered messages were written before MPI shut down
+  BOOST_CHECK_EQUAL(CFinfo.nb_sync_messages(), 0u);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END()
+
+////////////////////////////////////////////////////////////////////////////////
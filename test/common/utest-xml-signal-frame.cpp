@@ -14,6 +14,7 @@
 #include "common/URI.hpp"
 
 #include "common/XML/SignalFrame.hpp"
+#include "common/XML/SignalOptions.hpp"
 #include "common/XML/Protocol.hpp"
 #include "common/XML/XmlDoc.hpp"
 #include "common/XML/FileOperations.hpp"
@@ -104,6 +105,46 @@ BOOST_AUTO_TEST_CASE ( map )
 
 /////////////////////////////////////////////////////////////////////////////
 
+BOOST_AUTO_TEST_CASE ( binary )
+{
+  SignalFrame frame ( "theTarget", URI("cpath:/sender"), URI("cpath:/receiver") );
+  SignalOptions& options = frame.options();
+  options.add( "name", std::string("a <quoted> & \"escaped\" value") );
+  options.add( "count", 42u );
+  options.add( "ratio", 0.25 );
+  options.add( "values", std::vector<int>(3, 7) );
+  options.flush();
+
+  std::string text, binary;
+  to_string( *frame.xml_doc, text );
+  to_binary( *frame.xml_doc, binary );
+
+  BOOST_CHECK ( is_binary( binary.data(), binary.size() ) );
+  BOOST_CHECK ( !is_binary( text.c_str(), text.size() ) );
+  BOOST_CHECK ( binary.size() < text.size() );
+
+  // the rebuilt document prints to the same text
+  boost::shared_ptr<XmlDoc> doc = parse_binary( binary.data(), binary.size() );
+  std::string rebuilt_text;
+  to_string( *doc, rebuilt_text );
+  BOOST_CHECK_EQUAL ( rebuilt_text, text );
+
+  SignalFrame rebuilt( doc );
+  BOOST_CHECK_EQUAL ( rebuilt.node.attribute_value("target"), std::string("theTarget") );
+  BOOST_CHECK_EQUAL ( SignalOptions(rebuilt).value<cf3::Uint>("count"), 42u );
+
+  BOOST_CHECK_THROW ( parse_binary( binary.data(), binary.size() / 2 ), XmlError );
+
+  // a name size with more continuation bytes than a size_t can hold is rejected
+  std::size_t header_size = 0;
+  while( !is_binary( binary.data(), header_size ) )
+    ++header_size;
+  std::string too_long = binary.substr( 0, header_size + 1 ) + std::string( 12, '\xFF' ) + std::string( 1, '\0' );
+  BOOST_CHECK_THROW ( parse_binary( too_long.data(), too_long.size() ), XmlError );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
 BOOST_AUTO_TEST_SUITE_END()
 
 /////////////////////////////////////////////////////////////////////////////
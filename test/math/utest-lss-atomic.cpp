@@ -17,6 +17,8 @@
 #include <boost/lexical_cast.hpp>
 
 #include "common/Log.hpp"
+#include "common/PropertyList.hpp"
+#include "math/LSS/SolveLSS.hpp"
 #include "math/LSS/System.hpp"
 #include "math/VariablesDescriptor.hpp"
 
@@ -1131,6 +1133,242 @@ BOOST_AUTO_TEST_CASE( solve_system_laplacian )
 
 ////////////////////////////////////////////////////////////////////////////////
 
+BOOST_AUTO_TEST_CASE( solve_system_laplacian_extrapolated )
+{
+  // commpattern
+  if (irank==0)
+  {
+    gid += 0,1,2,3;
+    rank_updatable += 0,0,0,1;
+  } else {
+    gid += 2,3,4,5,6;
+    rank_updatable += 0,1,1,1,1;
+  }
+  boost::shared_ptr<common::PE::CommPattern> cp_ptr = common::allocate_component<common::PE::CommPattern>("commpattern");
+  common::PE::CommPattern& cp = *cp_ptr;
+  cp.insert("gid",gid,1,false);
+  cp.setup(Handle<common::PE::CommWrapper>(cp.get_child("gid")),rank_updatable);
+
+  // lss
+  if (irank==0)
+  {
+    node_connectivity += 0,1,0,1,2,1,2,3,2,3;
+    starting_indices += 0,2,5,8,10;
+  } else {
+    node_connectivity += 0,1,0,1,2,1,2,3,2,3,4,3,4;
+    starting_indices +=  0,2,5,8,11,13;
+  }
+  boost::shared_ptr<System> sys(common::allocate_component<System>("sys"));
+  sys->options().option("matrix_builder").change_value(matrix_builder);
+  sys->create(cp,1,node_connectivity,starting_indices);
+
+  Handle<common::Component> strategy = sys->solution_strategy();
+  strategy->options().set("print_settings", false);
+  strategy->options().set("adaptive_preconditioner", true);
+  strategy->options().set("extrapolation_order", 2u);
+  strategy->access_component("Parameters")->options().set("preconditioner_type", std::string("None"));
+
+  // The boundary values grow linearly, so from the third solve on the extrapolated guess is the solution
+  std::vector<Real> first_solution;
+  for(Uint step = 1; step != 5; ++step)
+  {
+    sys->matrix()->reset(1.);
+    sys->solution()->reset(0.);
+    sys->rhs()->reset(0.);
+    if (irank==0)
+    {
+      std::vector<Real> diag(4,-2.);
+      sys->set_diagonal(diag);
+      sys->dirichlet(0,0,10.*step);
+    } else {
+      std::vector<Real> diag(5,-2.);
+      sys->set_diagonal(diag);
+      sys->dirichlet(4,0,16.*step);
+    }
+
+    sys->solve();
+
+    std::vector<Real> vals;
+    sys->solution()->debug_data(vals);
+    if(step == 1)
+    {
+      first_solution = vals;
+    }
+    else
+    {
+      for (int i=0; i<vals.size(); i++)
+        if (cp.isUpdatable()[i])
+          BOOST_CHECK_CLOSE( vals[i], step*first_solution[i], 1e-4);
+    }
+
+    if(step > 2)
+      BOOST_CHECK(strategy->properties().value<Uint>("iteration_count") <= 1u);
+  }
+
+  BOOST_CHECK(strategy->properties().value<Uint>("preconditioner_rebuilds") >= 1u);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( solve_system_laplacian_mixed_precision )
+{
+  // commpattern
+  if (irank==0)
+  {
+    gid += 0,1,2,3;
+    rank_updatable += 0,0,0,1;
+  } else {
+    gid += 2,3,4,5,6;
+    rank_updatable += 0,1,1,1,1;
+  }
+  boost::shared_ptr<common::PE::CommPattern> cp_ptr = common::allocate_component<common::PE::CommPattern>("commpattern");
+  common::PE::CommPattern& cp = *cp_ptr;
+  cp.insert("gid",gid,1,false);
+  cp.setup(Handle<common::PE::CommWrapper>(cp.get_child("gid")),rank_updatable);
+
+  // lss
+  if (irank==0)
+  {
+    node_connectivity += 0,1,0,1,2,1,2,3,2,3;
+    starting_indices += 0,2,5,8,10;
+  } else {
+    node_connectivity += 0,1,0,1,2,1,2,3,2,3,4,3,4;
+    starting_indices +=  0,2,5,8,11,13;
+  }
+  boost::shared_ptr<System> sys(common::allocate_component<System>("sys"));
+  sys->options().option("matrix_builder").change_value(matrix_builder);
+  sys->create(cp,1,node_connectivity,starting_indices);
+
+  sys->solution_strategy()->options().set("print_settings", false);
+  sys->solution_strategy()->access_component("Parameters")->options().set("preconditioner_type", std::string("None"));
+
+  boost::shared_ptr<SolveLSS> solve_lss(common::allocate_component<SolveLSS>("SolveLSS"));
+  solve_lss->options().set("lss", Handle<System>(sys));
+
+  // Solve once in double precision as reference, and once in mixed precision
+  std::vector<Real> reference;
+  for(Uint mixed = 0; mixed != 2; ++mixed)
+  {
+    sys->matrix()->reset(1.);
+    sys->solution()->reset(0.);
+    sys->rhs()->reset(0.);
+    if (irank==0)
+    {
+      std::vector<Real> diag(4,-2.);
+      sys->set_diagonal(diag);
+      sys->dirichlet(0,0,10.);
+    } else {
+      std::vector<Real> diag(5,-2.);
+      sys->set_diagonal(diag);
+      sys->dirichlet(4,0,16.);
+    }
+
+    solve_lss->options().set("mixed_precision", mixed == 1);
+    BOOST_CHECK_EQUAL(is_not_null(solve_lss->get_child("MixedPrecisionStrategy")), mixed == 1);
+    if(mixed == 1)
+      solve_lss->get_child("MixedPrecisionStrategy")->options().set("tolerance", 1e-12);
+    solve_lss->execute();
+
+    std::vector<Real> vals;
+    sys->solution()->debug_data(vals);
+    if(mixed == 0)
+    {
+      reference = vals;
+    }
+    else
+    {
+      for (int i=0; i<vals.size(); i++)
+        if (cp.isUpdatable()[i])
+          BOOST_CHECK_CLOSE( vals[i], reference[i], 1e-6);
+      Handle<common::Component> strategy = solve_lss->get_child("MixedPrecisionStrategy");
+      BOOST_CHECK(strategy->properties().value<Real>("residual") <= 1e-12);
+      BOOST_CHECK(strategy->properties().value<Uint>("refinements") >= 1u);
+    }
+  }
+
+  // Switching mixed precision off removes the strategy again
+  solve_lss->options().set("mixed_precision", false);
+  BOOST_CHECK(is_null(solve_lss->get_child("MixedPrecisionStrategy")));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( solve_system_laplacian_persistent_workspace )
+{
+  // commpattern
+  if (irank==0)
+  {
+    gid += 0,1,2,3;
+    rank_updatable += 0,0,0,1;
+  } else {
+    gid += 2,3,4,5,6;
+    rank_updatable += 0,1,1,1,1;
+  }
+  boost::shared_ptr<common::PE::CommPattern> cp_ptr = common::allocate_component<common::PE::CommPattern>("commpattern");
+  common::PE::CommPattern& cp = *cp_ptr;
+  cp.insert("gid",gid,1,false);
+  cp.setup(Handle<common::PE::CommWrapper>(cp.get_child("gid")),rank_updatable);
+
+  // lss
+  if (irank==0)
+  {
+    node_connectivity += 0,1,0,1,2,1,2,3,2,3;
+    starting_indices += 0,2,5,8,10;
+  } else {
+    node_connectivity += 0,1,0,1,2,1,2,3,2,3,4,3,4;
+    starting_indices +=  0,2,5,8,11,13;
+  }
+  boost::shared_ptr<System> sys(common::allocate_component<System>("sys"));
+  sys->options().option("matrix_builder").change_value(matrix_builder);
+  sys->create(cp,1,node_connectivity,starting_indices);
+
+  sys->solution_strategy()->options().set("print_settings", false);
+  sys->solution_strategy()->options().set("compute_residual", true);
+  sys->solution_strategy()->access_component("Parameters")->options().set("preconditioner_type", std::string("None"));
+
+  boost::shared_ptr<SolveLSS> solve_lss(common::allocate_component<SolveLSS>("SolveLSS"));
+  solve_lss->options().set("lss", Handle<System>(sys));
+
+  // Repeated solves with the same pattern, as in a time loop, must reuse the workspace of the first solve
+  for(Uint mixed = 0; mixed != 2; ++mixed)
+  {
+    solve_lss->options().set("mixed_precision", mixed == 1);
+    Uint first_allocations = 0;
+    for(Uint step = 0; step != 4; ++step)
+    {
+      sys->matrix()->reset(1.);
+      sys->solution()->reset(0.);
+      sys->rhs()->reset(0.);
+      if (irank==0)
+      {
+        std::vector<Real> diag(4,-2.-step);
+        sys->set_diagonal(diag);
+        sys->dirichlet(0,0,10.);
+      } else {
+        std::vector<Real> diag(5,-2.-step);
+        sys->set_diagonal(diag);
+        sys->dirichlet(4,0,16.);
+      }
+
+      solve_lss->execute();
+
+      Handle<common::Component> strategy = mixed == 1 ? solve_lss->get_child("MixedPrecisionStrategy") : Handle<common::Component>(sys->solution_strategy());
+      const Uint allocations = strategy->properties().value<Uint>("workspace_allocations");
+      if(step == 0)
+      {
+        BOOST_CHECK(allocations >= 1u);
+        first_allocations = allocations;
+      }
+      else
+      {
+        BOOST_CHECK_EQUAL(allocations, first_allocations);
+      }
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 BOOST_AUTO_TEST_CASE( finalize_mpi )
 {
   CFinfo.setFilterRankZero(true);
@@ -101,6 +101,50 @@ struct LSSSymmetricDirichletFixture
     sys.create(cp,neq,node_connectivity,starting_indices);
   }
 
+  /// check the system after applying the dirichlet condition with value 10 to the test system
+  void check_dirichlet(LSS::System& sys)
+  {
+    Real val;
+    if(irank == 0)
+    {
+      sys.matrix()->get_value(0, 0, val);
+      BOOST_CHECK_EQUAL(val, 2.);
+      sys.matrix()->get_value(1, 0, val);
+      BOOST_CHECK_EQUAL(val, 0.);
+      sys.matrix()->get_value(0, 1, val);
+      BOOST_CHECK_EQUAL(val, 0.);
+      sys.matrix()->get_value(1, 1, val);
+      BOOST_CHECK_EQUAL(val, 1.);
+      sys.matrix()->get_value(2, 1, val);
+      BOOST_CHECK_EQUAL(val, 0.);
+
+      sys.rhs()->get_value(0, val);
+      BOOST_CHECK_EQUAL(val, -10.);
+      sys.rhs()->get_value(1, val);
+      BOOST_CHECK_EQUAL(val, 10.);
+    }
+    else
+    {
+      sys.matrix()->get_value(0, 1, val);
+      BOOST_CHECK_EQUAL(val, 0.);
+      sys.matrix()->get_value(1, 1, val);
+      BOOST_CHECK_EQUAL(val, 2.);
+      sys.matrix()->get_value(2, 1, val);
+      BOOST_CHECK_EQUAL(val, 1.);
+      sys.matrix()->get_value(1, 2, val);
+      BOOST_CHECK_EQUAL(val, 1.);
+      sys.matrix()->get_value(2, 2, val);
+      BOOST_CHECK_EQUAL(val, 2.);
+
+      sys.rhs()->get_value(0, val);
+      BOOST_CHECK_EQUAL(val, 10.);
+      sys.rhs()->get_value(1, val);
+      BOOST_CHECK_EQUAL(val, -10.);
+      sys.rhs()->get_value(2, val);
+      BOOST_CHECK_EQUAL(val, 0.);
+    }
+  }
+
   /// main solver selector
   std::string solvertype;
   std::string matrix_builder;
@@ -166,44 +210,42 @@ BOOST_AUTO_TEST_CASE( test_complete_system )
 
   sys->rhs()->print_native(std::cout);
 
+  check_dirichlet(*sys);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( test_batched_system )
+{
+  boost::shared_ptr<common::PE::CommPattern> cp_ptr = common::allocate_component<common::PE::CommPattern>("commpattern");
+  common::PE::CommPattern& cp = *cp_ptr;
+  build_commpattern(cp);
+  boost::shared_ptr<LSS::System> sys(common::allocate_component<LSS::System>("sys"));
+  sys->options().option("matrix_builder").change_value(matrix_builder);
+  build_system(*sys,cp);
+
+  sys->matrix()->set_row(0, 0, 2, 1);
+  sys->matrix()->set_row(1, 0, 2, 1);
+  sys->matrix()->set_row(2, 0, 2, 1);
+
+  // Nothing happens until the end of the batch, and a duplicated row keeps the last value
+  const Uint bc_row = irank == 0 ? 1 : 0;
+  sys->begin_constraint_batch();
+  sys->dirichlet(bc_row, 0, 5., true);
+  sys->dirichlet(std::vector<Uint>(1, bc_row), std::vector<Real>(1, 10.), true);
   Real val;
-  if(irank == 0)
-  {
-    sys->matrix()->get_value(0, 0, val);
-    BOOST_CHECK_EQUAL(val, 2.);
-    sys->matrix()->get_value(1, 0, val);
-    BOOST_CHECK_EQUAL(val, 0.);
-    sys->matrix()->get_value(0, 1, val);
-    BOOST_CHECK_EQUAL(val, 0.);
-    sys->matrix()->get_value(1, 1, val);
-    BOOST_CHECK_EQUAL(val, 1.);
-    sys->matrix()->get_value(2, 1, val);
-    BOOST_CHECK_EQUAL(val, 0.);
-
-    sys->rhs()->get_value(0, val);
-    BOOST_CHECK_EQUAL(val, -10.);
-    sys->rhs()->get_value(1, val);
-    BOOST_CHECK_EQUAL(val, 10.);
-  }
-  else
+  sys->rhs()->get_value(bc_row, val);
+  BOOST_CHECK_EQUAL(val, 0.);
+  sys->end_constraint_batch();
+
+  check_dirichlet(*sys);
+
+  // Applying the same rows to a new RHS without resetting the matrix reuses the eliminated values
+  if(matrix_builder == "cf3.math.LSS.TrilinosCrsMatrix")
   {
-    sys->matrix()->get_value(0, 1, val);
-    BOOST_CHECK_EQUAL(val, 0.);
-    sys->matrix()->get_value(1, 1, val);
-    BOOST_CHECK_EQUAL(val, 2.);
-    sys->matrix()->get_value(2, 1, val);
-    BOOST_CHECK_EQUAL(val, 1.);
-    sys->matrix()->get_value(1, 2, val);
-    BOOST_CHECK_EQUAL(val, 1.);
-    sys->matrix()->get_value(2, 2, val);
-    BOOST_CHECK_EQUAL(val, 2.);
-
-    sys->rhs()->get_value(0, val);
-    BOOST_CHECK_EQUAL(val, 10.);
-    sys->rhs()->get_value(1, val);
-    BOOST_CHECK_EQUAL(val, -10.);
-    sys->rhs()->get_value(2, val);
-    BOOST_CHECK_EQUAL(val, 0.);
+    sys->rhs()->reset(0.);
+    sys->dirichlet(std::vector<Uint>(1, bc_row), std::vector<Real>(1, 10.), true);
+    check_dirichlet(*sys);
   }
 }
 
@@ -0,0 +1,173 @@
+// Copyright (C) 2010-2013 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "Tests mesh::actions::BuildVolume and BuildArea"
+
+#include <boost/test/unit_test.hpp>
+#include <boost/assign/list_of.hpp>
+
+#include "common/Core.hpp"
+#include "common/Environment.hpp"
+#include "common/FindComponents.hpp"
+#include "common/Foreach.hpp"
+#include "common/OptionList.hpp"
+
+#include "mesh/Connectivity.hpp"
+#include "mesh/Dictionary.hpp"
+#include "mesh/ElementType.hpp"
+#include "mesh/ElementTypeLoop.hpp"
+#include "mesh/Entities.hpp"
+#include "mesh/Field.hpp"
+#include "mesh/Mesh.hpp"
+#include "mesh/MeshGenerator.hpp"
+#include "mesh/MeshTransformer.hpp"
+#include "mesh/Region.hpp"
+#include "mesh/Space.hpp"
+#include "mesh/LagrangeP1/ElementTypes.hpp"
+
+using namespace cf3;
+using namespace cf3::common;
+using namespace cf3::mesh;
+using namespace boost::assign;
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+
+/// Generate a mesh in the unit square or cube, scaled by the given lengths
+Mesh& generate(const std::string& name, const std::vector<Uint>& nb_cells, const std::vector<Real>& lengths)
+{
+  Handle<MeshGenerator> generator(Core::instance().root().create_component("generator_"+name, "cf3.mesh.SimpleMeshGenerator"));
+  generator->options().set("mesh", Core::instance().root().uri()/name);
+  generator->options().set("nb_cells", nb_cells);
+  generator->options().set("lengths", lengths);
+  return generator->generate();
+}
+
+/// Check the values of a P0 field against the virtual element type interface, and return their sum
+Real check_against_virtual(const Field& field, const bool volume)
+{
+  Real total = 0.;
+  boost_foreach(const Handle<Space>& space, field.spaces())
+  {
+    const Entities& entities = space->support();
+    RealMatrix coordinates;
+    entities.geometry_space().allocate_coordinates(coordinates);
+    for(Uint elem_idx = 0; elem_idx != entities.size(); ++elem_idx)
+    {
+      entities.geometry_space().put_coordinates(coordinates, elem_idx);
+      const Real expected = volume ? entities.element_type().volume(coordinates) : entities.element_type().area(coordinates);
+      const Real computed = field[space->connectivity()[elem_idx][0]][0];
+      BOOST_CHECK_CLOSE(computed, expected, 1e-10);
+      total += computed;
+    }
+  }
+  return total;
+}
+
+/// Counts the dispatched entities and the elements visited
+struct CountElements
+{
+  CountElements() : nb_dispatched(0), nb_elements(0) {}
+
+  template<typename ETYPE>
+  void operator()(const ETYPE&, const Entities& entities)
+  {
+    ++nb_dispatched;
+    for_each_element<ETYPE>(entities, *this);
+  }
+
+  template<typename ETYPE>
+  void operator()(const ETYPE&, const Uint, const typename ETYPE::NodesT& nodes)
+  {
+    BOOST_CHECK(ETYPE::volume(nodes) > 0.);
+    ++nb_elements;
+  }
+
+  Uint nb_dispatched;
+  Uint nb_elements;
+};
+
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE( BuildVolume_TestSuite )
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( Init )
+{
+  Core::instance().initiate(boost::unit_test::framework::master_test_suite().argc, boost::unit_test::framework::master_test_suite().argv);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( dispatch )
+{
+  Mesh& mesh = generate("dispatch", list_of(4)(3), list_of(2.)(3.));
+
+  Uint nb_cells = 0;
+  CountElements counter;
+  boost_foreach(const Entities& entities, find_components_recursively<Entities>(mesh.topology()))
+  {
+    const bool dispatched = dispatch_element_type<LagrangeP1::CellTypes>(entities, counter);
+    BOOST_CHECK_EQUAL(dispatched, entities.element_type().dimensionality() == 2u);
+    if(dispatched)
+      nb_cells += entities.size();
+  }
+
+  BOOST_CHECK_EQUAL(counter.nb_dispatched, 1u);
+  BOOST_CHECK_EQUAL(counter.nb_elements, nb_cells);
+  BOOST_CHECK_EQUAL(nb_cells, 12u);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( volume_and_area_2d )
+{
+  Mesh& mesh = generate("rect", list_of(10)(5), list_of(2.)(3.));
+  Handle<MeshTransformer> triangulator(Core::instance().root().create_component("triangulator", "cf3.mesh.MeshTriangulator"));
+  triangulator->transform(mesh);
+
+  Handle<MeshTransformer>(Core::instance().root().create_component("build_volume_2d", "cf3.mesh.actions.BuildVolume"))->transform(mesh);
+  Handle<MeshTransformer>(Core::instance().root().create_component("build_area_2d", "cf3.mesh.actions.BuildArea"))->transform(mesh);
+
+  const Field& volume = *Handle<Field const>(mesh.get_child("cells_P0")->get_child("volume"));
+  const Field& area = *Handle<Field const>(mesh.get_child("faces_P0")->get_child(mesh::Tags::area()));
+  BOOST_CHECK_CLOSE(check_against_virtual(volume, true), 6., 1e-10);
+  BOOST_CHECK_CLOSE(check_against_virtual(area, false), 10., 1e-10);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( volume_and_area_3d )
+{
+  Mesh& mesh = generate("box", list_of(4)(3)(2), list_of(1.)(2.)(3.));
+
+  Handle<MeshTransformer>(Core::instance().root().create_component("build_volume_3d", "cf3.mesh.actions.BuildVolume"))->transform(mesh);
+  Handle<MeshTransformer>(Core::instance().root().create_component("build_area_3d", "cf3.mesh.actions.BuildArea"))->transform(mesh);
+
+  const Field& volume = *Handle<Field const>(mesh.get_child("cells_P0")->get_child("volume"));
+  const Field& area = *Handle<Field const>(mesh.get_child("faces_P0")->get_child(mesh::Tags::area()));
+  BOOST_CHECK_CLOSE(check_against_virtual(volume, true), 6., 1e-10);
+  BOOST_CHECK_CLOSE(check_against_virtual(area, false), 22., 1e-10);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( Terminate )
+{
+  Core::instance().terminate();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END()
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,192 @@
+// Copyright (C) 2010-2013 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "Tests mesh::actions::DynamicLoadBalance"
+
+#include <boost/test/unit_test.hpp>
+
+#include "common/ConnectionManager.hpp"
+#include "common/Core.hpp"
+#include "common/Environment.hpp"
+#include "common/EventHandler.hpp"
+#include "common/FindComponents.hpp"
+#include "common/Foreach.hpp"
+#include "common/Group.hpp"
+#include "common/Log.hpp"
+#include "common/OptionList.hpp"
+#include "common/PropertyList.hpp"
+#include "common/TimedComponent.hpp"
+
+#include "common/PE/Comm.hpp"
+
+#include "mesh/actions/DynamicLoadBalance.hpp"
+#include "mesh/Entities.hpp"
+#include "mesh/Mesh.hpp"
+#include "mesh/MeshGenerator.hpp"
+#include "mesh/Region.hpp"
+#include "mesh/Tags.hpp"
+
+using namespace cf3;
+using namespace cf3::common;
+using namespace cf3::mesh;
+using namespace cf3::mesh::actions;
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Timed component looping over regions, with timings that are set by the test instead of measured
+class FakeTimedAction : public Component, public TimedComponent
+{
+public:
+  FakeTimedAction(const std::string& name) : Component(name)
+  {
+    options().add("regions", std::vector<URI>());
+  }
+
+  static std::string type_name() { return "FakeTimedAction"; }
+
+  /// Set the accumulated timings as store_timings would
+  void set_timings(const Real mean, const Uint count)
+  {
+    properties()["timer_mean"] = mean;
+    properties()["timer_count"] = count;
+  }
+
+  virtual void store_timings() {}
+};
+
+/// Counts the mesh_changed events
+struct MeshChangedCounter : public ConnectionManager
+{
+  MeshChangedCounter() : triggered(0)
+  {
+    Core::instance().event_handler().connect_to_event(mesh::Tags::event_mesh_changed(), this, &MeshChangedCounter::on_mesh_changed);
+  }
+
+  void on_mesh_changed(SignalArgs&)
+  {
+    ++triggered;
+  }
+
+  Uint triggered;
+};
+
+/// Total number of elements in the entities below the given region, over all processes
+Real global_nb_elements(const Region& region)
+{
+  Real local_nb_elems = 0.;
+  boost_foreach(const Entities& entities, find_components_recursively<Entities>(region))
+    local_nb_elems += static_cast<Real>(entities.size());
+  Real nb_elems = 0.;
+  PE::Comm::instance().all_reduce(PE::plus(), &local_nb_elems, 1, &nb_elems);
+  return nb_elems;
+}
+
+struct DynamicLoadBalanceFixture
+{
+  DynamicLoadBalanceFixture()
+  {
+    m_argc = boost::unit_test::framework::master_test_suite().argc;
+    m_argv = boost::unit_test::framework::master_test_suite().argv;
+  }
+
+  int m_argc;
+  char** m_argv;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_FIXTURE_TEST_SUITE( DynamicLoadBalanceSuite, DynamicLoadBalanceFixture )
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( init_mpi )
+{
+  Core::instance().initiate(m_argc,m_argv);
+  PE::Comm::instance().init(m_argc,m_argv);
+  BOOST_CHECK_EQUAL(PE::Comm::instance().size(), 2);
+}
+
+BOOST_AUTO_TEST_CASE( rebalance )
+{
+  const Uint rank = PE::Comm::instance().rank();
+
+  Handle<MeshGenerator> generator = Core::instance().root().create_component<MeshGenerator>("generator", "cf3.mesh.SimpleMeshGenerator");
+  generator->options().set("mesh", URI("//rect"));
+  generator->options().set("nb_cells", std::vector<Uint>(2, 20u));
+  generator->options().set("lengths", std::vector<Real>(2, 1.));
+  Mesh& mesh = generator->generate();
+
+  Region& interior = *Handle<Region>(mesh.topology().get_child("interior"));
+  Region& left = *Handle<Region>(mesh.topology().get_child("left"));
+
+  // One action looping over the interior cells, one over the left boundary only
+  Handle<Group> actions = Core::instance().root().create_component<Group>("actions");
+  Handle<FakeTimedAction> interior_action = actions->create_component<FakeTimedAction>("InteriorAction");
+  interior_action->options().set("regions", std::vector<URI>(1, interior.uri()));
+  Handle<FakeTimedAction> left_action = actions->create_component<FakeTimedAction>("LeftAction");
+  left_action->options().set("regions", std::vector<URI>(1, left.uri()));
+
+  Handle<DynamicLoadBalance> balancer = Core::instance().root().create_component<DynamicLoadBalance>("DynamicLoadBalance");
+  balancer->options().set("timed_component", Handle<Component>(actions));
+  balancer->set_mesh(mesh);
+
+  MeshChangedCounter mesh_changed_counter;
+
+  // Equal loads: nothing happens
+  interior_action->set_timings(1., 1u);
+  left_action->set_timings(0.1, 1u);
+  balancer->execute();
+
+  BOOST_CHECK_SMALL(balancer->properties().value<Real>("imbalance"), 1e-12);
+  BOOST_CHECK_EQUAL(balancer->properties().value<Uint>("nb_rebalances"), 0u);
+  BOOST_CHECK_EQUAL(mesh_changed_counter.triggered, 0u);
+  boost_foreach(const Handle<Entities>& entities, mesh.elements())
+    BOOST_CHECK(!entities->properties().check("load_weight"));
+
+  // Rank 0 spends 3 s in the interior since the previous execution and rank 1 only 1 s, both spend 0.1 s on the left boundary
+  const Real nb_interior = global_nb_elements(interior);
+  const Real nb_left = global_nb_elements(left);
+  const Real nb_total = global_nb_elements(mesh.topology());
+  interior_action->set_timings(rank == 0 ? 2. : 1., 2u);
+  left_action->set_timings(0.1, 2u);
+  balancer->execute();
+
+  BOOST_CHECK_CLOSE(balancer->properties().value<Real>("imbalance"), 3.1 / 2.1 - 1., 1e-8);
+  BOOST_CHECK_EQUAL(balancer->properties().value<Uint>("nb_rebalances"), 1u);
+  BOOST_CHECK_EQUAL(mesh_changed_counter.triggered, 1u);
+
+  // Weights are the time per element of each action over all processes, scaled to a mean of 1 over all elements
+  const Real scale = nb_total / (4. + 0.2);
+  boost_foreach(const Entities& entities, find_components_recursively<Entities>(interior))
+    BOOST_CHECK_CLOSE(entities.properties().value<Real>("load_weight"), 4. / nb_interior * scale, 1e-8);
+  boost_foreach(const Entities& entities, find_components_recursively<Entities>(left))
+    BOOST_CHECK_CLOSE(entities.properties().value<Real>("load_weight"), 0.2 / nb_left * scale, 1e-8);
+  boost_foreach(const Entities& entities, find_components_recursively<Entities>(*Handle<Region>(mesh.topology().get_child("right"))))
+    BOOST_CHECK_CLOSE(entities.properties().value<Real>("load_weight"), 0.01, 1e-8);
+
+  // The repartitioned mesh still holds all elements
+  BOOST_CHECK_EQUAL(global_nb_elements(interior), nb_interior);
+  BOOST_CHECK_EQUAL(global_nb_elements(mesh.topology()), nb_total);
+
+  // No time was spent since the previous execution
+  balancer->execute();
+  BOOST_CHECK_SMALL(balancer->properties().value<Real>("imbalance"), 1e-12);
+  BOOST_CHECK_EQUAL(balancer->properties().value<Uint>("nb_rebalances"), 1u);
+  BOOST_CHECK_EQUAL(mesh_changed_counter.triggered, 1u);
+}
+
+BOOST_AUTO_TEST_CASE( finalize_mpi )
+{
+  PE::Comm::instance().finalize();
+  BOOST_CHECK_EQUAL(PE::Comm::instance().is_active(),false);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END()
+
+////////////////////////////////////////////////////////////////////////////////
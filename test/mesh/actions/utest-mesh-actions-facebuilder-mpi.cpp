@@ -7,6 +7,9 @@
 #define BOOST_TEST_DYN_LINK
 #define BOOST_TEST_MODULE "Tests mesh::actions::BuildFaces"
 
+#include <map>
+#include <set>
+
 #include <boost/test/unit_test.hpp>
 #include <boost/assign/list_of.hpp>
 
@@ -17,9 +20,12 @@
 #include "common/OptionList.hpp"
 
 #include "common/FindComponents.hpp"
+#include "common/Foreach.hpp"
 #include "common/PE/Comm.hpp"
 #include "common/PE/debug.hpp"
 
+#include "math/Consts.hpp"
+
 #include "mesh/actions/BuildFaces.hpp"
 #include "mesh/actions/BuildFaceNormals.hpp"
 #include "mesh/MeshTransformer.hpp"
@@ -32,6 +38,9 @@
 #include "mesh/FaceCellConnectivity.hpp"
 #include "mesh/Cells.hpp"
 #include "mesh/SimpleMeshGenerator.hpp"
+#include "mesh/Space.hpp"
+#include "mesh/Connectivity.hpp"
+#include "mesh/Tags.hpp"
 
 using namespace cf3;
 using namespace boost::assign;
@@ -140,6 +149,75 @@ BOOST_AUTO_TEST_CASE( write_mesh )
 
 ////////////////////////////////////////////////////////////////////////////////
 
+BOOST_AUTO_TEST_CASE( build_faces_hashed_owners )
+{
+  // Mixed hexahedra and tetrahedra, so the processes may send faces with a different number of nodes
+  Mesh& hmesh = *Core::instance().root().create_component<Mesh>("hextet");
+  boost::shared_ptr<MeshReader> meshreader = build_component_abstract_type<MeshReader>("cf3.mesh.neu.Reader","meshreader");
+  meshreader->read_mesh_into("../../../resources/hextet.neu",hmesh);
+
+  boost::shared_ptr<BuildFaces> facebuilder = allocate_component<BuildFaces>("facebuilder");
+  facebuilder->options().set("hashed",true);
+  facebuilder->set_mesh(hmesh);
+  facebuilder->execute();
+
+  // Send every boundary face to all processes, as [nb_nodes, sorted global nodes..., owner]
+  PE::Comm& comm = PE::Comm::instance();
+  const common::List<Uint>& nodes_glb_idx = hmesh.geometry_fields().glb_idx();
+  std::vector<Uint> local_faces;
+  std::set< std::vector<Uint> > owned_faces;
+  boost_foreach(const Entities& faces, find_components_recursively_with_tag<Entities>(hmesh.topology(),mesh::Tags::face_entity()))
+  {
+    const FaceCellConnectivity& f2c = *faces.get_child_checked("cell_connectivity")->handle<FaceCellConnectivity>();
+    for (Uint f=0; f<faces.size(); ++f)
+    {
+      if (!f2c.is_bdry_face()[f] || faces.rank()[f] == math::Consts::uint_max())
+        continue;
+      BOOST_CHECK(faces.rank()[f] <= comm.rank());
+
+      std::vector<Uint> glb_nodes;
+      boost_foreach(const Uint node, faces.geometry_space().connectivity()[f])
+        glb_nodes.push_back(nodes_glb_idx[node]);
+      std::sort(glb_nodes.begin(), glb_nodes.end());
+      if (faces.rank()[f] == comm.rank())
+        owned_faces.insert(glb_nodes);
+      local_faces.push_back(glb_nodes.size());
+      local_faces.insert(local_faces.end(), glb_nodes.begin(), glb_nodes.end());
+      local_faces.push_back(faces.rank()[f]);
+    }
+  }
+  BOOST_CHECK(!local_faces.empty());
+
+  std::vector< std::vector<Uint> > send(comm.size(), local_faces);
+  std::vector< std::vector<Uint> > recv(comm.size());
+  comm.all_to_all(send, recv);
+
+  // Each face is owned by the lowest rank that has it, and all ranks agree on it
+  std::map< std::vector<Uint>, Uint > lowest_rank;
+  std::map< std::vector<Uint>, std::set<Uint> > owners;
+  for (Uint p=0; p<comm.size(); ++p)
+  {
+    for (Uint i=0; i<recv[p].size(); i+=recv[p][i]+2)
+    {
+      const std::vector<Uint> key(recv[p].begin()+i+1, recv[p].begin()+i+1+recv[p][i]);
+      if (lowest_rank.find(key) == lowest_rank.end())
+        lowest_rank[key] = p;
+      owners[key].insert(recv[p][i+1+recv[p][i]]);
+    }
+  }
+  Uint nb_unique_owned = 0;
+  for (std::map< std::vector<Uint>, std::set<Uint> >::const_iterator it = owners.begin(); it != owners.end(); ++it)
+  {
+    BOOST_CHECK_EQUAL(it->second.size(), 1u);
+    BOOST_CHECK_EQUAL(*it->second.begin(), lowest_rank[it->first]);
+    if (*it->second.begin() == comm.rank())
+      ++nb_unique_owned;
+  }
+  BOOST_CHECK_EQUAL(static_cast<Uint>(owned_faces.size()), nb_unique_owned);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 BOOST_AUTO_TEST_CASE( finalize_mpi )
 {
   Core::instance().terminate();
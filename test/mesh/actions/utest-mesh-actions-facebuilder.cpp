@@ -15,6 +15,9 @@
 #include "common/Core.hpp"
 #include "common/Environment.hpp"
 #include "common/FindComponents.hpp"
+#include "common/Foreach.hpp"
+#include "common/List.hpp"
+#include "common/StringConversion.hpp"
 
 #include "mesh/actions/BuildFaces.hpp"
 #include "mesh/actions/BuildFaceNormals.hpp"
@@ -390,6 +393,92 @@ BOOST_AUTO_TEST_CASE( build_faces_rectangle )
   }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( build_faceconnectivity_hashed )
+{
+  Mesh& qmesh = *Core::instance().root().create_component<Mesh>("quadtriag_hashed");
+  boost::shared_ptr< MeshReader > meshreader = build_component_abstract_type<MeshReader>("cf3.mesh.neu.Reader","meshreader");
+  meshreader->read_mesh_into("../../../resources/quadtriag.neu",qmesh);
+
+  FaceCellConnectivity& reference = *qmesh.create_component<FaceCellConnectivity>("reference_faces");
+  reference.setup(qmesh.topology());
+
+  // The hashed algorithm must give the same faces in the same order, for any number of threads
+  const Uint nb_threads[] = {1u, 3u};
+  for (Uint t=0; t<2; ++t)
+  {
+    FaceCellConnectivity& f2c = *qmesh.create_component<FaceCellConnectivity>("hashed_faces_"+to_str(nb_threads[t]));
+    f2c.options().set("hashed",true);
+    f2c.options().set("nb_threads",nb_threads[t]);
+    f2c.setup(qmesh.topology());
+
+    BOOST_CHECK_EQUAL( f2c.size() , reference.size() );
+    for (Uint f=0; f<f2c.size(); ++f)
+    {
+      BOOST_CHECK_EQUAL( f2c.is_bdry_face()[f] , reference.is_bdry_face()[f] );
+      BOOST_CHECK( f2c.connectivity()[f][0] == reference.connectivity()[f][0] );
+      BOOST_CHECK_EQUAL( f2c.face_number()[f][0] , reference.face_number()[f][0] );
+      if (!reference.is_bdry_face()[f])
+      {
+        BOOST_CHECK( f2c.connectivity()[f][1] == reference.connectivity()[f][1] );
+        BOOST_CHECK_EQUAL( f2c.face_number()[f][1] , reference.face_number()[f][1] );
+        BOOST_CHECK_EQUAL( f2c.cell_rotation()[f][1] , reference.cell_rotation()[f][1] );
+      }
+      BOOST_CHECK( f2c.face_nodes(f) == reference.face_nodes(f) );
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( build_faces_hashed )
+{
+  Mesh& qmesh = *Core::instance().root().create_component<Mesh>("quadtriag_build_faces_hashed");
+  boost::shared_ptr< MeshReader > meshreader = build_component_abstract_type<MeshReader>("cf3.mesh.neu.Reader","meshreader");
+  meshreader->read_mesh_into("../../../resources/quadtriag.neu",qmesh);
+
+  boost::shared_ptr<BuildFaces> facebuilder = allocate_component<BuildFaces>("facebuilder");
+  facebuilder->options().set("hashed",true);
+  facebuilder->options().set("nb_threads",2u);
+  facebuilder->set_mesh(qmesh);
+  facebuilder->execute();
+
+  // Same counts as the build_faces test case, which used the default algorithm on the same mesh
+  std::map<std::string,Uint> reference_sizes;
+  boost_foreach(const Entities& faces, find_components_recursively_with_tag<Entities>(mesh->topology(),mesh::Tags::face_entity()))
+    reference_sizes[faces.uri().path().substr(mesh->uri().path().size())] = faces.size();
+  BOOST_CHECK(!reference_sizes.empty());
+
+  Uint nb_face_entities = 0;
+  boost_foreach(const Entities& faces, find_components_recursively_with_tag<Entities>(qmesh.topology(),mesh::Tags::face_entity()))
+  {
+    BOOST_CHECK_EQUAL(faces.size(), reference_sizes[faces.uri().path().substr(qmesh.uri().path().size())]);
+    ++nb_face_entities;
+  }
+  BOOST_CHECK_EQUAL(nb_face_entities, static_cast<Uint>(reference_sizes.size()));
+
+  Region& wall_region = find_component_recursively_with_name<Region>(qmesh.topology(),"wall");
+  Faces& wall_faces = find_component<Faces>(wall_region);
+  FaceCellConnectivity& f2c = find_component<FaceCellConnectivity>(wall_faces);
+  BOOST_CHECK_EQUAL(f2c.size(),6u);
+  for (Face2Cell face(f2c); face.idx<f2c.size(); ++face.idx)
+  {
+    RealMatrix cell_coordinates = face.cells()[0].get_coordinates();
+    RealVector face_coordinates = wall_faces.geometry_space().get_coordinates(face.idx).row(0);
+    bool match_found = false;
+    for (Uint i=0; i<cell_coordinates.rows(); ++i)
+    {
+      if (cell_coordinates.row(i) == face_coordinates.transpose())
+      {
+        match_found = true;
+        break;
+      }
+    }
+    BOOST_CHECK(match_found);
+  }
+}
+
 //////////////////////////////////////////////////////////////////////////////
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,26 @@
+import sys
+import coolfluid as cf
+
+root = cf.Core.root()
+
+mesh = root.create_component('mesh','cf3.mesh.Mesh')
+mesh_generator = root.create_component("mesh_generator","cf3.mesh.SimpleMeshGenerator")
+mesh_generator.options().set("mesh",mesh.uri())
+mesh_generator.options().set("nb_cells",[10,10])
+mesh_generator.options().set("lengths",[1.,1.])
+mesh_generator.execute()
+
+memory_info = root.create_component('MemoryInfo', 'cf3.mesh.actions.MemoryInfo')
+memory_info.mesh = mesh
+memory_info.execute()
+
+# at least the coordinates of the 121 nodes and the connectivity of the 100 quads must be counted
+minimum = 121*2*8 + 100*4*4
+if memory_info.properties.total_memory < minimum:
+  raise Exception('Memory usage ' + str(memory_info.properties.total_memory) + ' is less than ' + str(minimum))
+
+memory_info.options().set('compact', True)
+memory_info.execute()
+compacted = memory_info.properties.total_memory
+if compacted < minimum:
+  raise Exception('Memory usage after compacting ' + str(compacted) + ' is less than ' + str(minimum))
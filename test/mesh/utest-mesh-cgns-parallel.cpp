@@ -0,0 +1,197 @@
+// Copyright (C) 2010-2013 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "Test module for parallel reading and writing of CGNS files"
+
+#include <boost/test/unit_test.hpp>
+
+#include "common/Log.hpp"
+#include "common/Core.hpp"
+#include "common/Environment.hpp"
+#include "common/OptionList.hpp"
+#include "common/FindComponents.hpp"
+#include "common/Foreach.hpp"
+#include "common/PE/Comm.hpp"
+#include "common/PE/operations.hpp"
+#include "common/List.hpp"
+
+#include "mesh/Mesh.hpp"
+#include "mesh/Region.hpp"
+#include "mesh/Cells.hpp"
+#include "mesh/Dictionary.hpp"
+#include "mesh/Field.hpp"
+#include "mesh/MeshGenerator.hpp"
+#include "mesh/MeshReader.hpp"
+#include "mesh/MeshWriter.hpp"
+
+using namespace cf3;
+using namespace cf3::mesh;
+using namespace cf3::common;
+
+////////////////////////////////////////////////////////////////////////////////
+
+struct CGNSParallelTests_Fixture
+{
+  /// common setup for each test case
+  CGNSParallelTests_Fixture()
+  {
+    m_argc = boost::unit_test::framework::master_test_suite().argc;
+    m_argv = boost::unit_test::framework::master_test_suite().argv;
+  }
+
+  /// common tear-down for each test case
+  ~CGNSParallelTests_Fixture()
+  {
+  }
+
+  /// common values accessed by all tests goes here
+  int    m_argc;
+  char** m_argv;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_FIXTURE_TEST_SUITE( CGNSParallelTests_TestSuite, CGNSParallelTests_Fixture )
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( init_mpi )
+{
+  Core::instance().initiate(m_argc,m_argv);
+  PE::Comm::instance().init(m_argc,m_argv);
+  BOOST_CHECK_EQUAL( PE::Comm::instance().is_active() , true );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( write_and_read_one_file )
+{
+  // Generate a mesh, partitioned over the ranks
+  Handle<Mesh> mesh = Core::instance().root().create_component<Mesh>("mesh");
+  boost::shared_ptr< MeshGenerator > generate_mesh = build_component_abstract_type<MeshGenerator>("cf3.mesh.SimpleMeshGenerator","meshgenerator");
+  generate_mesh->options().set("nb_cells",std::vector<Uint>(2,10));
+  generate_mesh->options().set("lengths",std::vector<Real>(2,1.));
+  generate_mesh->options().set("mesh",mesh->uri());
+  generate_mesh->execute();
+
+  Field& solution = mesh->geometry_fields().create_field("solution","u[s],V[v]");
+  const Field& coords = mesh->geometry_fields().coordinates();
+  for (Uint n=0; n<solution.size(); ++n)
+  {
+    solution[n][0] = coords[n][XX] + 2.*coords[n][YY];
+    solution[n][1] = coords[n][XX];
+    solution[n][2] = coords[n][YY];
+  }
+
+  // All ranks write their owned part in the same file
+  boost::shared_ptr< MeshWriter > writer = build_component_abstract_type<MeshWriter>("cf3.mesh.CGNS.Writer","meshwriter");
+  writer->options().set("fields",std::vector<URI>(1,solution.uri()));
+  writer->write_from_to(*mesh,"rect-parallel.cgns");
+
+  // Every rank reads a slice
+  Handle<Mesh> read_mesh = Core::instance().root().create_component<Mesh>("read_mesh");
+  boost::shared_ptr< MeshReader > reader = build_component_abstract_type<MeshReader>("cf3.mesh.CGNS.Reader","meshreader");
+  reader->read_mesh_into("rect-parallel.cgns",*read_mesh);
+
+  const Uint rank = PE::Comm::instance().rank();
+  Uint nb_owned_cells = 0;
+  boost_foreach(const Cells& cells, find_components_recursively<Cells>(read_mesh->topology()))
+  {
+    for (Uint e=0; e<cells.size(); ++e)
+    {
+      if (cells.rank()[e] == rank)
+        ++nb_owned_cells;
+    }
+  }
+  Uint glb_nb_cells = 0;
+  PE::Comm::instance().all_reduce(PE::plus(), &nb_owned_cells, 1, &glb_nb_cells);
+  BOOST_CHECK_EQUAL(glb_nb_cells, 100u);
+
+  Uint nb_owned_nodes = 0;
+  const Dictionary& nodes = read_mesh->geometry_fields();
+  for (Uint n=0; n<nodes.size(); ++n)
+  {
+    if (!nodes.is_ghost(n))
+      ++nb_owned_nodes;
+  }
+  Uint glb_nb_nodes = 0;
+  PE::Comm::instance().all_reduce(PE::plus(), &nb_owned_nodes, 1, &glb_nb_nodes);
+  BOOST_CHECK_EQUAL(glb_nb_nodes, 121u);
+
+  // The solution is read for all local nodes, including the ones that are owned by another rank
+  const Field& read_solution = read_mesh->geometry_fields().field("solution");
+  const Field& read_coords = read_mesh->geometry_fields().coordinates();
+  BOOST_CHECK_EQUAL(read_solution.row_size(), 3u);
+  for (Uint n=0; n<read_solution.size(); ++n)
+  {
+    BOOST_CHECK_CLOSE(read_solution[n][0], read_coords[n][XX] + 2.*read_coords[n][YY], 1e-10);
+    BOOST_CHECK_CLOSE(read_solution[n][1], read_coords[n][XX], 1e-10);
+    BOOST_CHECK_CLOSE(read_solution[n][2], read_coords[n][YY], 1e-10);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( write_and_read_empty_slices )
+{
+  // Two cells stacked in y: each boundary along x has a single face, so one rank owns none of it when writing,
+  // and one rank gets an empty slice of it when reading
+  Handle<Mesh> mesh = Core::instance().root().create_component<Mesh>("small_mesh");
+  boost::shared_ptr< MeshGenerator > generate_mesh = build_component_abstract_type<MeshGenerator>("cf3.mesh.SimpleMeshGenerator","small_meshgenerator");
+  std::vector<Uint> nb_cells(2,1);
+  nb_cells[YY] = 2;
+  generate_mesh->options().set("nb_cells",nb_cells);
+  generate_mesh->options().set("lengths",std::vector<Real>(2,1.));
+  generate_mesh->options().set("mesh",mesh->uri());
+  generate_mesh->execute();
+
+  Field& solution = mesh->geometry_fields().create_field("solution","u[s]");
+  const Field& coords = mesh->geometry_fields().coordinates();
+  for (Uint n=0; n<solution.size(); ++n)
+    solution[n][0] = coords[n][YY];
+
+  boost::shared_ptr< MeshWriter > writer = build_component_abstract_type<MeshWriter>("cf3.mesh.CGNS.Writer","small_meshwriter");
+  writer->options().set("fields",std::vector<URI>(1,solution.uri()));
+  writer->write_from_to(*mesh,"small-parallel.cgns");
+
+  Handle<Mesh> read_mesh = Core::instance().root().create_component<Mesh>("small_read_mesh");
+  boost::shared_ptr< MeshReader > reader = build_component_abstract_type<MeshReader>("cf3.mesh.CGNS.Reader","small_meshreader");
+  reader->read_mesh_into("small-parallel.cgns",*read_mesh);
+
+  const Uint rank = PE::Comm::instance().rank();
+  Uint nb_owned_cells = 0;
+  boost_foreach(const Cells& cells, find_components_recursively<Cells>(read_mesh->topology()))
+  {
+    for (Uint e=0; e<cells.size(); ++e)
+    {
+      if (cells.rank()[e] == rank)
+        ++nb_owned_cells;
+    }
+  }
+  Uint glb_nb_cells = 0;
+  PE::Comm::instance().all_reduce(PE::plus(), &nb_owned_cells, 1, &glb_nb_cells);
+  BOOST_CHECK_EQUAL(glb_nb_cells, 2u);
+
+  const Field& read_solution = read_mesh->geometry_fields().field("solution");
+  const Field& read_coords = read_mesh->geometry_fields().coordinates();
+  for (Uint n=0; n<read_solution.size(); ++n)
+    BOOST_CHECK_CLOSE(read_solution[n][0], read_coords[n][YY], 1e-10);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( finalize_mpi )
+{
+  PE::Comm::instance().finalize();
+  Core::instance().terminate();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END()
+
+////////////////////////////////////////////////////////////////////////////////
@@ -7,6 +7,9 @@
 #define BOOST_TEST_DYN_LINK
 #define BOOST_TEST_MODULE "Tests mesh component classes"
 
+#include <fstream>
+#include <sstream>
+
 #include <boost/test/unit_test.hpp>
 #include <boost/foreach.hpp>
 #include <boost/assign/list_of.hpp>
@@ -23,6 +26,7 @@
 #include "common/List.hpp"
 #include "common/Table.hpp"
 #include "common/DynTable.hpp"
+#include "common/HugePages.hpp"
 #include "mesh/ElementType.hpp"
 #include "mesh/Dictionary.hpp"
 #include "mesh/Field.hpp"
@@ -900,6 +904,112 @@ BOOST_AUTO_TEST_CASE( List_bool_Test )
 
 //////////////////////////////////////////////////////////////////////////////
 
+/// Transparent huge pages of the memory mapping that contains the given address, from /proc/self/smaps
+/// @param[out] advised true if the mapping is marked for huge pages ("hg" in its VmFlags)
+/// @return the amount of the mapping that is backed by huge pages, in kB (its AnonHugePages)
+Uint huge_pages_usage(const void* address, bool& advised)
+{
+  const std::size_t addr = reinterpret_cast<std::size_t>(address);
+  std::ifstream smaps("/proc/self/smaps");
+  std::string line;
+  bool in_mapping = false;
+  Uint anon_huge_pages = 0;
+  advised = false;
+  while (std::getline(smaps, line))
+  {
+    // Mapping headers start with the address range, i.e. 7f0000000000-7f0000200000
+    std::istringstream header(line);
+    std::size_t begin, end;
+    char dash;
+    if (header >> std::hex >> begin >> dash >> end && dash == '-')
+    {
+      in_mapping = begin <= addr && addr < end;
+      continue;
+    }
+    if (!in_mapping)
+      continue;
+    if (line.compare(0, 14, "AnonHugePages:") == 0)
+    {
+      std::istringstream value(line.substr(14));
+      value >> anon_huge_pages;
+    }
+    if (line.compare(0, 8, "VmFlags:") == 0)
+    {
+      advised = line.find(" hg") != std::string::npos;
+      break;
+    }
+  }
+  return anon_huge_pages;
+}
+
+/// True if the kernel can back advised memory with transparent huge pages
+bool huge_pages_supported()
+{
+  std::ifstream thp_mode("/sys/kernel/mm/transparent_hugepage/enabled");
+  std::string mode;
+  return std::getline(thp_mode, mode) && mode.find("[never]") == std::string::npos;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( Table_huge_pages )
+{
+  enable_huge_pages(true);
+  const bool supported = huge_pages_supported();
+  bool advised = false;
+
+  // Large enough to contain several huge pages
+  boost::shared_ptr< Table<Real> > table (allocate_component< Table<Real> >("huge_table")) ;
+  table->set_row_size(2);
+  table->resize(1000000);
+  for (Uint i=0; i<table->size(); ++i)
+    table->array()[i][1] = i;
+
+  // The storage was advised before it was first touched, so it is backed by huge pages right away
+  BOOST_CHECK_EQUAL(reinterpret_cast<std::size_t>(table->array().data()) % (2*1024*1024), 0u);
+  if (supported)
+  {
+    BOOST_CHECK(huge_pages_usage(&table->array()[table->size()/2][0], advised) > 0);
+    BOOST_CHECK(advised);
+  }
+
+  // Growing through a buffer keeps the values, and the new storage is backed by huge pages as well
+  Table<Real>::Buffer buffer = table->create_buffer();
+  buffer.add_row(create_coord( 1.0 , 2.0 ));
+  buffer.flush();
+  BOOST_CHECK_EQUAL(table->size(), 1000001u);
+  BOOST_CHECK_EQUAL(table->array()[999999][1], 999999.);
+  BOOST_CHECK_EQUAL(table->array()[1000000][1], 2.);
+  if (supported)
+  {
+    BOOST_CHECK(huge_pages_usage(&table->array()[table->size()/2][0], advised) > 0);
+    BOOST_CHECK(advised);
+  }
+
+  List<Uint>& list = *table->create_component< List<Uint> >("huge_list");
+  list.resize(2000000);
+  list[1999999] = 1u;
+  BOOST_CHECK_EQUAL(list[1999999], 1u);
+  if (supported)
+  {
+    BOOST_CHECK(huge_pages_usage(&list[1000000], advised) > 0);
+    BOOST_CHECK(advised);
+  }
+
+  // Small arrays use the regular allocator
+  List<Uint>& small_list = *table->create_component< List<Uint> >("small_list");
+  small_list.resize(1000);
+  huge_pages_usage(&small_list[0], advised);
+  BOOST_CHECK(!advised);
+
+  // Arrays allocated after disabling huge pages are not advised
+  enable_huge_pages(false);
+  boost::shared_ptr< Table<Real> > other_table (allocate_component< Table<Real> >("other_table")) ;
+  other_table->set_row_size(2);
+  other_table->resize(1000000);
+  huge_pages_usage(&other_table->array()[other_table->size()/2][0], advised);
+  BOOST_CHECK(!advised);
+}
 
 ////////////////////////////////////////////////////////////////////////////////
 
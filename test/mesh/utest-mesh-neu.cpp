@@ -109,6 +109,38 @@ BOOST_AUTO_TEST_CASE( read_2d_mesh )
 
 ////////////////////////////////////////////////////////////////////////////////
 
+// Each element group and boundary set is read after a seek, also on the ranks where reading an earlier section
+// reached the end of the file
+BOOST_AUTO_TEST_CASE( read_groups_and_boundaries )
+{
+  boost::shared_ptr< MeshReader > meshreader = build_component_abstract_type<MeshReader>("cf3.mesh.neu.Reader","meshreader");
+  meshreader->options().set("read_groups",true);
+  meshreader->options().set("read_boundaries",true);
+
+  Mesh& mesh = *Core::instance().root().create_component<Mesh>("quadtriag_sections");
+  meshreader->read_mesh_into("../../resources/quadtriag.neu",mesh);
+
+  // Number of elements or faces in each group and boundary set of the file
+  std::map<std::string, Uint> expected_counts;
+  expected_counts["liquid"] = 10;
+  expected_counts["gas"] = 6;
+  expected_counts["inlet"] = 2;
+  expected_counts["outlet"] = 4;
+  expected_counts["wall"] = 6;
+
+  for(std::map<std::string, Uint>::const_iterator it = expected_counts.begin(); it != expected_counts.end(); ++it)
+  {
+    Handle<Region> region(mesh.topology().get_child(it->first));
+    BOOST_REQUIRE_MESSAGE(is_not_null(region), "Missing region " + it->first);
+    const Uint local_count = region->recursive_elements_count(true);
+    Uint global_count = 0;
+    PE::Comm::instance().all_reduce(PE::plus(), &local_count, 1, &global_count);
+    BOOST_CHECK_EQUAL(global_count, it->second);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 #if 0
 // Disabled because there exists a duplicate node inside this hextet mesh
 // The GlobalNumbering algorithm hence gets confused as to who gets to own it.
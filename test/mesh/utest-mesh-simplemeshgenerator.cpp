@@ -12,9 +12,12 @@
 #include "common/Log.hpp"
 #include "common/OptionList.hpp"
 #include "common/Core.hpp"
+#include "common/FindComponents.hpp"
+#include "common/Foreach.hpp"
 
 #include "mesh/Mesh.hpp"
 #include "mesh/Region.hpp"
+#include "mesh/Cells.hpp"
 #include "mesh/MeshWriter.hpp"
 #include "mesh/SimpleMeshGenerator.hpp"
 #include "mesh/MeshTransformer.hpp"
@@ -23,6 +26,9 @@
 #include "common/List.hpp"
 #include "common/Table.hpp"
 #include "mesh/Dictionary.hpp"
+#include "mesh/Connectivity.hpp"
+#include "mesh/Field.hpp"
+#include "mesh/Space.hpp"
 
 using namespace std;
 using namespace boost;
@@ -56,6 +62,68 @@ struct SimpleMeshGeneratorTests_Fixture
 
 ////////////////////////////////////////////////////////////////////////////////
 
+/// Rank owning the given object when nb_objects are distributed in contiguous blocks, as in ParallelDistribution
+Uint owner(const Uint idx, const Uint nb_objects)
+{
+  const Uint nb_procs = PE::Comm::instance().size();
+  return std::min(idx / (nb_objects / nb_procs), nb_procs-1);
+}
+
+/// Check the global indices, ranks and coordinates of the nodes and cells of a mesh generated in parallel,
+/// and the ghost node exchange through the comm pattern built by the generator
+void check_partition(Mesh& mesh, const std::vector<Uint>& nb_cells, const Real length)
+{
+  const Uint rank = PE::Comm::instance().rank();
+  const Uint dim = nb_cells.size();
+  const Uint nnx = nb_cells[0]+1;
+  const Uint nny = dim > 1 ? nb_cells[1]+1 : 1;
+  const Uint nnz = dim > 2 ? nb_cells[2]+1 : 1;
+  const Uint ny = dim > 1 ? nb_cells[1] : 1;
+  const Uint nz = dim > 2 ? nb_cells[2] : 1;
+
+  Dictionary& nodes = mesh.geometry_fields();
+  Uint nb_ghosts = 0;
+  for(Uint n = 0; n != nodes.size(); ++n)
+  {
+    const Uint gid = nodes.glb_idx()[n];
+    const Uint idx[3] = { gid % nnx, (gid / nnx) % nny, gid / (nnx*nny) };
+    BOOST_CHECK_EQUAL(nodes.rank()[n], owner(gid, nnx*nny*nnz));
+    BOOST_CHECK_EQUAL(nodes.is_ghost(n), nodes.rank()[n] != rank);
+    for(Uint d = 0; d != dim; ++d)
+      BOOST_CHECK_CLOSE(nodes.coordinates()[n][d] + 1., static_cast<Real>(idx[d]) * length / static_cast<Real>(nb_cells[d]) + 1., 1e-10);
+    if(nodes.is_ghost(n))
+      ++nb_ghosts;
+  }
+  if(PE::Comm::instance().size() > 1)
+    BOOST_CHECK(nb_ghosts > 0);
+
+  Cells& cells = find_component_recursively<Cells>(mesh.topology());
+  const Uint nb_elems = nb_cells[0]*ny*nz;
+  for(Uint e = 0; e != cells.size(); ++e)
+  {
+    const Uint gid = cells.glb_idx()[e];
+    BOOST_CHECK(gid < nb_elems);
+    BOOST_CHECK_EQUAL(cells.rank()[e], owner(gid, nb_elems));
+    // The first node of a cell is its lowest corner
+    const Uint i = gid % nb_cells[0];
+    const Uint j = (gid / nb_cells[0]) % ny;
+    const Uint k = gid / (nb_cells[0]*ny);
+    BOOST_CHECK_EQUAL(nodes.glb_idx()[cells.geometry_space().connectivity()[e][0]], (k*nny + j)*nnx + i);
+  }
+
+  // Ghost nodes receive the global index set by their owner
+  BOOST_CHECK(is_not_null(nodes.get_child("CommPattern")) || !PE::Comm::instance().is_active());
+  Field& check_field = nodes.create_field("partition_check");
+  for(Uint n = 0; n != nodes.size(); ++n)
+    check_field[n][0] = nodes.is_ghost(n) ? -1. : static_cast<Real>(nodes.glb_idx()[n]);
+  check_field.parallelize();
+  check_field.synchronize();
+  for(Uint n = 0; n != nodes.size(); ++n)
+    BOOST_CHECK_EQUAL(check_field[n][0], static_cast<Real>(nodes.glb_idx()[n]));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 BOOST_FIXTURE_TEST_SUITE( SimpleMeshGeneratorTests_TestSuite, SimpleMeshGeneratorTests_Fixture )
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -141,6 +209,44 @@ BOOST_AUTO_TEST_CASE( generate_2d_mesh )
 
 ////////////////////////////////////////////////////////////////////////////////
 
+BOOST_AUTO_TEST_CASE( generate_2d_mesh_overlap )
+{
+
+  boost::shared_ptr< MeshGenerator > meshgenerator = build_component_abstract_type<MeshGenerator>("cf3.mesh.SimpleMeshGenerator","2Dgenerator_overlap");
+
+  meshgenerator->options().set("mesh",URI("//rect_overlap"));
+  meshgenerator->options().set("nb_cells",std::vector<Uint>(2,10));
+  meshgenerator->options().set("lengths",std::vector<Real>(2,1.));
+  meshgenerator->options().set("overlap",1u);
+  Mesh& mesh = meshgenerator->generate();
+
+  // Each rank owns a contiguous range of rows of elements, and gets one extra row of ghost elements per neighbour rank
+  const Uint rank = PE::Comm::instance().rank();
+  const Uint nb_procs = PE::Comm::instance().size();
+  Uint nb_owned = 0;
+  Uint nb_ghosts = 0;
+  boost_foreach(const Cells& cells, find_components_recursively<Cells>(mesh.topology()))
+  {
+    for (Uint e=0; e<cells.size(); ++e)
+    {
+      if (cells.rank()[e] == rank)
+        ++nb_owned;
+      else
+        ++nb_ghosts;
+    }
+  }
+
+  Uint glb_nb_owned = 0;
+  PE::Comm::instance().all_reduce(PE::plus(), &nb_owned, 1, &glb_nb_owned);
+  BOOST_CHECK_EQUAL(glb_nb_owned, 100u);
+  if (nb_procs == 1)
+    BOOST_CHECK_EQUAL(nb_ghosts, 0u);
+  else if (nb_procs == 2)
+    BOOST_CHECK_EQUAL(nb_ghosts, 10u);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 BOOST_AUTO_TEST_CASE( generate_3d_mesh )
 {
 
@@ -177,6 +283,22 @@ BOOST_AUTO_TEST_CASE( generate_3d_mesh )
 
 ////////////////////////////////////////////////////////////////////////////////
 
+BOOST_AUTO_TEST_CASE( generated_partition_numbering )
+{
+  for(Uint dim = 1; dim <= 3; ++dim)
+  {
+    const std::vector<Uint> nb_cells(dim, dim == 3 ? 5 : 9);
+    boost::shared_ptr< MeshGenerator > meshgenerator = build_component_abstract_type<MeshGenerator>("cf3.mesh.SimpleMeshGenerator","partition_generator");
+    meshgenerator->options().set("mesh",URI("//partition_"+to_str(dim)+"d"));
+    meshgenerator->options().set("nb_cells",nb_cells);
+    meshgenerator->options().set("lengths",std::vector<Real>(dim,1.));
+    meshgenerator->options().set("overlap",1u);
+    check_partition(meshgenerator->generate(), nb_cells, 1.);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 BOOST_AUTO_TEST_CASE( finalize_mpi )
 {
   PE::Comm::instance().finalize();
@@ -0,0 +1,124 @@
+// Copyright (C) 2010-2013 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "Test module for cf3::mesh::XDMF::Writer"
+
+#include <boost/test/unit_test.hpp>
+
+#include "common/BoostFilesystem.hpp"
+#include "common/Core.hpp"
+#include "common/OptionArray.hpp"
+#include "common/OptionList.hpp"
+#include "common/OptionURI.hpp"
+
+#include "common/XML/FileOperations.hpp"
+#include "common/XML/XmlDoc.hpp"
+
+#include "rapidxml/rapidxml.hpp"
+
+#include "mesh/Dictionary.hpp"
+#include "mesh/Field.hpp"
+#include "mesh/Mesh.hpp"
+#include "mesh/XDMF/Writer.hpp"
+
+#include "Tools/MeshGeneration/MeshGeneration.hpp"
+
+using namespace cf3;
+using namespace cf3::mesh;
+using namespace cf3::common;
+
+namespace xdmf_test
+{
+
+/// Snapshot grids of a parsed index, in order
+std::vector<rapidxml::xml_node<>*> snapshot_grids(const XML::XmlDoc& index)
+{
+  std::vector<rapidxml::xml_node<>*> result;
+  rapidxml::xml_node<>* temporal = index.content->first_node("Xdmf")->first_node("Domain")->first_node("Grid");
+  for(rapidxml::xml_node<>* grid = temporal->first_node("Grid"); grid != nullptr; grid = grid->next_sibling("Grid"))
+    result.push_back(grid);
+  return result;
+}
+
+/// Topology data item of the first rank in a snapshot grid
+rapidxml::xml_node<>* topology_item(rapidxml::xml_node<>* snapshot_grid)
+{
+  return snapshot_grid->first_node("Grid")->first_node("Topology")->first_node("DataItem");
+}
+
+} // xdmf_test
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE( XDMFSuite )
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( WriteSeries )
+{
+  Component& root = Core::instance().root();
+
+  Handle<Mesh> mesh = root.create_component<Mesh>("mesh");
+  Tools::MeshGeneration::create_rectangle(*mesh, 5., 5., 5, 5);
+  Field& solution = mesh->geometry_fields().create_field("solution", "p[s],u[v]");
+  const Uint nb_points = solution.size();
+
+  Handle<XDMF::Writer> writer = root.create_component<XDMF::Writer>("xdmf_writer");
+
+  std::vector<URI> fields(1, solution.uri());
+  writer->options().set("fields", fields);
+  std::vector<URI> single_precision_fields(1, solution.uri());
+
+  // Three snapshots on the same geometry
+  for(Uint i = 0; i != 3; ++i)
+  {
+    for(Uint j = 0; j != nb_points; ++j)
+      solution[j][0] = static_cast<Real>(i*j);
+    writer->options().set("time", 0.1*i);
+    writer->write_from_to(*mesh, URI("series.xmf"));
+
+    // The index is appended to and stays valid after each snapshot
+    boost::shared_ptr<XML::XmlDoc> index = XML::parse_file(URI("series.xmf"));
+    BOOST_CHECK_EQUAL(xdmf_test::snapshot_grids(*index).size(), i+1);
+  }
+
+  BOOST_CHECK_EQUAL(writer->nb_snapshots(), 3u);
+  BOOST_CHECK_EQUAL(writer->nb_geometry_writes(), 1u);
+
+  // A scalar and a 2D vector padded to 3 components, in double precision
+  BOOST_CHECK_EQUAL(boost::filesystem::file_size("series_P0_fields.bin"), 3*nb_points*4*sizeof(Real));
+
+  // Moving the mesh writes a new geometry, the next snapshot is stored in single precision
+  mesh->geometry_fields().coordinates()[0][0] += 0.1;
+  writer->options().set("single_precision_fields", single_precision_fields);
+  writer->write_from_to(*mesh, URI("series.xmf"));
+
+  BOOST_CHECK_EQUAL(writer->nb_snapshots(), 4u);
+  BOOST_CHECK_EQUAL(writer->nb_geometry_writes(), 2u);
+  BOOST_CHECK(boost::filesystem::exists("series_P0_geometry1.bin"));
+  BOOST_CHECK_EQUAL(boost::filesystem::file_size("series_P0_fields.bin"), 3*nb_points*4*sizeof(Real) + nb_points*4*sizeof(float));
+
+  // The first snapshot on each geometry declares it, the next ones refer to it
+  boost::shared_ptr<XML::XmlDoc> index = XML::parse_file(URI("series.xmf"));
+  const std::vector<rapidxml::xml_node<>*> grids = xdmf_test::snapshot_grids(*index);
+  BOOST_CHECK_EQUAL(grids.size(), 4u);
+  BOOST_CHECK_EQUAL(std::string(xdmf_test::topology_item(grids[0])->first_attribute("Name")->value()), "P0_geometry0_topology");
+  BOOST_CHECK_EQUAL(std::string(xdmf_test::topology_item(grids[1])->first_attribute("Reference")->value()), "XML");
+  BOOST_CHECK(std::string(xdmf_test::topology_item(grids[2])->value()).find("snapshot_0") != std::string::npos);
+  BOOST_CHECK_EQUAL(std::string(xdmf_test::topology_item(grids[3])->first_attribute("Name")->value()), "P0_geometry1_topology");
+
+  // A new file name starts a new series
+  writer->write_from_to(*mesh, URI("other_series.xmf"));
+  BOOST_CHECK_EQUAL(writer->nb_snapshots(), 1u);
+  BOOST_CHECK_EQUAL(writer->nb_geometry_writes(), 1u);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END()
+
+////////////////////////////////////////////////////////////////////////////////
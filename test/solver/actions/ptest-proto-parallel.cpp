@@ -29,6 +29,9 @@
 #include "mesh/ElementData.hpp"
 #include "mesh/FieldManager.hpp"
 #include "mesh/Dictionary.hpp"
+#include "mesh/Field.hpp"
+#include "mesh/Space.hpp"
+#include "mesh/Connectivity.hpp"
 
 #include "mesh/Integrators/Gauss.hpp"
 #include "mesh/LagrangeP0/Hexa.hpp"
@@ -48,6 +51,7 @@
 #include "solver/actions/Proto/ProtoAction.hpp"
 #include "solver/actions/Proto/ElementLooper.hpp"
 #include "solver/actions/Proto/Expression.hpp"
+#include "solver/actions/Proto/FieldSync.hpp"
 #include "solver/actions/Proto/Functions.hpp"
 #include "solver/actions/Proto/NodeLooper.hpp"
 #include "solver/actions/Proto/Terminals.hpp"
@@ -298,6 +302,97 @@ BOOST_FIXTURE_TEST_CASE( CheckResultOverlap, ProtoParallelFixture )
 }
 
 
+////////////////////////////////////////////////////////////////////////////////
+
+// Deferred synchronization: node loops exchange the pending ghost values before visiting the nodes
+BOOST_FIXTURE_TEST_CASE( DeferredNodeExchange, ProtoParallelFixture )
+{
+  Model& model = *root.get_child("NoOverlap")->handle<Model>();
+  Mesh& mesh = *model.domain().get_child("mesh")->handle<Mesh>();
+  Dictionary& nodes = mesh.geometry_fields();
+
+  model.physics().variable_manager().create_descriptor("deferred", "DeferredRank, CopiedRank");
+  model.solver().field_manager().create_field("deferred", nodes);
+  const Field& deferred_field = find_component_with_tag<Field>(nodes, "deferred");
+
+  const Real rank = static_cast<Real>(PE::Comm::instance().rank());
+  FieldVariable<0, ScalarField> U("DeferredRank", "deferred");
+  FieldVariable<1, ScalarField> W("CopiedRank", "deferred");
+
+  // The ghost nodes get the local rank, until the owner sends its value
+  FieldSynchronizer& synchronizer = FieldSynchronizer::instance();
+  synchronizer.set_deferred(true);
+  for_each_node(mesh.topology(), U = rank);
+  synchronizer.set_deferred(false);
+  BOOST_CHECK(synchronizer.has_pending());
+
+  for_each_node(mesh.topology(), W = U);
+  BOOST_CHECK(!synchronizer.has_pending());
+
+  const Uint nb_nodes = nodes.size();
+  for(Uint i = 0; i != nb_nodes; ++i)
+  {
+    BOOST_CHECK_EQUAL(deferred_field[i][0], static_cast<Real>(nodes.rank()[i]));
+    BOOST_CHECK_EQUAL(deferred_field[i][1], static_cast<Real>(nodes.rank()[i]));
+  }
+}
+
+// Deferred synchronization: element loops first process the elements without ghost nodes, then wait for the exchange
+BOOST_FIXTURE_TEST_CASE( DeferredElementExchange, ProtoParallelFixture )
+{
+  Model& model = *root.get_child("NoOverlap")->handle<Model>();
+  Mesh& mesh = *model.domain().get_child("mesh")->handle<Mesh>();
+  Dictionary& nodes = mesh.geometry_fields();
+  Dictionary& elems_P0 = *mesh.get_child("elems_P0")->handle<Dictionary>();
+  const Field& cell_field = find_component_recursively_with_name<Field>(elems_P0, "variables");
+
+  const Real rank = static_cast<Real>(PE::Comm::instance().rank());
+  FieldVariable<0, ScalarField> U("DeferredRank", "deferred");
+  FieldVariable<1, ScalarField> R("CellRank", "variables");
+
+  FieldSynchronizer& synchronizer = FieldSynchronizer::instance();
+  synchronizer.set_deferred(true);
+  for_each_node(mesh.topology(), U = rank);
+  synchronizer.set_deferred(false);
+
+  // Only the elements touching a ghost node have to wait for the exchange
+  synchronizer.start_exchange();
+  BOOST_CHECK(synchronizer.exchange_in_progress());
+  Uint nb_elems = 0;
+  Uint nb_ghost_dependent = 0;
+  BOOST_FOREACH(const Elements& elements, find_components_recursively<Elements>(mesh.topology()))
+  {
+    std::vector<bool> ghost_dependent;
+    nb_ghost_dependent += synchronizer.mark_ghost_dependent(elements, ghost_dependent);
+    nb_elems += elements.size();
+  }
+  if(PE::Comm::instance().size() > 1)
+  {
+    BOOST_CHECK(nb_ghost_dependent > 0);
+    BOOST_CHECK(nb_ghost_dependent < nb_elems);
+  }
+
+  // The element loop finishes the exchange, and uses the owner values for all elements
+  for_each_element<ElementsT>(mesh.topology(), R = U);
+  BOOST_CHECK(!synchronizer.exchange_in_progress());
+
+  BOOST_FOREACH(const Elements& elements, find_components_recursively<Elements>(mesh.topology()))
+  {
+    const Connectivity& node_connectivity = elements.geometry_space().connectivity();
+    const Connectivity& cell_connectivity = elements.space(elems_P0).connectivity();
+    const Uint nb_elem_nodes = node_connectivity.row_size();
+    for(Uint elem = 0; elem != elements.size(); ++elem)
+    {
+      // U is interpolated at the element center, which is the average for a linear hexahedron
+      Real expected = 0.;
+      for(Uint i = 0; i != nb_elem_nodes; ++i)
+        expected += static_cast<Real>(nodes.rank()[node_connectivity[elem][i]]);
+      expected /= static_cast<Real>(nb_elem_nodes);
+      BOOST_CHECK_SMALL(cell_field[cell_connectivity[elem][0]][1] - expected, 1e-12);
+    }
+  }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 BOOST_AUTO_TEST_SUITE_END()
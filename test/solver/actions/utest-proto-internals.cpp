@@ -19,6 +19,7 @@
 #include "solver/Solver.hpp"
 
 #include "solver/actions/Proto/ElementLooper.hpp"
+#include "solver/actions/Proto/JacobianCache.hpp"
 #include "solver/actions/Proto/Expression.hpp"
 #include "solver/actions/Proto/Functions.hpp"
 #include "solver/actions/Proto/NodeLooper.hpp"
@@ -136,6 +137,90 @@ BOOST_AUTO_TEST_CASE( EquationVars )
   ));
 }
 
+BOOST_AUTO_TEST_CASE( JacobianCacheValues )
+{
+  Handle<Mesh> mesh = Core::instance().root().create_component<Mesh>("JacobianCacheMesh");
+  Tools::MeshGeneration::create_rectangle_tris(*mesh, 1., 2., 5, 7);
+
+  const Elements& elements = find_component_recursively_with_filter<Elements>(*mesh, IsElementsVolume());
+  const Table<Real>& coords = elements.geometry_fields().coordinates();
+  const Table<Uint>& conn = elements.geometry_space().connectivity();
+
+  typedef JacobianCache<LagrangeP1::Triag2D> CacheT;
+  BOOST_CHECK(CacheT::width > 1);
+  CacheT cache(coords, conn);
+
+  const Uint nb_elems = elements.size();
+  LagrangeP1::Triag2D::NodesT nodes;
+  LagrangeP1::Triag2D::JacobianT jac, jac_inv;
+  Real jac_det;
+  bool is_invertible;
+  for(Uint block_begin = 0; block_begin < nb_elems; block_begin += CacheT::width)
+  {
+    const Uint block_end = std::min(block_begin + CacheT::width, nb_elems);
+    cache.load(block_begin, block_end - block_begin);
+    for(Uint elem = block_begin; elem != block_end; ++elem)
+    {
+      BOOST_CHECK(cache.contains(elem));
+      fill(nodes, coords, conn[elem]);
+      cache.jacobian(elem, jac, jac_inv, jac_det, is_invertible);
+      BOOST_CHECK(is_invertible);
+
+      const LagrangeP1::Triag2D::JacobianT ref_jac = LagrangeP1::Triag2D::jacobian(LagrangeP1::Triag2D::MappedCoordsT::Zero(), nodes);
+      BOOST_CHECK_CLOSE(jac_det, ref_jac.determinant(), 1e-10);
+      for(Uint i = 0; i != 2; ++i)
+      {
+        for(Uint j = 0; j != 2; ++j)
+        {
+          BOOST_CHECK_CLOSE(jac(i,j) + 1., ref_jac(i,j) + 1., 1e-10);
+          BOOST_CHECK_CLOSE(jac_inv(i,j) + 1., ref_jac.inverse()(i,j) + 1., 1e-10);
+        }
+      }
+    }
+  }
+}
+
+/// Run expressions that use the cached jacobians through the element looper, for a number of elements that is not a multiple of the cache width
+BOOST_AUTO_TEST_CASE( JacobianCacheLooper )
+{
+  Handle<Mesh> mesh = Core::instance().root().create_component<Mesh>("JacobianCacheLooperMesh");
+  Tools::MeshGeneration::create_rectangle_tris(*mesh, 1., 2., 5, 7);
+  BOOST_CHECK(find_component_recursively_with_filter<Elements>(*mesh, IsElementsVolume()).size() % JacobianCache<LagrangeP1::Triag2D>::width != 0);
+
+  mesh->geometry_fields().create_field( "jacobian_cache_solution", "Temperature" ).add_tag("jacobian_cache_solution");
+  FieldVariable<0, ScalarField > T("Temperature", "jacobian_cache_solution");
+
+  // Linear field, with gradient (2, 3)
+  nodes_expression(T = 2.*coordinates[0] + 3.*coordinates[1])->loop(mesh->topology());
+
+  // Integral of the gradient, using the inverse jacobian for nabla and the determinant for the integration weight
+  RealVector2 gradient_integral;
+  Real area;
+  boost::shared_ptr<Expression> integrate = elements_expression
+  (
+    boost::mpl::vector1<LagrangeP1::Triag2D>(),
+    group
+    (
+      element_quadrature(boost::proto::lit(gradient_integral) += nabla(T)*nodal_values(T)),
+      boost::proto::lit(area) += volume
+    )
+  );
+
+  // The same with and without the cache
+  for(int cached = 1; cached >= 0; --cached)
+  {
+    set_jacobian_cache_enabled(cached == 1);
+    gradient_integral.setZero();
+    area = 0.;
+    integrate->loop(mesh->topology());
+
+    BOOST_CHECK_CLOSE(area, 2., 1e-10);
+    BOOST_CHECK_CLOSE(gradient_integral[0], 4., 1e-8);
+    BOOST_CHECK_CLOSE(gradient_integral[1], 6., 1e-8);
+  }
+  set_jacobian_cache_enabled(true);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -72,6 +72,35 @@ using namespace cf3::solver;
 using namespace cf3::solver::actions;
 using namespace cf3::solver::actions::Proto;
 
+/// Build the node connectivity of the volume elements of the given mesh, as needed to create an LSS
+void build_node_connectivity(const Mesh& mesh, std::vector<Uint>& node_connectivity, std::vector<Uint>& starting_indices)
+{
+  const Uint nb_nodes = mesh.geometry_fields().size();
+  std::vector< std::set<Uint> > connectivity_sets(nb_nodes);
+  BOOST_FOREACH(const Entities& elements, common::find_components_recursively_with_filter<Entities>(mesh, IsElementsVolume()))
+  {
+    const Connectivity& connectivity = elements.geometry_space().connectivity();
+    const Uint nb_elems = connectivity.size();
+    for(Uint elem = 0; elem != nb_elems; ++elem)
+    {
+      BOOST_FOREACH(const Uint node_a, connectivity[elem])
+      {
+        BOOST_FOREACH(const Uint node_b, connectivity[elem])
+        {
+          connectivity_sets[node_a].insert(node_b);
+        }
+      }
+    }
+  }
+
+  starting_indices.push_back(0);
+  BOOST_FOREACH(const std::set<Uint>& nodes, connectivity_sets)
+  {
+    starting_indices.push_back(starting_indices.back() + nodes.size());
+    node_connectivity.insert(node_connectivity.end(), nodes.begin(), nodes.end());
+  }
+}
+
 struct ProtoLSSFixture
 {
   ProtoLSSFixture() :
@@ -91,32 +120,7 @@ struct ProtoLSSFixture
       field_manager = model->create_component<FieldManager>("FieldManager");
       field_manager->options().set("variable_manager", model->physics().variable_manager().handle<math::VariableManager>());
       
-      // Build node connectivity
-      const Uint nb_nodes = mesh->geometry_fields().size();
-      std::vector< std::set<Uint> > connectivity_sets(nb_nodes);
-      BOOST_FOREACH(const Entities& elements, common::find_components_recursively_with_filter<Entities>(*mesh, IsElementsVolume()))
-      {
-        const Connectivity& connectivity = elements.geometry_space().connectivity();
-        const Uint nb_elems = connectivity.size();
-        const Uint nb_elem_nodes = connectivity.row_size();
-        for(Uint elem = 0; elem != nb_elems; ++elem)
-        {
-          BOOST_FOREACH(const Uint node_a, connectivity[elem])
-          {
-            BOOST_FOREACH(const Uint node_b, connectivity[elem])
-            {
-              connectivity_sets[node_a].insert(node_b);
-            }
-          }
-        }
-      }
-      
-      starting_indices.push_back(0);
-      BOOST_FOREACH(const std::set<Uint>& nodes, connectivity_sets)
-      {
-        starting_indices.push_back(starting_indices.back() + nodes.size());
-        node_connectivity.insert(node_connectivity.end(), nodes.begin(), nodes.end());
-      }
+      build_node_connectivity(*mesh, node_connectivity, starting_indices);
       
       loop_regions.push_back(mesh->topology().uri());
     }
@@ -488,10 +492,78 @@ BOOST_AUTO_TEST_CASE( NestedCustomOps )
   BOOST_CHECK_SMALL(diff_norm.front(), 1e-10);
 }
 
+/// Assemble a Laplacian and set the RHS, solution and Dirichlet conditions from a node expression using the given number of threads
+void assemble_node_writes(Mesh& mesh, math::LSS::System& lss, const Uint nb_threads)
+{
+  FieldVariable<0, ScalarField> T("ThreadedVar", "threaded_lss");
+  SystemMatrix matrix(lss);
+  SystemRHS sys_rhs(lss);
+  SolutionVector sol_vec(lss);
+  DirichletBC dirichlet(lss);
+
+  for_each_element< boost::mpl::vector1<mesh::LagrangeP1::Quad2D> >(mesh.topology(), group
+  (
+    _A = _0,
+    element_quadrature(_A(T,T) += transpose(nabla(T)) * nabla(T)),
+    matrix += _A
+  ));
+
+  for_each_node(mesh.topology(), T = coordinates[0] * coordinates[1]);
+
+  // The Dirichlet condition also modifies the RHS of the neighbouring rows, so the order of the writes matters
+  for_each_node(mesh.topology(), group
+  (
+    sys_rhs(T) = T + coordinates[0],
+    sol_vec(T) = 2. * T,
+    dirichlet(T) = coordinates[1]
+  ), nb_threads);
+}
+
+BOOST_AUTO_TEST_CASE( ThreadedNodeWrites )
+{
+  // Large enough to be split into several chunks
+  Handle<Mesh> threaded_mesh = model->domain().create_component<Mesh>("threaded_mesh");
+  Tools::MeshGeneration::create_rectangle(*threaded_mesh, 1., 1., 30, 30);
+  threaded_mesh->geometry_fields().create_field("threaded_lss", "ThreadedVar").add_tag("threaded_lss");
+
+  std::vector<Uint> threaded_connectivity;
+  std::vector<Uint> threaded_starting_indices;
+  build_node_connectivity(*threaded_mesh, threaded_connectivity, threaded_starting_indices);
+
+  Handle<math::LSS::System> sequential_lss = root.create_component<math::LSS::System>("sequential_lss");
+  Handle<math::LSS::System> threaded_lss = root.create_component<math::LSS::System>("threaded_lss");
+  sequential_lss->options().set("matrix_builder", std::string("cf3.math.LSS.TrilinosCrsMatrix"));
+  threaded_lss->options().set("matrix_builder", std::string("cf3.math.LSS.TrilinosCrsMatrix"));
+  sequential_lss->create(threaded_mesh->geometry_fields().comm_pattern(), 1, threaded_connectivity, threaded_starting_indices);
+  threaded_lss->create(threaded_mesh->geometry_fields().comm_pattern(), 1, threaded_connectivity, threaded_starting_indices);
+
+  assemble_node_writes(*threaded_mesh, *sequential_lss, 1);
+  assemble_node_writes(*threaded_mesh, *threaded_lss, 4);
+
+  // The deferred writes are applied in the order of the nodes, so the results must be identical
+  std::vector<Uint> seq_rows, seq_cols, thr_rows, thr_cols;
+  std::vector<Real> seq_values, thr_values;
+  sequential_lss->matrix()->debug_data(seq_rows, seq_cols, seq_values);
+  threaded_lss->matrix()->debug_data(thr_rows, thr_cols, thr_values);
+  BOOST_CHECK_EQUAL_COLLECTIONS(seq_rows.begin(), seq_rows.end(), thr_rows.begin(), thr_rows.end());
+  BOOST_CHECK_EQUAL_COLLECTIONS(seq_cols.begin(), seq_cols.end(), thr_cols.begin(), thr_cols.end());
+  BOOST_CHECK_EQUAL_COLLECTIONS(seq_values.begin(), seq_values.end(), thr_values.begin(), thr_values.end());
+
+  sequential_lss->rhs()->debug_data(seq_values);
+  threaded_lss->rhs()->debug_data(thr_values);
+  BOOST_CHECK_EQUAL_COLLECTIONS(seq_values.begin(), seq_values.end(), thr_values.begin(), thr_values.end());
+
+  sequential_lss->solution()->debug_data(seq_values);
+  threaded_lss->solution()->debug_data(thr_values);
+  BOOST_CHECK_EQUAL_COLLECTIONS(seq_values.begin(), seq_values.end(), thr_values.begin(), thr_values.end());
+}
+
 BOOST_AUTO_TEST_CASE( CleanUp )
 {
   root.remove_component("scalar_lss");
   root.remove_component("vector_lss");
+  root.remove_component("sequential_lss");
+  root.remove_component("threaded_lss");
 }
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -38,6 +38,7 @@
 #include "mesh/ElementData.hpp"
 #include "mesh/FieldManager.hpp"
 #include "mesh/Dictionary.hpp"
+#include "mesh/Field.hpp"
 
 #include "mesh/Integrators/Gauss.hpp"
 #include "mesh/ElementTypes.hpp"
@@ -138,6 +139,169 @@ BOOST_AUTO_TEST_CASE( CheckResult )
   BOOST_CHECK_CLOSE(result[1], 1., 1e-8);
 }
 
+BOOST_AUTO_TEST_CASE( ThreadedLinearizeU )
+{
+  Handle<Model> model(Core::instance().root().get_child("Model"));
+
+  FieldVariable<0, VectorField> u("u","velocity");
+  FieldVariable<2, VectorField> u_adv("u_adv", "advection");
+  FieldVariable<3, VectorField> u1("u1", "advection");
+  FieldVariable<4, VectorField> u2("u2", "advection");
+  FieldVariable<5, VectorField> u3("u3", "advection");
+
+  ProtoAction& reset = *model->create_component<ProtoAction>("ThreadedReset");
+  reset.set_expression(nodes_expression(u_adv[_i] = 0.));
+  reset.options().set("physical_model", model->physics().handle<physics::PhysModel>());
+  reset.options().set(solver::Tags::regions(), std::vector<URI>(1, model->domain().get_child("mesh")->handle<Mesh>()->topology().uri()));
+  reset.options().set("nb_threads", 4u);
+  reset.execute();
+
+  ProtoAction& action = *model->create_component<ProtoAction>("ThreadedActionU");
+  action.set_expression(nodes_expression(u_adv = 2.1875*u - 2.1875*u1 + 1.3125*u2 - 0.3125*u3));
+  action.options().set("physical_model", model->physics().handle<physics::PhysModel>());
+  action.options().set(solver::Tags::regions(), std::vector<URI>(1, model->domain().get_child("mesh")->handle<Mesh>()->topology().uri()));
+  action.options().set("nb_threads", 4u);
+
+  action.execute();
+
+  // Same linearization on varying inputs, compared with the sequential loop
+  Handle<Mesh> mesh(model->domain().get_child("mesh"));
+  const std::vector<URI> regions(1, mesh->topology().uri());
+
+  FieldVariable<0, VectorField> v("v", "linearize");
+  FieldVariable<1, VectorField> v1("v1", "linearize");
+  FieldVariable<2, VectorField> v2("v2", "linearize");
+  FieldVariable<3, VectorField> v3("v3", "linearize");
+  FieldVariable<4, VectorField> v_seq("v_seq", "linearize");
+  FieldVariable<5, VectorField> v_thr("v_thr", "linearize");
+
+  ProtoAction& init = *model->create_component<ProtoAction>("LinearizeInit");
+  init.set_expression(nodes_expression(group
+  (
+    v[0] = coordinates[0], v[1] = coordinates[1],
+    v1[0] = coordinates[0]*coordinates[0], v1[1] = coordinates[1]*coordinates[1],
+    v2[0] = 1. - coordinates[0], v2[1] = 1. - coordinates[1],
+    v3[0] = 3.*coordinates[0] + 0.5, v3[1] = 3.*coordinates[1] + 0.5
+  )));
+  init.options().set("physical_model", model->physics().handle<physics::PhysModel>());
+  init.options().set(solver::Tags::regions(), regions);
+  Handle<FieldManager>(model->get_child("FieldManager"))->create_field("linearize", mesh->geometry_fields());
+  init.execute();
+
+  ProtoAction& sequential = *model->create_component<ProtoAction>("SequentialLinearize");
+  sequential.set_expression(nodes_expression(v_seq = 2.1875*v - 2.1875*v1 + 1.3125*v2 - 0.3125*v3));
+  sequential.options().set("physical_model", model->physics().handle<physics::PhysModel>());
+  sequential.options().set(solver::Tags::regions(), regions);
+  sequential.execute();
+
+  ProtoAction& threaded = *model->create_component<ProtoAction>("ThreadedLinearize");
+  threaded.set_expression(nodes_expression(v_thr = 2.1875*v - 2.1875*v1 + 1.3125*v2 - 0.3125*v3));
+  threaded.options().set("physical_model", model->physics().handle<physics::PhysModel>());
+  threaded.options().set(solver::Tags::regions(), regions);
+  threaded.options().set("nb_threads", 4u);
+  threaded.execute();
+
+  // Each node is computed by the same operations, so the results are identical
+  const Field& linearize = *Handle<Field const>(mesh->geometry_fields().get_child("linearize"));
+  const Field& coords = mesh->geometry_fields().coordinates();
+  const Uint seq_offset = linearize.var_offset("v_seq");
+  const Uint thr_offset = linearize.var_offset("v_thr");
+  const Uint nb_nodes = linearize.size();
+  Uint nb_differences = 0;
+  Uint nb_wrong = 0;
+  for(Uint node = 0; node != nb_nodes; ++node)
+  {
+    for(Uint i = 0; i != 2; ++i)
+    {
+      const Real x = coords[node][i];
+      const Real expected = 2.1875*x - 2.1875*x*x + 1.3125*(1. - x) - 0.3125*(3.*x + 0.5);
+      if(linearize[node][seq_offset+i] != linearize[node][thr_offset+i])
+        ++nb_differences;
+      if(std::abs(linearize[node][thr_offset+i] - expected) > 1e-12)
+        ++nb_wrong;
+    }
+  }
+  BOOST_CHECK_EQUAL(nb_differences, 0u);
+  BOOST_CHECK_EQUAL(nb_wrong, 0u);
+}
+
+BOOST_AUTO_TEST_CASE( ThreadedReductions )
+{
+  Handle<Model> model(Core::instance().root().get_child("Model"));
+  Handle<Mesh> mesh(model->domain().get_child("mesh"));
+
+  FieldVariable<2, VectorField> u_adv("u_adv", "advection");
+
+  Real sum = 0.;
+  Real maximum = -1.;
+  Real minimum = 10.;
+
+  ProtoAction& action = *model->create_component<ProtoAction>("ThreadedReductions");
+  action.set_expression(nodes_expression(group
+  (
+    lit(sum) += u_adv[0] + u_adv[1],
+    lit(maximum) = _max(lit(maximum), u_adv[0]),
+    lit(minimum) = _min(u_adv[1], lit(minimum))
+  )));
+  action.options().set("physical_model", model->physics().handle<physics::PhysModel>());
+  action.options().set(solver::Tags::regions(), std::vector<URI>(1, mesh->topology().uri()));
+  action.options().set("nb_threads", 4u);
+
+  action.execute();
+
+  BOOST_CHECK_CLOSE(sum, 2.*mesh->geometry_fields().size(), 1e-8);
+  BOOST_CHECK_CLOSE(maximum, 1., 1e-8);
+  BOOST_CHECK_CLOSE(minimum, 1., 1e-8);
+
+  // The next loops reuse the threads of the pool
+  const Uint nb_workers = NodeThreadPool::instance().nb_workers();
+  sum = 0.;
+  action.execute();
+  BOOST_CHECK_CLOSE(sum, 2.*mesh->geometry_fields().size(), 1e-8);
+  BOOST_CHECK_EQUAL(NodeThreadPool::instance().nb_workers(), nb_workers);
+}
+
+BOOST_AUTO_TEST_CASE( NodeThreadingWhitelist )
+{
+  FieldVariable<0, ScalarField> s("s", "whitelist");
+  Real sum = 0.;
+
+  // Fields, numbers, the coordinates, lit() Reals and function pointers can be used by several threads
+  NodeThreadingInfo safe;
+  const AnalyzeNodeThreading analyze_safe(safe);
+  analyze_safe(lit(sum) += _sqrt(s*s) + 2.*coordinates[0]);
+  BOOST_CHECK(safe.is_thread_safe());
+
+  // Any other terminal, such as a stream, keeps the loop sequential
+  NodeThreadingInfo unsafe;
+  const AnalyzeNodeThreading analyze_unsafe(unsafe);
+  analyze_unsafe(_cout << s);
+  BOOST_CHECK(!unsafe.is_thread_safe());
+}
+
+// Reductions to a vector are not thread safe, so this must fall back to a sequential loop
+BOOST_AUTO_TEST_CASE( ThreadedCheckResult )
+{
+  Handle<Model> model(Core::instance().root().get_child("Model"));
+
+  RealVector result(2); result.setZero();
+  FieldVariable<0, VectorField> u_adv("u_adv", "advection");
+
+  ProtoAction& action = *model->create_component<ProtoAction>("ThreadedActionCheck");
+  action.set_expression(nodes_expression(lit(result) += u_adv));
+  action.options().set("physical_model", model->physics().handle<physics::PhysModel>());
+  action.options().set(solver::Tags::regions(), std::vector<URI>(1, model->domain().get_child("mesh")->handle<Mesh>()->topology().uri()));
+  action.options().set("nb_threads", 4u);
+
+  action.execute();
+
+  Handle<Mesh> mesh(model->domain().get_child("mesh"));
+  result /= mesh->geometry_fields().size();
+
+  BOOST_CHECK_CLOSE(result[0], 1., 1e-8);
+  BOOST_CHECK_CLOSE(result[1], 1., 1e-8);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 ////////////////////////////////////////////////////////////////////////////////